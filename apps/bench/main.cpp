@@ -0,0 +1,617 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/Version.h"
+#include "dsp/diffusion/Diffusion.h"
+#include "dsp/engines/tune_hall/EarlyReflections.h"
+#include "dsp/engines/tune_hall/OutputStage.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+#include "dsp/tail/Tank.h"
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/ModuleFixtures.h"
+#include "common/PerfCounters.h"
+#include "common/TestSignals.h"
+
+/*
+  =============================================================================
+  apps/bench/main.cpp — bigpi_bench (per-mode end-to-end benchmark)
+  =============================================================================
+
+  What this program does:
+    - Runs every bigpi::Mode through ReverbEngine::processBlock
+    - Sweeps block sizes, sample rates and quality (Eco 8 lines / HQ 16 lines)
+    - Feeds realistic input (plucks, noise bursts) instead of a single impulse
+    - Times every processBlock() call
+
+  What it reports (per mode / rate / block / quality):
+    - ns_per_sample  : total processing time / processed samples
+    - rtf            : realtime factor (audio time / CPU time, >1 is faster)
+    - p50/p99/max    : block time percentiles in microseconds
+    - budget_p99_pct : p99 block time as % of the block period
+                       (RoadMap Phase 2: "block-level performance budget")
+    - with --stages  : per-stage ns/sample (predelay, ER, tank, ...) and the
+                       share of each stage in the whole block. Needs a build
+                       with -DBIGPI_ENABLE_PROFILING=ON (see core/Profiling.h).
+    - with --perf    : hardware counters (Linux perf_event_open) around the
+                       timed run: IPC and L1D / LLC / cache / branch misses
+                       per sample, per mode. Afterwards the same counters
+                       for stand-alone modules (Tank 8/16 lines, diffusion,
+                       ER, OutputStage) to separate memory- from math-bound
+                       work. Skipped with a note when counters are
+                       unavailable (containers, perf_event_paranoid).
+
+  Output:
+    - human-readable table on stdout
+    - JSON report (one object per line) via --json
+
+  Baseline compare:
+    Save a report once (e.g. bench_baseline.json), then run with
+      --baseline bench_baseline.json
+    Any config whose ns_per_sample got slower by more than --tolerance
+    (default 10%) is flagged and the program exits with code 2.
+
+  Usage:
+    bigpi_bench [--modes all|Hall,Room,...] [--rates 44100,48000,...]
+                [--blocks 16,32,...] [--quality eco,hq,preset]
+                [--signal mixed|pluck|burst] [--seconds 2]
+                [--json out.json] [--baseline base.json] [--tolerance 0.10]
+                [--quick] [--stages] [--perf]
+
+  Tip:
+    Build with -DCMAKE_BUILD_TYPE=Release. Debug numbers are meaningless.
+*/
+
+using namespace bigpi::bench;
+
+// ============================================================================
+// Config
+// ============================================================================
+
+struct BenchOptions {
+    std::vector<bigpi::Mode> modes;
+    std::vector<int> rates = { 44100, 48000, 88200, 96000, 192000 };
+    std::vector<int> blocks = { 16, 32, 64, 128, 256, 512, 1024 };
+    std::vector<std::string> qualities = { "eco", "hq" };
+
+    std::string signal = "mixed";
+    float seconds = 2.0f;
+    float warmupSeconds = 0.5f;
+
+    std::string jsonPath = "bigpi_bench.json";
+    std::string baselinePath;
+    double tolerance = 0.10;
+
+    bool stages = false;
+    bool perf = false;
+};
+
+// ============================================================================
+// Hardware counter helpers
+// ============================================================================
+
+static void appendPerfJson(JsonObject& o, const PerfReading& p, double samples) {
+    if (samples <= 0.0) return;
+    o.num("ipc", p.ipc());
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+        const auto ev = PerfEvent(e);
+        if (!p.has(ev)) continue;
+        const std::string key = std::string(perfEventName(ev)) + "_per_sample";
+        o.num(key.c_str(), p.get(ev) / samples);
+    }
+}
+
+// "ipc 1.92  cyc 3012.4  l1d 41.20  llc 0.01  cache 0.20  br 1.05" (per sample)
+static void printPerf(const char* label, const PerfReading& p, double samples) {
+    std::printf("    %-22s ipc %5.2f", label, p.ipc());
+    static const char* shortName[kNumPerfEvents] = { "cyc", "ins", "l1d", "llc", "cache", "br" };
+    for (int e = 0; e < kNumPerfEvents; ++e) {
+        const auto ev = PerfEvent(e);
+        if (ev == PerfEvent::Instructions) continue;
+        if (p.has(ev)) std::printf("  %s %8.2f", shortName[e], p.get(ev) / samples);
+        else std::printf("  %s %8s", shortName[e], "n/a");
+    }
+    std::printf("  (per sample)\n");
+}
+
+struct BenchResult {
+    std::string mode;
+    int sr = 0;
+    int block = 0;
+    std::string quality;
+
+    double nsPerSample = 0.0;
+    double rtf = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double budgetP99Pct = 0.0;
+    size_t samples = 0;
+
+    // Per-stage breakdown (only filled with --stages on a profiling build)
+    ReverbEngine::Stats stats{};
+
+    // Hardware counters over the timed run (only with --perf)
+    bool hasPerf = false;
+    PerfReading perf{};
+
+    std::string key() const {
+        return mode + "|" + std::to_string(sr) + "|" + std::to_string(block) + "|" + quality;
+    }
+
+    std::string toJson() const {
+        JsonObject o;
+        o.str("mode", mode)
+            .integer("sr", sr)
+            .integer("block", block)
+            .str("quality", quality)
+            .num("ns_per_sample", nsPerSample)
+            .num("rtf", rtf)
+            .num("p50_us", p50Us)
+            .num("p99_us", p99Us)
+            .num("max_us", maxUs)
+            .num("budget_p99_pct", budgetP99Pct);
+
+        if (stats.enabled && stats.samples > 0) {
+            for (int s = 0; s < bigpi::prof::kNumStages; ++s) {
+                const auto st = bigpi::prof::Stage(s);
+                const std::string key = std::string("stage_") + bigpi::prof::stageName(st) + "_ns_per_sample";
+                o.num(key.c_str(), double(stats.stage(st).totalNs) / double(stats.samples));
+            }
+            o.integer("xrun_blocks", int64_t(stats.xrunBlocks));
+        }
+
+        if (hasPerf) appendPerfJson(o, perf, double(samples));
+        return o.done();
+    }
+};
+
+static void printUsage() {
+    std::cout <<
+        "bigpi_bench options:\n"
+        "  --modes all|Name,Name    modes to run (default all)\n"
+        "  --rates 48000,96000      sample rates\n"
+        "  --blocks 16,64,256       block sizes\n"
+        "  --quality eco,hq,preset  tank line count (8, 16, mode preset)\n"
+        "  --signal mixed|pluck|burst\n"
+        "  --seconds S              timed audio per config (default 2)\n"
+        "  --json PATH              JSON report path (default bigpi_bench.json)\n"
+        "  --baseline PATH          compare against a stored report\n"
+        "  --tolerance T            allowed slowdown vs baseline (default 0.10)\n"
+        "  --quick                  48 kHz, blocks 64/256, HQ only\n"
+        "  --stages                 per-stage breakdown (profiling build only)\n"
+        "  --perf                   hardware counters per mode + per module (Linux)\n";
+}
+
+static bool parseModes(const std::string& s, std::vector<bigpi::Mode>& out) {
+    out.clear();
+    if (s == "all") {
+        for (int i = 0; i < int(bigpi::Mode::Count); ++i) out.push_back(bigpi::Mode(i));
+        return true;
+    }
+    for (const auto& name : parseCsvList(s)) {
+        bigpi::Mode m;
+        if (!bigpi::modeFromString(name.c_str(), m)) {
+            std::cerr << "Unknown mode: " << name << "\n";
+            return false;
+        }
+        out.push_back(m);
+    }
+    return !out.empty();
+}
+
+static bool parseInts(const std::string& s, std::vector<int>& out) {
+    out.clear();
+    for (const auto& v : parseCsvList(s)) {
+        const int x = std::atoi(v.c_str());
+        if (x <= 0) return false;
+        out.push_back(x);
+    }
+    return !out.empty();
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& o) {
+    parseModes("all", o.modes);
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](std::string& v) -> bool {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+            v = argv[++i];
+            return true;
+        };
+
+        std::string v;
+        if (a == "--help" || a == "-h") { printUsage(); std::exit(0); }
+        else if (a == "--quick") {
+            o.rates = { 48000 };
+            o.blocks = { 64, 256 };
+            o.qualities = { "hq" };
+        }
+        else if (a == "--stages") { o.stages = true; }
+        else if (a == "--perf") { o.perf = true; }
+        else if (a == "--modes") { if (!next(v) || !parseModes(v, o.modes)) return false; }
+        else if (a == "--rates") { if (!next(v) || !parseInts(v, o.rates)) return false; }
+        else if (a == "--blocks") { if (!next(v) || !parseInts(v, o.blocks)) return false; }
+        else if (a == "--quality") {
+            if (!next(v)) return false;
+            o.qualities = parseCsvList(v);
+            for (const auto& q : o.qualities) {
+                if (!isValidQuality(q)) { std::cerr << "Unknown quality: " << q << "\n"; return false; }
+            }
+        }
+        else if (a == "--signal") { if (!next(v)) return false; o.signal = v; }
+        else if (a == "--seconds") { if (!next(v)) return false; o.seconds = std::max(0.05f, float(std::atof(v.c_str()))); }
+        else if (a == "--json") { if (!next(v)) return false; o.jsonPath = v; }
+        else if (a == "--baseline") { if (!next(v)) return false; o.baselinePath = v; }
+        else if (a == "--tolerance") { if (!next(v)) return false; o.tolerance = std::max(0.0, std::atof(v.c_str())); }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Run one config
+// ============================================================================
+
+/*
+  runOne()
+  --------
+  Fresh engine per config so no state (delay memory, smoothers) leaks between
+  runs. The warm-up prefix is processed untimed, then the timed signal is fed
+  block by block.
+*/
+static BenchResult runOne(bigpi::Mode mode, int sr, int block, const std::string& quality,
+    const std::vector<float>& warmL, const std::vector<float>& warmR,
+    const std::vector<float>& inL, const std::vector<float>& inR,
+    std::vector<float>& outL, std::vector<float>& outR,
+    PerfCounters* pc)
+{
+    ReverbEngine eng;
+    prepareMode(eng, float(sr), block, mode, quality);
+
+    runUntimed(eng, warmL, warmR, outL, outR, block, int(warmL.size()));
+    eng.resetStats();
+
+    LatencyHistogram hist;
+    if (pc) pc->start();
+    const uint64_t totalNs = runTimed(eng, inL, inR, outL, outR, block, hist);
+    if (pc) pc->stop();
+
+    const double samples = double(inL.size());
+    const double audioNs = 1.0e9 * samples / double(sr);
+
+    BenchResult r;
+    r.mode = bigpi::modeToString(mode);
+    r.sr = sr;
+    r.block = block;
+    r.quality = quality;
+    r.nsPerSample = double(totalNs) / samples;
+    r.rtf = (totalNs > 0) ? audioNs / double(totalNs) : 0.0;
+    r.p50Us = double(hist.percentile(0.50)) * 1e-3;
+    r.p99Us = double(hist.percentile(0.99)) * 1e-3;
+    r.maxUs = double(hist.max()) * 1e-3;
+    r.budgetP99Pct = 100.0 * double(hist.percentile(0.99)) / blockDeadlineNs(float(sr), block);
+    r.samples = inL.size();
+    r.stats = eng.getStats();
+    if (pc) {
+        r.hasPerf = true;
+        r.perf = pc->read();
+    }
+    return r;
+}
+
+// ============================================================================
+// Stand-alone module counters (--perf)
+// ============================================================================
+
+/*
+  runModulePerf()
+  ---------------
+  Runs each heavy module on its own over `in` (mono is enough here) and
+  reads the counters around it. One JSON object per module ("module" key
+  instead of "mode", so baseline compare ignores these lines).
+
+  Reading the Tank rows:
+    - IPC well below 1 with high L1D/LLC misses per sample -> memory bound
+      (delay-line reads), look at line count / buffer layout.
+    - IPC above ~2 with few misses -> math bound (interpolation, LFOs,
+      filters), look at SIMD / cheaper kernels.
+*/
+static void runModulePerf(PerfCounters& pc, int sr, const std::vector<float>& in,
+    std::vector<std::string>& jsonLines)
+{
+    const float fsr = float(sr);
+    const double samples = double(in.size());
+    float sink = 0.0f;
+
+    std::cout << "\nModules @ " << sr << " Hz (hardware counters, per sample):\n";
+
+    auto report = [&](const char* name) {
+        const PerfReading r = pc.read();
+        printPerf(name, r, samples);
+
+        JsonObject o;
+        o.str("module", name).integer("sr", sr);
+        appendPerfJson(o, r, samples);
+        jsonLines.push_back(o.done());
+    };
+
+    // Tank: Eco (8) and HQ (16) lines
+    dsp::MultiLFO lfo;
+    lfo.init(16, fsr);
+
+    for (int lines : { 8, 16 }) {
+        bigpi::core::Tank tank;
+        initReferenceTank(tank, fsr, lines);
+
+        std::array<float, bigpi::core::Tank::kMaxLines> inj{};
+        std::array<float, bigpi::core::Tank::kMaxLines> y{};
+
+        pc.start();
+        for (float x : in) {
+            const float v = x * (1.0f / float(lines));
+            for (int l = 0; l < lines; ++l) inj[size_t(l)] = v;
+            tank.processSampleVec(inj, 0.92f, lfo, y);
+            sink += y[0];
+        }
+        pc.stop();
+        report(lines == 8 ? "tank/8" : "tank/16");
+    }
+
+    // Diffusion (input chain, then late chain)
+    {
+        bigpi::core::Diffusion diffusion;
+        diffusion.init(fsr, 0xB16B00B5u);
+
+        pc.start();
+        for (float x : in) {
+            float L = x, R = -x;
+            diffusion.processInput(L, R);
+            sink += L + R;
+        }
+        pc.stop();
+        report("diffusion_input");
+
+        pc.start();
+        for (float x : in) {
+            float L = x, R = -x;
+            diffusion.processLate(L, R, 0.6f);
+            sink += L + R;
+        }
+        pc.stop();
+        report("diffusion_late");
+    }
+
+    // Block modules (64-sample blocks)
+    {
+        EarlyReflections er;
+        er.prepare(fsr);
+        OutputStage out;
+        out.prepare(fsr);
+
+        std::vector<float> bL(64), bR(64);
+        const int total = int(in.size());
+
+        // ER reads the engine's input history; give it one of its own here
+        dsp::DelayLine hist;
+        hist.init(int(fsr * 0.10f) + 64 + 4);
+
+        pc.start();
+        for (int pos = 0; pos + 64 <= total; pos += 64) {
+            for (int i = 0; i < 64; ++i) hist.push(in[size_t(pos + i)]);
+            er.processBlock(hist, hist, 0.0f, bL.data(), bR.data(), 64);
+            sink += bL[0];
+        }
+        pc.stop();
+        report("er");
+
+        pc.start();
+        for (int pos = 0; pos + 64 <= total; pos += 64) {
+            std::copy_n(&in[size_t(pos)], 64, bL.begin());
+            std::copy_n(&in[size_t(pos)], 64, bR.begin());
+            out.processBlock(bL.data(), bR.data(), 64);
+            sink += bL[0];
+        }
+        pc.stop();
+        report("output_stage");
+    }
+
+    volatile float keep = sink;
+    (void)keep;
+}
+
+/*
+  printStages()
+  -------------
+  One line per stage: ns/sample, share of the whole block, p99 per chunk.
+  Every stage is listed for every mode so the columns line up when diffing.
+*/
+static void printStages(const ReverbEngine::Stats& st) {
+    if (!st.enabled || st.samples == 0) return;
+
+    const double blockNs = double(st.stage(bigpi::prof::Stage::Block).totalNs);
+    const double samples = double(st.samples);
+
+    for (int s = 0; s < bigpi::prof::kNumStages; ++s) {
+        const auto stage = bigpi::prof::Stage(s);
+        const auto& h = st.stage(stage);
+        if (stage == bigpi::prof::Stage::Block) continue;
+
+        std::printf("    %-16s %9.2f ns/smp  %5.1f%%  p99 %8.2f us\n",
+            bigpi::prof::stageName(stage),
+            double(h.totalNs) / samples,
+            blockNs > 0.0 ? 100.0 * double(h.totalNs) / blockNs : 0.0,
+            double(h.percentileNs(0.99)) * 1e-3);
+    }
+    std::printf("    %-16s %llu / %llu blocks over deadline (%llu at risk)\n", "xruns",
+        (unsigned long long)st.xrunBlocks, (unsigned long long)st.blocks,
+        (unsigned long long)st.riskBlocks);
+}
+
+// ============================================================================
+// Baseline compare
+// ============================================================================
+
+static std::map<std::string, double> loadBaseline(const std::string& path) {
+    std::map<std::string, double> out;
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "Cannot read baseline: " << path << "\n";
+        return out;
+    }
+
+    std::string line;
+    while (std::getline(f, line)) {
+        std::string mode, sr, block, quality, ns;
+        if (!jsonField(line, "mode", mode)) continue;
+        if (!jsonField(line, "sr", sr) || !jsonField(line, "block", block)) continue;
+        if (!jsonField(line, "quality", quality) || !jsonField(line, "ns_per_sample", ns)) continue;
+        out[mode + "|" + sr + "|" + block + "|" + quality] = std::atof(ns.c_str());
+    }
+    return out;
+}
+
+static int compareBaseline(const std::vector<BenchResult>& results,
+    const std::map<std::string, double>& base, double tol)
+{
+    int regressions = 0;
+    int matched = 0;
+
+    std::cout << "\nBaseline compare (tolerance " << tol * 100.0 << "%):\n";
+    for (const auto& r : results) {
+        auto it = base.find(r.key());
+        if (it == base.end() || it->second <= 0.0) continue;
+        matched++;
+
+        const double ratio = r.nsPerSample / it->second;
+        const bool bad = ratio > 1.0 + tol;
+        if (bad) regressions++;
+
+        if (bad || ratio < 1.0 - tol) {
+            std::printf("  %-12s %6d Hz  blk %4d  %-6s  %8.2f -> %8.2f ns/smp  (%+.1f%%)%s\n",
+                r.mode.c_str(), r.sr, r.block, r.quality.c_str(),
+                it->second, r.nsPerSample, (ratio - 1.0) * 100.0,
+                bad ? "  REGRESSION" : "  improved");
+        }
+    }
+
+    std::cout << "  matched " << matched << " configs, " << regressions << " regression(s)\n";
+    return regressions;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    std::cout << "Big Pi — bigpi_bench\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n";
+
+    BenchOptions o;
+    if (!parseArgs(argc, argv, o)) return 1;
+
+    if (!isOptimizedBuild()) {
+        std::cout << "WARNING: this is not an optimized build (NDEBUG not set).\n"
+                     "         Configure with -DCMAKE_BUILD_TYPE=Release for real numbers.\n";
+    }
+    PerfCounters counters;
+    PerfCounters* pc = nullptr;
+    if (o.perf) {
+        if (counters.open()) pc = &counters;
+        else std::cout << "NOTE: --perf skipped: " << counters.reason() << "\n";
+    }
+
+    if (o.stages && !BIGPI_PROFILE) {
+        std::cout << "WARNING: --stages needs a profiling build "
+                     "(-DBIGPI_ENABLE_PROFILING=ON); no breakdown will be shown.\n";
+    }
+    std::cout << "\n";
+
+    std::vector<BenchResult> results;
+
+    std::printf("%-12s %7s %5s %-6s %9s %8s %9s %9s %9s %8s\n",
+        "mode", "sr", "block", "qual", "ns/smp", "rtf", "p50 us", "p99 us", "max us", "p99 %");
+
+    for (int sr : o.rates) {
+        // One input signal per sample rate, shared by every config at that rate.
+        // The first warmupSeconds are processed untimed.
+        const size_t warm = size_t(o.warmupSeconds * float(sr));
+        const size_t timed = size_t(o.seconds * float(sr));
+
+        std::vector<float> inL(warm + timed), inR(warm + timed);
+        if (!generateSignal(o.signal, inL, inR, float(sr), 0xB16B1u)) {
+            std::cerr << "Unknown signal: " << o.signal << "\n";
+            return 1;
+        }
+
+        const std::vector<float> warmL(inL.begin(), inL.begin() + warm);
+        const std::vector<float> warmR(inR.begin(), inR.begin() + warm);
+        const std::vector<float> tL(inL.begin() + warm, inL.end());
+        const std::vector<float> tR(inR.begin() + warm, inR.end());
+
+        std::vector<float> outL(warm + timed), outR(warm + timed);
+
+        for (bigpi::Mode mode : o.modes) {
+            for (const auto& q : o.qualities) {
+                for (int block : o.blocks) {
+                    const BenchResult r = runOne(mode, sr, block, q, warmL, warmR, tL, tR, outL, outR, pc);
+
+                    std::printf("%-12s %7d %5d %-6s %9.2f %8.1f %9.2f %9.2f %9.2f %7.1f%%\n",
+                        r.mode.c_str(), r.sr, r.block, r.quality.c_str(),
+                        r.nsPerSample, r.rtf, r.p50Us, r.p99Us, r.maxUs, r.budgetP99Pct);
+                    if (o.stages) printStages(r.stats);
+                    if (r.hasPerf) printPerf("counters", r.perf, double(r.samples));
+                    std::fflush(stdout);
+
+                    results.push_back(r);
+                }
+            }
+        }
+    }
+
+    // Stand-alone modules, once, at the first sample rate
+    std::vector<std::string> moduleLines;
+    if (pc && !o.rates.empty()) {
+        const int sr = o.rates.front();
+        std::vector<float> mL(size_t(o.seconds * float(sr))), mR(mL.size());
+        generateSignal(o.signal, mL, mR, float(sr), 0xB16B1u);
+        runModulePerf(*pc, sr, mL, moduleLines);
+    }
+
+    // JSON report
+    if (!o.jsonPath.empty()) {
+        std::vector<std::string> lines;
+        lines.reserve(results.size() + moduleLines.size());
+        for (const auto& r : results) lines.push_back(r.toJson());
+        for (const auto& m : moduleLines) lines.push_back(m);
+
+        std::ofstream f(o.jsonPath);
+        if (!f) {
+            std::cerr << "Cannot write " << o.jsonPath << "\n";
+            return 1;
+        }
+        writeJsonLines(f, lines);
+        std::cout << "\nWrote JSON: " << o.jsonPath << "\n";
+    }
+
+    if (!o.baselinePath.empty()) {
+        const auto base = loadBaseline(o.baselinePath);
+        if (compareBaseline(results, base, o.tolerance) > 0) return 2;
+    }
+
+    return 0;
+}
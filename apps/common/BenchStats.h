@@ -0,0 +1,252 @@
+#pragma once
+/*
+  =============================================================================
+  BenchStats.h — Big Pi harness timing + statistics helpers
+  =============================================================================
+
+  Shared by the benchmark style tools in apps/ (bigpi_bench and friends).
+
+  What lives here:
+    - nowNs():            monotonic wall clock in nanoseconds
+    - LatencyHistogram:   fixed-size log-linear histogram of block times
+                          (no allocation while recording, ~1.5% resolution)
+    - JsonWriter:         tiny streaming JSON object writer
+    - parseCsvList():     "16,32,64" style CLI list parsing
+
+  Why a histogram instead of storing every block time:
+    Stress runs can cover hours of simulated audio (tens of millions of
+    blocks). A log-linear histogram keeps memory fixed while still giving
+    usable p50/p99/p99.99 values and an exact maximum.
+*/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bigpi::bench {
+
+    // ============================================================================
+    // Clock
+    // ============================================================================
+
+    inline uint64_t nowNs() {
+        using namespace std::chrono;
+        return uint64_t(duration_cast<nanoseconds>(
+            steady_clock::now().time_since_epoch()).count());
+    }
+
+    // ============================================================================
+    // LatencyHistogram
+    // ============================================================================
+
+    class LatencyHistogram {
+    public:
+        // 64 sub-buckets per power of two -> worst-case quantisation ~1.5%.
+        static constexpr int kSubBits = 6;
+        static constexpr int kSub = 1 << kSubBits;
+        static constexpr int kOctaves = 40;                 // up to ~2^40 ns (18 min)
+        static constexpr int kBuckets = kOctaves * kSub;
+
+        void clear() {
+            counts.fill(0);
+            n = 0;
+            sum = 0.0;
+            maxV = 0;
+            minV = UINT64_MAX;
+        }
+
+        LatencyHistogram() { clear(); }
+
+        void record(uint64_t v) {
+            counts[bucketOf(v)]++;
+            n++;
+            sum += double(v);
+            if (v > maxV) maxV = v;
+            if (v < minV) minV = v;
+        }
+
+        void merge(const LatencyHistogram& o) {
+            for (int i = 0; i < kBuckets; ++i) counts[i] += o.counts[i];
+            n += o.n;
+            sum += o.sum;
+            if (o.maxV > maxV) maxV = o.maxV;
+            if (o.minV < minV) minV = o.minV;
+        }
+
+        uint64_t count() const { return n; }
+        uint64_t max() const { return maxV; }
+        uint64_t min() const { return n ? minV : 0; }
+        double mean() const { return n ? sum / double(n) : 0.0; }
+
+        // q in [0,1]. Returns the upper edge of the bucket holding the quantile,
+        // clamped to the exact observed maximum.
+        uint64_t percentile(double q) const {
+            if (n == 0) return 0;
+            if (q <= 0.0) return min();
+            if (q >= 1.0) return maxV;
+
+            const uint64_t rank = uint64_t(q * double(n - 1)) + 1;
+            uint64_t acc = 0;
+            for (int i = 0; i < kBuckets; ++i) {
+                acc += counts[i];
+                if (acc >= rank) {
+                    const uint64_t edge = bucketUpper(i);
+                    return edge < maxV ? edge : maxV;
+                }
+            }
+            return maxV;
+        }
+
+    private:
+        std::array<uint64_t, kBuckets> counts{};
+        uint64_t n = 0;
+        double sum = 0.0;
+        uint64_t maxV = 0;
+        uint64_t minV = UINT64_MAX;
+
+        static int msb(uint64_t v) {
+            int b = 0;
+            while (v >>= 1) ++b;
+            return b;
+        }
+
+        static int bucketOf(uint64_t v) {
+            if (v < uint64_t(kSub)) return int(v);             // exact for small values
+            const int e = msb(v);                               // >= kSubBits
+            const int octave = e - kSubBits + 1;
+            if (octave >= kOctaves) return kBuckets - 1;
+            const int sub = int((v >> (e - kSubBits)) & uint64_t(kSub - 1));
+            return octave * kSub + sub;
+        }
+
+        static uint64_t bucketUpper(int idx) {
+            const int octave = idx / kSub;
+            const int sub = idx % kSub;
+            if (octave == 0) return uint64_t(sub);
+            const int shift = octave - 1;
+            return ((uint64_t(kSub + sub) + 1) << shift) - 1;
+        }
+    };
+
+    // ============================================================================
+    // JsonWriter (flat objects, one per line)
+    // ============================================================================
+
+    /*
+      Reports are written as "JSON lines" inside an array:
+
+        [
+        {"mode":"Hall","sr":48000,...},
+        {"mode":"Room","sr":48000,...}
+        ]
+
+      One object per line keeps the files diff-friendly and lets the baseline
+      reader below stay tiny.
+    */
+    class JsonObject {
+    public:
+        JsonObject& str(const char* key, const std::string& v) {
+            sep();
+            os << '"' << key << "\":\"" << escape(v) << '"';
+            return *this;
+        }
+
+        JsonObject& num(const char* key, double v) {
+            sep();
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.6g", v);
+            os << '"' << key << "\":" << buf;
+            return *this;
+        }
+
+        JsonObject& integer(const char* key, int64_t v) {
+            sep();
+            os << '"' << key << "\":" << v;
+            return *this;
+        }
+
+        std::string done() const { return "{" + os.str() + "}"; }
+
+    private:
+        std::ostringstream os;
+        bool first = true;
+
+        void sep() {
+            if (!first) os << ',';
+            first = false;
+        }
+
+        static std::string escape(const std::string& s) {
+            std::string out;
+            out.reserve(s.size());
+            for (char c : s) {
+                if (c == '"' || c == '\\') out.push_back('\\');
+                out.push_back(c);
+            }
+            return out;
+        }
+    };
+
+    inline void writeJsonLines(std::ostream& os, const std::vector<std::string>& objects) {
+        os << "[\n";
+        for (size_t i = 0; i < objects.size(); ++i) {
+            os << objects[i] << (i + 1 < objects.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+
+    // Extracts a value for `key` from one flat JSON object line written above.
+    // Returns false if the key is missing. Strings are returned without quotes.
+    inline bool jsonField(const std::string& line, const std::string& key, std::string& out) {
+        const std::string pat = "\"" + key + "\":";
+        size_t p = line.find(pat);
+        if (p == std::string::npos) return false;
+        p += pat.size();
+
+        if (p < line.size() && line[p] == '"') {
+            size_t e = line.find('"', p + 1);
+            if (e == std::string::npos) return false;
+            out = line.substr(p + 1, e - p - 1);
+            return true;
+        }
+
+        size_t e = line.find_first_of(",}", p);
+        if (e == std::string::npos) e = line.size();
+        out = line.substr(p, e - p);
+        return true;
+    }
+
+    // ============================================================================
+    // CLI helpers
+    // ============================================================================
+
+    inline std::vector<std::string> parseCsvList(const std::string& s) {
+        std::vector<std::string> out;
+        std::string cur;
+        for (char c : s) {
+            if (c == ',') {
+                if (!cur.empty()) out.push_back(cur);
+                cur.clear();
+            }
+            else {
+                cur.push_back(c);
+            }
+        }
+        if (!cur.empty()) out.push_back(cur);
+        return out;
+    }
+
+    inline bool isOptimizedBuild() {
+#if defined(NDEBUG)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+} // namespace bigpi::bench
@@ -0,0 +1,123 @@
+#pragma once
+/*
+  =============================================================================
+  EngineTiming.h — Big Pi harness helpers for timing ReverbEngine
+  =============================================================================
+
+  Small glue shared by the benchmark tools:
+    - qualityName / qualityLines: Eco/HQ <-> Params::tankLines
+    - prepareMode:                prepare + select a mode with its preset defaults
+    - runTimed:                   feed a signal through the engine block by block
+                                  and record every block time into a histogram
+*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/BenchStats.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+namespace bigpi::bench {
+
+    // ============================================================================
+    // Quality (Eco / HQ)
+    // ============================================================================
+
+    inline int qualityLines(const std::string& q) {
+        if (q == "eco") return 8;
+        if (q == "hq") return 16;
+        return 0; // "preset"
+    }
+
+    inline bool isValidQuality(const std::string& q) {
+        return q == "eco" || q == "hq" || q == "preset";
+    }
+
+    // ============================================================================
+    // Engine setup
+    // ============================================================================
+
+    /*
+      prepareMode(eng, sr, block, mode, quality)
+      ------------------------------------------
+      Prepares the engine and selects `mode` with the mode's own suggested
+      defaults, then applies the quality override on top.
+
+      ReverbEngine::setParams() only re-applies a mode preset when the mode
+      changes, so we start from the params prepare() left behind (Hall preset)
+      instead of a default-constructed Params. That way every mode, including
+      Hall, runs with its preset defaults.
+    */
+    inline ReverbEngine::Params prepareMode(ReverbEngine& eng, float sr, int block,
+        bigpi::Mode mode, const std::string& quality)
+    {
+        eng.prepare(sr, block);
+
+        ReverbEngine::Params p = eng.getParams();
+        p.mode = mode;
+        eng.setParams(p);
+
+        p = eng.getParams();
+        p.tankLines = qualityLines(quality);
+        eng.setParams(p);
+
+        eng.reset();
+        return eng.getParams();
+    }
+
+    // ============================================================================
+    // Timed run
+    // ============================================================================
+
+    /*
+      runTimed(eng, inL, inR, outL, outR, block, hist)
+      -------------------------------------------------
+      Processes the whole input in `block`-sized calls, timing each call.
+      Returns the total processing time in nanoseconds.
+
+      The output buffers must be at least as large as the input.
+    */
+    inline uint64_t runTimed(ReverbEngine& eng,
+        const std::vector<float>& inL, const std::vector<float>& inR,
+        std::vector<float>& outL, std::vector<float>& outR,
+        int block,
+        LatencyHistogram& hist)
+    {
+        const int total = int(std::min(inL.size(), inR.size()));
+        uint64_t sum = 0;
+
+        for (int pos = 0; pos < total; pos += block) {
+            const int n = std::min(block, total - pos);
+
+            const uint64_t t0 = nowNs();
+            eng.processBlock(&inL[pos], &inR[pos], &outL[pos], &outR[pos], n);
+            const uint64_t dt = nowNs() - t0;
+
+            hist.record(dt);
+            sum += dt;
+        }
+
+        return sum;
+    }
+
+    // Untimed run (warm-up: fills delay lines, settles smoothers and caches).
+    inline void runUntimed(ReverbEngine& eng,
+        const std::vector<float>& inL, const std::vector<float>& inR,
+        std::vector<float>& outL, std::vector<float>& outR,
+        int block, int samples)
+    {
+        samples = std::min(samples, int(std::min(inL.size(), inR.size())));
+        for (int pos = 0; pos < samples; pos += block) {
+            const int n = std::min(block, samples - pos);
+            eng.processBlock(&inL[pos], &inR[pos], &outL[pos], &outR[pos], n);
+        }
+    }
+
+    // Block period in nanoseconds (the real-time deadline for one block).
+    inline double blockDeadlineNs(float sr, int block) {
+        return 1.0e9 * double(block) / double(sr);
+    }
+
+} // namespace bigpi::bench
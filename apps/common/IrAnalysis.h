@@ -0,0 +1,182 @@
+#pragma once
+/*
+  =============================================================================
+  IrAnalysis.h — Big Pi impulse-response metrics for regression checks
+  =============================================================================
+
+  Two renders of the same mode can differ sample-by-sample (a faster kernel,
+  a different summation order) and still sound identical. These metrics
+  compare what the ear cares about:
+
+    nullResidualDb  : energy of (candidate - reference) relative to the
+                      reference, in dB. -inf for bit-exact renders.
+    maxAbsError     : largest per-sample difference.
+    RT60 / EDT      : per octave band, from Schroeder backward integration.
+                      RT60 from the -5..-25 dB slope (T20), or -5..-15 dB
+                      (T10) when the render ends before -25 dB.
+                      EDT from the 0..-10 dB slope.
+    echo density    : Abel & Huang normalised echo density, averaged over
+                      the first 300 ms after the onset (1.0 = Gaussian-like
+                      diffuse tail, lower = sparse discrete echoes).
+
+  All functions are offline helpers (allocate freely).
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::bench {
+
+    // ============================================================================
+    // Sample-level comparison
+    // ============================================================================
+
+    inline double maxAbsError(const std::vector<float>& ref, const std::vector<float>& cand) {
+        const size_t n = std::min(ref.size(), cand.size());
+        double m = 0.0;
+        for (size_t i = 0; i < n; ++i) m = std::max(m, double(std::abs(ref[i] - cand[i])));
+        return m;
+    }
+
+    // Residual energy relative to the reference energy (dB).
+    inline double nullResidualDb(const std::vector<float>& ref, const std::vector<float>& cand) {
+        const size_t n = std::min(ref.size(), cand.size());
+        double eRef = 0.0, eDiff = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double d = double(ref[i]) - double(cand[i]);
+            eRef += double(ref[i]) * double(ref[i]);
+            eDiff += d * d;
+        }
+        if (eDiff <= 0.0) return -std::numeric_limits<double>::infinity();
+        if (eRef <= 0.0) return std::numeric_limits<double>::infinity();
+        return 10.0 * std::log10(eDiff / eRef);
+    }
+
+    // ============================================================================
+    // Octave bands
+    // ============================================================================
+
+    inline constexpr std::array<float, 7> kOctaveBandsHz = { 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f };
+
+    // 4th-order octave band: two HP + two LP biquads at fc/sqrt2 and fc*sqrt2.
+    inline std::vector<float> octaveBand(const std::vector<float>& x, float fc, float sr) {
+        dsp::Biquad hp1, hp2, lp1, lp2;
+        const float lo = fc / std::sqrt(2.0f);
+        const float hi = std::min(fc * std::sqrt(2.0f), 0.49f * sr);
+        hp1.setHighPass(lo, 0.7071f, sr);
+        hp2.setHighPass(lo, 0.7071f, sr);
+        lp1.setLowPass(hi, 0.7071f, sr);
+        lp2.setLowPass(hi, 0.7071f, sr);
+
+        std::vector<float> y(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            y[i] = lp2.process(lp1.process(hp2.process(hp1.process(x[i]))));
+        }
+        return y;
+    }
+
+    // ============================================================================
+    // Decay (Schroeder integration)
+    // ============================================================================
+
+    struct DecayMetrics {
+        double rt60 = 0.0;   // seconds (0 = could not be measured)
+        double edt = 0.0;    // seconds
+        bool fromT10 = false;
+    };
+
+    // Backward-integrated energy decay curve in dB (0 dB at the start).
+    inline std::vector<double> schroederDb(const std::vector<float>& h) {
+        std::vector<double> edc(h.size());
+        double acc = 0.0;
+        for (size_t i = h.size(); i-- > 0;) {
+            acc += double(h[i]) * double(h[i]);
+            edc[i] = acc;
+        }
+        const double e0 = (acc > 0.0) ? acc : 1.0;
+        for (auto& v : edc) v = (v > 0.0) ? 10.0 * std::log10(v / e0) : -300.0;
+        return edc;
+    }
+
+    // Least-squares slope (dB/s) of edc between hiDb and loDb (e.g. -5, -25).
+    // Returns 0 when the curve never reaches loDb.
+    inline double decaySlope(const std::vector<double>& edc, float sr, double hiDb, double loDb) {
+        size_t a = 0;
+        while (a < edc.size() && edc[a] > hiDb) ++a;
+        size_t b = a;
+        while (b < edc.size() && edc[b] > loDb) ++b;
+        if (b >= edc.size() || b <= a + 2) return 0.0;
+
+        double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+        const double n = double(b - a);
+        for (size_t i = a; i < b; ++i) {
+            const double t = double(i) / double(sr);
+            sx += t; sy += edc[i]; sxx += t * t; sxy += t * edc[i];
+        }
+        const double den = n * sxx - sx * sx;
+        return (den != 0.0) ? (n * sxy - sx * sy) / den : 0.0;
+    }
+
+    inline DecayMetrics decayMetrics(const std::vector<float>& h, float sr) {
+        DecayMetrics m;
+        const auto edc = schroederDb(h);
+
+        // Integration is truncated at the end of the render, so the last
+        // ~10% of the curve bends down; keep fits away from it.
+        std::vector<double> curve(edc.begin(), edc.begin() + long(edc.size() * 9 / 10));
+
+        double s = decaySlope(curve, sr, -5.0, -25.0);
+        if (s < 0.0) m.rt60 = -60.0 / s;
+        else {
+            s = decaySlope(curve, sr, -5.0, -15.0);
+            if (s < 0.0) { m.rt60 = -60.0 / s; m.fromT10 = true; }
+        }
+
+        const double se = decaySlope(curve, sr, 0.0, -10.0);
+        if (se < 0.0) m.edt = -60.0 / se;
+        return m;
+    }
+
+    // ============================================================================
+    // Echo density (Abel & Huang 2006)
+    // ============================================================================
+
+    inline double meanEchoDensity(const std::vector<float>& h, float sr,
+        double windowMs = 20.0, double spanMs = 300.0)
+    {
+        // Onset: first sample above -60 dB of the peak
+        float peak = 0.0f;
+        for (float v : h) peak = std::max(peak, std::abs(v));
+        if (peak <= 0.0f) return 0.0;
+
+        size_t onset = 0;
+        while (onset < h.size() && std::abs(h[onset]) < peak * 1.0e-3f) ++onset;
+
+        const size_t win = std::max<size_t>(8, size_t(windowMs * 0.001 * sr));
+        const size_t hop = win / 2;
+        const size_t end = std::min(h.size(), onset + size_t(spanMs * 0.001 * sr));
+        const double erfcNorm = 1.0 / 0.3173105078629141; // 1 / erfc(1/sqrt(2))
+
+        double sum = 0.0;
+        int count = 0;
+        for (size_t s = onset; s + win <= end; s += hop) {
+            double e = 0.0;
+            for (size_t i = s; i < s + win; ++i) e += double(h[i]) * double(h[i]);
+            const double sd = std::sqrt(e / double(win));
+            if (sd <= 0.0) continue;
+
+            size_t outside = 0;
+            for (size_t i = s; i < s + win; ++i) if (std::abs(double(h[i])) > sd) ++outside;
+
+            sum += erfcNorm * double(outside) / double(win);
+            count++;
+        }
+        return count ? sum / double(count) : 0.0;
+    }
+
+} // namespace bigpi::bench
@@ -0,0 +1,42 @@
+#pragma once
+/*
+  =============================================================================
+  ModuleFixtures.h — Big Pi stand-alone module setups for the benchmark tools
+  =============================================================================
+
+  Benchmarks that time a single module (outside ReverbEngine) need it set up
+  the way the engine would. Keep those setups here so bigpi_bench and
+  bigpi_microbench measure the same thing.
+*/
+
+#include "dsp/tail/Tank.h"
+
+namespace bigpi::bench {
+
+    /*
+      initReferenceTank()
+      -------------------
+      Hall-like tank: 16 prime-ish delays from ~32 ms to ~137 ms, spread
+      modulation multipliers, 4.5 ms mod depth. `lines` selects 8 (Eco) or
+      16 (HQ).
+    */
+    inline void initReferenceTank(bigpi::core::Tank& t, float sr, int lines) {
+        static const float baseMs[16] = {
+            31.7f, 37.9f, 41.3f, 43.1f, 53.3f, 59.9f, 61.1f, 71.7f,
+            79.3f, 89.1f, 97.9f, 103.3f, 109.7f, 117.1f, 125.9f, 137.3f
+        };
+
+        t.init(sr, int(sr * 2.5f), 0xC0FFEEu);
+        bigpi::core::Tank::Config c = t.getConfig();
+        c.lines = lines;
+        for (int i = 0; i < 16; ++i) {
+            c.delaySamp[i] = baseMs[i] * 0.001f * sr;
+            const float tt = float(i) / 15.0f;
+            c.modDepthMul[i] = 0.85f + 0.30f * tt;
+            c.modRateMul[i] = 0.80f + 0.40f * tt;
+        }
+        c.modDepthSamples = 4.5f * 0.001f * sr;
+        t.setConfig(c);
+    }
+
+} // namespace bigpi::bench
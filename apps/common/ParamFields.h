@@ -0,0 +1,168 @@
+#pragma once
+/*
+  =============================================================================
+  ParamFields.h — Big Pi ReverbEngine::Params by name (for the tools)
+  =============================================================================
+
+  One table of every float member of ReverbEngine::Params with its useful
+  range. Used by:
+    - bigpi_fuzz     : draws random values inside the ranges
+    - pedal_host CLI : --set name=value
+
+  FloatField::hi < 0 means "fraction of the sample rate" (e.g. -0.499 = just
+  below Nyquist), so ranges follow the sample rate (see fieldHi()).
+
+  setParamByName() also understands the non-float members: mode (by name),
+  inputDiffStages and tankLines.
+*/
+
+#include <cstdlib>
+#include <string>
+
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+namespace bigpi::bench {
+
+    struct FloatField {
+        const char* name;
+        float ReverbEngine::Params::* member;
+        float lo;
+        float hi;
+        bool logScale;
+    };
+
+    using P = ReverbEngine::Params;
+
+    inline const FloatField kFloatFields[] = {
+        { "mix",                    &P::mix,                    0.0f,  1.0f,    false },
+        { "predelayMs",             &P::predelayMs,             0.0f,  200.0f,  false },
+        { "decay",                  &P::decay,                  0.0f,  1.0f,    false },
+        { "dampingHz",              &P::dampingHz,              200.0f, -0.499f, true },
+        { "feedbackHpHz",           &P::feedbackHpHz,           10.0f, 1000.0f, true },
+        { "modDepthMs",             &P::modDepthMs,             0.0f,  41.6f,   false },
+        { "modRateHz",              &P::modRateHz,              0.01f, 20.0f,   true },
+        { "modJitterEnable",        &P::modJitterEnable,        0.0f,  1.0f,    false },
+        { "modJitterAmount",        &P::modJitterAmount,        0.0f,  2.0f,    false },
+        { "modJitterRateHz",        &P::modJitterRateHz,        0.01f, 20.0f,   true },
+        { "modJitterSmoothMs",      &P::modJitterSmoothMs,      1.0f,  1000.0f, true },
+        { "fbXoverLoHz",            &P::fbXoverLoHz,            50.0f, 1000.0f, true },
+        { "fbXoverHiHz",            &P::fbXoverHiHz,            1000.0f, -0.45f, true },
+        { "decayLowMul",            &P::decayLowMul,            0.5f,  1.5f,    false },
+        { "decayMidMul",            &P::decayMidMul,            0.5f,  1.5f,    false },
+        { "decayHighMul",           &P::decayHighMul,           0.5f,  1.5f,    false },
+        { "inputDiffG",             &P::inputDiffG,             0.30f, 0.85f,   false },
+        { "lateDiffEnable",         &P::lateDiffEnable,         0.0f,  1.0f,    false },
+        { "lateDiffAmount",         &P::lateDiffAmount,         0.0f,  1.0f,    false },
+        { "lateDiffMinG",           &P::lateDiffMinG,           0.25f, 0.85f,   false },
+        { "lateDiffMaxG",           &P::lateDiffMaxG,           0.25f, 0.85f,   false },
+        { "erLevel",                &P::erLevel,                0.0f,  1.0f,    false },
+        { "erSize",                 &P::erSize,                 0.0f,  1.0f,    false },
+        { "erDampHz",               &P::erDampHz,               200.0f, -0.499f, true },
+        { "erWidth",                &P::erWidth,                0.0f,  1.0f,    false },
+        { "stereoDepth",            &P::stereoDepth,            0.0f,  1.0f,    false },
+        { "cloudEnable",            &P::cloudEnable,            0.0f,  1.0f,    false },
+        { "cloudSpinHz",            &P::cloudSpinHz,            0.001f, 5.0f,   true },
+        { "cloudWanderAmount",      &P::cloudWanderAmount,      0.0f,  1.0f,    false },
+        { "cloudWanderRateHz",      &P::cloudWanderRateHz,      0.01f, 5.0f,    true },
+        { "cloudWanderSmoothMs",    &P::cloudWanderSmoothMs,    1.0f,  2000.0f, true },
+        { "cloudFrontEnable",       &P::cloudFrontEnable,       0.0f,  1.0f,    false },
+        { "cloudFrontAmount",       &P::cloudFrontAmount,       0.0f,  1.0f,    false },
+        { "cloudFrontSizeMs",       &P::cloudFrontSizeMs,       0.0f,  120.0f,  false },
+        { "cloudFrontWidth",        &P::cloudFrontWidth,        0.0f,  1.0f,    false },
+        { "cloudDelaySetEnable",    &P::cloudDelaySetEnable,    0.0f,  1.0f,    false },
+        { "cloudSmearEnable",       &P::cloudSmearEnable,       0.0f,  1.0f,    false },
+        { "cloudSmearAmount",       &P::cloudSmearAmount,       0.0f,  1.0f,    false },
+        { "cloudSmearTimeMs",       &P::cloudSmearTimeMs,       0.0f,  60.0f,   false },
+        { "cloudSmearWidth",        &P::cloudSmearWidth,        0.0f,  1.0f,    false },
+        { "dynDiffEnable",          &P::dynDiffEnable,          0.0f,  1.0f,    false },
+        { "dynDiffTailBoost",       &P::dynDiffTailBoost,       0.0f,  1.0f,    false },
+        { "dynDiffTransientReduce", &P::dynDiffTransientReduce, 0.0f,  1.0f,    false },
+        { "dynDiffLateBoost",       &P::dynDiffLateBoost,       0.0f,  1.0f,    false },
+        { "shimmerEnable",          &P::shimmerEnable,          0.0f,  1.0f,    false },
+        { "shimmerAmount",          &P::shimmerAmount,          0.0f,  1.0f,    false },
+        { "shimmerFifthMix",        &P::shimmerFifthMix,        0.0f,  1.0f,    false },
+        { "granularEnable",         &P::granularEnable,         0.0f,  1.0f,    false },
+        { "granularAmount",         &P::granularAmount,         0.0f,  1.0f,    false },
+        { "granularBehavior",       &P::granularBehavior,       0.0f,  2.0f,    false },
+        { "granularDensityHz",      &P::granularDensityHz,      0.1f,  80.0f,   true },
+        { "granularLengthMs",       &P::granularLengthMs,       10.0f, 500.0f,  true },
+        { "granularPitchRange",     &P::granularPitchRange,     0.0f,  12.0f,   false },
+        { "granularReverse",        &P::granularReverse,        0.0f,  1.0f,    false },
+        { "granularScan",           &P::granularScan,           0.0f,  1.0f,    false },
+        { "springEnable",           &P::springEnable,           0.0f,  1.0f,    false },
+        { "springMix",              &P::springMix,              0.0f,  1.0f,    false },
+        { "springLengthMs",         &P::springLengthMs,         15.0f, 80.0f,   false },
+        { "springDispersion",       &P::springDispersion,       0.0f,  1.0f,    false },
+        { "springDrip",             &P::springDrip,             0.0f,  1.0f,    false },
+        { "springDampHz",           &P::springDampHz,           1000.0f, 12000.0f, true },
+        { "springToneHz",           &P::springToneHz,           300.0f, 6000.0f, true },
+        { "springEmphasis",         &P::springEmphasis,         0.0f,  1.0f,    false },
+        { "tapeEnable",             &P::tapeEnable,             0.0f,  1.0f,    false },
+        { "tapeMix",                &P::tapeMix,                0.0f,  1.0f,    false },
+        { "tapeHeads",              &P::tapeHeads,              0.0f,  3.0f,    false },
+        { "tapeTimeMs",             &P::tapeTimeMs,             40.0f, 350.0f,  true },
+        { "tapeFeedback",           &P::tapeFeedback,           0.0f,  0.9f,    false },
+        { "tapeWow",                &P::tapeWow,                0.0f,  1.0f,    false },
+        { "tapeFlutter",            &P::tapeFlutter,            0.0f,  1.0f,    false },
+        { "tapeDrive",              &P::tapeDrive,              0.0f,  6.0f,    false },
+        { "tapeAge",                &P::tapeAge,                0.0f,  1.0f,    false },
+        { "singularityEnable",      &P::singularityEnable,      0.0f,  1.0f,    false },
+        { "singularityMix",         &P::singularityMix,         0.0f,  1.0f,    false },
+        { "singularitySizeSec",     &P::singularitySizeSec,     0.2f,  3.0f,    true },
+        { "singularityDecaySec",    &P::singularityDecaySec,    1.0f,  60.0f,   true },
+        { "singularityDampHz",      &P::singularityDampHz,      500.0f, 5000.0f, true },
+        { "singularityGravity",     &P::singularityGravity,     0.0f,  1.0f,    false },
+        { "outHpHz",                &P::outHpHz,                10.0f, 2000.0f, true },
+        { "outLowShelfHz",          &P::outLowShelfHz,          20.0f, 2000.0f, true },
+        { "outLowGainDb",           &P::outLowGainDb,           -24.0f, 24.0f,  false },
+        { "outHighShelfHz",         &P::outHighShelfHz,         1000.0f, -0.499f, true },
+        { "outHighGainDb",          &P::outHighGainDb,          -24.0f, 24.0f,  false },
+        { "outWidth",               &P::outWidth,               0.0f,  2.0f,    false },
+        { "outDrive",               &P::outDrive,               0.0f,  1.0f,    false },
+        { "outLevel",               &P::outLevel,               0.0f,  2.0f,    false },
+        { "freeze",                 &P::freeze,                 0.0f,  1.0f,    false },
+        { "duckEnable",             &P::duckEnable,             0.0f,  1.0f,    false },
+        { "duckThresholdDb",        &P::duckThresholdDb,        -80.0f, 0.0f,   false },
+        { "duckDepthDb",            &P::duckDepthDb,            0.0f,  36.0f,   false },
+        { "loudCompEnable",         &P::loudCompEnable,         0.0f,  1.0f,    false },
+        { "loudCompStrength",       &P::loudCompStrength,       0.0f,  1.0f,    false },
+        { "loudCompMaxDb",          &P::loudCompMaxDb,          0.0f,  24.0f,   false },
+    };
+
+    inline float fieldHi(const FloatField& f, float sr) {
+        return (f.hi < 0.0f) ? -f.hi * sr : f.hi;
+    }
+
+    inline const FloatField* findFloatField(const std::string& name) {
+        for (const auto& f : kFloatFields) {
+            if (name == f.name) return &f;
+        }
+        return nullptr;
+    }
+
+    /*
+      setParamByName(p, name, value)
+      ------------------------------
+      Sets one member from text. Returns false for unknown names or values
+      that do not parse. No range clamping: the engine clamps on its own,
+      and out-of-range values are sometimes exactly what a test wants.
+    */
+    inline bool setParamByName(ReverbEngine::Params& p, const std::string& name, const std::string& value) {
+        if (name == "mode") return bigpi::modeFromString(value.c_str(), p.mode);
+
+        char* end = nullptr;
+        const double v = std::strtod(value.c_str(), &end);
+        if (end == value.c_str() || *end != '\0') return false;
+
+        if (name == "inputDiffStages") { p.inputDiffStages = int(v); return true; }
+        if (name == "tankLines") { p.tankLines = int(v); return true; }
+
+        if (const FloatField* f = findFloatField(name)) {
+            p.*(f->member) = float(v);
+            return true;
+        }
+        return false;
+    }
+
+} // namespace bigpi::bench
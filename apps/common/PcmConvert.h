@@ -0,0 +1,341 @@
+#pragma once
+/*
+  =============================================================================
+  PcmConvert.h — Big Pi float <-> PCM sample conversion (SIMD, TPDF dither)
+  =============================================================================
+
+  Used by the streaming WAV reader/writer (WavIO.h) and the raw PCM tools.
+
+  Formats (little-endian, interleaved):
+    Int16, Int24 (packed 3 bytes), Int32, Float32
+
+  Scaling (same convention the old pedal_host writer used):
+    encode: x * (2^(bits-1) - 1), clamped, rounded to nearest (NaN -> 0)
+    decode: v / 2^(bits-1)
+
+  Dither:
+    TPDF (triangular) dither of +-1 LSB: the difference of two uniform
+    random numbers, added before rounding. Only meaningful for Int16/Int24
+    (for Int32 it is below float precision, for Float32 it is skipped).
+
+  SIMD:
+    The hot loops (scale + dither + clamp + round, and int -> float) run 4
+    samples at a time with SSE2 on x86-64 or NEON on ARM (the Pi), with a
+    scalar tail/fallback. The dither generator is 4 independent xorshift32
+    lanes so it vectorises too.
+
+  All functions work on caller-provided buffers: no allocation.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIGPI_PCM_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BIGPI_PCM_NEON 1
+#endif
+
+namespace bigpi::bench {
+
+    // ============================================================================
+    // Formats
+    // ============================================================================
+
+    enum class SampleFormat : int {
+        Int16 = 0,
+        Int24,
+        Int32,
+        Float32
+    };
+
+    inline int bytesPerSample(SampleFormat f) {
+        switch (f) {
+        case SampleFormat::Int16: return 2;
+        case SampleFormat::Int24: return 3;
+        default:                  return 4;
+        }
+    }
+
+    inline int bitsPerSample(SampleFormat f) { return 8 * bytesPerSample(f); }
+
+    inline bool isFloatFormat(SampleFormat f) { return f == SampleFormat::Float32; }
+
+    inline const char* sampleFormatName(SampleFormat f) {
+        switch (f) {
+        case SampleFormat::Int16:   return "16";
+        case SampleFormat::Int24:   return "24";
+        case SampleFormat::Int32:   return "32";
+        case SampleFormat::Float32: return "f32";
+        default:                    return "?";
+        }
+    }
+
+    // Accepts 16, 24, 32, f32 / float (also s16/s24/s32 as used by raw PCM tools).
+    inline bool sampleFormatFromString(const std::string& s, SampleFormat& out) {
+        if (s == "16" || s == "s16") { out = SampleFormat::Int16; return true; }
+        if (s == "24" || s == "s24") { out = SampleFormat::Int24; return true; }
+        if (s == "32" || s == "s32") { out = SampleFormat::Int32; return true; }
+        if (s == "f32" || s == "float") { out = SampleFormat::Float32; return true; }
+        return false;
+    }
+
+    // ============================================================================
+    // TPDF dither
+    // ============================================================================
+
+    struct TpdfDither {
+        bool enabled = false;
+        uint32_t lane[4] = { 0x9E3779B9u, 0x85EBCA6Bu, 0xC2B2AE35u, 0x27D4EB2Fu };
+
+        explicit TpdfDither(bool on = false, uint32_t seed = 0x5EEDu) : enabled(on) {
+            for (int i = 0; i < 4; ++i) {
+                lane[i] ^= seed * (2u * uint32_t(i) + 1u);
+                if (lane[i] == 0) lane[i] = 1u;
+            }
+        }
+
+        // Scalar step of lane 0 (used by the scalar tail).
+        float next() {
+            const float a = uni(step(lane[0]));
+            const float b = uni(step(lane[0]));
+            return a - b;   // triangular in (-1, 1) LSB
+        }
+
+        static uint32_t step(uint32_t& x) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            return x;
+        }
+
+        static float uni(uint32_t x) { return float(x >> 8) * (1.0f / 16777216.0f); }
+    };
+
+    namespace pcmdetail {
+
+        inline float encodeScale(SampleFormat f) {
+            switch (f) {
+            case SampleFormat::Int16: return 32767.0f;
+            case SampleFormat::Int24: return 8388607.0f;
+            default:                  return 2147483520.0f; // largest float below 2^31
+            }
+        }
+
+        inline float decodeScale(SampleFormat f) {
+            switch (f) {
+            case SampleFormat::Int16: return 1.0f / 32768.0f;
+            case SampleFormat::Int24: return 1.0f / 8388608.0f;
+            default:                  return float(1.0 / 2147483648.0);
+            }
+        }
+
+#if BIGPI_PCM_SSE2
+        inline __m128i xorshift4(__m128i& s) {
+            s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+            s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+            s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+            return s;
+        }
+
+        inline __m128 uni4(__m128i x) {
+            return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 8)), _mm_set1_ps(1.0f / 16777216.0f));
+        }
+#elif BIGPI_PCM_NEON
+        inline uint32x4_t xorshift4(uint32x4_t& s) {
+            s = veorq_u32(s, vshlq_n_u32(s, 13));
+            s = veorq_u32(s, vshrq_n_u32(s, 17));
+            s = veorq_u32(s, vshlq_n_u32(s, 5));
+            return s;
+        }
+
+        inline float32x4_t uni4(uint32x4_t x) {
+            return vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(x, 8)), 1.0f / 16777216.0f);
+        }
+#endif
+
+    } // namespace pcmdetail
+
+    // ============================================================================
+    // Float -> int (scaled, dithered, clamped, rounded)
+    // ============================================================================
+
+    /*
+      floatToInt(in, out, n, fmt, dither)
+      -----------------------------------
+      Converts n floats to integers at the scale of `fmt` (Int16/24/32).
+      The result is stored as int32 (packing to 2/3/4 bytes is separate).
+    */
+    inline void floatToInt(const float* in, int32_t* out, size_t n, SampleFormat fmt, TpdfDither* dither) {
+        const float scale = pcmdetail::encodeScale(fmt);
+        const float hi = scale;
+        const float lo = -scale - 1.0f;
+        const bool dith = dither && dither->enabled && fmt != SampleFormat::Int32;
+        size_t i = 0;
+
+#if BIGPI_PCM_SSE2
+        const __m128 vScale = _mm_set1_ps(scale);
+        const __m128 vHi = _mm_set1_ps(hi);
+        const __m128 vLo = _mm_set1_ps(lo);
+
+        if (dith) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->lane));
+            for (; i + 4 <= n; i += 4) {
+                const __m128 a = pcmdetail::uni4(pcmdetail::xorshift4(s));
+                const __m128 b = pcmdetail::uni4(pcmdetail::xorshift4(s));
+                __m128 x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), vScale), _mm_sub_ps(a, b));
+                x = _mm_and_ps(x, _mm_cmpord_ps(x, x));     // NaN -> 0
+                x = _mm_min_ps(_mm_max_ps(x, vLo), vHi);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(x));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->lane), s);
+        }
+        else {
+            for (; i + 4 <= n; i += 4) {
+                __m128 x = _mm_mul_ps(_mm_loadu_ps(in + i), vScale);
+                x = _mm_and_ps(x, _mm_cmpord_ps(x, x));     // NaN -> 0
+                x = _mm_min_ps(_mm_max_ps(x, vLo), vHi);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(x));
+            }
+        }
+#elif BIGPI_PCM_NEON
+        const float32x4_t vHi = vdupq_n_f32(hi);
+        const float32x4_t vLo = vdupq_n_f32(lo);
+
+        if (dith) {
+            uint32x4_t s = vld1q_u32(dither->lane);
+            for (; i + 4 <= n; i += 4) {
+                const float32x4_t a = pcmdetail::uni4(pcmdetail::xorshift4(s));
+                const float32x4_t b = pcmdetail::uni4(pcmdetail::xorshift4(s));
+                float32x4_t x = vaddq_f32(vmulq_n_f32(vld1q_f32(in + i), scale), vsubq_f32(a, b));
+                x = vminq_f32(vmaxq_f32(x, vLo), vHi);
+                vst1q_s32(out + i, vcvtnq_s32_f32(x));
+            }
+            vst1q_u32(dither->lane, s);
+        }
+        else {
+            for (; i + 4 <= n; i += 4) {
+                float32x4_t x = vmulq_n_f32(vld1q_f32(in + i), scale);
+                x = vminq_f32(vmaxq_f32(x, vLo), vHi);
+                vst1q_s32(out + i, vcvtnq_s32_f32(x));
+            }
+        }
+#endif
+
+        for (; i < n; ++i) {
+            float x = in[i] * scale;
+            if (dith) x += dither->next();
+            if (!(x == x)) x = 0.0f;            // NaN -> 0 (like the SIMD paths)
+            x = std::min(hi, std::max(lo, x));
+            out[i] = int32_t(std::lrint(x));
+        }
+    }
+
+    // int32 (already at the scale of fmt) -> float
+    inline void intToFloat(const int32_t* in, float* out, size_t n, SampleFormat fmt) {
+        const float scale = pcmdetail::decodeScale(fmt);
+        size_t i = 0;
+
+#if BIGPI_PCM_SSE2
+        const __m128 vScale = _mm_set1_ps(scale);
+        for (; i + 4 <= n; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), vScale));
+        }
+#elif BIGPI_PCM_NEON
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(in + i)), scale));
+        }
+#endif
+
+        for (; i < n; ++i) out[i] = float(in[i]) * scale;
+    }
+
+    // ============================================================================
+    // Packing (int32 <-> 2/3/4 little-endian bytes)
+    // ============================================================================
+
+    inline void packInts(const int32_t* in, unsigned char* out, size_t n, SampleFormat fmt) {
+        switch (fmt) {
+        case SampleFormat::Int16:
+            for (size_t i = 0; i < n; ++i) {
+                const uint32_t v = uint32_t(in[i]);
+                out[2 * i] = (unsigned char)(v & 0xFF);
+                out[2 * i + 1] = (unsigned char)((v >> 8) & 0xFF);
+            }
+            break;
+
+        case SampleFormat::Int24:
+            for (size_t i = 0; i < n; ++i) {
+                const uint32_t v = uint32_t(in[i]);
+                out[3 * i] = (unsigned char)(v & 0xFF);
+                out[3 * i + 1] = (unsigned char)((v >> 8) & 0xFF);
+                out[3 * i + 2] = (unsigned char)((v >> 16) & 0xFF);
+            }
+            break;
+
+        default:
+            std::memcpy(out, in, n * 4); // little-endian hosts only (x86, ARM)
+            break;
+        }
+    }
+
+    inline void unpackInts(const unsigned char* in, int32_t* out, size_t n, SampleFormat fmt) {
+        switch (fmt) {
+        case SampleFormat::Int16:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = int16_t(uint16_t(in[2 * i] | (in[2 * i + 1] << 8)));
+            }
+            break;
+
+        case SampleFormat::Int24:
+            for (size_t i = 0; i < n; ++i) {
+                const uint32_t v = (uint32_t(in[3 * i]) << 8) | (uint32_t(in[3 * i + 1]) << 16) | (uint32_t(in[3 * i + 2]) << 24);
+                out[i] = int32_t(v) >> 8;
+            }
+            break;
+
+        default:
+            std::memcpy(out, in, n * 4);
+            break;
+        }
+    }
+
+    // ============================================================================
+    // Whole conversions (interleaved bytes <-> float)
+    // ============================================================================
+
+    /*
+      encodeSamples(in, out, n, fmt, dither, scratch)
+      -----------------------------------------------
+      n interleaved floats -> n samples of `fmt` in `out`.
+      `scratch` must hold n int32 (unused for Float32).
+    */
+    inline void encodeSamples(const float* in, unsigned char* out, size_t n,
+        SampleFormat fmt, TpdfDither* dither, int32_t* scratch)
+    {
+        if (fmt == SampleFormat::Float32) {
+            std::memcpy(out, in, n * 4);
+            return;
+        }
+        floatToInt(in, scratch, n, fmt, dither);
+        packInts(scratch, out, n, fmt);
+    }
+
+    inline void decodeSamples(const unsigned char* in, float* out, size_t n,
+        SampleFormat fmt, int32_t* scratch)
+    {
+        if (fmt == SampleFormat::Float32) {
+            std::memcpy(out, in, n * 4);
+            return;
+        }
+        unpackInts(in, scratch, n, fmt);
+        intToFloat(scratch, out, n, fmt);
+    }
+
+} // namespace bigpi::bench
@@ -0,0 +1,227 @@
+#pragma once
+/*
+  =============================================================================
+  PerfCounters.h — Big Pi hardware performance counters (Linux perf_event_open)
+  =============================================================================
+
+  Answers questions timing alone cannot, e.g. "is the Tank bound by cache
+  misses on its 16 delay lines or by the math?":
+
+    cycles, instructions        -> IPC (instructions per cycle)
+    L1D read misses             -> delay-line reads leaving L1
+    LLC read misses             -> reads going all the way to DRAM
+    cache misses (generic)      -> kernel's best "cache miss" event
+    branch misses               -> unpredictable control flow
+
+  There is no portable L2 event in the perf ABI (only L1D / LLC / generic),
+  so L2 is not listed; "cache_misses" is usually the LLC on x86 and the L2
+  on many ARM cores.
+
+  Usage:
+    PerfCounters pc;
+    if (pc.open()) {
+        pc.start(); ... work ... pc.stop();
+        PerfReading r = pc.read();
+    }
+
+  Degrades gracefully:
+    - Non-Linux builds: open() returns false, reason() explains why.
+    - Containers / perf_event_paranoid / missing PMU: every event that fails
+      to open is simply marked unavailable. If none opens, open() is false.
+
+  Counters are opened per event (not as one group) so a PMU with few
+  counters still reports what it can; multiplexed values are scaled by
+  time_enabled / time_running.
+
+  Counts only the calling thread, user space only.
+*/
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace bigpi::bench {
+
+    enum class PerfEvent : int {
+        Cycles = 0,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        CacheMisses,
+        BranchMisses,
+
+        Count
+    };
+
+    inline constexpr int kNumPerfEvents = int(PerfEvent::Count);
+
+    inline const char* perfEventName(PerfEvent e) {
+        switch (e) {
+        case PerfEvent::Cycles:       return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::L1dMisses:    return "l1d_misses";
+        case PerfEvent::LlcMisses:    return "llc_misses";
+        case PerfEvent::CacheMisses:  return "cache_misses";
+        case PerfEvent::BranchMisses: return "branch_misses";
+        default:                      return "unknown";
+        }
+    }
+
+    // One reading: scaled counts, valid[] false for events that did not open
+    // (or never got scheduled on the PMU).
+    struct PerfReading {
+        std::array<double, kNumPerfEvents> value{};
+        std::array<bool, kNumPerfEvents> valid{};
+
+        bool has(PerfEvent e) const { return valid[size_t(e)]; }
+        double get(PerfEvent e) const { return value[size_t(e)]; }
+
+        double ipc() const {
+            if (!has(PerfEvent::Cycles) || !has(PerfEvent::Instructions)) return 0.0;
+            const double c = get(PerfEvent::Cycles);
+            return c > 0.0 ? get(PerfEvent::Instructions) / c : 0.0;
+        }
+    };
+
+    class PerfCounters {
+    public:
+        PerfCounters() { fds.fill(-1); }
+        ~PerfCounters() { close(); }
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // Opens every event it can. Returns true if at least one opened.
+        bool open() {
+            close();
+#if defined(__linux__)
+            int opened = 0;
+            int lastErr = 0;
+            for (int i = 0; i < kNumPerfEvents; ++i) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                describe(PerfEvent(i), attr);
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                const long fd = syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1, -1, 0);
+                if (fd >= 0) {
+                    fds[size_t(i)] = int(fd);
+                    opened++;
+                }
+                else {
+                    lastErr = errno;
+                }
+            }
+
+            if (opened == 0) {
+                why = std::string("perf_event_open failed: ") + std::strerror(lastErr)
+                    + " (container without PMU access or kernel.perf_event_paranoid too high?)";
+                return false;
+            }
+            why.clear();
+            return true;
+#else
+            why = "hardware counters need Linux perf_event_open";
+            return false;
+#endif
+        }
+
+        void close() {
+#if defined(__linux__)
+            for (auto& fd : fds) {
+                if (fd >= 0) ::close(fd);
+                fd = -1;
+            }
+#endif
+        }
+
+        bool isOpen() const {
+            for (int fd : fds) if (fd >= 0) return true;
+            return false;
+        }
+
+        // Why open() failed (empty when it succeeded).
+        const std::string& reason() const { return why; }
+
+        // Resets and enables every open counter.
+        void start() {
+#if defined(__linux__)
+            for (int fd : fds) {
+                if (fd < 0) continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        void stop() {
+#if defined(__linux__)
+            for (int fd : fds) {
+                if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+#endif
+        }
+
+        // Counts since the last start(), scaled for multiplexing.
+        PerfReading read() const {
+            PerfReading r;
+#if defined(__linux__)
+            for (int i = 0; i < kNumPerfEvents; ++i) {
+                const int fd = fds[size_t(i)];
+                if (fd < 0) continue;
+
+                uint64_t buf[3] = { 0, 0, 0 }; // value, time_enabled, time_running
+                if (::read(fd, buf, sizeof(buf)) != ssize_t(sizeof(buf))) continue;
+                if (buf[2] == 0) continue;     // never scheduled on the PMU
+
+                r.value[size_t(i)] = double(buf[0]) * double(buf[1]) / double(buf[2]);
+                r.valid[size_t(i)] = true;
+            }
+#endif
+            return r;
+        }
+
+    private:
+        std::array<int, kNumPerfEvents> fds{};
+        std::string why;
+
+#if defined(__linux__)
+        static void describe(PerfEvent e, perf_event_attr& attr) {
+            auto cache = [](uint64_t id) {
+                return id | (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8)
+                    | (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+            };
+
+            switch (e) {
+            case PerfEvent::Cycles:
+                attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+            case PerfEvent::Instructions:
+                attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case PerfEvent::L1dMisses:
+                attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_L1D); break;
+            case PerfEvent::LlcMisses:
+                attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_LL); break;
+            case PerfEvent::CacheMisses:
+                attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+            case PerfEvent::BranchMisses:
+            default:
+                attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            }
+        }
+#endif
+    };
+
+} // namespace bigpi::bench
@@ -0,0 +1,97 @@
+#pragma once
+/*
+  =============================================================================
+  SpscRing.h — Big Pi single-producer / single-consumer lock-free ring
+  =============================================================================
+
+  A fixed-capacity FIFO for passing small values (usually pointers to
+  preallocated blocks) from exactly one producer thread to exactly one
+  consumer thread.
+
+    - No locks, no allocation after construction.
+    - tryPush() / tryPop() never block: they return false when the ring is
+      full / empty. What to do then (spin, yield, sleep) is the caller's
+      choice, which is what lets an audio-style thread decide never to wait
+      on the OS while an I/O thread happily sleeps.
+    - head and tail live on separate cache lines so the two threads do not
+      false-share; each side also caches the other side's index and only
+      re-reads the shared atomic when the cached value says full / empty.
+
+  Memory ordering:
+    The producer writes the slot, then publishes head with release. The
+    consumer reads head with acquire, reads the slot, then publishes tail
+    with release so the producer may reuse the slot. That is the whole
+    contract: a value pushed is fully visible to the thread that pops it.
+
+  Capacity is rounded up to a power of two (index wrap is a mask).
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bigpi::bench {
+
+    template <typename T>
+    class SpscRing {
+    public:
+        explicit SpscRing(size_t minCapacity) {
+            size_t cap = 2;
+            while (cap < minCapacity) cap <<= 1;
+            slots.resize(cap);
+            mask = cap - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        size_t capacity() const { return mask + 1; }
+
+        // Producer thread only.
+        bool tryPush(const T& v) {
+            const uint64_t h = head.value.load(std::memory_order_relaxed);
+            if (h - tailCache >= capacity()) {
+                tailCache = tail.value.load(std::memory_order_acquire);
+                if (h - tailCache >= capacity()) return false;   // full
+            }
+            slots[size_t(h) & mask] = v;
+            head.value.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer thread only.
+        bool tryPop(T& out) {
+            const uint64_t t = tail.value.load(std::memory_order_relaxed);
+            if (t == headCache) {
+                headCache = head.value.load(std::memory_order_acquire);
+                if (t == headCache) return false;                 // empty
+            }
+            out = slots[size_t(t) & mask];
+            tail.value.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Any thread; only a hint while the other side is running.
+        size_t sizeApprox() const {
+            const uint64_t h = head.value.load(std::memory_order_acquire);
+            const uint64_t t = tail.value.load(std::memory_order_acquire);
+            return size_t(h - t);
+        }
+
+    private:
+        struct alignas(64) Index {
+            std::atomic<uint64_t> value{ 0 };
+        };
+
+        Index head;                 // written by the producer
+        Index tail;                 // written by the consumer
+
+        alignas(64) uint64_t tailCache = 0;     // producer's view of tail
+        alignas(64) uint64_t headCache = 0;     // consumer's view of head
+
+        std::vector<T> slots;
+        size_t mask = 0;
+    };
+
+} // namespace bigpi::bench
@@ -0,0 +1,160 @@
+#pragma once
+/*
+  =============================================================================
+  TestSignals.h — Big Pi harness input generators (deterministic)
+  =============================================================================
+
+  Realistic-ish program material for benchmarks and regression renders.
+
+  Why not just an impulse:
+    An impulse exercises the tank only once and then measures a decaying tail.
+    Real guitar input keeps re-exciting the network, keeps envelope followers
+    moving (dynamic diffusion, dynamic damping, ducking) and keeps denormals
+    away. For CPU numbers that match the pedal we want that kind of material.
+
+  Generators (all deterministic for a given seed):
+    - generateNoiseBursts: enveloped white-noise bursts with gaps
+    - generatePlucks:      Karplus-Strong style plucked strings
+    - generateMixed:       plucks with occasional noise bursts on top
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::bench {
+
+    // Tiny deterministic RNG (same xorshift style the engine uses for seeds).
+    struct XorShift32 {
+        uint32_t x = 0x12345678u;
+
+        explicit XorShift32(uint32_t seed = 0x12345678u) : x(seed ? seed : 1u) {}
+
+        uint32_t next() {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            return x;
+        }
+
+        // [0, 1)
+        float uni() { return float(next() >> 8) * (1.0f / 16777216.0f); }
+
+        // [-1, 1)
+        float bi() { return 2.0f * uni() - 1.0f; }
+    };
+
+    // ============================================================================
+    // Noise bursts
+    // ============================================================================
+
+    inline void generateNoiseBursts(std::vector<float>& L, std::vector<float>& R,
+        float sampleRate, uint32_t seed,
+        float burstSec = 0.12f, float periodSec = 0.9f, float amp = 0.5f)
+    {
+        XorShift32 rng(seed);
+
+        const size_t n = std::min(L.size(), R.size());
+        const int burst = std::max(1, int(burstSec * sampleRate));
+        const int period = std::max(burst + 1, int(periodSec * sampleRate));
+        const int fade = std::max(1, std::min(256, burst / 4));
+
+        for (size_t i = 0; i < n; ++i) {
+            const int ph = int(i % size_t(period));
+            float env = 0.0f;
+            if (ph < burst) {
+                env = 1.0f;
+                if (ph < fade) env = float(ph) / float(fade);
+                if (ph > burst - fade) env = float(burst - ph) / float(fade);
+            }
+            L[i] = amp * env * rng.bi();
+            R[i] = amp * env * rng.bi();
+        }
+    }
+
+    // ============================================================================
+    // Plucked strings (Karplus-Strong)
+    // ============================================================================
+
+    inline void generatePlucks(std::vector<float>& L, std::vector<float>& R,
+        float sampleRate, uint32_t seed,
+        float notesPerSec = 3.0f, float amp = 0.6f)
+    {
+        // Standard-tuning open strings + a few fretted notes (Hz).
+        static constexpr float kNotes[] = {
+            82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f,
+            220.0f, 293.66f, 392.0f, 440.0f, 523.25f, 659.26f
+        };
+        static constexpr int kNumNotes = int(sizeof(kNotes) / sizeof(kNotes[0]));
+
+        XorShift32 rng(seed);
+
+        const size_t n = std::min(L.size(), R.size());
+        std::fill(L.begin(), L.begin() + n, 0.0f);
+        std::fill(R.begin(), R.begin() + n, 0.0f);
+
+        const int maxPeriod = int(sampleRate / 60.0f) + 2;
+        std::vector<float> ks(size_t(maxPeriod), 0.0f);
+
+        const int noteLen = std::max(1, int(sampleRate / std::max(0.1f, notesPerSec)));
+
+        for (size_t start = 0; start < n; start += size_t(noteLen)) {
+            const float hz = kNotes[rng.next() % kNumNotes];
+            const int period = std::max(2, std::min(maxPeriod, int(sampleRate / hz)));
+            const float vel = amp * (0.55f + 0.45f * rng.uni());
+            const float pan = 0.5f + 0.3f * rng.bi();
+
+            // Excite with noise (pick attack)
+            for (int k = 0; k < period; ++k) ks[size_t(k)] = rng.bi();
+
+            const size_t end = std::min(n, start + size_t(noteLen));
+            int idx = 0;
+            float prev = 0.0f;
+
+            for (size_t i = start; i < end; ++i) {
+                const float cur = ks[size_t(idx)];
+                const float y = 0.5f * (cur + prev) * 0.996f;
+                prev = cur;
+                ks[size_t(idx)] = y;
+                if (++idx >= period) idx = 0;
+
+                L[i] += vel * (1.0f - pan) * 2.0f * cur;
+                R[i] += vel * pan * 2.0f * cur;
+            }
+        }
+    }
+
+    // ============================================================================
+    // Mixed program material
+    // ============================================================================
+
+    inline void generateMixed(std::vector<float>& L, std::vector<float>& R,
+        float sampleRate, uint32_t seed)
+    {
+        generatePlucks(L, R, sampleRate, seed);
+
+        std::vector<float> nL(L.size()), nR(R.size());
+        generateNoiseBursts(nL, nR, sampleRate, seed ^ 0xA5A5A5A5u, 0.05f, 2.3f, 0.25f);
+
+        for (size_t i = 0; i < L.size(); ++i) {
+            L[i] = dsp::clampf(L[i] + nL[i], -1.0f, 1.0f);
+            R[i] = dsp::clampf(R[i] + nR[i], -1.0f, 1.0f);
+        }
+    }
+
+    // Dispatch by name: "burst", "pluck", "mixed". Returns false if unknown.
+    inline bool generateSignal(const std::string& name,
+        std::vector<float>& L, std::vector<float>& R,
+        float sampleRate, uint32_t seed)
+    {
+        if (name == "burst") { generateNoiseBursts(L, R, sampleRate, seed); return true; }
+        if (name == "pluck") { generatePlucks(L, R, sampleRate, seed); return true; }
+        if (name == "mixed") { generateMixed(L, R, sampleRate, seed); return true; }
+        return false;
+    }
+
+} // namespace bigpi::bench
@@ -0,0 +1,413 @@
+#pragma once
+/*
+  =============================================================================
+  WavIO.h — Big Pi WAV / RF64 file I/O for the tools (streaming + whole-file)
+  =============================================================================
+
+  WavWriter (streaming):
+    open() writes a header with placeholder sizes, write() converts and
+    appends fixed-size chunks, close() patches the sizes. Memory use is
+    constant (one chunk of scratch), so hour-long renders are fine.
+    Formats: 16/24/32-bit PCM or 32-bit float (see PcmConvert.h), optional
+    TPDF dither for 16/24-bit.
+
+    RF64: the header reserves a 28-byte "JUNK" chunk right after "WAVE".
+    If the file ends up larger than 4 GiB, close() turns "RIFF" into "RF64"
+    and the JUNK chunk into the "ds64" chunk holding the 64-bit sizes
+    (EBU Tech 3306). Below 4 GiB the file stays a plain WAV and every
+    reader simply skips the JUNK chunk.
+
+  WavReader (streaming):
+    Reads RIFF and RF64 files with 16/24/32-bit PCM or 32-bit float, plain
+    or WAVE_FORMAT_EXTENSIBLE, any channel count (channel 0 -> L, channel 1
+    -> R, mono is copied to both). Unknown chunks are skipped. A data size
+    of 0 or 0xFFFFFFFF without ds64 (unfinished streaming writers) means
+    "until the end of the file".
+
+  writeWavFloat32() / readWav():
+    Whole-file helpers on top of the streaming classes.
+
+  None of this is for the audio thread (file I/O + buffers sized in open()).
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/PcmConvert.h"
+
+namespace bigpi::bench {
+
+    namespace wavdetail {
+
+        inline void putU32(unsigned char* p, uint32_t v) {
+            p[0] = (unsigned char)(v & 0xFF);
+            p[1] = (unsigned char)((v >> 8) & 0xFF);
+            p[2] = (unsigned char)((v >> 16) & 0xFF);
+            p[3] = (unsigned char)((v >> 24) & 0xFF);
+        }
+
+        inline void putU16(unsigned char* p, uint16_t v) {
+            p[0] = (unsigned char)(v & 0xFF);
+            p[1] = (unsigned char)((v >> 8) & 0xFF);
+        }
+
+        inline void putU64(unsigned char* p, uint64_t v) {
+            putU32(p, uint32_t(v & 0xFFFFFFFFu));
+            putU32(p + 4, uint32_t(v >> 32));
+        }
+
+        inline uint32_t getU32(const unsigned char* p) {
+            return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+        }
+
+        inline uint16_t getU16(const unsigned char* p) {
+            return uint16_t(p[0] | (p[1] << 8));
+        }
+
+        inline uint64_t getU64(const unsigned char* p) {
+            return uint64_t(getU32(p)) | (uint64_t(getU32(p + 4)) << 32);
+        }
+
+        // Frames converted per chunk (both directions).
+        inline constexpr size_t kChunkFrames = 4096;
+
+    } // namespace wavdetail
+
+    // ============================================================================
+    // Writer
+    // ============================================================================
+
+    class WavWriter {
+    public:
+        WavWriter() = default;
+        ~WavWriter() { close(); }
+
+        WavWriter(const WavWriter&) = delete;
+        WavWriter& operator=(const WavWriter&) = delete;
+
+        bool open(const std::string& path, int sampleRate, SampleFormat format,
+            bool dither = false, int numChannels = 2)
+        {
+            close();
+            if (numChannels < 1 || numChannels > 2 || sampleRate <= 0) return false;
+
+            f.open(path, std::ios::binary | std::ios::trunc);
+            if (!f) return false;
+
+            fmt = format;
+            channels = numChannels;
+            sr = sampleRate;
+            frames = 0;
+            dith = TpdfDither(dither);
+
+            const size_t n = wavdetail::kChunkFrames * size_t(channels);
+            inter.assign(n, 0.0f);
+            scratch.assign(n, 0);
+            bytes.assign(n * size_t(bytesPerSample(fmt)), 0);
+
+            writeHeader(0, false);
+            return bool(f);
+        }
+
+        bool isOpen() const { return f.is_open(); }
+        uint64_t framesWritten() const { return frames; }
+
+        // Planar stereo (or mono from L when opened with 1 channel).
+        bool write(const float* L, const float* R, size_t numFrames) {
+            if (!f.is_open()) return false;
+
+            size_t done = 0;
+            while (done < numFrames) {
+                const size_t n = std::min(wavdetail::kChunkFrames, numFrames - done);
+                if (channels == 2) {
+                    for (size_t i = 0; i < n; ++i) {
+                        inter[2 * i] = L[done + i];
+                        inter[2 * i + 1] = R[done + i];
+                    }
+                }
+                else {
+                    std::memcpy(inter.data(), L + done, n * sizeof(float));
+                }
+                if (!writeConverted(inter.data(), n)) return false;
+                done += n;
+            }
+            return true;
+        }
+
+        // Already interleaved (numFrames * channels floats).
+        bool writeInterleaved(const float* x, size_t numFrames) {
+            if (!f.is_open()) return false;
+
+            size_t done = 0;
+            while (done < numFrames) {
+                const size_t n = std::min(wavdetail::kChunkFrames, numFrames - done);
+                if (!writeConverted(x + done * size_t(channels), n)) return false;
+                done += n;
+            }
+            return true;
+        }
+
+        // Patches the sizes (RF64 when needed). Safe to call twice.
+        bool close() {
+            if (!f.is_open()) return true;
+
+            const uint64_t dataBytes = frames * uint64_t(blockAlign());
+            if (dataBytes & 1u) f.put('\0'); // chunks are word-aligned
+
+            const uint64_t riffBytes = (kHeaderBytes - 8) + dataBytes + (dataBytes & 1u);
+            const bool rf64 = riffBytes > 0xFFFFFFFFull;
+
+            f.seekp(0);
+            writeHeader(dataBytes, rf64);
+
+            const bool ok = bool(f);
+            f.close();
+            return ok;
+        }
+
+    private:
+        // RIFF(12) + JUNK/ds64(8+28) + fmt(8+16) + data(8)
+        static constexpr uint64_t kHeaderBytes = 12 + 36 + 24 + 8;
+
+        std::ofstream f;
+        SampleFormat fmt = SampleFormat::Int16;
+        int channels = 2;
+        int sr = 48000;
+        uint64_t frames = 0;
+        TpdfDither dith{};
+
+        std::vector<float> inter;
+        std::vector<int32_t> scratch;
+        std::vector<unsigned char> bytes;
+
+        uint16_t blockAlign() const { return uint16_t(channels * bytesPerSample(fmt)); }
+
+        bool writeConverted(const float* x, size_t n) {
+            const size_t samples = n * size_t(channels);
+            encodeSamples(x, bytes.data(), samples, fmt, &dith, scratch.data());
+            f.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(samples * size_t(bytesPerSample(fmt))));
+            frames += n;
+            return bool(f);
+        }
+
+        void writeHeader(uint64_t dataBytes, bool rf64) {
+            using namespace wavdetail;
+            unsigned char h[kHeaderBytes] = {};
+            unsigned char* p = h;
+
+            const uint64_t riffBytes = (kHeaderBytes - 8) + dataBytes + (dataBytes & 1u);
+
+            std::memcpy(p, rf64 ? "RF64" : "RIFF", 4);
+            putU32(p + 4, rf64 ? 0xFFFFFFFFu : uint32_t(riffBytes));
+            std::memcpy(p + 8, "WAVE", 4);
+            p += 12;
+
+            std::memcpy(p, rf64 ? "ds64" : "JUNK", 4);
+            putU32(p + 4, 28);
+            if (rf64) {
+                putU64(p + 8, riffBytes);
+                putU64(p + 16, dataBytes);
+                putU64(p + 24, frames);
+                putU32(p + 32, 0); // no table entries
+            }
+            p += 36;
+
+            std::memcpy(p, "fmt ", 4);
+            putU32(p + 4, 16);
+            putU16(p + 8, isFloatFormat(fmt) ? 3 : 1);
+            putU16(p + 10, uint16_t(channels));
+            putU32(p + 12, uint32_t(sr));
+            putU32(p + 16, uint32_t(sr) * blockAlign());
+            putU16(p + 20, blockAlign());
+            putU16(p + 22, uint16_t(bitsPerSample(fmt)));
+            p += 24;
+
+            std::memcpy(p, "data", 4);
+            putU32(p + 4, rf64 ? 0xFFFFFFFFu : uint32_t(dataBytes));
+
+            f.write(reinterpret_cast<const char*>(h), std::streamsize(kHeaderBytes));
+        }
+    };
+
+    // ============================================================================
+    // Reader
+    // ============================================================================
+
+    class WavReader {
+    public:
+        bool open(const std::string& path) {
+            using namespace wavdetail;
+
+            f.close();
+            f.clear();
+            err.clear();
+            framesLeft = 0;
+            total = 0;
+
+            f.open(path, std::ios::binary);
+            if (!f) return fail("cannot open " + path);
+
+            f.seekg(0, std::ios::end);
+            const uint64_t fileBytes = uint64_t(f.tellg());
+            f.seekg(0);
+
+            unsigned char hdr[12];
+            if (!f.read(reinterpret_cast<char*>(hdr), 12)) return fail("file too short");
+            const bool rf64 = std::memcmp(hdr, "RF64", 4) == 0;
+            if ((!rf64 && std::memcmp(hdr, "RIFF", 4) != 0) || std::memcmp(hdr + 8, "WAVE", 4) != 0) {
+                return fail("not a RIFF/RF64 WAVE file");
+            }
+
+            uint64_t ds64Data = 0;
+            bool haveFmt = false;
+
+            for (;;) {
+                unsigned char ch[8];
+                if (!f.read(reinterpret_cast<char*>(ch), 8)) return fail("no data chunk");
+                const uint32_t size = getU32(ch + 4);
+
+                if (std::memcmp(ch, "ds64", 4) == 0) {
+                    std::vector<unsigned char> d(size);
+                    if (size < 24 || !f.read(reinterpret_cast<char*>(d.data()), std::streamsize(size))) return fail("bad ds64 chunk");
+                    ds64Data = getU64(&d[8]);
+                    if (size & 1u) f.seekg(1, std::ios::cur);
+                }
+                else if (std::memcmp(ch, "fmt ", 4) == 0) {
+                    std::vector<unsigned char> d(size);
+                    if (size < 16 || !f.read(reinterpret_cast<char*>(d.data()), std::streamsize(size))) return fail("bad fmt chunk");
+                    if (size & 1u) f.seekg(1, std::ios::cur);
+
+                    uint16_t tag = getU16(&d[0]);
+                    chans = getU16(&d[2]);
+                    rate = int(getU32(&d[4]));
+                    const uint16_t bits = getU16(&d[14]);
+                    if (tag == 0xFFFE && size >= 26) tag = getU16(&d[24]); // WAVE_FORMAT_EXTENSIBLE
+
+                    if (tag == 3 && bits == 32) fmt = SampleFormat::Float32;
+                    else if (tag == 1 && bits == 16) fmt = SampleFormat::Int16;
+                    else if (tag == 1 && bits == 24) fmt = SampleFormat::Int24;
+                    else if (tag == 1 && bits == 32) fmt = SampleFormat::Int32;
+                    else return fail("unsupported sample format (need 16/24/32-bit PCM or 32-bit float)");
+
+                    if (chans < 1) return fail("no channels");
+                    haveFmt = true;
+                }
+                else if (std::memcmp(ch, "data", 4) == 0) {
+                    if (!haveFmt) return fail("data before fmt");
+
+                    const uint64_t here = uint64_t(f.tellg());
+                    const uint64_t avail = (fileBytes > here) ? fileBytes - here : 0;
+
+                    uint64_t dataBytes = size;
+                    if (rf64 && size == 0xFFFFFFFFu) dataBytes = ds64Data;
+                    else if (size == 0 || size == 0xFFFFFFFFu) dataBytes = avail; // unfinished stream
+                    dataBytes = std::min(dataBytes, avail);
+
+                    const size_t frameBytes = size_t(chans) * size_t(bytesPerSample(fmt));
+                    total = dataBytes / frameBytes;
+                    framesLeft = total;
+
+                    const size_t n = kChunkFrames * size_t(chans);
+                    inter.assign(n, 0.0f);
+                    scratch.assign(n, 0);
+                    bytes.assign(n * size_t(bytesPerSample(fmt)), 0);
+                    return true;
+                }
+                else {
+                    f.seekg(std::streamoff(uint64_t(size) + (size & 1u)), std::ios::cur);
+                    if (!f) return fail("truncated chunk");
+                }
+            }
+        }
+
+        int sampleRate() const { return rate; }
+        int channels() const { return chans; }
+        SampleFormat format() const { return fmt; }
+        uint64_t frames() const { return total; }
+        const std::string& error() const { return err; }
+
+        /*
+          read(L, R, maxFrames)
+          ---------------------
+          Reads up to maxFrames frames into planar L/R. Returns the number of
+          frames read (0 at the end of the data or on error).
+        */
+        size_t read(float* L, float* R, size_t maxFrames) {
+            size_t done = 0;
+            while (done < maxFrames && framesLeft > 0) {
+                const size_t n = size_t(std::min<uint64_t>(std::min(wavdetail::kChunkFrames, maxFrames - done), framesLeft));
+                const size_t samples = n * size_t(chans);
+
+                if (!f.read(reinterpret_cast<char*>(bytes.data()), std::streamsize(samples * size_t(bytesPerSample(fmt))))) {
+                    framesLeft = 0;
+                    break;
+                }
+                decodeSamples(bytes.data(), inter.data(), samples, fmt, scratch.data());
+
+                const size_t c = size_t(chans);
+                const size_t rIdx = (chans > 1) ? 1 : 0;
+                for (size_t i = 0; i < n; ++i) {
+                    L[done + i] = inter[i * c];
+                    R[done + i] = inter[i * c + rIdx];
+                }
+
+                done += n;
+                framesLeft -= n;
+            }
+            return done;
+        }
+
+    private:
+        std::ifstream f;
+        std::string err;
+
+        SampleFormat fmt = SampleFormat::Int16;
+        int chans = 0;
+        int rate = 0;
+        uint64_t total = 0;
+        uint64_t framesLeft = 0;
+
+        std::vector<float> inter;
+        std::vector<int32_t> scratch;
+        std::vector<unsigned char> bytes;
+
+        bool fail(const std::string& why) {
+            err = why;
+            f.close();
+            return false;
+        }
+    };
+
+    // ============================================================================
+    // Whole-file helpers
+    // ============================================================================
+
+    // Stereo 32-bit float: lossless for engine output (what golden renders need).
+    inline bool writeWavFloat32(const std::string& path,
+        const std::vector<float>& L, const std::vector<float>& R, int sampleRate)
+    {
+        if (L.size() != R.size()) return false;
+
+        WavWriter w;
+        if (!w.open(path, sampleRate, SampleFormat::Float32)) return false;
+        if (!w.write(L.data(), R.data(), L.size())) return false;
+        return w.close();
+    }
+
+    inline bool readWav(const std::string& path,
+        std::vector<float>& L, std::vector<float>& R, int& sampleRate)
+    {
+        WavReader r;
+        if (!r.open(path)) return false;
+
+        sampleRate = r.sampleRate();
+        L.resize(size_t(r.frames()));
+        R.resize(size_t(r.frames()));
+        return r.read(L.data(), R.data(), L.size()) == L.size();
+    }
+
+} // namespace bigpi::bench
@@ -0,0 +1,562 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/Version.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/ParamFields.h"
+#include "common/TestSignals.h"
+
+/*
+  =============================================================================
+  apps/fuzz/main.cpp — bigpi_fuzz (performance-cliff fuzzer over Params)
+  =============================================================================
+
+  Why:
+    Some Params combinations may cost far more CPU than the mode normally
+    does: denormal-heavy decays, dampingHz near Nyquist, huge modDepthMs
+    pushing reads across cache lines, ... This tool searches for them.
+
+  How it works:
+    - Every iteration gets its own 32-bit seed (derived from --seed).
+    - The seed alone decides the mode, the quality (Eco/HQ) and the Params:
+      each field keeps the mode default or is re-drawn from its full range,
+      biased towards the range edges where cliffs usually live.
+    - The config is timed on program material and compared against the
+      SAME mode/quality with its default Params. The ratio
+        cost = ns/sample(config) / ns/sample(mode defaults)
+      is what gets ranked: a cliff, not just an expensive mode.
+
+  Output:
+    - the top-K configs by cost ratio, each with its seed and the fields
+      that differ from the mode defaults
+    - --save-regress FILE stores the top-K as regression cases
+      (JSON, one object per line; existing cases are kept). A case keeps
+      its mode, quality and the drawn Params as name=value pairs, so it
+      replays the same config after ParamFields.h changes (a seed alone
+      maps to different Params once fields are added or reordered).
+
+  Reproduce / guard:
+    --replay SEED       re-run one config and print all of its Params
+    --regress FILE      re-time every stored case; a case that got slower
+                        than its recorded ns/sample by more than --tolerance
+                        is flagged and the exit code is 2. A case that no
+                        longer replays (unknown field or mode) is flagged
+                        STALE and also fails the run.
+
+  Usage:
+    bigpi_fuzz [--iterations 200] [--seed N] [--top 10] [--sr 48000]
+               [--block 64] [--seconds 0.5] [--save-regress cases.json]
+    bigpi_fuzz --replay 0x1234abcd [--sr 48000] [--block 64]
+    bigpi_fuzz --regress cases.json [--tolerance 0.15]
+
+  Tip:
+    Build with -DCMAKE_BUILD_TYPE=Release. Debug numbers are meaningless.
+*/
+
+using namespace bigpi::bench;
+
+using Params = ReverbEngine::Params;
+
+// ============================================================================
+// Params space (ranges: common/ParamFields.h)
+// ============================================================================
+
+// Edge-biased draw: 20% low edge, 20% high edge, 60% inside the range.
+static float drawValue(const FloatField& f, float sr, XorShift32& rng) {
+    const float lo = f.lo;
+    const float hi = fieldHi(f, sr);
+    const float u = rng.uni();
+
+    if (u < 0.2f) return lo;
+    if (u < 0.4f) return hi;
+
+    const float t = rng.uni();
+    if (f.logScale && lo > 0.0f) return lo * std::pow(hi / lo, t);
+    return lo + (hi - lo) * t;
+}
+
+/*
+  FuzzConfig
+  ----------
+  Everything needed to rebuild one fuzz case from its seed.
+*/
+struct FuzzConfig {
+    uint32_t seed = 0;
+    bigpi::Mode mode = bigpi::Mode::Hall;
+    std::string quality = "hq";
+    Params params{};     // full Params after randomisation
+    Params defaults{};   // the mode's own defaults (for diffs)
+};
+
+static FuzzConfig configFromSeed(uint32_t seed, float sr, int block) {
+    FuzzConfig c;
+    c.seed = seed;
+
+    XorShift32 rng(seed ? seed : 1u);
+    c.mode = bigpi::Mode(int(rng.next() % uint32_t(bigpi::Mode::Count)));
+    c.quality = (rng.next() & 1u) ? "hq" : "eco";
+
+    // Mode defaults come from the engine itself (preset applied)
+    ReverbEngine tmp;
+    c.defaults = prepareMode(tmp, sr, block, c.mode, c.quality);
+    c.params = c.defaults;
+
+    // Each field: keep the default (50%) or redraw it
+    for (const auto& f : kFloatFields) {
+        if (rng.next() & 1u) c.params.*(f.member) = drawValue(f, sr, rng);
+    }
+    if (rng.next() & 1u) c.params.inputDiffStages = int(rng.next() % 9u); // 0..8
+
+    return c;
+}
+
+/*
+  paramsToText(p) / configFromText(...)
+  -------------------------------------
+  The drawn Params as "name=value name=value ..." (every float field plus
+  inputDiffStages and tankLines, floats with enough digits to round-trip).
+  configFromText() starts from the mode defaults and applies the pairs;
+  fields the text does not mention keep their defaults. false + the
+  offending pair when a name is unknown to this build.
+*/
+static std::string paramsToText(const Params& p) {
+    std::string out;
+    char buf[96];
+    for (const auto& f : kFloatFields) {
+        std::snprintf(buf, sizeof(buf), "%s=%.9g ", f.name, double(p.*(f.member)));
+        out += buf;
+    }
+    std::snprintf(buf, sizeof(buf), "inputDiffStages=%d tankLines=%d", p.inputDiffStages, p.tankLines);
+    out += buf;
+    return out;
+}
+
+static bool configFromText(const std::string& text, bigpi::Mode mode, const std::string& quality,
+    float sr, int block, FuzzConfig& c, std::string& bad)
+{
+    c.mode = mode;
+    c.quality = quality;
+
+    ReverbEngine tmp;
+    c.defaults = prepareMode(tmp, sr, block, c.mode, c.quality);
+    c.params = c.defaults;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(' ', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string pair = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (pair.empty()) continue;
+
+        const size_t eq = pair.find('=');
+        if (eq == std::string::npos || !setParamByName(c.params, pair.substr(0, eq), pair.substr(eq + 1))) {
+            bad = pair;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void printDiff(const FuzzConfig& c, bool all) {
+    for (const auto& f : kFloatFields) {
+        const float v = c.params.*(f.member);
+        const float d = c.defaults.*(f.member);
+        if (all || v != d) {
+            std::printf("      %-24s %12.5g", f.name, double(v));
+            if (v != d) std::printf("   (default %.5g)", double(d));
+            std::printf("\n");
+        }
+    }
+    if (all || c.params.inputDiffStages != c.defaults.inputDiffStages) {
+        std::printf("      %-24s %12d   (default %d)\n", "inputDiffStages",
+            c.params.inputDiffStages, c.defaults.inputDiffStages);
+    }
+}
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+struct Timing {
+    double nsPerSample = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+static Timing timeConfig(bigpi::Mode mode, const std::string& quality, const Params* params,
+    float sr, int block,
+    const std::vector<float>& warmL, const std::vector<float>& warmR,
+    const std::vector<float>& inL, const std::vector<float>& inR,
+    std::vector<float>& outL, std::vector<float>& outR)
+{
+    ReverbEngine eng;
+    prepareMode(eng, sr, block, mode, quality);
+    if (params) {
+        eng.setParams(*params);
+        eng.reset();
+    }
+
+    runUntimed(eng, warmL, warmR, outL, outR, block, int(warmL.size()));
+
+    LatencyHistogram hist;
+    const uint64_t ns = runTimed(eng, inL, inR, outL, outR, block, hist);
+
+    Timing t;
+    t.nsPerSample = double(ns) / double(inL.size());
+    t.p99Us = double(hist.percentile(0.99)) * 1e-3;
+    t.maxUs = double(hist.max()) * 1e-3;
+    return t;
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+struct FuzzOptions {
+    int iterations = 200;
+    uint32_t seed = 0xF022u;
+    int top = 10;
+
+    int sr = 48000;
+    int block = 64;
+    float seconds = 0.5f;
+    float warmupSeconds = 0.25f;
+
+    bool replay = false;
+    uint32_t replaySeed = 0;
+
+    std::string saveRegressPath;
+    std::string regressPath;
+    double tolerance = 0.15;
+};
+
+static void printUsage() {
+    std::cout <<
+        "bigpi_fuzz options:\n"
+        "  --iterations N           configs to sample (default 200)\n"
+        "  --seed N                 master seed (default 0xF022)\n"
+        "  --top K                  slowest configs to report (default 10)\n"
+        "  --sr 48000               sample rate\n"
+        "  --block 64               block size\n"
+        "  --seconds S              timed audio per config (default 0.5)\n"
+        "  --save-regress PATH      store the top K as regression cases\n"
+        "  --replay SEED            re-run one config and print its Params\n"
+        "  --regress PATH           re-time stored cases, exit 2 on slowdown\n"
+        "  --tolerance T            allowed slowdown for --regress (default 0.15)\n";
+}
+
+static bool parseArgs(int argc, char** argv, FuzzOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](std::string& v) -> bool {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+            v = argv[++i];
+            return true;
+        };
+
+        std::string v;
+        if (a == "--help" || a == "-h") { printUsage(); std::exit(0); }
+        else if (a == "--iterations") { if (!next(v)) return false; o.iterations = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--seed") { if (!next(v)) return false; o.seed = uint32_t(std::strtoul(v.c_str(), nullptr, 0)); }
+        else if (a == "--top") { if (!next(v)) return false; o.top = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--sr") { if (!next(v)) return false; o.sr = std::max(8000, std::atoi(v.c_str())); }
+        else if (a == "--block") { if (!next(v)) return false; o.block = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--seconds") { if (!next(v)) return false; o.seconds = std::max(0.05f, float(std::atof(v.c_str()))); }
+        else if (a == "--save-regress") { if (!next(v)) return false; o.saveRegressPath = v; }
+        else if (a == "--replay") {
+            if (!next(v)) return false;
+            o.replay = true;
+            o.replaySeed = uint32_t(std::strtoul(v.c_str(), nullptr, 0));
+        }
+        else if (a == "--regress") { if (!next(v)) return false; o.regressPath = v; }
+        else if (a == "--tolerance") { if (!next(v)) return false; o.tolerance = std::max(0.0, std::atof(v.c_str())); }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Regression cases file
+// ============================================================================
+
+struct RegressCase {
+    uint32_t seed = 0;
+    int sr = 48000;
+    int block = 64;
+    double nsPerSample = 0.0;
+    double ratio = 0.0;
+    std::string mode;
+    std::string quality;
+    std::string params;     // paramsToText(); empty in files from older builds
+
+    std::string toJson() const {
+        char seedHex[16];
+        std::snprintf(seedHex, sizeof(seedHex), "0x%08x", seed);
+
+        JsonObject o;
+        o.str("seed", seedHex)
+            .str("mode", mode)
+            .str("quality", quality)
+            .integer("sr", sr)
+            .integer("block", block)
+            .num("ns_per_sample", nsPerSample)
+            .num("cost_ratio", ratio)
+            .str("params", params);
+        return o.done();
+    }
+};
+
+static std::vector<RegressCase> loadCases(const std::string& path) {
+    std::vector<RegressCase> out;
+    std::ifstream f(path);
+    std::string line;
+    while (std::getline(f, line)) {
+        std::string seed, sr, block, ns, ratio;
+        RegressCase c;
+        if (!jsonField(line, "seed", seed) || !jsonField(line, "ns_per_sample", ns)) continue;
+        if (!jsonField(line, "sr", sr) || !jsonField(line, "block", block)) continue;
+        jsonField(line, "cost_ratio", ratio);
+        jsonField(line, "mode", c.mode);
+        jsonField(line, "quality", c.quality);
+        jsonField(line, "params", c.params);
+
+        c.seed = uint32_t(std::strtoul(seed.c_str(), nullptr, 0));
+        c.sr = std::atoi(sr.c_str());
+        c.block = std::atoi(block.c_str());
+        c.nsPerSample = std::atof(ns.c_str());
+        c.ratio = std::atof(ratio.c_str());
+        out.push_back(c);
+    }
+    return out;
+}
+
+static bool saveCases(const std::string& path, const std::vector<RegressCase>& cases) {
+    std::vector<std::string> lines;
+    for (const auto& c : cases) lines.push_back(c.toJson());
+
+    std::ofstream f(path);
+    if (!f) return false;
+    writeJsonLines(f, lines);
+    return true;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+// Same signal for every config at one rate (program material).
+struct Signal {
+    std::vector<float> warmL, warmR, inL, inR, outL, outR;
+
+    Signal(const FuzzOptions& o, int sr) {
+        const size_t warm = size_t(o.warmupSeconds * float(sr));
+        const size_t timed = size_t(o.seconds * float(sr));
+
+        std::vector<float> L(warm + timed), R(warm + timed);
+        generateMixed(L, R, float(sr), 0xF0220u);
+
+        warmL.assign(L.begin(), L.begin() + long(warm));
+        warmR.assign(R.begin(), R.begin() + long(warm));
+        inL.assign(L.begin() + long(warm), L.end());
+        inR.assign(R.begin() + long(warm), R.end());
+        outL.assign(L.size(), 0.0f);
+        outR.assign(L.size(), 0.0f);
+    }
+};
+
+struct CaseResult {
+    FuzzConfig cfg;
+    Timing t;
+    Timing base;
+    double ratio = 0.0;
+};
+
+// Mode-default timings, keyed "mode|quality" (measured once per run).
+using BaseCache = std::map<std::string, Timing>;
+
+static CaseResult runSeed(uint32_t seed, int sr, int block, Signal& s, BaseCache& cache) {
+    CaseResult r;
+    r.cfg = configFromSeed(seed, float(sr), block);
+
+    const std::string key = std::string(bigpi::modeToString(r.cfg.mode)) + "|" + r.cfg.quality;
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        const Timing base = timeConfig(r.cfg.mode, r.cfg.quality, nullptr, float(sr), block,
+            s.warmL, s.warmR, s.inL, s.inR, s.outL, s.outR);
+        it = cache.emplace(key, base).first;
+    }
+    r.base = it->second;
+
+    r.t = timeConfig(r.cfg.mode, r.cfg.quality, &r.cfg.params, float(sr), block,
+        s.warmL, s.warmR, s.inL, s.inR, s.outL, s.outR);
+    r.ratio = (r.base.nsPerSample > 0.0) ? r.t.nsPerSample / r.base.nsPerSample : 0.0;
+    return r;
+}
+
+static int runRegress(const FuzzOptions& o) {
+    const auto cases = loadCases(o.regressPath);
+    if (cases.empty()) {
+        std::cerr << "No cases in " << o.regressPath << "\n";
+        return 1;
+    }
+
+    int regressions = 0;
+    int stale = 0;
+    std::printf("%-10s %-12s %-4s %7s %5s %12s %12s %8s\n",
+        "seed", "mode", "qual", "sr", "block", "stored ns", "now ns", "change");
+
+    for (const auto& c : cases) {
+        // Rebuild the stored config. Cases without params (older files) fall
+        // back to the seed, which only holds while it still draws the same
+        // mode and quality.
+        FuzzConfig cfg;
+        std::string why;
+        bigpi::Mode mode = bigpi::Mode::Hall;
+        const bool known = bigpi::modeFromString(c.mode.c_str(), mode) && isValidQuality(c.quality);
+
+        if (!known) {
+            why = "unknown mode/quality '" + c.mode + "/" + c.quality + "'";
+        }
+        else if (!c.params.empty()) {
+            std::string bad;
+            if (!configFromText(c.params, mode, c.quality, float(c.sr), c.block, cfg, bad)) {
+                why = "unknown field '" + bad + "'";
+            }
+        }
+        else {
+            cfg = configFromSeed(c.seed, float(c.sr), c.block);
+            if (cfg.mode != mode || cfg.quality != c.quality) {
+                why = "seed now draws " + std::string(bigpi::modeToString(cfg.mode)) + "/" + cfg.quality;
+            }
+        }
+
+        if (!why.empty()) {
+            stale++;
+            std::printf("0x%08x %-12s %-4s %7d %5d %12.2f %12s %8s  STALE: %s\n",
+                c.seed, c.mode.c_str(), c.quality.c_str(), c.sr, c.block,
+                c.nsPerSample, "-", "-", why.c_str());
+            continue;
+        }
+
+        Signal s(o, c.sr);
+        const Timing t = timeConfig(cfg.mode, cfg.quality, &cfg.params, float(c.sr), c.block,
+            s.warmL, s.warmR, s.inL, s.inR, s.outL, s.outR);
+
+        const double change = (c.nsPerSample > 0.0) ? t.nsPerSample / c.nsPerSample - 1.0 : 0.0;
+        const bool bad = change > o.tolerance;
+        if (bad) regressions++;
+
+        std::printf("0x%08x %-12s %-4s %7d %5d %12.2f %12.2f %+7.1f%%%s\n",
+            c.seed, bigpi::modeToString(cfg.mode), cfg.quality.c_str(), c.sr, c.block,
+            c.nsPerSample, t.nsPerSample, change * 100.0, bad ? "  REGRESSION" : "");
+    }
+
+    std::printf("\n%zu case(s), %d regression(s), %d stale (tolerance %.0f%%)\n",
+        cases.size(), regressions, stale, o.tolerance * 100.0);
+    return (regressions > 0 || stale > 0) ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "Big Pi — bigpi_fuzz\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n";
+
+    FuzzOptions o;
+    if (!parseArgs(argc, argv, o)) return 1;
+
+    if (!isOptimizedBuild()) {
+        std::cout << "WARNING: this is not an optimized build (NDEBUG not set).\n"
+                     "         Configure with -DCMAKE_BUILD_TYPE=Release for real numbers.\n";
+    }
+    std::cout << "\n";
+
+    if (!o.regressPath.empty()) return runRegress(o);
+
+    Signal s(o, o.sr);
+    BaseCache baseCache;
+
+    if (o.replay) {
+        const CaseResult r = runSeed(o.replaySeed, o.sr, o.block, s, baseCache);
+        std::printf("seed 0x%08x  mode %s  quality %s  sr %d  block %d\n",
+            r.cfg.seed, bigpi::modeToString(r.cfg.mode), r.cfg.quality.c_str(), o.sr, o.block);
+        std::printf("  %.2f ns/smp (defaults %.2f)  cost x%.2f  p99 %.2f us  max %.2f us\n",
+            r.t.nsPerSample, r.base.nsPerSample, r.ratio, r.t.p99Us, r.t.maxUs);
+        std::printf("  Params:\n");
+        printDiff(r.cfg, true);
+        return 0;
+    }
+
+    // Fuzz
+    std::vector<CaseResult> results;
+    results.reserve(size_t(o.iterations));
+
+    XorShift32 master(o.seed ? o.seed : 1u);
+    for (int i = 0; i < o.iterations; ++i) {
+        const uint32_t seed = master.next();
+        results.push_back(runSeed(seed, o.sr, o.block, s, baseCache));
+
+        if ((i + 1) % 25 == 0) {
+            std::printf("  %d / %d configs\n", i + 1, o.iterations);
+            std::fflush(stdout);
+        }
+    }
+
+    std::sort(results.begin(), results.end(),
+        [](const CaseResult& a, const CaseResult& b) { return a.ratio > b.ratio; });
+
+    const int k = std::min(o.top, int(results.size()));
+    std::printf("\nTop %d configs by cost ratio (vs. the same mode with default Params):\n", k);
+    for (int i = 0; i < k; ++i) {
+        const auto& r = results[size_t(i)];
+        std::printf("\n#%d  seed 0x%08x  %-10s %-3s  x%.2f  %.2f ns/smp (defaults %.2f)  p99 %.2f us  max %.2f us\n",
+            i + 1, r.cfg.seed, bigpi::modeToString(r.cfg.mode), r.cfg.quality.c_str(),
+            r.ratio, r.t.nsPerSample, r.base.nsPerSample, r.t.p99Us, r.t.maxUs);
+        printDiff(r.cfg, false);
+    }
+
+    if (!o.saveRegressPath.empty()) {
+        std::vector<RegressCase> cases = loadCases(o.saveRegressPath);
+        for (int i = 0; i < k; ++i) {
+            const auto& r = results[size_t(i)];
+
+            RegressCase c;
+            c.seed = r.cfg.seed;
+            c.sr = o.sr;
+            c.block = o.block;
+            c.nsPerSample = r.t.nsPerSample;
+            c.ratio = r.ratio;
+            c.mode = bigpi::modeToString(r.cfg.mode);
+            c.quality = r.cfg.quality;
+            c.params = paramsToText(r.cfg.params);
+
+            // Same seed/rate/block again: refresh instead of duplicating
+            auto same = [&c](const RegressCase& e) { return e.seed == c.seed && e.sr == c.sr && e.block == c.block; };
+            auto it = std::find_if(cases.begin(), cases.end(), same);
+            if (it != cases.end()) *it = c;
+            else cases.push_back(c);
+        }
+
+        if (!saveCases(o.saveRegressPath, cases)) {
+            std::cerr << "Cannot write " << o.saveRegressPath << "\n";
+            return 1;
+        }
+        std::cout << "\nSaved " << cases.size() << " regression case(s) to " << o.saveRegressPath << "\n";
+    }
+
+    return 0;
+}
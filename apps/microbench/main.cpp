@@ -0,0 +1,570 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/CycleClock.h"
+#include "core/Version.h"
+#include "dsp/common/Dsp.h"
+#include "dsp/diffusion/Diffusion.h"
+#include "dsp/engines/tune_hall/EarlyReflections.h"
+#include "dsp/engines/tune_hall/OutputStage.h"
+#include "dsp/granular/GranularEngine.h"
+#include "dsp/pitch/PitchShifter.h"
+#include "dsp/singularity/SingularityEngine.h"
+#include "dsp/spring/SpringModel.h"
+#include "dsp/tape/MagneticTape.h"
+#include "dsp/tail/Matrices.h"
+#include "dsp/tail/Tank.h"
+#include "dsp/tail/TapPatterns.h"
+
+#include "common/BenchStats.h"
+#include "common/ModuleFixtures.h"
+#include "common/TestSignals.h"
+
+/*
+  =============================================================================
+  apps/microbench/main.cpp — bigpi_microbench (per-primitive micro-benchmarks)
+  =============================================================================
+
+  bigpi_bench answers "how expensive is a mode". This tool answers "how
+  expensive is one kernel", so optimisation work on a single primitive
+  (DelayLine read, allpass, matrix, tank step...) can be measured on its own.
+
+  Method (per kernel, per variant):
+    1) Warm-up repetitions (not recorded)
+    2) N timed repetitions, each running `ops` calls back-to-back
+    3) Per-rep cost = ticks / ops (rdtsc / cntvct, see core/CycleClock.h)
+    4) Outlier rejection: drop reps further than 3 * MAD from the median
+       (interrupts, migrations, frequency ramps)
+    5) Report median, min and mean of the kept reps
+
+  Variants:
+    hot  : kernel state + inputs stay in cache (many ops per rep)
+    cold : a large scratch buffer is streamed before each rep, evicting the
+           kernel's delay memory; each rep then runs one 64-sample block.
+           This is closer to the pedal, where every module competes for cache.
+
+  Usage:
+    bigpi_microbench [--filter substring] [--reps N] [--json out.json]
+                     [--variant hot|cold|both]
+*/
+
+using namespace bigpi::bench;
+
+// ============================================================================
+// Optimisation barrier
+// ============================================================================
+
+template <typename T>
+static inline void doNotOptimize(const T& v) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &v;
+#endif
+}
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+struct MicroOptions {
+    std::string filter;
+    std::string variant = "both";
+    int reps = 101;
+    int warmupReps = 15;
+    std::string jsonPath;
+};
+
+struct MicroResult {
+    std::string name;
+    std::string variant;
+    int opsPerRep = 0;
+
+    double medianTicks = 0.0;
+    double minTicks = 0.0;
+    double meanTicks = 0.0;
+    double medianNs = 0.0;
+
+    int kept = 0;
+    int total = 0;
+};
+
+/*
+  Kernel description:
+    run(ops)   : executes `ops` operations of the kernel
+    opsHot     : ops per rep in the hot variant
+    opsCold    : ops per rep in the cold variant (one block)
+*/
+struct Kernel {
+    std::string name;
+    std::function<void(int)> run;
+    int opsHot = 4096;
+    int opsCold = 64;
+};
+
+class CacheFlusher {
+public:
+    CacheFlusher() : buf(size_t(32) << 20 >> 2, 1.0f) {}
+
+    // Stream through 32 MB (larger than any L2/LLC on our targets).
+    void flush() {
+        float acc = 0.0f;
+        for (size_t i = 0; i < buf.size(); i += 16) {
+            buf[i] += 1.0f;
+            acc += buf[i];
+        }
+        doNotOptimize(acc);
+    }
+
+private:
+    std::vector<float> buf;
+};
+
+static MicroResult measure(const Kernel& k, bool cold, const MicroOptions& o, CacheFlusher& flusher) {
+    const int ops = cold ? k.opsCold : k.opsHot;
+
+    for (int r = 0; r < o.warmupReps; ++r) k.run(ops);
+
+    std::vector<double> perOp;
+    perOp.reserve(size_t(o.reps));
+
+    for (int r = 0; r < o.reps; ++r) {
+        if (cold) flusher.flush();
+
+        const uint64_t t0 = bigpi::core::readCycleCounter();
+        k.run(ops);
+        const uint64_t t1 = bigpi::core::readCycleCounter();
+
+        perOp.push_back(double(t1 - t0) / double(ops));
+    }
+
+    // Median + MAD outlier rejection
+    std::vector<double> sorted = perOp;
+    std::sort(sorted.begin(), sorted.end());
+    const double med = sorted[sorted.size() / 2];
+
+    std::vector<double> dev;
+    dev.reserve(sorted.size());
+    for (double v : sorted) dev.push_back(std::abs(v - med));
+    std::sort(dev.begin(), dev.end());
+    const double mad = std::max(dev[dev.size() / 2], 1e-9);
+
+    std::vector<double> kept;
+    for (double v : sorted) {
+        if (std::abs(v - med) <= 3.0 * 1.4826 * mad) kept.push_back(v);
+    }
+    if (kept.empty()) kept = sorted;
+
+    double sum = 0.0;
+    for (double v : kept) sum += v;
+
+    MicroResult res;
+    res.name = k.name;
+    res.variant = cold ? "cold" : "hot";
+    res.opsPerRep = ops;
+    res.medianTicks = kept[kept.size() / 2];
+    res.minTicks = kept.front();
+    res.meanTicks = sum / double(kept.size());
+    res.medianNs = res.medianTicks * 1.0e9 / bigpi::core::ticksPerSecond();
+    res.kept = int(kept.size());
+    res.total = int(sorted.size());
+    return res;
+}
+
+// ============================================================================
+// Kernels
+// ============================================================================
+
+/*
+  All kernel state lives in this struct so lambdas can capture by reference
+  and nothing is allocated while timing.
+*/
+struct Fixtures {
+    static constexpr float kSr = 48000.0f;
+
+    std::vector<float> in;      // input signal (mixed program material)
+    std::vector<float> delays;  // fractional delays in samples (modulated reads)
+
+    dsp::DelayLine delay;
+    dsp::Allpass allpass;
+    dsp::Biquad biquad;
+    dsp::MultiLFO lfo;
+    dsp::SmoothNoise noise;
+    dsp::OnePoleLP onePole;
+
+    std::array<float, bigpi::core::kMaxLines> vec{};
+
+    bigpi::core::Tank tank8;
+    bigpi::core::Tank tank16;
+    std::array<float, bigpi::core::Tank::kMaxLines> inj{};
+    std::array<float, bigpi::core::Tank::kMaxLines> yOut{};
+
+    bigpi::core::Diffusion diffusion;
+    bigpi::core::PitchShifter pitch;
+    bigpi::core::GranularEngine granular;
+    bigpi::core::SpringModel spring;
+    bigpi::core::MagneticTape tape;
+    bigpi::core::SingularityEngine singularity;
+    EarlyReflections er;
+    dsp::DelayLine erHistL, erHistR;     // ER reads the engine's input history
+    OutputStage out;
+
+    std::vector<float> bufL, bufR, bufL2, bufR2;
+
+    float sink = 0.0f;
+    size_t cursor = 0;
+
+    Fixtures() {
+        const size_t n = 1 << 16;
+        std::vector<float> r(n);
+        in.resize(n);
+        generateMixed(in, r, kSr, 0xBEEFu);
+
+        XorShift32 rng(0x1234u);
+        delays.resize(n);
+        for (auto& d : delays) d = 400.0f + 4000.0f * rng.uni();
+
+        delay.init(int(kSr * 2.5f));
+        for (size_t i = 0; i < delay.buf.size(); ++i) delay.push(in[i % n]);
+
+        allpass.init(int(kSr * 0.03f));
+        allpass.delaySamp = 437.0f;
+        allpass.g = 0.7f;
+
+        biquad.setLowShelf(200.0f, 3.0f, 0.9f, kSr);
+
+        lfo.init(16, kSr);
+
+        noise.setSampleRate(kSr);
+        noise.setRateHz(0.35f);
+        noise.setSmoothMs(80.0f);
+
+        onePole.setCutoff(9000.0f, kSr);
+
+        for (int i = 0; i < bigpi::core::kMaxLines; ++i) vec[i] = rng.bi();
+
+        initReferenceTank(tank8, kSr, 8);
+        initReferenceTank(tank16, kSr, 16);
+
+        diffusion.init(kSr, 0xB16B00B5u);
+
+        pitch.prepare(kSr);
+        pitch.setVoiceGains(0.7f, 0.3f);
+
+        // Worst case: dense, long grains keep all 32 voices busy
+        granular.prepare(kSr, 64, 0x6A41A7u);
+        bigpi::core::GranularEngine::Params gp;
+        gp.densityHz = 80.0f;
+        gp.lengthMs = 400.0f;
+        gp.pitchRange = 0.5f;
+        gp.reverse = 0.3f;
+        gp.scan = 1.0f;
+        granular.setParams(gp);
+
+        spring.prepare(kSr);
+
+        bigpi::core::MagneticTape::Params tp;
+        tp.heads = bigpi::core::MagneticTape::HeadPattern::Quad;
+        tape.prepare(kSr);
+        tape.applyCoeffs(bigpi::core::MagneticTape::makeCoeffs(tp, kSr));
+
+        singularity.prepare(kSr);
+        er.prepare(kSr);
+        erHistL.init(int(kSr * 0.10f) + 64 + 4);
+        erHistR.init(int(kSr * 0.10f) + 64 + 4);
+        out.prepare(kSr);
+
+        bufL.assign(4096, 0.0f);
+        bufR.assign(4096, 0.0f);
+        bufL2.assign(4096, 0.0f);
+        bufR2.assign(4096, 0.0f);
+        for (size_t i = 0; i < bufL.size(); ++i) { bufL[i] = in[i]; bufR[i] = r[i]; }
+    }
+
+    float nextIn() {
+        const float x = in[cursor];
+        cursor = (cursor + 1) & (in.size() - 1);
+        return x;
+    }
+};
+
+static std::vector<Kernel> makeKernels(Fixtures& f) {
+    std::vector<Kernel> ks;
+
+    ks.push_back({ "DelayLine::readFracCubic", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.delay.readFracCubic(f.delays[(f.cursor + size_t(i)) & (f.delays.size() - 1)]);
+        f.cursor = (f.cursor + size_t(ops)) & (f.delays.size() - 1);
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "DelayLine::push", [&f](int ops) {
+        for (int i = 0; i < ops; ++i) f.delay.push(f.nextIn());
+        doNotOptimize(f.delay.w);
+    } });
+
+    ks.push_back({ "Allpass::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.allpass.process(f.nextIn());
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "Biquad::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.biquad.process(f.nextIn());
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "OnePoleLP::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.onePole.process(f.nextIn());
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "MultiLFO::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.lfo.process(i & 15, 0.25f);
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "SmoothNoise::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.noise.process();
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "softSat", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += dsp::softSat(f.nextIn(), 1.2f);
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "SoftSaturator", [&f](int ops) {
+        dsp::SoftSaturator sat;
+        sat.setDrive(1.2f);
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += sat.process(f.nextIn());
+        doNotOptimize(acc);
+    } });
+
+    for (int lines : { 8, 16 }) {
+        const std::string suffix = "/" + std::to_string(lines);
+
+        ks.push_back({ "hadamardMix" + suffix, [&f, lines](int ops) {
+            for (int i = 0; i < ops; ++i) {
+                bigpi::core::hadamardMix(f.vec, lines);
+                doNotOptimize(f.vec);
+            }
+        } });
+
+        ks.push_back({ "householderMix" + suffix, [&f, lines](int ops) {
+            for (int i = 0; i < ops; ++i) {
+                bigpi::core::householderMix(f.vec, lines);
+                doNotOptimize(f.vec);
+            }
+        } });
+
+        ks.push_back({ "renderTapPattern" + suffix, [&f, lines](int ops) {
+            float acc = 0.0f;
+            for (int i = 0; i < ops; ++i) {
+                float L = 0.0f, R = 0.0f;
+                bigpi::core::renderTapPattern(f.vec, lines, i & 3, L, R);
+                acc += L + R;
+            }
+            doNotOptimize(acc);
+        } });
+
+        bigpi::core::Tank& tank = (lines == 8) ? f.tank8 : f.tank16;
+        ks.push_back({ "Tank::processSampleVec" + suffix, [&f, &tank, lines](int ops) {
+            for (int i = 0; i < ops; ++i) {
+                const float x = f.nextIn() * (1.0f / float(lines));
+                for (int l = 0; l < lines; ++l) f.inj[size_t(l)] = x;
+                tank.processSampleVec(f.inj, 0.92f, f.lfo, f.yOut);
+            }
+            doNotOptimize(f.yOut);
+        } });
+    }
+
+    // Shimmer budget: should stay below two tank lines (Tank /8 cost / 4)
+    ks.push_back({ "PitchShifter::process", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) acc += f.pitch.process(f.nextIn());
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "Diffusion::processInput", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) {
+            float L = f.nextIn(), R = -L;
+            f.diffusion.processInput(L, R);
+            acc += L + R;
+        }
+        doNotOptimize(acc);
+    } });
+
+    ks.push_back({ "Diffusion::processLate", [&f](int ops) {
+        float acc = 0.0f;
+        for (int i = 0; i < ops; ++i) {
+            float L = f.nextIn(), R = -L;
+            f.diffusion.processLate(L, R, 0.6f);
+            acc += L + R;
+        }
+        doNotOptimize(acc);
+    } });
+
+    // Block modules: one "op" is one sample, processed in 64-sample blocks.
+    ks.push_back({ "EarlyReflections (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            for (int i = 0; i < n; ++i) {
+                f.erHistL.push(f.bufL[size_t(pos + i) & 4095]);
+                f.erHistR.push(f.bufR[size_t(pos + i) & 4095]);
+            }
+            f.er.processBlock(f.erHistL, f.erHistR, 0.0f, f.bufL2.data(), f.bufR2.data(), n);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    // Granular budget: 32 voices should stay below the 8-line tank (Tank /8)
+    ks.push_back({ "GranularEngine (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            const size_t at = size_t(pos) & 4095 & ~size_t(63);
+            f.granular.capture(&f.bufL[at], &f.bufR[at], n, false);
+            f.granular.render(f.bufL2.data(), f.bufR2.data(), n);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    // Spring budget: should stay below the 16-line tank (Tank /16)
+    ks.push_back({ "SpringModel (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            const size_t at = size_t(pos) & 4095 & ~size_t(63);
+            f.spring.processBlock(&f.bufL[at], &f.bufR[at], f.bufL2.data(), f.bufR2.data(), n);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    ks.push_back({ "MagneticTape (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            const size_t at = size_t(pos) & 4095 & ~size_t(63);
+            f.tape.processBlock(&f.bufL[at], &f.bufR[at], f.bufL2.data(), f.bufR2.data(), n);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    ks.push_back({ "SingularityEngine (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            const size_t at = size_t(pos) & 4095 & ~size_t(63);
+            f.singularity.processBlock(&f.bufL[at], &f.bufR[at], f.bufL2.data(), f.bufR2.data(), n, false);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    ks.push_back({ "OutputStage (per smp)", [&f](int ops) {
+        for (int pos = 0; pos < ops; pos += 64) {
+            const int n = std::min(64, ops - pos);
+            std::copy_n(f.bufL.begin(), n, f.bufL2.begin());
+            std::copy_n(f.bufR.begin(), n, f.bufR2.begin());
+            f.out.processBlock(f.bufL2.data(), f.bufR2.data(), n);
+        }
+        doNotOptimize(f.bufL2[0]);
+    } });
+
+    return ks;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static bool parseArgs(int argc, char** argv, MicroOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 < argc && a == "--filter") o.filter = argv[++i];
+        else if (i + 1 < argc && a == "--reps") o.reps = std::max(5, std::atoi(argv[++i]));
+        else if (i + 1 < argc && a == "--json") o.jsonPath = argv[++i];
+        else if (i + 1 < argc && a == "--variant") o.variant = argv[++i];
+        else {
+            std::cerr << "usage: bigpi_microbench [--filter S] [--reps N] [--json PATH] [--variant hot|cold|both]\n";
+            return false;
+        }
+    }
+    return o.variant == "hot" || o.variant == "cold" || o.variant == "both";
+}
+
+int main(int argc, char** argv) {
+    MicroOptions o;
+    if (!parseArgs(argc, argv, o)) return 1;
+
+    std::cout << "Big Pi — bigpi_microbench\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n";
+    std::cout << "Counter: " << bigpi::core::cycleCounterName()
+        << " @ " << bigpi::core::ticksPerSecond() * 1e-6 << " MHz\n";
+    if (!isOptimizedBuild()) {
+        std::cout << "WARNING: not an optimized build (NDEBUG not set).\n";
+    }
+    std::cout << "\n";
+
+    Fixtures f;
+    CacheFlusher flusher;
+    const std::vector<Kernel> kernels = makeKernels(f);
+
+    std::printf("%-30s %-5s %6s %12s %12s %12s %10s %8s\n",
+        "kernel", "var", "ops", "ticks/op", "min", "mean", "ns/op", "kept");
+
+    std::vector<std::string> json;
+
+    for (const auto& k : kernels) {
+        if (!o.filter.empty() && k.name.find(o.filter) == std::string::npos) continue;
+
+        for (int v = 0; v < 2; ++v) {
+            const bool cold = (v == 1);
+            if (cold && o.variant == "hot") continue;
+            if (!cold && o.variant == "cold") continue;
+
+            const MicroResult r = measure(k, cold, o, flusher);
+
+            std::printf("%-30s %-5s %6d %12.2f %12.2f %12.2f %10.2f %4d/%-3d\n",
+                r.name.c_str(), r.variant.c_str(), r.opsPerRep,
+                r.medianTicks, r.minTicks, r.meanTicks, r.medianNs, r.kept, r.total);
+            std::fflush(stdout);
+
+            JsonObject jo;
+            jo.str("kernel", r.name).str("variant", r.variant)
+                .integer("ops", r.opsPerRep)
+                .num("ticks_per_op", r.medianTicks)
+                .num("min_ticks_per_op", r.minTicks)
+                .num("mean_ticks_per_op", r.meanTicks)
+                .num("ns_per_op", r.medianNs)
+                .str("counter", bigpi::core::cycleCounterName());
+            json.push_back(jo.done());
+        }
+    }
+
+    doNotOptimize(f.sink);
+
+    if (!o.jsonPath.empty()) {
+        std::ofstream jf(o.jsonPath);
+        if (!jf) {
+            std::cerr << "Cannot write " << o.jsonPath << "\n";
+            return 1;
+        }
+        writeJsonLines(jf, json);
+        std::cout << "\nWrote JSON: " << o.jsonPath << "\n";
+    }
+
+    return 0;
+}
@@ -2,11 +2,38 @@
 #include <vector>
 #include <cmath>
 #include <cstdint>
-#include <fstream>
+#include <cstdlib>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
-
+#include <thread>
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/ParamFields.h"
+#include "common/SpscRing.h"
+#include "common/TestSignals.h"
+#include "common/WavIO.h"
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#endif
+
+#include "core/Trace.h"
 #include "core/Version.h"
+#include "dsp/engines/tune_hall/PresetBank.h"
 #include "dsp/engines/tune_hall/ReverbEngine.h"
 #include "dsp/modes/Modes.h"
 
@@ -15,10 +42,86 @@
   App/main.cpp  Big Pi Test Harness (modular project)
   =============================================================================
 
-  What this program does:
-    - Generates a test input signal (impulse or tone burst)
-    - Runs it through ReverbEngine
-    - Writes the result to a stereo 16-bit WAV file
+  What this program does, one command at a time:
+    (none)   impulse / tone burst through ReverbEngine -> stereo 16-bit WAV
+    render   any WAV file through the engine, streamed in fixed chunks
+    batch    a whole tuning session (inputs x modes x parameter grid)
+    stream   raw audio on stdin/stdout, for live use in a shell pipeline
+    rt       a real-time host loop that stands in for the pedal's interrupt
+    bank     build / list a precomputed binary preset bank
+
+  Without a command it generates a test input signal (impulse or tone
+  burst), runs it through ReverbEngine and writes the result to a stereo
+  16-bit WAV file.
+
+  With the "render" command it runs any WAV file through the engine:
+
+    bigpi_test render --in guitar.wav --out wet.wav [options]
+
+    --mode NAME        Room / Hall / Plate / ... (default Hall, preset defaults)
+    --quality Q        eco | hq | preset (default preset)
+    --mix X            0..1
+    --decay X          0..1
+    --predelay MS      pre-delay in milliseconds
+    --set NAME=VALUE   any ReverbEngine::Params member by name, repeatable
+                       (e.g. --set dampingHz=6000 --set outWidth=1.2)
+    --bits B           16 | 24 | 32 | f32 (default: same as the input)
+    --dither           TPDF dither when writing 16/24-bit
+    --block N          engine block size (default 64)
+    --tail SECONDS     silence fed after the input so the tail rings out
+                       (default 3)
+    --threads 1|3      3 (default): reader, DSP and writer threads
+                       1: everything on one thread (for comparison)
+    --bank FILE        preset bank (see "bank" below); with --program N|NAME
+                       it replaces --mode (default: program 0)
+
+    The file is streamed: it is read, processed and written in fixed chunks,
+    so memory use does not grow with the file length (hour-long files and
+    >4 GiB RF64 output are fine). Input may be 16/24/32-bit PCM or 32-bit
+    float, mono or stereo, RIFF or RF64; the output is stereo at the input
+    sample rate.
+
+    With 3 threads the chunks travel reader -> DSP -> writer -> reader
+    through lock-free SPSC rings (common/SpscRing.h). The pool of chunks is
+    allocated once, so a slow disk simply stalls the reader (back-pressure)
+    and the DSP thread only ever waits for the next chunk, never on a file.
+
+  Or, with the "batch" command, renders a whole tuning session at once:
+
+    bigpi_test batch --manifest session.txt --out-dir renders [--jobs N]
+                     [--cache DIR]
+
+    The manifest lists inputs x modes x a parameter grid (format: see the
+    "batch" section below). Jobs run on N worker threads (default: one per
+    core), each with its own ReverbEngine. Every job writes one WAV into
+    --out-dir, plus OUT_DIR/batch_timing.csv with per-job timing. Impulse
+    jobs with identical settings are rendered once (content-hash IR cache).
+
+  Or, with the "stream" command (alias --stream), sits in a shell pipeline:
+
+    arecord -f FLOAT_LE -r 48000 -c 2 -t raw | bigpi_test stream | aplay ...
+
+    Raw interleaved f32 or s16 on stdin/stdout in fixed periods, timing and
+    underruns on stderr (details in the "stream" section below).
+
+  Or, with the "rt" command, pretends to be the pedal's audio interrupt:
+
+    bigpi_test rt --seconds 600 --period 64 --cpu 3 --priority 80
+
+    A timer wakes a SCHED_FIFO, core-pinned, memory-locked thread once per
+    period (each step falls back gracefully without privileges) and reports
+    wake jitter, processing time, deadline misses and xruns at the end
+    (details in the "rt" section below).
+
+  Or, with the "bank" command, precomputes a binary preset bank
+  (dsp/engines/tune_hall/PresetBank.h) that the other commands load with
+  --bank FILE --program N|NAME instead of --mode:
+
+    bigpi_test bank build --out presets.bank [--presets presets.txt]
+                          [--rates 44100,48000,96000]
+    bigpi_test bank list presets.bank
+
+    (details in the "bank" section below).
 
   Why this matters:
     Reverbs are hard to debug by reading code.
@@ -29,23 +132,30 @@
     - Find the WAV file in your CURRENT working directory
       (usually the build folder you ran the program from)
     - Listen in a DAW or audio player
-*/
 
-// ============================================================================
-// WAV writer helpers (16-bit PCM stereo)
-// ============================================================================
+  Options:
+    --trace FILE   record a timeline of every processed block and write it as
+                   Chrome trace JSON (open in chrome://tracing or
+                   https://ui.perfetto.dev). Stage / mode-change markers from
+                   inside the engine need a build with -DBIGPI_ENABLE_TRACE=ON;
+                   without it only the per-block markers of this harness show.
+*/
 
 /*
 ===============================================================================
 HOW TO BUILD + RUN THIS TEST HARNESS (BEGINNER GUIDE)
 ===============================================================================
 
-This program:
+Run without a command, this program:
   - Generates a test input (impulse or tone burst)
   - Runs it through the reverb
   - Writes a WAV file you can listen to
 
-It does NOT record your guitar or use real audio I/O yet. It is an offline test.
+The other commands (see the top of this file) render your own recordings
+("render", "batch"), process live audio from a pipe ("stream", e.g. fed by
+arecord and played by aplay), run the engine on a real-time host loop with
+pedal-style timing ("rt") and build preset banks ("bank"). There is no
+built-in audio driver: live audio goes through "stream".
 
 -------------------------------------------------------------------------------
 1) PREREQUISITES (Linux)
@@ -108,83 +218,6 @@ END OF BEGINNER GUIDE
 ===============================================================================
 */
 
-static void write_u32_le(std::ofstream& f, uint32_t v) {
-    char b[4];
-    b[0] = char(v & 0xFF);
-    b[1] = char((v >> 8) & 0xFF);
-    b[2] = char((v >> 16) & 0xFF);
-    b[3] = char((v >> 24) & 0xFF);
-    f.write(b, 4);
-}
-
-static void write_u16_le(std::ofstream& f, uint16_t v) {
-    char b[2];
-    b[0] = char(v & 0xFF);
-    b[1] = char((v >> 8) & 0xFF);
-    f.write(b, 2);
-}
-
-static int16_t float_to_i16(float x) {
-    x = std::max(-1.0f, std::min(1.0f, x));
-    int v = int(std::lround(x * 32767.0f));
-    v = std::max(-32768, std::min(32767, v));
-    return (int16_t)v;
-}
-
-static bool write_wav_stereo_16(
-    const std::string& path,
-    const std::vector<float>& L,
-    const std::vector<float>& R,
-    int sampleRate
-) {
-    if (L.size() != R.size() || L.empty()) {
-        std::cerr << "WAV write failed: invalid channel sizes\n";
-        return false;
-    }
-
-    const uint16_t numChannels = 2;
-    const uint16_t bitsPerSample = 16;
-    const uint16_t bytesPerSample = bitsPerSample / 8;
-    const uint32_t byteRate = sampleRate * numChannels * bytesPerSample;
-    const uint16_t blockAlign = numChannels * bytesPerSample;
-
-    const uint32_t dataBytes = uint32_t(L.size()) * numChannels * bytesPerSample;
-
-    std::ofstream f(path, std::ios::binary);
-    if (!f) {
-        std::cerr << "WAV write failed: cannot open " << path << "\n";
-        return false;
-    }
-
-    // RIFF
-    f.write("RIFF", 4);
-    write_u32_le(f, 36 + dataBytes);
-    f.write("WAVE", 4);
-
-    // fmt
-    f.write("fmt ", 4);
-    write_u32_le(f, 16);
-    write_u16_le(f, 1); // PCM
-    write_u16_le(f, numChannels);
-    write_u32_le(f, (uint32_t)sampleRate);
-    write_u32_le(f, byteRate);
-    write_u16_le(f, blockAlign);
-    write_u16_le(f, bitsPerSample);
-
-    // data
-    f.write("data", 4);
-    write_u32_le(f, dataBytes);
-
-    for (size_t i = 0; i < L.size(); ++i) {
-        int16_t li = float_to_i16(L[i]);
-        int16_t ri = float_to_i16(R[i]);
-        f.write(reinterpret_cast<const char*>(&li), 2);
-        f.write(reinterpret_cast<const char*>(&ri), 2);
-    }
-
-    return true;
-}
-
 // ============================================================================
 // Test signals
 // ============================================================================
@@ -243,11 +276,1899 @@ static std::string make_wav_name(bigpi::Mode mode, bool impulse, bool tone) {
     return "big_pi_" + modeName + "_" + sig + ".wav";
 }
 
+// ============================================================================
+// Engine options (shared by render and stream)
+// ============================================================================
+
+struct EngineOptions {
+    bigpi::Mode mode = bigpi::Mode::Hall;
+    std::string quality = "preset";
+    int block = 64;
+    std::vector<std::pair<std::string, std::string>> sets;  // applied in order
+
+    // --bank FILE --program N|NAME: start from a precomputed program instead
+    // of a mode preset (--quality / --set still apply on top).
+    std::shared_ptr<PresetBank> bank;
+    std::string programArg;
+    int program = -1;                       // resolved by finish_engine_options()
+};
+
+// 1 = `a` was an engine option, 0 = not one, -1 = bad value (already reported).
+static int parse_engine_option(const std::string& a, const std::string& v, EngineOptions& e) {
+    if (a == "--mode") {
+        if (!bigpi::modeFromString(v.c_str(), e.mode)) {
+            std::cerr << "Unknown mode: " << v << "\n";
+            return -1;
+        }
+    }
+    else if (a == "--quality") {
+        if (!bigpi::bench::isValidQuality(v)) {
+            std::cerr << "Unknown quality: " << v << " (eco | hq | preset)\n";
+            return -1;
+        }
+        e.quality = v;
+    }
+    else if (a == "--block") {
+        e.block = std::atoi(v.c_str());
+        if (e.block < 1 || e.block > 8192) {
+            std::cerr << "--block must be 1..8192\n";
+            return -1;
+        }
+    }
+    else if (a == "--mix") e.sets.emplace_back("mix", v);
+    else if (a == "--decay") e.sets.emplace_back("decay", v);
+    else if (a == "--predelay") e.sets.emplace_back("predelayMs", v);
+    else if (a == "--set") {
+        const size_t eq = v.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            std::cerr << "--set expects NAME=VALUE, got: " << v << "\n";
+            return -1;
+        }
+        if (v.substr(0, eq) == "mode") {
+            std::cerr << "Use --mode to select the mode.\n";
+            return -1;
+        }
+        e.sets.emplace_back(v.substr(0, eq), v.substr(eq + 1));
+    }
+    else if (a == "--bank") {
+        auto bank = std::make_shared<PresetBank>();
+        std::string err;
+        if (!bank->open(v, err)) {
+            std::cerr << "Cannot load bank " << err << "\n";
+            return -1;
+        }
+        e.bank = bank;
+    }
+    else if (a == "--program") e.programArg = v;
+    else {
+        return 0;
+    }
+    return 1;
+}
+
+// Bank program by index or name (exact match first, then a number).
+static int find_bank_program(const PresetBank& bank, const std::string& arg) {
+    const int byName = bank.findByName(arg);
+    if (byName >= 0) return byName;
+
+    char* end = nullptr;
+    const long idx = std::strtol(arg.c_str(), &end, 10);
+    if (end == arg.c_str() || *end != '\0' || idx < 0 || idx >= bank.programCount()) return -1;
+    return int(idx);
+}
+
+// After all options are parsed (--bank and --program may come in any order).
+static bool finish_engine_options(EngineOptions& e) {
+    if (!e.bank) {
+        if (!e.programArg.empty()) {
+            std::cerr << "--program needs --bank FILE\n";
+            return false;
+        }
+        return true;
+    }
+
+    e.program = e.programArg.empty() ? 0 : find_bank_program(*e.bank, e.programArg);
+    if (e.program < 0) {
+        std::cerr << "No program '" << e.programArg << "' in the bank (see: bigpi_test bank list FILE)\n";
+        return false;
+    }
+    // Same mode at every rate; shown by the commands' banners
+    e.mode = e.bank->find(e.program, e.bank->rate(0))->params.mode;
+    return true;
+}
+
+static bool apply_sets(ReverbEngine::Params& p, const EngineOptions& e) {
+    for (const auto& kv : e.sets) {
+        if (!bigpi::bench::setParamByName(p, kv.first, kv.second)) {
+            std::cerr << "Bad parameter: " << kv.first << "=" << kv.second << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  Mode preset first, then the user's overrides on top (in command-line order).
+
+  With --bank the program is loaded as-is (no coefficient design); only
+  --quality / --set overrides go through setParams() afterwards. The call
+  sequence mirrors prepareMode() + setParams() (reset() settles the
+  smoothers on the program, the last call re-arms the modulators), so
+  without overrides the output is bit-identical to --mode.
+*/
+static bool setup_engine(ReverbEngine& reverb, float sampleRate, const EngineOptions& e) {
+    if (e.bank) {
+        const PresetBank::Program* g = e.bank->find(e.program, sampleRate);
+        if (!g) {
+            std::cerr << "Bank has no programs for " << sampleRate << " Hz (built for:";
+            for (int r = 0; r < e.bank->rateCount(); ++r) std::cerr << " " << e.bank->rate(r);
+            std::cerr << ")\n";
+            return false;
+        }
+
+        ReverbEngine::Params p = g->params;
+        if (e.quality != "preset") p.tankLines = bigpi::bench::qualityLines(e.quality);
+        if (!apply_sets(p, e)) return false;
+
+        const bool overrides = (e.quality != "preset" || !e.sets.empty());
+
+        reverb.prepare(sampleRate, e.block);
+        reverb.loadProgram(*g);
+        if (e.quality != "preset") reverb.setParams(p);
+        reverb.reset();
+
+        if (overrides) reverb.setParams(p);
+        else reverb.loadProgram(*g);
+        return true;
+    }
+
+    ReverbEngine::Params p = bigpi::bench::prepareMode(reverb, sampleRate, e.block, e.mode, e.quality);
+    if (!apply_sets(p, e)) return false;
+    reverb.setParams(p);
+    return true;
+}
+
+// ============================================================================
+// render: stream a WAV file through the engine
+// ============================================================================
+
+struct RenderOptions {
+    std::string inPath;
+    std::string outPath;
+    EngineOptions engine;
+    std::string bits;                       // empty = same as the input
+    bool dither = false;
+    double tailSeconds = 3.0;
+    int threads = 3;
+};
+
+static bool parse_render_args(int argc, char** argv, RenderOptions& o) {
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        const bool hasValue = (i + 1 < argc);
+
+        if (a == "--dither") { o.dither = true; continue; }
+        if (!hasValue) {
+            std::cerr << "Missing value for " << a << "\n";
+            return false;
+        }
+
+        const std::string v = argv[++i];
+        const int eng = parse_engine_option(a, v, o.engine);
+        if (eng < 0) return false;
+        if (eng > 0) continue;
+
+        if (a == "--in") o.inPath = v;
+        else if (a == "--out") o.outPath = v;
+        else if (a == "--bits") o.bits = v;
+        else if (a == "--tail") o.tailSeconds = std::atof(v.c_str());
+        else if (a == "--threads") o.threads = std::atoi(v.c_str());
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return false;
+        }
+    }
+
+    if (o.inPath.empty() || o.outPath.empty()) {
+        std::cerr << "render needs --in and --out\n";
+        return false;
+    }
+    if (!finish_engine_options(o.engine)) return false;
+    if (o.threads != 1 && o.threads != 3) {
+        std::cerr << "--threads must be 1 or 3\n";
+        return false;
+    }
+    o.tailSeconds = std::max(0.0, o.tailSeconds);
+    return true;
+}
+
+/*
+  RenderChunk
+  -----------
+  One unit of work. The pool is allocated before rendering starts and the
+  same chunks are recycled until the end: no allocation while streaming.
+*/
+struct RenderChunk {
+    static constexpr size_t kFrames = 4096;
+
+    std::vector<float> inL, inR, outL, outR;
+    size_t frames = 0;
+    bool last = false;          // end of stream (frames may be 0)
+
+    RenderChunk() : inL(kFrames), inR(kFrames), outL(kFrames), outR(kFrames) {}
+};
+
+// Input side: a file (or a generated signal), then `tailLeft` frames of silence.
+struct RenderSource {
+    bigpi::bench::WavReader* reader = nullptr;
+    const std::vector<float>* genL = nullptr;
+    const std::vector<float>* genR = nullptr;
+    size_t genPos = 0;
+    uint64_t tailLeft = 0;
+
+    // Fills c.in*; sets c.last when there is nothing more to read.
+    void fill(RenderChunk& c) {
+        size_t n = 0;
+        if (reader) {
+            n = reader->read(c.inL.data(), c.inR.data(), RenderChunk::kFrames);
+        }
+        else if (genL && genR) {
+            n = std::min(RenderChunk::kFrames, genL->size() - genPos);
+            std::copy_n(genL->begin() + std::ptrdiff_t(genPos), n, c.inL.begin());
+            std::copy_n(genR->begin() + std::ptrdiff_t(genPos), n, c.inR.begin());
+            genPos += n;
+        }
+        if (n == 0 && tailLeft > 0) {
+            n = size_t(std::min<uint64_t>(RenderChunk::kFrames, tailLeft));
+            std::fill(c.inL.begin(), c.inL.begin() + n, 0.0f);
+            std::fill(c.inR.begin(), c.inR.begin() + n, 0.0f);
+            tailLeft -= n;
+        }
+        c.frames = n;
+        c.last = (n == 0);
+    }
+};
+
+struct RenderTiming {
+    uint64_t dspNs = 0;             // inside processBlock
+    uint64_t dspStarvedNs = 0;      // DSP thread waiting for input (I/O bound)
+    uint64_t readerStalls = 0;      // reader found no free chunk (back-pressure)
+    bool writeFailed = false;
+};
+
+static void process_chunk(ReverbEngine& reverb, RenderChunk& c, int block) {
+    for (size_t pos = 0; pos < c.frames; pos += size_t(block)) {
+        const int len = int(std::min(size_t(block), c.frames - pos));
+        reverb.processBlock(&c.inL[pos], &c.inR[pos], &c.outL[pos], &c.outR[pos], len);
+    }
+}
+
+static void render_serial(RenderSource& src, ReverbEngine& reverb, int block,
+    bigpi::bench::WavWriter& writer, RenderTiming& t)
+{
+    using bigpi::bench::nowNs;
+
+    RenderChunk c;
+    for (;;) {
+        src.fill(c);
+        if (c.last) break;
+
+        const uint64_t d0 = nowNs();
+        process_chunk(reverb, c, block);
+        t.dspNs += nowNs() - d0;
+
+        if (!writer.write(c.outL.data(), c.outR.data(), c.frames)) {
+            t.writeFailed = true;
+            return;
+        }
+    }
+}
+
+/*
+  render_pipelined
+  ----------------
+  reader thread:  free -> fill (file read + decode) -> filled
+  this thread:    filled -> processBlock -> done
+  writer thread:  done -> encode + file write -> free
+
+  Every ring can hold the whole pool, so a push never fails; only pops
+  wait. The I/O threads sleep briefly when they have nothing to do, the
+  DSP thread only yields (it never touches a file).
+*/
+static void render_pipelined(RenderSource& src, ReverbEngine& reverb, int block,
+    bigpi::bench::WavWriter& writer, RenderTiming& t)
+{
+    using namespace bigpi::bench;
+
+    constexpr size_t kPoolChunks = 8;
+    std::vector<RenderChunk> pool(kPoolChunks);
+
+    SpscRing<RenderChunk*> freeQ(kPoolChunks), filledQ(kPoolChunks), doneQ(kPoolChunks);
+    for (auto& c : pool) freeQ.tryPush(&c);
+
+    std::atomic<bool> abort{ false };
+    std::atomic<uint64_t> readerStalls{ 0 };
+
+    const auto ioWait = [] { std::this_thread::sleep_for(std::chrono::microseconds(100)); };
+
+    std::thread reader([&] {
+        uint64_t stalls = 0;
+        for (;;) {
+            RenderChunk* c = nullptr;
+            while (!freeQ.tryPop(c)) {
+                if (abort.load(std::memory_order_relaxed)) return;
+                ++stalls;
+                ioWait();
+            }
+            src.fill(*c);
+            filledQ.tryPush(c);
+            if (c->last) break;
+        }
+        readerStalls.store(stalls, std::memory_order_relaxed);
+    });
+
+    std::thread writerThread([&] {
+        for (;;) {
+            RenderChunk* c = nullptr;
+            while (!doneQ.tryPop(c)) {
+                if (abort.load(std::memory_order_relaxed)) return;
+                ioWait();
+            }
+            if (c->last) break;
+            if (!writer.write(c->outL.data(), c->outR.data(), c->frames)) {
+                t.writeFailed = true;
+                abort.store(true, std::memory_order_relaxed);
+                return;
+            }
+            freeQ.tryPush(c);
+        }
+    });
+
+    for (;;) {
+        RenderChunk* c = nullptr;
+        const uint64_t w0 = nowNs();
+        while (!filledQ.tryPop(c)) {
+            if (abort.load(std::memory_order_relaxed)) break;
+            std::this_thread::yield();
+        }
+        if (c == nullptr) break;
+        t.dspStarvedNs += nowNs() - w0;
+
+        const uint64_t d0 = nowNs();
+        process_chunk(reverb, *c, block);
+        t.dspNs += nowNs() - d0;
+
+        doneQ.tryPush(c);
+        if (c->last) break;
+    }
+
+    reader.join();
+    writerThread.join();
+    t.readerStalls = readerStalls.load(std::memory_order_relaxed);
+}
+
+static int run_render(const RenderOptions& o) {
+    using namespace bigpi::bench;
+
+    WavReader reader;
+    if (!reader.open(o.inPath)) {
+        std::cerr << "Cannot read " << o.inPath << ": " << reader.error() << "\n";
+        return 1;
+    }
+
+    SampleFormat outFormat = reader.format();
+    if (!o.bits.empty() && !sampleFormatFromString(o.bits, outFormat)) {
+        std::cerr << "Unknown --bits: " << o.bits << " (16 | 24 | 32 | f32)\n";
+        return 1;
+    }
+
+    const int sampleRate = reader.sampleRate();
+
+    ReverbEngine reverb;
+    if (!setup_engine(reverb, float(sampleRate), o.engine)) return 1;
+
+    WavWriter writer;
+    if (!writer.open(o.outPath, sampleRate, outFormat, o.dither)) {
+        std::cerr << "Cannot write " << o.outPath << "\n";
+        return 1;
+    }
+
+    std::cout << "Rendering " << o.inPath << " (" << reader.frames() << " frames, "
+              << sampleRate << " Hz, " << reader.channels() << " ch, "
+              << sampleFormatName(reader.format()) << ")\n"
+              << "  mode " << bigpi::modeToString(o.engine.mode) << ", block " << o.engine.block
+              << ", out " << sampleFormatName(outFormat) << (o.dither ? " + TPDF dither" : "") << "\n";
+
+    RenderSource src;
+    src.reader = &reader;
+    src.tailLeft = uint64_t(o.tailSeconds * double(sampleRate));
+    RenderTiming timing;
+
+    const uint64_t t0 = nowNs();
+    if (o.threads == 3) render_pipelined(src, reverb, o.engine.block, writer, timing);
+    else render_serial(src, reverb, o.engine.block, writer, timing);
+
+    if (timing.writeFailed) {
+        std::cerr << "Write failed: " << o.outPath << "\n";
+        return 1;
+    }
+    if (!writer.close()) {
+        std::cerr << "Write failed: " << o.outPath << "\n";
+        return 1;
+    }
+    if (!reader.error().empty()) {
+        std::cerr << "Read error: " << reader.error() << "\n";
+        return 1;
+    }
+
+    const double wallSec = double(nowNs() - t0) * 1e-9;
+    const double dspSec = double(timing.dspNs) * 1e-9;
+    const double audioSec = double(writer.framesWritten()) / double(sampleRate);
+    std::cout << "Wrote " << o.outPath << ": " << writer.framesWritten() << " frames ("
+              << audioSec << " s) in " << wallSec << " s, "
+              << (wallSec > 0.0 ? audioSec / wallSec : 0.0) << "x realtime\n"
+              << "  DSP " << dspSec << " s (" << (wallSec > 0.0 ? 100.0 * dspSec / wallSec : 0.0)
+              << "% of wall time), " << o.threads << " thread(s)";
+    if (o.threads == 3) {
+        std::cout << ", DSP waited for input " << double(timing.dspStarvedNs) * 1e-9
+                  << " s, reader back-pressure stalls " << timing.readerStalls;
+    }
+    std::cout << "\n";
+    return 0;
+}
+
+// ============================================================================
+// stream: raw PCM stdin -> engine -> stdout
+// ============================================================================
+
+/*
+  bigpi_test stream [--format f32|s16] [--rate 48000] [--channels 1|2]
+                    [--period 256] [--dither] [--report SECONDS]
+                    [engine options: --mode --quality --block --mix --decay
+                     --predelay --set]
+
+  Reads interleaved little-endian raw PCM from stdin one period at a time,
+  runs it through processBlock() (any period size: the engine splits it
+  into --block sized chunks itself) and writes the same format and channel
+  count to stdout. Mono output is the average of the stereo wet signal.
+
+    arecord -f FLOAT_LE -r 48000 -c 2 -t raw | bigpi_test stream | aplay -f FLOAT_LE -r 48000 -c 2 -t raw
+
+  stderr gets a status line every --report seconds of audio (0 = only the
+  final summary): per-period processing time (mean / max), load (max
+  processing time / period length), and:
+    late       periods whose processing alone took longer than the period
+               (this machine cannot keep up at this period size)
+    underruns  periods written more than one period behind the realtime
+               schedule (a device reading our stdout would have run dry);
+               the schedule restarts after each one. A file or generator
+               feeding faster than realtime never underruns.
+
+  Everything (stdio buffers included) is allocated before the first period;
+  the loop itself never allocates.
+*/
+
+struct StreamOptions {
+    EngineOptions engine;
+    bigpi::bench::SampleFormat format = bigpi::bench::SampleFormat::Float32;
+    int sampleRate = 48000;
+    int channels = 2;
+    int period = 256;
+    bool dither = false;
+    double reportSeconds = 1.0;
+};
+
+static bool parse_stream_args(int argc, char** argv, StreamOptions& o) {
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--dither") { o.dither = true; continue; }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << a << "\n";
+            return false;
+        }
+
+        const std::string v = argv[++i];
+        const int eng = parse_engine_option(a, v, o.engine);
+        if (eng < 0) return false;
+        if (eng > 0) continue;
+
+        if (a == "--format") {
+            if (v == "f32" || v == "float") o.format = bigpi::bench::SampleFormat::Float32;
+            else if (v == "s16") o.format = bigpi::bench::SampleFormat::Int16;
+            else {
+                std::cerr << "--format must be f32 or s16\n";
+                return false;
+            }
+        }
+        else if (a == "--rate") o.sampleRate = std::atoi(v.c_str());
+        else if (a == "--channels") o.channels = std::atoi(v.c_str());
+        else if (a == "--period") o.period = std::atoi(v.c_str());
+        else if (a == "--report") o.reportSeconds = std::max(0.0, std::atof(v.c_str()));
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return false;
+        }
+    }
+
+    if (o.sampleRate <= 0 || o.channels < 1 || o.channels > 2 || o.period < 1 || o.period > 65536) {
+        std::cerr << "Need --rate > 0, --channels 1|2, --period 1..65536\n";
+        return false;
+    }
+    return finish_engine_options(o.engine);
+}
+
+// fread until `bytes` arrived or EOF; a partial last period is zero-padded.
+static size_t read_period(unsigned char* dst, size_t bytes) {
+    size_t got = 0;
+    while (got < bytes) {
+        const size_t n = std::fread(dst + got, 1, bytes - got, stdin);
+        if (n == 0) break;
+        got += n;
+    }
+    if (got < bytes) std::memset(dst + got, 0, bytes - got);
+    return got;
+}
+
+static int run_stream(const StreamOptions& o) {
+    using namespace bigpi::bench;
+
+    const size_t frames = size_t(o.period);
+    const size_t ch = size_t(o.channels);
+    const size_t frameBytes = ch * size_t(bytesPerSample(o.format));
+    const size_t periodBytes = frames * frameBytes;
+
+    // ---- everything allocated up front ----
+    ReverbEngine reverb;
+    if (!setup_engine(reverb, float(o.sampleRate), o.engine)) return 1;
+
+    std::vector<unsigned char> inBytes(periodBytes), outBytes(periodBytes);
+    std::vector<float> inter(frames * ch);
+    std::vector<int32_t> scratch(frames * ch);
+    std::vector<float> inL(frames), inR(frames), outL(frames), outR(frames);
+    TpdfDither dither(o.dither);
+
+    // Our own stdio buffers: otherwise glibc mallocs them on first use.
+    // Static storage: stdio keeps them until exit (setvbuf() is only valid
+    // before the first operation on a stream, so they are never handed back).
+    // Sized for the largest period parse_stream_args() accepts.
+    static constexpr size_t kMaxPeriodBytes = size_t(65536) * 2 * 4;
+    static char stdinBuf[kMaxPeriodBytes];
+    static char stdoutBuf[kMaxPeriodBytes];
+    const size_t stdioBytes = std::max<size_t>(periodBytes, 4096);
+    std::setvbuf(stdin, stdinBuf, _IOFBF, stdioBytes);
+    std::setvbuf(stdout, stdoutBuf, _IOFBF, stdioBytes);
+
+    auto hist = std::make_unique<LatencyHistogram>();
+
+    const double periodNs = 1e9 * double(frames) / double(o.sampleRate);
+    const uint64_t reportPeriods = o.reportSeconds > 0.0
+        ? std::max<uint64_t>(1, uint64_t(o.reportSeconds * double(o.sampleRate) / double(frames)))
+        : 0;
+
+    std::fprintf(stderr, "bigpi stream: %s, %d Hz, %d ch, period %d (%.2f ms), mode %s, block %d\n",
+        o.format == SampleFormat::Float32 ? "f32" : "s16", o.sampleRate, o.channels, o.period,
+        periodNs * 1e-6, bigpi::modeToString(o.engine.mode), o.engine.block);
+
+    uint64_t periods = 0, late = 0, underruns = 0;
+    uint64_t winPeriods = 0, winSumNs = 0, winMaxNs = 0;
+    uint64_t scheduleStartNs = 0, schedulePeriods = 0;
+
+    for (;;) {
+        const size_t got = read_period(inBytes.data(), periodBytes);
+        if (got == 0) break;
+
+        const uint64_t t0 = nowNs();
+        if (schedulePeriods == 0) scheduleStartNs = t0;
+
+        decodeSamples(inBytes.data(), inter.data(), frames * ch, o.format, scratch.data());
+        for (size_t i = 0; i < frames; ++i) {
+            inL[i] = inter[i * ch];
+            inR[i] = inter[i * ch + (ch - 1)];
+        }
+
+        reverb.processBlock(inL.data(), inR.data(), outL.data(), outR.data(), o.period);
+
+        if (ch == 2) {
+            for (size_t i = 0; i < frames; ++i) {
+                inter[2 * i] = outL[i];
+                inter[2 * i + 1] = outR[i];
+            }
+        }
+        else {
+            for (size_t i = 0; i < frames; ++i) inter[i] = 0.5f * (outL[i] + outR[i]);
+        }
+        encodeSamples(inter.data(), outBytes.data(), frames * ch, o.format, &dither, scratch.data());
+
+        const uint64_t procNs = nowNs() - t0;
+
+        // A partial last period is written only up to the frames that came in.
+        const size_t outLen = (got / frameBytes) * frameBytes;
+        if (std::fwrite(outBytes.data(), 1, outLen, stdout) != outLen || std::fflush(stdout) != 0) {
+            std::fprintf(stderr, "bigpi stream: stdout closed\n");
+            break;
+        }
+
+        // Realtime schedule check, after the period actually left the process
+        ++schedulePeriods;
+        const double dueNs = double(scheduleStartNs) + double(schedulePeriods) * periodNs;
+        if (double(nowNs()) > dueNs + periodNs) {
+            ++underruns;
+            schedulePeriods = 0;
+        }
+
+        ++periods;
+        if (double(procNs) > periodNs) ++late;
+        hist->record(procNs);
+        ++winPeriods;
+        winSumNs += procNs;
+        winMaxNs = std::max(winMaxNs, procNs);
+
+        if (reportPeriods && winPeriods >= reportPeriods) {
+            std::fprintf(stderr, "[%8.1f s] proc mean %7.1f us  max %7.1f us  load %5.1f%%  late %llu  underruns %llu\n",
+                double(periods) * double(frames) / double(o.sampleRate),
+                double(winSumNs) / double(winPeriods) * 1e-3, double(winMaxNs) * 1e-3,
+                100.0 * double(winMaxNs) / periodNs,
+                (unsigned long long)late, (unsigned long long)underruns);
+            winPeriods = 0;
+            winSumNs = 0;
+            winMaxNs = 0;
+        }
+
+        if (got < periodBytes) break;
+    }
+
+    std::fprintf(stderr,
+        "bigpi stream: %llu periods (%.2f s), proc mean %.1f us, p99 %.1f us, max %.1f us "
+        "(period %.1f us), late %llu, underruns %llu\n",
+        (unsigned long long)periods, double(periods) * double(frames) / double(o.sampleRate),
+        hist->mean() * 1e-3, double(hist->percentile(0.99)) * 1e-3, double(hist->max()) * 1e-3,
+        periodNs * 1e-3, (unsigned long long)late, (unsigned long long)underruns);
+
+    std::fflush(stdout);
+    return 0;
+}
+
+// ============================================================================
+// batch: manifest of files x modes x parameter grid, on a worker pool
+// ============================================================================
+
+/*
+  Manifest format (plain text, one setting per line, # starts a comment):
+
+    inputs  = impulse, pluck, guitar.wav    generated signals or WAV files
+    modes   = Hall, Plate, Room             or: all
+    grid decay     = 0.5, 0.8, 0.95         every combination of every grid
+    grid dampingHz = 4000, 9000             line is rendered
+    set outWidth   = 1.2                    fixed override for every job
+    seconds = 6                             length of generated signals
+    tail    = 3                             silence appended to every input
+    sr      = 48000                         rate of generated signals
+    block   = 64
+    quality = preset                        eco | hq | preset
+    bits    = 24                            16 | 24 | 32 | f32
+    dither  = 0
+
+  Generated signals: impulse, burst, pluck, mixed (common/TestSignals.h).
+  Anything else in "inputs" is a WAV path (relative to the working folder).
+
+  Impulse jobs are deduplicated: the fully resolved settings (executable
+  fingerprint, rate, block, length, output format, every Params member) are
+  hashed, and jobs with the same hash are rendered once. The render is also
+  kept in the cache folder (default OUT_DIR/ir_cache) under that hash, so
+  the next batch run reuses it until the binary or any setting changes.
+  The fingerprint hashes the executable's own bytes: REVERB_BUILD_ID is set
+  by hand and stays the same across DSP edits. Where the executable cannot
+  be read (no /proc/self/exe) the cache folder is not used at all.
+*/
+
+struct BatchManifest {
+    std::vector<std::string> inputs;
+    std::vector<bigpi::Mode> modes;
+    std::vector<std::pair<std::string, std::vector<std::string>>> grid;
+    std::vector<std::pair<std::string, std::string>> sets;
+
+    int sampleRate = 48000;
+    double seconds = 6.0;
+    double tailSeconds = 3.0;
+    int block = 64;
+    std::string quality = "preset";
+    std::string bits = "24";
+    bool dither = false;
+};
+
+struct BatchJob {
+    std::string input;
+    bigpi::Mode mode = bigpi::Mode::Hall;
+    std::vector<std::pair<std::string, std::string>> point;    // this job's grid values
+    ReverbEngine::Params params;                                // fully resolved
+    std::string outPath;
+
+    // IR cache
+    std::string irHash;         // impulse jobs only
+    int duplicateOf = -1;       // same settings as an earlier job: copy its file
+    bool cacheHit = false;      // found in the cache folder: copy it
+
+    // Results (written by the worker that ran the job)
+    bool ok = false;
+    std::string error;
+    int worker = -1;
+    int sampleRate = 0;
+    uint64_t frames = 0;
+    double wallMs = 0.0;
+    double dspMs = 0.0;
+};
+
+static std::string trim_copy(const std::string& s) {
+    const size_t a = s.find_first_not_of(" \t\r");
+    if (a == std::string::npos) return "";
+    const size_t b = s.find_last_not_of(" \t\r");
+    return s.substr(a, b - a + 1);
+}
+
+static bool is_generated_signal(const std::string& name) {
+    return name == "impulse" || name == "burst" || name == "pluck" || name == "mixed";
+}
+
+static bool load_manifest(const std::string& path, BatchManifest& m) {
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "Cannot read manifest: " << path << "\n";
+        return false;
+    }
+
+    int lineNo = 0;
+    std::string line;
+    while (std::getline(f, line)) {
+        ++lineNo;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        line = trim_copy(line);
+        if (line.empty()) continue;
+
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << path << ":" << lineNo << ": expected KEY = VALUE\n";
+            return false;
+        }
+        std::string key = trim_copy(line.substr(0, eq));
+        std::vector<std::string> values;
+        for (const auto& v : bigpi::bench::parseCsvList(line.substr(eq + 1))) {
+            const std::string t = trim_copy(v);
+            if (!t.empty()) values.push_back(t);
+        }
+        if (values.empty()) {
+            std::cerr << path << ":" << lineNo << ": no value for " << key << "\n";
+            return false;
+        }
+
+        // "grid NAME" / "set NAME": check the name against Params right away
+        std::string param;
+        if (key.rfind("grid ", 0) == 0 || key.rfind("set ", 0) == 0) {
+            param = trim_copy(key.substr(key.find(' ')));
+            ReverbEngine::Params probe;
+            if (param == "mode" || !bigpi::bench::setParamByName(probe, param, values[0])) {
+                std::cerr << path << ":" << lineNo << ": bad parameter " << param << "\n";
+                return false;
+            }
+        }
+
+        if (key.rfind("grid ", 0) == 0) m.grid.emplace_back(param, values);
+        else if (key.rfind("set ", 0) == 0) m.sets.emplace_back(param, values[0]);
+        else if (key == "inputs") m.inputs = values;
+        else if (key == "modes") {
+            m.modes.clear();
+            for (const auto& v : values) {
+                if (v == "all") {
+                    for (int i = 0; i < int(bigpi::Mode::Count); ++i) m.modes.push_back(bigpi::Mode(i));
+                    continue;
+                }
+                bigpi::Mode mode;
+                if (!bigpi::modeFromString(v.c_str(), mode)) {
+                    std::cerr << path << ":" << lineNo << ": unknown mode " << v << "\n";
+                    return false;
+                }
+                m.modes.push_back(mode);
+            }
+        }
+        else if (key == "seconds") m.seconds = std::atof(values[0].c_str());
+        else if (key == "tail") m.tailSeconds = std::max(0.0, std::atof(values[0].c_str()));
+        else if (key == "sr") m.sampleRate = std::atoi(values[0].c_str());
+        else if (key == "block") m.block = std::atoi(values[0].c_str());
+        else if (key == "quality") m.quality = values[0];
+        else if (key == "bits") m.bits = values[0];
+        else if (key == "dither") m.dither = (values[0] == "1" || values[0] == "true" || values[0] == "on");
+        else {
+            std::cerr << path << ":" << lineNo << ": unknown key " << key << "\n";
+            return false;
+        }
+    }
+
+    bigpi::bench::SampleFormat fmt;
+    if (m.inputs.empty()) { std::cerr << "Manifest has no inputs\n"; return false; }
+    if (m.modes.empty()) m.modes.push_back(bigpi::Mode::Hall);
+    if (!bigpi::bench::isValidQuality(m.quality)) { std::cerr << "Bad quality: " << m.quality << "\n"; return false; }
+    if (!bigpi::bench::sampleFormatFromString(m.bits, fmt)) { std::cerr << "Bad bits: " << m.bits << "\n"; return false; }
+    if (m.block < 1 || m.block > 8192) { std::cerr << "block must be 1..8192\n"; return false; }
+    if (m.sampleRate <= 0 || m.seconds <= 0.0) { std::cerr << "sr and seconds must be > 0\n"; return false; }
+    return true;
+}
+
+// 64-bit FNV-1a: stable across runs and platforms (names cache files).
+static uint64_t fnv1a64(const std::string& s) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+// FNV-1a of this executable's bytes, computed once. Any rebuild that changes
+// the engine changes it. Empty when the executable cannot be read.
+static const std::string& binary_fingerprint() {
+    static const std::string id = [] {
+        std::ifstream f("/proc/self/exe", std::ios::binary);
+        if (!f) return std::string();
+
+        uint64_t h = 0xCBF29CE484222325ull;
+        std::vector<char> buf(1 << 16);
+        while (f.read(buf.data(), std::streamsize(buf.size())) || f.gcount() > 0) {
+            const std::streamsize n = f.gcount();
+            for (std::streamsize i = 0; i < n; ++i) {
+                h ^= uint8_t(buf[size_t(i)]);
+                h *= 0x100000001B3ull;
+            }
+        }
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)h);
+        return std::string(hex);
+    }();
+    return id;
+}
+
+// Everything that changes the rendered bytes of an impulse job.
+static std::string ir_cache_hash(const BatchManifest& m, const ReverbEngine::Params& p) {
+    std::ostringstream k;
+    k.precision(9);
+    k << REVERB_BUILD_ID << "|exe=" << binary_fingerprint() << "|sr=" << m.sampleRate << "|block=" << m.block
+      << "|seconds=" << m.seconds << "|tail=" << m.tailSeconds
+      << "|bits=" << m.bits << "|dither=" << m.dither
+      << "|mode=" << bigpi::modeToString(p.mode)
+      << "|inputDiffStages=" << p.inputDiffStages << "|tankLines=" << p.tankLines;
+    for (const auto& f : bigpi::bench::kFloatFields) k << "|" << f.name << "=" << p.*(f.member);
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)fnv1a64(k.str()));
+    return hex;
+}
+
+static std::string job_file_name(const BatchJob& j) {
+    std::string stem = is_generated_signal(j.input)
+        ? j.input
+        : std::filesystem::path(j.input).stem().string();
+
+    std::string name = stem + "_" + bigpi::modeToString(j.mode);
+    for (const auto& kv : j.point) name += "_" + kv.first + "-" + kv.second;
+
+    for (char& c : name) {
+        const bool keep = std::isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.';
+        if (!keep) c = '_';
+    }
+    return name + ".wav";
+}
+
+// Expands inputs x modes x grid and resolves every job's Params.
+static std::vector<BatchJob> plan_batch(const BatchManifest& m, const std::string& outDir) {
+    // Mode preset defaults, one prepare per mode
+    std::vector<std::pair<bigpi::Mode, ReverbEngine::Params>> defaults;
+    {
+        ReverbEngine tmp;
+        for (bigpi::Mode mode : m.modes) {
+            defaults.emplace_back(mode,
+                bigpi::bench::prepareMode(tmp, float(m.sampleRate), m.block, mode, m.quality));
+        }
+    }
+
+    size_t gridPoints = 1;
+    for (const auto& g : m.grid) gridPoints *= g.second.size();
+
+    std::vector<BatchJob> jobs;
+    for (const auto& input : m.inputs) {
+        for (const auto& d : defaults) {
+            for (size_t gi = 0; gi < gridPoints; ++gi) {
+                BatchJob j;
+                j.input = input;
+                j.mode = d.first;
+                j.params = d.second;
+
+                for (const auto& kv : m.sets) bigpi::bench::setParamByName(j.params, kv.first, kv.second);
+
+                // gi -> one value per grid axis (last axis varies fastest)
+                size_t rest = gi;
+                std::vector<std::pair<std::string, std::string>> point(m.grid.size());
+                for (size_t a = m.grid.size(); a-- > 0;) {
+                    const auto& axis = m.grid[a];
+                    point[a] = { axis.first, axis.second[rest % axis.second.size()] };
+                    rest /= axis.second.size();
+                }
+                for (const auto& kv : point) bigpi::bench::setParamByName(j.params, kv.first, kv.second);
+                j.point = std::move(point);
+
+                j.outPath = (std::filesystem::path(outDir) / job_file_name(j)).string();
+                if (input == "impulse") j.irHash = ir_cache_hash(m, j.params);
+                jobs.push_back(std::move(j));
+            }
+        }
+    }
+    return jobs;
+}
+
+// One job on the calling worker's engine.
+static void run_batch_job(const BatchManifest& m, BatchJob& j, ReverbEngine& reverb) {
+    using namespace bigpi::bench;
+
+    const uint64_t t0 = nowNs();
+
+    WavReader reader;
+    std::vector<float> genL, genR;
+    RenderSource src;
+    int sampleRate = m.sampleRate;
+
+    if (is_generated_signal(j.input)) {
+        const size_t n = size_t(m.seconds * double(m.sampleRate));
+        genL.assign(n, 0.0f);
+        genR.assign(n, 0.0f);
+        if (j.input == "impulse") {
+            genL[0] = 1.0f;
+            genR[0] = 1.0f;
+        }
+        else {
+            generateSignal(j.input, genL, genR, float(m.sampleRate), 1u);
+        }
+        src.genL = &genL;
+        src.genR = &genR;
+    }
+    else {
+        if (!reader.open(j.input)) {
+            j.error = "cannot read " + j.input + ": " + reader.error();
+            return;
+        }
+        sampleRate = reader.sampleRate();
+        src.reader = &reader;
+    }
+    src.tailLeft = uint64_t(m.tailSeconds * double(sampleRate));
+
+    // Preset for the mode, then the job's resolved params (same mode: no preset re-apply)
+    prepareMode(reverb, float(sampleRate), m.block, j.mode, m.quality);
+    reverb.setParams(j.params);
+
+    SampleFormat fmt = SampleFormat::Int24;
+    sampleFormatFromString(m.bits, fmt);
+
+    WavWriter writer;
+    if (!writer.open(j.outPath, sampleRate, fmt, m.dither)) {
+        j.error = "cannot write " + j.outPath;
+        return;
+    }
+
+    RenderTiming timing;
+    render_serial(src, reverb, m.block, writer, timing);
+    if (timing.writeFailed || !writer.close()) {
+        j.error = "write failed: " + j.outPath;
+        return;
+    }
+
+    j.sampleRate = sampleRate;
+    j.frames = writer.framesWritten();
+    j.dspMs = double(timing.dspNs) * 1e-6;
+    j.wallMs = double(nowNs() - t0) * 1e-6;
+    j.ok = true;
+}
+
+static bool copy_over(const std::string& from, const std::string& to, std::string& err) {
+    std::error_code ec;
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) err = "copy " + from + " -> " + to + ": " + ec.message();
+    return !ec;
+}
+
+static bool write_batch_csv(const std::string& path, const std::vector<BatchJob>& jobs) {
+    std::ofstream f(path);
+    if (!f) return false;
+
+    f << "job,input,mode,params,output,frames,audio_s,wall_ms,dsp_ms,realtime_x,worker,cache,status\n";
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& j = jobs[i];
+
+        std::string params;
+        for (const auto& kv : j.point) params += (params.empty() ? "" : " ") + kv.first + "=" + kv.second;
+
+        std::string cache = "render";
+        if (j.duplicateOf >= 0) cache = "dup:" + std::to_string(j.duplicateOf);
+        else if (j.cacheHit) cache = "hit";
+
+        const double audioSec = j.sampleRate > 0 ? double(j.frames) / double(j.sampleRate) : 0.0;
+        f << i << "," << j.input << "," << bigpi::modeToString(j.mode) << ",\"" << params << "\","
+          << j.outPath << "," << j.frames << "," << audioSec << "," << j.wallMs << "," << j.dspMs << ","
+          << (j.wallMs > 0.0 ? audioSec * 1000.0 / j.wallMs : 0.0) << "," << j.worker << ","
+          << cache << "," << (j.ok ? "ok" : "\"" + j.error + "\"") << "\n";
+    }
+    return bool(f);
+}
+
+static int run_batch(int argc, char** argv) {
+    std::string manifestPath, outDir, cacheDir;
+    int workers = int(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << a << "\n";
+            return 1;
+        }
+        const std::string v = argv[++i];
+        if (a == "--manifest") manifestPath = v;
+        else if (a == "--out-dir") outDir = v;
+        else if (a == "--cache") cacheDir = v;
+        else if (a == "--jobs") workers = std::max(1, std::atoi(v.c_str()));
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return 1;
+        }
+    }
+    if (manifestPath.empty() || outDir.empty()) {
+        std::cerr << "Usage: bigpi_test batch --manifest FILE --out-dir DIR [--jobs N] [--cache DIR]\n";
+        return 1;
+    }
+    if (cacheDir.empty()) cacheDir = (std::filesystem::path(outDir) / "ir_cache").string();
+
+    BatchManifest m;
+    if (!load_manifest(manifestPath, m)) return 1;
+
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    std::filesystem::create_directories(cacheDir, ec);
+    if (!std::filesystem::is_directory(outDir) || !std::filesystem::is_directory(cacheDir)) {
+        std::cerr << "Cannot create " << outDir << " / " << cacheDir << "\n";
+        return 1;
+    }
+
+    std::vector<BatchJob> jobs = plan_batch(m, outDir);
+
+    // The cache folder is only safe when the hash covers this binary
+    const bool useCacheDir = !binary_fingerprint().empty();
+    if (!useCacheDir) {
+        std::cout << "Note: cannot fingerprint this executable, the IR cache folder is not used\n";
+    }
+
+    // IR dedup: first job per hash renders (or copies from the cache folder),
+    // the rest copy its file once everything has rendered. A job listed twice
+    // (same output file) is also only run once.
+    std::vector<std::pair<std::string, int>> firstByHash;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        BatchJob& j = jobs[i];
+        for (size_t k = 0; k < i && j.duplicateOf < 0; ++k) {
+            if (jobs[k].outPath == j.outPath) j.duplicateOf = int(k);
+        }
+        if (j.irHash.empty() || j.duplicateOf >= 0) continue;
+
+        const auto it = std::find_if(firstByHash.begin(), firstByHash.end(),
+            [&](const auto& e) { return e.first == j.irHash; });
+        if (it != firstByHash.end()) {
+            j.duplicateOf = it->second;
+            continue;
+        }
+        firstByHash.emplace_back(j.irHash, int(i));
+        j.cacheHit = useCacheDir && std::filesystem::exists(std::filesystem::path(cacheDir) / (j.irHash + ".wav"));
+    }
+
+    size_t toRender = 0, primaries = 0;
+    for (const auto& j : jobs) {
+        primaries += (j.duplicateOf < 0) ? 1 : 0;
+        toRender += (j.duplicateOf < 0 && !j.cacheHit) ? 1 : 0;
+    }
+    workers = std::min(workers, int(std::max<size_t>(1, toRender)));
+
+    std::cout << "Batch: " << jobs.size() << " jobs (" << toRender << " to render, "
+              << (jobs.size() - toRender) << " from the IR cache) on " << workers << " worker(s)\n";
+    if (primaries > toRender) {
+        std::cout << "Note: " << (primaries - toRender) << " impulse render(s) reused from " << cacheDir
+                  << " (same executable " << binary_fingerprint() << " and settings)\n";
+    }
+
+    // Worker pool: each worker owns one engine and pulls job indices.
+    std::atomic<size_t> nextJob{ 0 };
+    std::atomic<size_t> finished{ 0 };
+    std::mutex printMutex;
+    const uint64_t t0 = bigpi::bench::nowNs();
+
+    const auto worker = [&](int id) {
+        ReverbEngine reverb;
+        for (;;) {
+            const size_t i = nextJob.fetch_add(1, std::memory_order_relaxed);
+            if (i >= jobs.size()) break;
+
+            BatchJob& j = jobs[i];
+            if (j.duplicateOf >= 0) continue;
+            j.worker = id;
+
+            const std::string cached = (std::filesystem::path(cacheDir) / (j.irHash + ".wav")).string();
+            if (j.cacheHit) {
+                j.ok = copy_over(cached, j.outPath, j.error);
+                bigpi::bench::WavReader r;
+                if (j.ok && r.open(j.outPath)) {
+                    j.sampleRate = r.sampleRate();
+                    j.frames = r.frames();
+                }
+            }
+            else {
+                run_batch_job(m, j, reverb);
+                std::string cacheErr;   // a failed cache store does not fail the job
+                if (j.ok && useCacheDir && !j.irHash.empty()) copy_over(j.outPath, cached, cacheErr);
+            }
+
+            const size_t done = finished.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::lock_guard<std::mutex> lock(printMutex);
+            std::cout << "[" << done << "/" << primaries << "] "
+                      << (j.ok ? "" : "FAILED ") << j.outPath
+                      << (j.cacheHit ? "  (cache)" : "")
+                      << (j.ok ? "" : "  " + j.error) << "\n";
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+
+    // Duplicates of IR jobs rendered above
+    for (auto& j : jobs) {
+        if (j.duplicateOf < 0) continue;
+        const BatchJob& src = jobs[size_t(j.duplicateOf)];
+        j.sampleRate = src.sampleRate;
+        j.frames = src.frames;
+        j.ok = src.ok && (src.outPath == j.outPath || copy_over(src.outPath, j.outPath, j.error));
+        if (!src.ok) j.error = "source job failed";
+    }
+
+    const double wallSec = double(bigpi::bench::nowNs() - t0) * 1e-9;
+    int failed = 0;
+    for (const auto& j : jobs) failed += j.ok ? 0 : 1;
+
+    const std::string csvPath = (std::filesystem::path(outDir) / "batch_timing.csv").string();
+    if (!write_batch_csv(csvPath, jobs)) {
+        std::cerr << "Cannot write " << csvPath << "\n";
+        return 1;
+    }
+
+    std::cout << "Done in " << wallSec << " s: " << (jobs.size() - size_t(failed)) << " ok, "
+              << failed << " failed. Timing: " << csvPath << "\n";
+    return failed ? 1 : 0;
+}
+
+// ============================================================================
+// bank: precomputed preset banks (dsp/engines/tune_hall/PresetBank.h)
+// ============================================================================
+
+/*
+  bigpi_test bank build --out FILE [--presets FILE] [--rates 44100,48000,96000]
+  bigpi_test bank list FILE
+
+  build renders every preset at every rate into one bank file (up to
+  PresetBank::kMaxRates rates, default 44100,48000,96000). Without
+  --presets the bank holds one program per mode, named after the mode,
+  with that mode's preset defaults.
+
+  Presets file: one [Name] section per program, then KEY = VALUE lines.
+  Blank lines and # comments are ignored.
+
+    [Big Hall]
+    mode = Hall            # applied first, with the mode's preset defaults
+    decay = 0.95           # then any ReverbEngine::Params member by name
+    dampingHz = 6500
+    quality = eco          # eco | hq | preset (= tankLines 8 / 16 / 0)
+
+  Programs are numbered in file order (--program takes the number or the
+  name). A bank only loads into a build with the same struct layout:
+  rebuild it after engine changes (list / --bank say so when needed).
+*/
+
+static bool load_presets(const std::string& path, std::vector<PresetBank::Entry>& out) {
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "Cannot read presets: " << path << "\n";
+        return false;
+    }
+
+    // Keys per section, applied once the section is complete (mode first).
+    struct Section {
+        std::string name;
+        int line = 0;
+        std::vector<std::pair<std::string, std::string>> keys;
+    };
+    std::vector<Section> sections;
+
+    int lineNo = 0;
+    std::string line;
+    while (std::getline(f, line)) {
+        ++lineNo;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        line = trim_copy(line);
+        if (line.empty()) continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                std::cerr << path << ":" << lineNo << ": expected [Name]\n";
+                return false;
+            }
+            sections.push_back({ trim_copy(line.substr(1, line.size() - 2)), lineNo, {} });
+            continue;
+        }
+
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos || sections.empty()) {
+            std::cerr << path << ":" << lineNo << ": expected [Name] or KEY = VALUE\n";
+            return false;
+        }
+        sections.back().keys.emplace_back(trim_copy(line.substr(0, eq)), trim_copy(line.substr(eq + 1)));
+    }
+
+    for (const Section& s : sections) {
+        ReverbEngine::Params p;
+        for (const auto& kv : s.keys) {
+            if (kv.first == "mode" && !bigpi::modeFromString(kv.second.c_str(), p.mode)) {
+                std::cerr << path << ": [" << s.name << "]: unknown mode " << kv.second << "\n";
+                return false;
+            }
+        }
+        p = ReverbEngine::withModePreset(p);
+
+        for (const auto& kv : s.keys) {
+            if (kv.first == "mode") continue;
+            if (kv.first == "quality") {
+                if (!bigpi::bench::isValidQuality(kv.second)) {
+                    std::cerr << path << ": [" << s.name << "]: bad quality " << kv.second << "\n";
+                    return false;
+                }
+                p.tankLines = bigpi::bench::qualityLines(kv.second);
+                continue;
+            }
+            if (!bigpi::bench::setParamByName(p, kv.first, kv.second)) {
+                std::cerr << path << ": [" << s.name << "]: bad parameter " << kv.first << " = " << kv.second << "\n";
+                return false;
+            }
+        }
+
+        PresetBank::Entry e;
+        e.name = s.name;
+        e.params = p;
+        out.push_back(e);
+    }
+
+    if (out.empty()) {
+        std::cerr << path << ": no [Name] sections\n";
+        return false;
+    }
+    return true;
+}
+
+static int run_bank_build(int argc, char** argv) {
+    std::string outPath, presetsPath;
+    std::string ratesArg = "44100,48000,96000";
+
+    for (int i = 3; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << a << "\n";
+            return 1;
+        }
+        const std::string v = argv[++i];
+        if (a == "--out") outPath = v;
+        else if (a == "--presets") presetsPath = v;
+        else if (a == "--rates") ratesArg = v;
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return 1;
+        }
+    }
+    if (outPath.empty()) {
+        std::cerr << "bank build needs --out FILE\n";
+        return 1;
+    }
+
+    std::vector<float> rates;
+    for (const auto& r : bigpi::bench::parseCsvList(ratesArg)) {
+        const std::string t = trim_copy(r);
+        if (!t.empty()) rates.push_back(float(std::atof(t.c_str())));
+    }
+
+    std::vector<PresetBank::Entry> entries;
+    if (!presetsPath.empty()) {
+        if (!load_presets(presetsPath, entries)) return 1;
+    }
+    else {
+        for (int m = 0; m < int(bigpi::Mode::Count); ++m) {
+            PresetBank::Entry e;
+            e.name = bigpi::modeToString(bigpi::Mode(m));
+            e.params.mode = bigpi::Mode(m);
+            e.params = ReverbEngine::withModePreset(e.params);
+            entries.push_back(e);
+        }
+    }
+
+    std::string err;
+    if (!PresetBank::write(outPath, entries, rates, err)) {
+        std::cerr << "bank build: " << err << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << outPath << ": " << entries.size() << " programs x " << rates.size()
+              << " rates, " << std::filesystem::file_size(outPath) << " bytes (build "
+              << REVERB_BUILD_ID << ")\n";
+    return 0;
+}
+
+static int run_bank_list(const std::string& path) {
+    PresetBank bank;
+    std::string err;
+    if (!bank.open(path, err)) {
+        std::cerr << "Cannot load bank " << err << "\n";
+        return 1;
+    }
+
+    std::cout << path << ": " << bank.programCount() << " programs, built by " << bank.buildId()
+              << (bank.isMapped() ? " (memory-mapped)" : "") << "\n  rates:";
+    for (int r = 0; r < bank.rateCount(); ++r) std::cout << " " << bank.rate(r);
+    std::cout << "\n\n";
+
+    for (int i = 0; i < bank.programCount(); ++i) {
+        const ReverbEngine::Program* g = bank.find(i, bank.rate(0));
+        std::printf("  %3d  %-31s %-11s mix %.2f  decay %.3f  damp %6.0f Hz  lines %2d\n", i, bank.name(i),
+            bigpi::modeToString(g->params.mode), double(g->params.mix), double(g->params.decay),
+            double(g->params.dampingHz), g->tank.cfg.lines);
+    }
+    return 0;
+}
+
+static int run_bank(int argc, char** argv) {
+    const std::string sub = (argc > 2) ? argv[2] : "";
+    if (sub == "build") return run_bank_build(argc, argv);
+    if (sub == "list" && argc == 4) return run_bank_list(argv[3]);
+
+    std::cerr << "Usage: bigpi_test bank build --out FILE [--presets FILE] [--rates 44100,48000,96000]\n"
+                 "       bigpi_test bank list FILE\n";
+    return 1;
+}
+
+// ============================================================================
+// rt: simulated hardware audio callback (period clock, SCHED_FIFO, deadlines)
+// ============================================================================
+
+/*
+  bigpi_test rt [--seconds 30] [--rate 48000] [--period 64] [--cpu N]
+                [--priority 80] [--signal mixed] [--json report.json]
+                [--governor on|off] [--burn PCT] [--burn-for SECONDS]
+                [--pc-every SECONDS] [--pc-via program|params]
+                [engine options: --mode --quality --block --mix --decay
+                 --predelay --set --bank --program]
+
+  Qualifies a build for underruns without audio hardware. A thread wakes
+  on an absolute CLOCK_MONOTONIC timer once per period, exactly like a
+  sound card interrupt would, and processes one period of a looped test
+  signal (common/TestSignals.h). The next period starts at the next timer
+  tick, so the deadline for each callback is the start of the following
+  period.
+
+  Setup (each step falls back with a note instead of failing):
+    mlockall()       no page faults on the audio path (needs CAP_IPC_LOCK or
+                     a big enough RLIMIT_MEMLOCK)
+    --cpu N          pins the audio thread to core N (e.g. an isolcpus core)
+    SCHED_FIFO       --priority 1..99 (needs CAP_SYS_NICE or rtprio in
+                     /etc/security/limits.conf); 0 = stay SCHED_OTHER
+
+  Reported at the end:
+    wake jitter      actual wake-up - scheduled period start
+    processing       time inside processBlock
+    completion       wake jitter + processing, as % of the period:
+                     > 100% is a deadline miss (= an underrun on hardware)
+    xruns            misses so late that whole periods were skipped; the
+                     period clock then restarts from "now", as a driver
+                     would after recovering from an underrun
+
+  CPU pressure (core/QualityGovernor.h):
+    --burn PCT       busy-waits PCT % of every period before processBlock, as
+                     if other plugins ran first in the same callback; the
+                     engine's deadline (setStatsDeadlineUs) shrinks to what
+                     is left
+    --burn-for S     only for the first S seconds (0 = whole run), so the
+                     governor's way back up is visible too
+    --governor on    lets the engine step its quality down and back up; the
+                     level, every decision and the time spent per level are
+                     reported at the end
+
+  Program changes (needs --bank):
+    --pc-every S     every S seconds the audio thread steps to the bank's
+                     next program, as a MIDI program change would
+    --pc-via program ReverbEngine::setProgram(): pointer swap, the engine
+                     only copies precomputed coefficients (default)
+    --pc-via params  setParams() with the same params: everything derived
+                     on the audio thread, for comparison
+                     Processing time of the change periods is reported
+                     separately.
+
+  Exit code 2 when any deadline was missed (handy in CI on the target).
+*/
+
+struct RtOptions {
+    EngineOptions engine;
+    double seconds = 30.0;
+    int sampleRate = 48000;
+    int period = 64;
+    int cpu = -1;
+    int priority = 80;
+    std::string signal = "mixed";
+    std::string jsonPath;
+    bool governor = false;
+    double burnPct = 0.0;
+    double burnSeconds = 0.0;
+    double pcEverySeconds = 0.0;
+    std::string pcVia = "program";
+};
+
+static bool parse_rt_args(int argc, char** argv, RtOptions& o) {
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << a << "\n";
+            return false;
+        }
+
+        const std::string v = argv[++i];
+        const int eng = parse_engine_option(a, v, o.engine);
+        if (eng < 0) return false;
+        if (eng > 0) continue;
+
+        if (a == "--seconds") o.seconds = std::atof(v.c_str());
+        else if (a == "--rate") o.sampleRate = std::atoi(v.c_str());
+        else if (a == "--period") o.period = std::atoi(v.c_str());
+        else if (a == "--cpu") o.cpu = std::atoi(v.c_str());
+        else if (a == "--priority") o.priority = std::atoi(v.c_str());
+        else if (a == "--signal") o.signal = v;
+        else if (a == "--json") o.jsonPath = v;
+        else if (a == "--governor") {
+            if (v != "on" && v != "off") {
+                std::cerr << "--governor takes on | off\n";
+                return false;
+            }
+            o.governor = (v == "on");
+        }
+        else if (a == "--burn") o.burnPct = std::atof(v.c_str());
+        else if (a == "--burn-for") o.burnSeconds = std::atof(v.c_str());
+        else if (a == "--pc-every") o.pcEverySeconds = std::atof(v.c_str());
+        else if (a == "--pc-via") {
+            if (v != "program" && v != "params") {
+                std::cerr << "--pc-via takes program | params\n";
+                return false;
+            }
+            o.pcVia = v;
+        }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return false;
+        }
+    }
+
+    if (o.seconds <= 0.0 || o.sampleRate <= 0 || o.period < 1 || o.period > 8192
+        || o.priority < 0 || o.priority > 99) {
+        std::cerr << "Need --seconds > 0, --rate > 0, --period 1..8192, --priority 0..99\n";
+        return false;
+    }
+    if (o.burnPct < 0.0 || o.burnPct >= 100.0 || o.burnSeconds < 0.0) {
+        std::cerr << "Need --burn 0..99 and --burn-for >= 0\n";
+        return false;
+    }
+    if (o.signal != "silence" && !is_generated_signal(o.signal)) {
+        std::cerr << "Unknown --signal: " << o.signal << " (impulse | burst | pluck | mixed | silence)\n";
+        return false;
+    }
+    if (o.pcEverySeconds < 0.0 || (o.pcEverySeconds > 0.0 && !o.engine.bank)) {
+        std::cerr << "--pc-every needs a value >= 0 and --bank FILE\n";
+        return false;
+    }
+    return finish_engine_options(o.engine);
+}
+
+/*
+  RtBins
+  ------
+  Coarse fixed-edge histogram for the end report (the LatencyHistograms
+  give the percentiles; this gives the shape at a glance).
+*/
+struct RtBins {
+    static constexpr int kBins = 9;
+    double edges[kBins - 1];
+    uint64_t counts[kBins] = {};
+
+    void record(double v) {
+        int b = 0;
+        while (b < kBins - 1 && v >= edges[b]) ++b;
+        ++counts[b];
+    }
+
+    void print(const char* title, const char* unit) const {
+        uint64_t total = 0;
+        for (uint64_t c : counts) total += c;
+        std::printf("  %s\n", title);
+        for (int b = 0; b < kBins; ++b) {
+            char range[48];
+            if (b == 0) std::snprintf(range, sizeof(range), "< %g %s", edges[0], unit);
+            else if (b == kBins - 1) std::snprintf(range, sizeof(range), ">= %g %s", edges[b - 1], unit);
+            else std::snprintf(range, sizeof(range), "%g .. %g %s", edges[b - 1], edges[b], unit);
+
+            const double pct = total ? 100.0 * double(counts[b]) / double(total) : 0.0;
+            const int bar = int(pct * 0.4 + 0.5);
+            std::printf("    %-20s %10llu  %6.2f%%  %s\n", range, (unsigned long long)counts[b], pct,
+                std::string(size_t(bar), '#').c_str());
+        }
+    }
+};
+
+#if defined(__linux__)
+
+static uint64_t timespec_ns(const timespec& t) {
+    return uint64_t(t.tv_sec) * 1000000000ull + uint64_t(t.tv_nsec);
+}
+
+static timespec ns_timespec(uint64_t ns) {
+    timespec t;
+    t.tv_sec = time_t(ns / 1000000000ull);
+    t.tv_nsec = long(ns % 1000000000ull);
+    return t;
+}
+
+static uint64_t monotonic_ns() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return timespec_ns(t);
+}
+
+struct RtResult {
+    bigpi::bench::LatencyHistogram jitter, proc, completion;
+    bigpi::bench::LatencyHistogram procChange, procSteady;     // --pc-every split
+    RtBins jitterBins{ { 5, 10, 25, 50, 100, 250, 500, 1000 } };         // us
+    RtBins loadBins{ { 25, 50, 75, 90, 100, 150, 200, 400 } };                     // % of period
+    uint64_t periods = 0;
+    uint64_t misses = 0;
+    uint64_t xruns = 0;
+    uint64_t skippedPeriods = 0;
+
+    std::string schedNote;
+    std::string affinityNote;
+};
+
+static void rt_audio_thread(const RtOptions& o, ReverbEngine& reverb,
+    const std::vector<float>& sigL, const std::vector<float>& sigR,
+    const std::vector<const ReverbEngine::Program*>& programs, RtResult& r)
+{
+    // ---- scheduling (before the first period) ----
+    if (o.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(o.cpu, &set);
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        r.affinityNote = err ? "pin to CPU " + std::to_string(o.cpu) + " failed (" + std::strerror(err) + ")"
+                             : "pinned to CPU " + std::to_string(o.cpu);
+    }
+    else {
+        r.affinityNote = "not pinned (use --cpu N)";
+    }
+
+    if (o.priority > 0) {
+        sched_param sp{};
+        sp.sched_priority = std::min(o.priority, sched_get_priority_max(SCHED_FIFO));
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+        r.schedNote = err ? std::string("SCHED_FIFO unavailable (") + std::strerror(err) + "), running SCHED_OTHER"
+                          : "SCHED_FIFO priority " + std::to_string(sp.sched_priority);
+    }
+    else {
+        r.schedNote = "SCHED_OTHER (--priority 0)";
+    }
+
+    const size_t frames = size_t(o.period);
+    std::vector<float> outL(frames), outR(frames);
+
+    const uint64_t periodNs = uint64_t(1e9 * double(frames) / double(o.sampleRate));
+    const uint64_t totalPeriods = uint64_t(o.seconds * double(o.sampleRate) / double(frames));
+    const size_t sigLen = sigL.size();
+    size_t sigPos = 0;
+
+    // Simulated neighbours: burnNs of every period belongs to someone else.
+    const uint64_t burnNs = uint64_t(double(periodNs) * o.burnPct * 0.01);
+    const uint64_t burnPeriods = (o.burnSeconds > 0.0)
+        ? uint64_t(o.burnSeconds * double(o.sampleRate) / double(frames)) : totalPeriods;
+
+    // Program changes: every pcPeriods periods, cycling through the bank
+    const uint64_t pcPeriods = (o.pcEverySeconds > 0.0 && !programs.empty())
+        ? std::max<uint64_t>(1, uint64_t(o.pcEverySeconds * double(o.sampleRate) / double(frames))) : 0;
+    size_t pcNext = (size_t(std::max(0, o.engine.program)) + 1) % std::max<size_t>(1, programs.size());
+
+    // Warm-up: a few untimed periods (first-touch of engine state, caches)
+    for (int w = 0; w < 16; ++w) {
+        reverb.processBlock(&sigL[0], &sigR[0], outL.data(), outR.data(), o.period);
+    }
+    reverb.resetStats();
+
+    uint64_t next = monotonic_ns() + periodNs;
+    for (uint64_t k = 0; k < totalPeriods; ++k) {
+        const timespec ts = ns_timespec(next);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+
+        const uint64_t wake = monotonic_ns();
+
+        if (burnNs > 0 && k <= burnPeriods) {
+            // Engine budget = what the neighbours leave (and back to all of it)
+            if (k == 0) reverb.setStatsDeadlineUs(float(double(periodNs - burnNs) * 1e-3));
+            if (k == burnPeriods) reverb.setStatsDeadlineUs(0.0f);
+            if (k < burnPeriods) {
+                while (monotonic_ns() < wake + burnNs) {}
+            }
+        }
+
+        const uint64_t procStart = monotonic_ns();
+        const bool change = pcPeriods && k > 0 && (k % pcPeriods) == 0;
+        if (change) {
+            // What a MIDI handler would do; the engine picks it up right below
+            if (o.pcVia == "params") reverb.setParams(programs[pcNext]->params);
+            else reverb.setProgram(programs[pcNext]);
+            pcNext = (pcNext + 1) % programs.size();
+        }
+        reverb.processBlock(&sigL[sigPos], &sigR[sigPos], outL.data(), outR.data(), o.period);
+        const uint64_t end = monotonic_ns();
+
+        sigPos += frames;
+        if (sigPos + frames > sigLen) sigPos = 0;
+
+        const uint64_t jitter = wake > next ? wake - next : 0;
+        const uint64_t done = end > next ? end - next : 0;
+        r.jitter.record(jitter);
+        r.proc.record(end - procStart);
+        if (pcPeriods) (change ? r.procChange : r.procSteady).record(end - procStart);
+        r.completion.record(done);
+        r.jitterBins.record(double(jitter) * 1e-3);
+        r.loadBins.record(100.0 * double(done) / double(periodNs));
+        ++r.periods;
+
+        next += periodNs;
+        if (done > periodNs) {
+            ++r.misses;
+            // Whole periods lost: restart the clock from now (driver recovery)
+            if (end > next + periodNs) {
+                ++r.xruns;
+                r.skippedPeriods += (end - next) / periodNs;
+                next = end + periodNs;
+            }
+        }
+    }
+}
+
+static int run_rt(const RtOptions& o) {
+    using namespace bigpi::bench;
+
+    // ---- everything allocated up front ----
+    ReverbEngine reverb;
+    if (!setup_engine(reverb, float(o.sampleRate), o.engine)) return 1;
+    reverb.setQualityGovernor(o.governor);
+
+    // 10 s of looped program material (at least a few periods)
+    const size_t sigLen = std::max(size_t(o.period) * 4, size_t(10 * o.sampleRate));
+    std::vector<float> sigL(sigLen, 0.0f), sigR(sigLen, 0.0f);
+    if (o.signal == "impulse") {
+        sigL[0] = 1.0f;
+        sigR[0] = 1.0f;
+    }
+    else if (o.signal != "silence") {
+        generateSignal(o.signal, sigL, sigR, float(o.sampleRate), 1u);
+    }
+
+    // Every bank program at this rate, resolved before the clock starts
+    std::vector<const ReverbEngine::Program*> programs;
+    if (o.engine.bank && o.pcEverySeconds > 0.0) {
+        for (int i = 0; i < o.engine.bank->programCount(); ++i) {
+            programs.push_back(o.engine.bank->find(i, float(o.sampleRate)));
+        }
+    }
+
+    auto result = std::make_unique<RtResult>();
+
+    const bool locked = (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+    const std::string lockNote = locked ? "memory locked" : std::string("mlockall failed (") + std::strerror(errno) + ")";
+
+    const double periodUs = 1e6 * double(o.period) / double(o.sampleRate);
+    std::cout << "Big Pi RT host: " << bigpi::modeToString(o.engine.mode) << ", " << o.sampleRate << " Hz, period "
+              << o.period << " (" << periodUs << " us), block " << o.engine.block << ", "
+              << o.seconds << " s of " << o.signal << "\n";
+    if (o.burnPct > 0.0) {
+        std::cout << "  burning " << o.burnPct << "% of each period";
+        if (o.burnSeconds > 0.0) std::cout << " for the first " << o.burnSeconds << " s";
+        std::cout << ", quality governor " << (o.governor ? "on" : "off") << "\n";
+    }
+    if (!programs.empty()) {
+        std::cout << "  program change every " << o.pcEverySeconds << " s via "
+                  << (o.pcVia == "params" ? "setParams()" : "setProgram()") << ", "
+                  << programs.size() << " programs\n";
+    }
+
+    std::thread audio(rt_audio_thread, std::cref(o), std::ref(reverb), std::cref(sigL), std::cref(sigR),
+        std::cref(programs), std::ref(*result));
+    audio.join();
+
+    if (locked) munlockall();
+
+    const RtResult& r = *result;
+    std::cout << "  " << r.schedNote << ", " << r.affinityNote << ", " << lockNote << "\n\n";
+
+    const auto row = [&](const char* name, const LatencyHistogram& h) {
+        std::printf("  %-12s p50 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f us\n", name,
+            double(h.percentile(0.50)) * 1e-3, double(h.percentile(0.99)) * 1e-3,
+            double(h.percentile(0.999)) * 1e-3, double(h.max()) * 1e-3);
+    };
+    row("wake jitter", r.jitter);
+    row("processing", r.proc);
+    row("completion", r.completion);
+    if (r.procChange.count() > 0) {
+        std::printf("\n  processing, %llu program-change periods vs the rest:\n",
+            (unsigned long long)r.procChange.count());
+        row("  change", r.procChange);
+        row("  steady", r.procSteady);
+    }
+    std::printf("\n");
+    r.jitterBins.print("wake jitter", "us");
+    r.loadBins.print("completion (% of period)", "%");
+
+    std::printf("\n  %llu periods, %llu deadline misses (%.4f%%), %llu xruns (%llu periods skipped)\n",
+        (unsigned long long)r.periods, (unsigned long long)r.misses,
+        r.periods ? 100.0 * double(r.misses) / double(r.periods) : 0.0,
+        (unsigned long long)r.xruns, (unsigned long long)r.skippedPeriods);
+
+    const bigpi::core::GovernorStats gov = reverb.getStats().governor;
+    if (o.governor) {
+        using bigpi::core::qualityLevelName;
+
+        uint64_t govBlocks = 0;
+        for (uint64_t b : gov.blocksAtLevel) govBlocks += b;
+
+        std::printf("\n  quality governor: level %s (deepest %s), %llu down / %llu up, "
+                    "load %.2f (peak %.2f), step-up hold %.0f ms\n",
+            qualityLevelName(gov.level), qualityLevelName(gov.maxLevel),
+            (unsigned long long)gov.stepDowns, (unsigned long long)gov.stepUps,
+            double(gov.load), double(gov.peakLoad), double(gov.upHoldMs));
+        for (int l = 0; l < bigpi::core::kNumQualityLevels; ++l) {
+            if (gov.blocksAtLevel[size_t(l)] == 0) continue;
+            std::printf("    %-16s %6.2f%% of blocks\n", qualityLevelName(l),
+                100.0 * double(gov.blocksAtLevel[size_t(l)]) / double(std::max<uint64_t>(1, govBlocks)));
+        }
+        if (gov.logCount > 0) std::printf("  last decisions:\n");
+        for (int i = 0; i < gov.logCount; ++i) {
+            const bigpi::core::GovernorDecision& d = gov.log[size_t(i)];
+            std::printf("    %9.3f s  %-16s -> %-16s %-9s load %.2f\n", double(d.atMs) * 1e-3,
+                qualityLevelName(d.from), qualityLevelName(d.to),
+                bigpi::core::governorReasonName(d.reason), double(d.load));
+        }
+    }
+
+    if (!o.jsonPath.empty()) {
+        JsonObject j;
+        j.str("mode", bigpi::modeToString(o.engine.mode))
+         .integer("sr", o.sampleRate).integer("period", o.period).integer("block", o.engine.block)
+         .str("signal", o.signal).num("seconds", o.seconds)
+         .str("sched", r.schedNote).str("affinity", r.affinityNote).integer("mlock", locked ? 1 : 0)
+         .integer("periods", int64_t(r.periods)).integer("misses", int64_t(r.misses))
+         .integer("xruns", int64_t(r.xruns)).integer("skipped_periods", int64_t(r.skippedPeriods))
+         .num("period_us", periodUs)
+         .num("jitter_p99_us", double(r.jitter.percentile(0.99)) * 1e-3)
+         .num("jitter_max_us", double(r.jitter.max()) * 1e-3)
+         .num("proc_p99_us", double(r.proc.percentile(0.99)) * 1e-3)
+         .num("proc_max_us", double(r.proc.max()) * 1e-3)
+         .num("completion_p99_us", double(r.completion.percentile(0.99)) * 1e-3)
+         .num("completion_max_us", double(r.completion.max()) * 1e-3)
+         .num("burn_pct", o.burnPct).num("burn_seconds", o.burnSeconds)
+         .integer("governor", o.governor ? 1 : 0)
+         .str("governor_level", bigpi::core::qualityLevelName(gov.level))
+         .str("governor_deepest", bigpi::core::qualityLevelName(gov.maxLevel))
+         .integer("governor_step_downs", int64_t(gov.stepDowns))
+         .integer("governor_step_ups", int64_t(gov.stepUps))
+         .num("governor_peak_load", double(gov.peakLoad))
+         .num("pc_every_seconds", o.pcEverySeconds).str("pc_via", o.pcVia)
+         .integer("program_changes", int64_t(r.procChange.count()))
+         .num("pc_proc_max_us", double(r.procChange.max()) * 1e-3)
+         .num("steady_proc_max_us", double(r.procSteady.max()) * 1e-3);
+
+        std::ofstream f(o.jsonPath);
+        writeJsonLines(f, { j.done() });
+        if (!f) {
+            std::cerr << "Cannot write " << o.jsonPath << "\n";
+            return 1;
+        }
+    }
+
+    return r.misses ? 2 : 0;
+}
+
+#else
+
+static int run_rt(const RtOptions&) {
+    std::cerr << "bigpi_test rt needs Linux (clock_nanosleep, SCHED_FIFO, mlockall).\n";
+    return 1;
+}
+
+#endif
+
 // ============================================================================
 // Main
 // ============================================================================
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "render") {
+        RenderOptions o;
+        if (!parse_render_args(argc, argv, o)) {
+            std::cerr << "Usage: bigpi_test render --in in.wav --out out.wav [--mode NAME] "
+                         "[--quality eco|hq|preset] [--mix X] [--decay X] [--predelay MS] "
+                         "[--set NAME=VALUE ...] [--bits 16|24|32|f32] [--dither] "
+                         "[--block N] [--tail SECONDS] [--threads 1|3] "
+                         "[--bank FILE --program N|NAME]\n";
+            return 1;
+        }
+        return run_render(o);
+    }
+    if (argc > 1 && std::string(argv[1]) == "batch") {
+        return run_batch(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "bank") {
+        return run_bank(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "rt") {
+        RtOptions o;
+        if (!parse_rt_args(argc, argv, o)) {
+            std::cerr << "Usage: bigpi_test rt [--seconds S] [--rate HZ] [--period N] [--cpu N] "
+                         "[--priority 0..99] [--signal impulse|burst|pluck|mixed|silence] [--json FILE] "
+                         "[--governor on|off] [--burn PCT] [--burn-for SECONDS] [--mode NAME] [--quality Q] [--block N] [--mix X] [--decay X] [--predelay MS] "
+                         "[--set NAME=VALUE ...] [--bank FILE --program N|NAME] [--pc-every SECONDS] [--pc-via program|params]\n";
+            return 1;
+        }
+        return run_rt(o);
+    }
+    if (argc > 1 && (std::string(argv[1]) == "stream" || std::string(argv[1]) == "--stream")) {
+        StreamOptions o;
+        if (!parse_stream_args(argc, argv, o)) {
+            std::cerr << "Usage: bigpi_test stream [--format f32|s16] [--rate HZ] [--channels 1|2] "
+                         "[--period N] [--dither] [--report SECONDS] [--mode NAME] [--quality Q] "
+                         "[--block N] [--mix X] [--decay X] [--predelay MS] [--set NAME=VALUE ...] "
+                         "[--bank FILE --program N|NAME]\n";
+            return 1;
+        }
+        return run_stream(o);
+    }
+
+    // Optional: --trace FILE (see header comment)
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: bigpi_test [--trace out.json]\n"
+                         "       bigpi_test render --in in.wav --out out.wav [options]\n"
+                         "       bigpi_test batch --manifest FILE --out-dir DIR [--jobs N] [--cache DIR]\n"
+                         "       bigpi_test stream [options] < in.raw > out.raw\n"
+                         "       bigpi_test rt [options]\n"
+                         "       bigpi_test bank build|list ...\n";
+            return 1;
+        }
+    }
+
     std::cout << "Big Pi  Modular Reverb Test Harness\n";
     std::cout << "Build: " << REVERB_BUILD_ID << "\n\n";
 
@@ -257,7 +2178,7 @@ int main() {
     const int blockSize = 64;
 
     std::vector<float> inL(numSamples), inR(numSamples);
-    std::vector<float> outL(numSamples), outR(numSamples);
+    std::vector<float> outL(blockSize), outR(blockSize);
 
     // Choose a test input (BEGINNER TIP: set ONE of these true)
     bool doImpulse = true;
@@ -350,25 +2271,59 @@ int main() {
     p.loudCompStrength = 0.50f;
     p.loudCompMaxDb = 9.0f;
 
+    // Tracing starts before setParams() so the param/mode markers show up too
+    auto& tracer = bigpi::trace::Tracer::instance();
+    if (!tracePath.empty()) {
+        tracer.init();
+        tracer.setThreadName("audio");
+        tracer.start();
+        tracer.startCollector();
+        if (!BIGPI_TRACE) {
+            std::cout << "Note: engine trace markers are compiled out "
+                         "(configure with -DBIGPI_ENABLE_TRACE=ON for stage detail).\n";
+        }
+    }
+
     reverb.setParams(p);
 
+    // Result goes straight to disk, block by block (mode + signal type in filename)
+    const std::string wavName = make_wav_name(p.mode, doImpulse, doToneBurst);
+
+    bigpi::bench::WavWriter wav;
+    if (!wav.open(wavName, sampleRate, bigpi::bench::SampleFormat::Int16)) {
+        std::cerr << "Failed to write WAV: cannot open " << wavName << "\n";
+        return 1;
+    }
+
     // Process in blocks
     std::cout << "Processing...\n";
 
     for (int pos = 0; pos < numSamples; pos += blockSize) {
         int n = std::min(blockSize, numSamples - pos);
 
+        tracer.begin("block", pos / blockSize);
         reverb.processBlock(
             &inL[pos], &inR[pos],
-            &outL[pos], &outR[pos],
+            outL.data(), outR.data(),
             n
         );
+        tracer.end("block");
+
+        wav.write(outL.data(), outR.data(), size_t(n));
     }
 
-    // Write result (mode + signal type in filename)
-    const std::string wavName = make_wav_name(p.mode, doImpulse, doToneBurst);
+    if (!tracePath.empty()) {
+        tracer.stop();
+        if (tracer.writeChromeJson(tracePath)) {
+            std::cout << "Wrote trace: " << tracePath
+                      << " (dropped events: " << tracer.droppedEvents() << ")\n";
+        }
+        else {
+            std::cerr << "Failed to write trace: " << tracePath << "\n";
+        }
+    }
 
-    if (write_wav_stereo_16(wavName, outL, outR, sampleRate)) {
+    if (wav.close()) {
         std::cout << "Wrote WAV: " << wavName << "\n";
         std::cout << "Tip: The WAV is in the folder you ran the program from.\n";
         std::cout << "Try switching p.mode and re-running to compare modes.\n";
@@ -0,0 +1,473 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/Version.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/IrAnalysis.h"
+#include "common/TestSignals.h"
+#include "common/WavIO.h"
+
+/*
+  =============================================================================
+  apps/regress/main.cpp — bigpi_regress (golden renders + accuracy gates)
+  =============================================================================
+
+  Why:
+    Every optimisation (fast math, SIMD, block tank, fp16 storage) changes
+    the output numerically. Before accepting a speed-up we need to know the
+    change is inaudible. This tool renders reference responses for every
+    mode and compares candidate renders against them.
+
+  Signals (per mode, wet only, mode preset defaults):
+    impulse  unit impulse L=R
+    burst    50 ms deterministic noise burst
+
+  Metrics (see common/IrAnalysis.h):
+    max_abs       largest sample difference
+    null_db       residual energy relative to the reference (dB)
+    rt60 / edt    worst relative difference over the octave bands (impulse)
+    echo density  absolute difference of the mean NED (impulse)
+
+  Gates:
+    Per-mode tolerances. Modes with heavy modulation/feedback chaos get a
+    looser null gate (tiny numeric changes decorrelate their late tail
+    without changing how they sound). Override any gate per mode with
+    --tolerances FILE (JSON, one object per line):
+      {"mode":"Shimmer","null_db":-10,"rt60_pct":8}
+    Keys: max_abs, null_db, rt60_pct, edt_pct, ned_abs.
+    --exact sets every gate to bit-exact (max_abs 0).
+
+  Commands:
+    bigpi_regress render  --out DIR        write golden WAVs (float32)
+    bigpi_regress compare --ref DIR --cand DIR
+    bigpi_regress check   --ref DIR        render in memory with this build
+                                           and compare against DIR
+
+    Common options: [--modes all|Hall,...] [--sr 48000] [--block 64]
+                    [--seconds 6] [--json report.json] [--tolerances FILE]
+                    [--exact]
+
+    compare/check exit with code 2 when any gate fails.
+
+  Note:
+    The DSP is float throughout (Dsp.h primitives are float-typed), so
+    there is no double-precision reference build; the golden renders are
+    the current scalar engine.
+*/
+
+using namespace bigpi::bench;
+
+// ============================================================================
+// Config
+// ============================================================================
+
+struct Tolerance {
+    double maxAbs = -1.0;    // < 0 = not gated (reported only)
+    double nullDb = -30.0;
+    double rt60Pct = 5.0;
+    double edtPct = 5.0;
+    double nedAbs = 0.05;
+};
+
+static Tolerance defaultTolerance(bigpi::Mode m) {
+    Tolerance t;
+    switch (m) {
+    case bigpi::Mode::Sky:
+    case bigpi::Mode::Blossom:
+    case bigpi::Mode::Shimmer:
+    case bigpi::Mode::Magnetic:
+    case bigpi::Mode::Granular:
+    case bigpi::Mode::Singularity:
+    case bigpi::Mode::MicroCosmic:
+        // Heavily modulated: late tails decorrelate on any numeric change
+        t.nullDb = -12.0;
+        t.rt60Pct = 8.0;
+        t.edtPct = 8.0;
+        break;
+    default:
+        break;
+    }
+    return t;
+}
+
+struct RegressOptions {
+    std::string command;
+    std::vector<bigpi::Mode> modes;
+
+    std::string outDir;
+    std::string refDir;
+    std::string candDir;
+
+    int sr = 48000;
+    int block = 64;
+    float seconds = 6.0f;
+
+    std::string jsonPath;
+    std::string tolerancePath;
+    bool exact = false;
+};
+
+static const char* kSignals[] = { "impulse", "burst" };
+
+static void printUsage() {
+    std::cout <<
+        "bigpi_regress render  --out DIR\n"
+        "bigpi_regress compare --ref DIR --cand DIR\n"
+        "bigpi_regress check   --ref DIR\n"
+        "options:\n"
+        "  --modes all|Name,Name    modes (default all)\n"
+        "  --sr 48000               sample rate\n"
+        "  --block 64               block size\n"
+        "  --seconds 6              render length\n"
+        "  --json PATH              write the comparison report\n"
+        "  --tolerances PATH        per-mode gate overrides\n"
+        "  --exact                  require bit-exact output\n";
+}
+
+static bool parseArgs(int argc, char** argv, RegressOptions& o) {
+    if (argc < 2) return false;
+    o.command = argv[1];
+    if (o.command == "--help" || o.command == "-h") { printUsage(); std::exit(0); }
+    if (o.command != "render" && o.command != "compare" && o.command != "check") {
+        std::cerr << "Unknown command: " << o.command << "\n";
+        return false;
+    }
+
+    for (int i = 0; i < int(bigpi::Mode::Count); ++i) o.modes.push_back(bigpi::Mode(i));
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](std::string& v) -> bool {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+            v = argv[++i];
+            return true;
+        };
+
+        std::string v;
+        if (a == "--modes") {
+            if (!next(v)) return false;
+            if (v != "all") {
+                o.modes.clear();
+                for (const auto& name : parseCsvList(v)) {
+                    bigpi::Mode m;
+                    if (!bigpi::modeFromString(name.c_str(), m)) { std::cerr << "Unknown mode: " << name << "\n"; return false; }
+                    o.modes.push_back(m);
+                }
+            }
+        }
+        else if (a == "--out") { if (!next(v)) return false; o.outDir = v; }
+        else if (a == "--ref") { if (!next(v)) return false; o.refDir = v; }
+        else if (a == "--cand") { if (!next(v)) return false; o.candDir = v; }
+        else if (a == "--sr") { if (!next(v)) return false; o.sr = std::max(8000, std::atoi(v.c_str())); }
+        else if (a == "--block") { if (!next(v)) return false; o.block = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--seconds") { if (!next(v)) return false; o.seconds = std::max(0.5f, float(std::atof(v.c_str()))); }
+        else if (a == "--json") { if (!next(v)) return false; o.jsonPath = v; }
+        else if (a == "--tolerances") { if (!next(v)) return false; o.tolerancePath = v; }
+        else if (a == "--exact") { o.exact = true; }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return false;
+        }
+    }
+
+    if (o.command == "render" && o.outDir.empty()) { std::cerr << "render needs --out DIR\n"; return false; }
+    if (o.command != "render" && o.refDir.empty()) { std::cerr << o.command << " needs --ref DIR\n"; return false; }
+    if (o.command == "compare" && o.candDir.empty()) { std::cerr << "compare needs --cand DIR\n"; return false; }
+    return !o.modes.empty();
+}
+
+static std::map<std::string, Tolerance> loadTolerances(const std::string& path, bool& ok) {
+    std::map<std::string, Tolerance> out;
+    ok = true;
+    if (path.empty()) return out;
+
+    std::ifstream f(path);
+    if (!f) { ok = false; return out; }
+
+    std::string line;
+    while (std::getline(f, line)) {
+        std::string mode;
+        if (!jsonField(line, "mode", mode)) continue;
+
+        bigpi::Mode m;
+        if (!bigpi::modeFromString(mode.c_str(), m)) continue;
+
+        Tolerance t = defaultTolerance(m);
+        std::string v;
+        if (jsonField(line, "max_abs", v)) t.maxAbs = std::atof(v.c_str());
+        if (jsonField(line, "null_db", v)) t.nullDb = std::atof(v.c_str());
+        if (jsonField(line, "rt60_pct", v)) t.rt60Pct = std::atof(v.c_str());
+        if (jsonField(line, "edt_pct", v)) t.edtPct = std::atof(v.c_str());
+        if (jsonField(line, "ned_abs", v)) t.nedAbs = std::atof(v.c_str());
+        out[mode] = t;
+    }
+    return out;
+}
+
+// ============================================================================
+// Rendering
+// ============================================================================
+
+static void makeSignal(const std::string& name, std::vector<float>& L, std::vector<float>& R, int sr) {
+    std::fill(L.begin(), L.end(), 0.0f);
+    std::fill(R.begin(), R.end(), 0.0f);
+
+    if (name == "impulse") {
+        L[0] = 1.0f;
+        R[0] = 1.0f;
+        return;
+    }
+
+    // burst: 50 ms of white noise with 2 ms fades
+    XorShift32 rng(0x60D1Du);
+    const size_t n = std::min(L.size(), size_t(0.05f * float(sr)));
+    const size_t fade = std::max<size_t>(1, size_t(0.002f * float(sr)));
+    for (size_t i = 0; i < n; ++i) {
+        float g = 0.5f;
+        if (i < fade) g *= float(i) / float(fade);
+        if (n - i < fade) g *= float(n - i) / float(fade);
+        L[i] = g * rng.bi();
+        R[i] = g * rng.bi();
+    }
+}
+
+static void renderOne(bigpi::Mode mode, const std::string& signal, const RegressOptions& o,
+    std::vector<float>& outL, std::vector<float>& outR)
+{
+    const size_t n = size_t(o.seconds * float(o.sr));
+    std::vector<float> inL(n), inR(n);
+    makeSignal(signal, inL, inR, o.sr);
+    outL.assign(n, 0.0f);
+    outR.assign(n, 0.0f);
+
+    ReverbEngine eng;
+    ReverbEngine::Params p = prepareMode(eng, float(o.sr), o.block, mode, "preset");
+    p.mix = 1.0f; // wet only: the dry path would dominate the metrics
+    eng.setParams(p);
+    eng.reset();
+
+    for (size_t pos = 0; pos < n; pos += size_t(o.block)) {
+        const int len = int(std::min(size_t(o.block), n - pos));
+        eng.processBlock(&inL[pos], &inR[pos], &outL[pos], &outR[pos], len);
+    }
+}
+
+static std::string wavPath(const std::string& dir, bigpi::Mode mode, const std::string& signal) {
+    return dir + "/" + bigpi::modeToString(mode) + "_" + signal + ".wav";
+}
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+struct CompareResult {
+    std::string mode;
+    std::string signal;
+    double maxAbs = 0.0;
+    double nullDb = 0.0;
+    double rt60Pct = 0.0;   // worst band, |relative difference| in %
+    double edtPct = 0.0;
+    double nedAbs = 0.0;
+    bool pass = true;
+    std::string failed;     // which gates failed
+};
+
+static double relPct(double ref, double cand) {
+    if (ref <= 0.0 && cand <= 0.0) return 0.0;
+    if (ref <= 0.0) return 100.0;
+    return 100.0 * std::abs(cand - ref) / ref;
+}
+
+static CompareResult compareOne(const std::string& mode, const std::string& signal,
+    const std::vector<float>& refL, const std::vector<float>& refR,
+    const std::vector<float>& candL, const std::vector<float>& candR,
+    float sr, const Tolerance& tol)
+{
+    CompareResult r;
+    r.mode = mode;
+    r.signal = signal;
+
+    r.maxAbs = std::max(maxAbsError(refL, candL), maxAbsError(refR, candR));
+
+    // Null test on both channels together
+    std::vector<float> ref(refL), cand(candL);
+    ref.insert(ref.end(), refR.begin(), refR.end());
+    cand.insert(cand.end(), candR.begin(), candR.end());
+    r.nullDb = nullResidualDb(ref, cand);
+
+    if (signal == "impulse") {
+        for (float fc : kOctaveBandsHz) {
+            if (fc * std::sqrt(2.0f) > 0.45f * sr) continue;
+
+            for (int ch = 0; ch < 2; ++ch) {
+                const auto bRef = octaveBand(ch ? refR : refL, fc, sr);
+                const auto bCand = octaveBand(ch ? candR : candL, fc, sr);
+                const DecayMetrics a = decayMetrics(bRef, sr);
+                const DecayMetrics b = decayMetrics(bCand, sr);
+                r.rt60Pct = std::max(r.rt60Pct, relPct(a.rt60, b.rt60));
+                r.edtPct = std::max(r.edtPct, relPct(a.edt, b.edt));
+            }
+        }
+
+        r.nedAbs = std::max(std::abs(meanEchoDensity(refL, sr) - meanEchoDensity(candL, sr)),
+            std::abs(meanEchoDensity(refR, sr) - meanEchoDensity(candR, sr)));
+    }
+
+    auto gate = [&](bool bad, const char* name) {
+        if (!bad) return;
+        r.pass = false;
+        if (!r.failed.empty()) r.failed += ",";
+        r.failed += name;
+    };
+
+    gate(tol.maxAbs >= 0.0 && r.maxAbs > tol.maxAbs, "max_abs");
+    gate(tol.maxAbs != 0.0 && r.nullDb > tol.nullDb, "null_db");
+    gate(r.rt60Pct > tol.rt60Pct, "rt60");
+    gate(r.edtPct > tol.edtPct, "edt");
+    gate(r.nedAbs > tol.nedAbs, "ned");
+    return r;
+}
+
+static int runCompare(const RegressOptions& o) {
+    bool tolOk = true;
+    const auto overrides = loadTolerances(o.tolerancePath, tolOk);
+    if (!tolOk) {
+        std::cerr << "Cannot read tolerances: " << o.tolerancePath << "\n";
+        return 1;
+    }
+
+    const bool inMemory = (o.command == "check");
+
+    std::printf("%-12s %-8s %12s %9s %8s %8s %8s  %s\n",
+        "mode", "signal", "max_abs", "null dB", "rt60 %", "edt %", "ned", "result");
+
+    std::vector<CompareResult> results;
+    int failures = 0;
+    int missing = 0;
+
+    for (bigpi::Mode mode : o.modes) {
+        const std::string name = bigpi::modeToString(mode);
+
+        Tolerance tol = defaultTolerance(mode);
+        auto it = overrides.find(name);
+        if (it != overrides.end()) tol = it->second;
+        if (o.exact) tol.maxAbs = 0.0;
+
+        for (const char* signal : kSignals) {
+            std::vector<float> refL, refR, candL, candR;
+            int refSr = 0, candSr = 0;
+
+            if (!readWav(wavPath(o.refDir, mode, signal), refL, refR, refSr)) {
+                std::printf("%-12s %-8s  missing reference\n", name.c_str(), signal);
+                missing++;
+                continue;
+            }
+
+            if (inMemory) {
+                RegressOptions ro = o;
+                ro.sr = refSr;
+                ro.seconds = float(refL.size()) / float(refSr);
+                renderOne(mode, signal, ro, candL, candR);
+                candSr = refSr;
+            }
+            else if (!readWav(wavPath(o.candDir, mode, signal), candL, candR, candSr)) {
+                std::printf("%-12s %-8s  missing candidate\n", name.c_str(), signal);
+                missing++;
+                continue;
+            }
+
+            if (candSr != refSr || candL.size() != refL.size()) {
+                std::printf("%-12s %-8s  format mismatch (sr/length)\n", name.c_str(), signal);
+                failures++;
+                continue;
+            }
+
+            const CompareResult r = compareOne(name, signal, refL, refR, candL, candR, float(refSr), tol);
+            if (!r.pass) failures++;
+
+            std::printf("%-12s %-8s %12.3g %9.1f %8.2f %8.2f %8.3f  %s%s\n",
+                r.mode.c_str(), r.signal.c_str(), r.maxAbs, r.nullDb, r.rt60Pct, r.edtPct, r.nedAbs,
+                r.pass ? "ok" : "FAIL ", r.failed.c_str());
+            results.push_back(r);
+        }
+    }
+
+    if (!o.jsonPath.empty()) {
+        std::vector<std::string> lines;
+        for (const auto& r : results) {
+            JsonObject j;
+            j.str("mode", r.mode)
+                .str("signal", r.signal)
+                .num("max_abs", r.maxAbs)
+                .num("null_db", std::isfinite(r.nullDb) ? r.nullDb : -999.0)
+                .num("rt60_pct", r.rt60Pct)
+                .num("edt_pct", r.edtPct)
+                .num("ned_abs", r.nedAbs)
+                .str("result", r.pass ? "ok" : r.failed);
+            lines.push_back(j.done());
+        }
+        std::ofstream f(o.jsonPath);
+        if (f) writeJsonLines(f, lines);
+        else std::cerr << "Cannot write " << o.jsonPath << "\n";
+    }
+
+    std::printf("\n%zu compared, %d failed, %d missing\n", results.size(), failures, missing);
+    return (failures > 0 || missing > 0) ? 2 : 0;
+}
+
+static int runRender(const RegressOptions& o) {
+    std::error_code ec;
+    std::filesystem::create_directories(o.outDir, ec);
+    if (!std::filesystem::is_directory(o.outDir)) {
+        std::cerr << "Cannot create " << o.outDir << "\n";
+        return 1;
+    }
+
+    int written = 0;
+    for (bigpi::Mode mode : o.modes) {
+        for (const char* signal : kSignals) {
+            std::vector<float> L, R;
+            renderOne(mode, signal, o, L, R);
+
+            const std::string path = wavPath(o.outDir, mode, signal);
+            if (!writeWavFloat32(path, L, R, o.sr)) {
+                std::cerr << "Cannot write " << path << "\n";
+                return 1;
+            }
+            written++;
+        }
+        std::printf("  rendered %s\n", bigpi::modeToString(mode));
+    }
+    std::printf("\nWrote %d golden renders to %s\n", written, o.outDir.c_str());
+    return 0;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    std::cout << "Big Pi — bigpi_regress\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n\n";
+
+    RegressOptions o;
+    if (!parseArgs(argc, argv, o)) {
+        printUsage();
+        return 1;
+    }
+
+    if (o.command == "render") return runRender(o);
+    return runCompare(o);
+}
@@ -0,0 +1,617 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core/Version.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/TestSignals.h"
+
+/*
+  =============================================================================
+  apps/rtcheck/main.cpp — bigpi_rtcheck (audio-thread real-time safety check)
+  =============================================================================
+
+  Why:
+    RoadMap Phase 0 says "Eliminate runtime allocations in audio path", but
+    nothing enforced it. On the pedal a single malloc, mutex wait or file
+    write inside the audio callback can block for longer than a block period.
+
+  How it works:
+    This executable defines its own malloc/free/calloc/realloc, aligned
+    allocation, operator new/delete, mutex/condvar/semaphore waits and the
+    common blocking syscalls (read/write/open/close/sleep/poll/select/
+    fsync/mmap/munmap). On Linux the executable's symbols win over libc's,
+    so every call in the process (engine, libstdc++, libc) lands here first.
+
+    Each replacement checks a thread-local flag. The harness raises the flag
+    around every ReverbEngine::processBlock() and setParams() call (setParams
+    runs on the audio thread on the pedal: mode changes reload the preset
+    there). Calls made with the flag down are forwarded untouched.
+
+    On a violation it prints what was called, which mode / automation
+    pattern / engine call was running, and a backtrace, then aborts (so a
+    debugger or core dump stops right at the offending call).
+    --keep-going reports every distinct call site instead and exits with
+    code 2 at the end.
+
+  Automation patterns (each run on every selected mode):
+    static      preset parameters, noise input
+    sweep       smooth parameter ramps, setParams() every block
+    random      random parameter jumps every block
+    modeswitch  a different mode every ~100 ms (preset reload path)
+    quality     Eco/HQ tank switch every ~100 ms (tank line count change)
+    freeze      freeze toggled every ~100 ms
+
+  Usage:
+    bigpi_rtcheck [--modes all|Hall,Room,...] [--patterns all|sweep,...]
+                  [--sr 48000] [--block 64] [--seconds 1.0] [--keep-going]
+    bigpi_rtcheck --self-test [--keep-going]
+
+    --self-test allocates, locks and writes inside a guarded scope to prove
+    the replacements are active in this build (it must report violations).
+
+  Notes:
+    - Linux/glibc only (uses dlsym(RTLD_NEXT) and __libc_malloc).
+    - prepare() and reset() are NOT guarded: they are allowed to allocate.
+    - Symbol names in backtraces need the executable's symbols exported
+      (CMake sets ENABLE_EXPORTS); use addr2line for file:line.
+*/
+
+using namespace bigpi::bench;
+
+// ============================================================================
+// Guard state
+// ============================================================================
+
+namespace rt {
+
+    // Plain PODs only: these are read from inside malloc.
+    static thread_local int tlActive = 0;       // > 0 while inside a guarded call
+    static thread_local int tlReporting = 0;    // re-entrancy stop while reporting
+
+    // What is running right now (static strings only, no allocation)
+    static thread_local const char* tlCall = "";
+    static const char* gMode = "";
+    static const char* gPattern = "";
+
+    static bool gKeepGoing = false;
+    static std::atomic<int> gViolations{ 0 };
+
+    // Distinct call sites already reported in --keep-going mode
+    constexpr int kMaxSites = 256;
+    static void* gSites[kMaxSites];
+    static int gSiteCount = 0;
+
+    class Scope {
+    public:
+        explicit Scope(const char* call) : prevCall(tlCall) { tlCall = call; ++tlActive; }
+        ~Scope() { --tlActive; tlCall = prevCall; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* prevCall;
+    };
+
+    // ------------------------------------------------------------------------
+    // Real functions (resolved with dlsym(RTLD_NEXT, ...))
+    // ------------------------------------------------------------------------
+
+    template <typename Fn>
+    static Fn next(const char* name) {
+        return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+    }
+
+#define BIGPI_RT_REAL(ret, name, args)                                   \
+    using name##_fn = ret (*) args;                                      \
+    static name##_fn real_##name() {                                     \
+        static name##_fn fn = next<name##_fn>(#name);                    \
+        return fn;                                                       \
+    }
+
+    BIGPI_RT_REAL(ssize_t, read, (int, void*, size_t))
+    BIGPI_RT_REAL(ssize_t, write, (int, const void*, size_t))
+    BIGPI_RT_REAL(int, open, (const char*, int, ...))
+    BIGPI_RT_REAL(int, close, (int))
+    BIGPI_RT_REAL(int, fsync, (int))
+    BIGPI_RT_REAL(int, nanosleep, (const struct timespec*, struct timespec*))
+    BIGPI_RT_REAL(int, clock_nanosleep, (clockid_t, int, const struct timespec*, struct timespec*))
+    BIGPI_RT_REAL(int, usleep, (useconds_t))
+    BIGPI_RT_REAL(unsigned, sleep, (unsigned))
+    BIGPI_RT_REAL(int, poll, (struct pollfd*, nfds_t, int))
+    BIGPI_RT_REAL(int, select, (int, fd_set*, fd_set*, fd_set*, struct timeval*))
+    BIGPI_RT_REAL(void*, mmap, (void*, size_t, int, int, int, off_t))
+    BIGPI_RT_REAL(int, munmap, (void*, size_t))
+    BIGPI_RT_REAL(int, pthread_mutex_lock, (pthread_mutex_t*))
+    BIGPI_RT_REAL(int, pthread_cond_wait, (pthread_cond_t*, pthread_mutex_t*))
+    BIGPI_RT_REAL(int, pthread_cond_timedwait, (pthread_cond_t*, pthread_mutex_t*, const struct timespec*))
+    BIGPI_RT_REAL(int, pthread_rwlock_rdlock, (pthread_rwlock_t*))
+    BIGPI_RT_REAL(int, pthread_rwlock_wrlock, (pthread_rwlock_t*))
+    BIGPI_RT_REAL(int, sem_wait, (sem_t*))
+
+#undef BIGPI_RT_REAL
+
+    // Resolve everything up front: dlsym() itself may allocate, which must
+    // not happen for the first time inside a guarded call.
+    static void resolveAll() {
+        real_read(); real_write(); real_open(); real_close(); real_fsync();
+        real_nanosleep(); real_clock_nanosleep(); real_usleep(); real_sleep();
+        real_poll(); real_select(); real_mmap(); real_munmap();
+        real_pthread_mutex_lock(); real_pthread_cond_wait(); real_pthread_cond_timedwait();
+        real_pthread_rwlock_rdlock(); real_pthread_rwlock_wrlock(); real_sem_wait();
+
+        // backtrace() loads libgcc's unwinder (and allocates) on first use
+        void* warm[4];
+        (void)backtrace(warm, 4);
+    }
+
+    // ------------------------------------------------------------------------
+    // Reporting (no allocation: raw write() to stderr)
+    // ------------------------------------------------------------------------
+
+    static void say(const char* s) {
+        if (real_write()) (void)real_write()(2, s, std::strlen(s));
+    }
+
+    static bool alreadyReported(void* site) {
+        for (int i = 0; i < gSiteCount; ++i) if (gSites[i] == site) return true;
+        if (gSiteCount < kMaxSites) gSites[gSiteCount++] = site;
+        return false;
+    }
+
+    // Called by every replacement. Cheap when the guard is down.
+    static inline void check(const char* what) {
+        if (tlActive <= 0 || tlReporting) return;
+
+        tlReporting = 1;
+        gViolations.fetch_add(1, std::memory_order_relaxed);
+
+        void* frames[48];
+        const int n = backtrace(frames, 48);
+
+        // frames[0] = check(), frames[1] = the replacement, frames[2] = caller
+        void* site = (n > 2) ? frames[2] : nullptr;
+        if (!gKeepGoing || !alreadyReported(site)) {
+            say("\n[rtcheck] REAL-TIME VIOLATION: ");
+            say(what);
+            say("\n[rtcheck]   inside ReverbEngine::");
+            say(tlCall);
+            say("()  mode=");
+            say(gMode);
+            say("  pattern=");
+            say(gPattern);
+            say("\n[rtcheck] backtrace:\n");
+            backtrace_symbols_fd(frames + 1, n - 1, 2);
+        }
+
+        tlReporting = 0;
+        if (!gKeepGoing) std::abort();
+    }
+
+} // namespace rt
+
+// ============================================================================
+// Replacements
+// ============================================================================
+
+extern "C" {
+
+    // glibc's allocator entry points (exported for exactly this purpose)
+    void* __libc_malloc(size_t);
+    void  __libc_free(void*);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+
+    void* malloc(size_t n) { rt::check("malloc"); return __libc_malloc(n); }
+    void  free(void* p) { if (p) rt::check("free"); __libc_free(p); }
+    void* calloc(size_t a, size_t b) { rt::check("calloc"); return __libc_calloc(a, b); }
+    void* realloc(void* p, size_t n) { rt::check("realloc"); return __libc_realloc(p, n); }
+    void* memalign(size_t al, size_t n) { rt::check("memalign"); return __libc_memalign(al, n); }
+    void* aligned_alloc(size_t al, size_t n) { rt::check("aligned_alloc"); return __libc_memalign(al, n); }
+
+    int posix_memalign(void** out, size_t al, size_t n) {
+        rt::check("posix_memalign");
+        void* p = __libc_memalign(al, n);
+        if (!p) return ENOMEM;
+        *out = p;
+        return 0;
+    }
+
+    ssize_t read(int fd, void* buf, size_t n) { rt::check("read"); return rt::real_read()(fd, buf, n); }
+    ssize_t write(int fd, const void* buf, size_t n) { rt::check("write"); return rt::real_write()(fd, buf, n); }
+    int close(int fd) { rt::check("close"); return rt::real_close()(fd); }
+    int fsync(int fd) { rt::check("fsync"); return rt::real_fsync()(fd); }
+
+    int open(const char* path, int flags, ...) {
+        rt::check("open");
+        mode_t mode = 0;
+        if (flags & (O_CREAT | O_TMPFILE)) {
+            va_list ap;
+            va_start(ap, flags);
+            mode = mode_t(va_arg(ap, int));
+            va_end(ap);
+        }
+        return rt::real_open()(path, flags, mode);
+    }
+
+    int nanosleep(const struct timespec* req, struct timespec* rem) {
+        rt::check("nanosleep");
+        return rt::real_nanosleep()(req, rem);
+    }
+
+    int clock_nanosleep(clockid_t clk, int flags, const struct timespec* req, struct timespec* rem) {
+        rt::check("clock_nanosleep");
+        return rt::real_clock_nanosleep()(clk, flags, req, rem);
+    }
+
+    int usleep(useconds_t us) { rt::check("usleep"); return rt::real_usleep()(us); }
+    unsigned sleep(unsigned s) { rt::check("sleep"); return rt::real_sleep()(s); }
+
+    int poll(struct pollfd* fds, nfds_t n, int timeout) {
+        rt::check("poll");
+        return rt::real_poll()(fds, n, timeout);
+    }
+
+    int select(int n, fd_set* r, fd_set* w, fd_set* e, struct timeval* t) {
+        rt::check("select");
+        return rt::real_select()(n, r, w, e, t);
+    }
+
+    void* mmap(void* addr, size_t len, int prot, int flags, int fd, off_t off) {
+        rt::check("mmap");
+        return rt::real_mmap()(addr, len, prot, flags, fd, off);
+    }
+
+    int munmap(void* addr, size_t len) { rt::check("munmap"); return rt::real_munmap()(addr, len); }
+
+    // Locks: only the calls that can wait. unlock/trylock never block.
+    int pthread_mutex_lock(pthread_mutex_t* m) {
+        rt::check("pthread_mutex_lock");
+        return rt::real_pthread_mutex_lock()(m);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* c, pthread_mutex_t* m) {
+        rt::check("pthread_cond_wait");
+        return rt::real_pthread_cond_wait()(c, m);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t) {
+        rt::check("pthread_cond_timedwait");
+        return rt::real_pthread_cond_timedwait()(c, m, t);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* l) {
+        rt::check("pthread_rwlock_rdlock");
+        return rt::real_pthread_rwlock_rdlock()(l);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* l) {
+        rt::check("pthread_rwlock_wrlock");
+        return rt::real_pthread_rwlock_wrlock()(l);
+    }
+
+    int sem_wait(sem_t* s) { rt::check("sem_wait"); return rt::real_sem_wait()(s); }
+
+} // extern "C"
+
+// operator new/delete would reach malloc/free anyway; replacing them makes
+// the report name the C++ allocation directly. Aligned forms fall through
+// to aligned_alloc/free above.
+void* operator new(size_t n) {
+    rt::check("operator new");
+    if (void* p = __libc_malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t n) {
+    rt::check("operator new[]");
+    if (void* p = __libc_malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    rt::check("operator new");
+    return __libc_malloc(n ? n : 1);
+}
+
+void* operator new[](size_t n, const std::nothrow_t&) noexcept {
+    rt::check("operator new[]");
+    return __libc_malloc(n ? n : 1);
+}
+
+void operator delete(void* p) noexcept { if (p) rt::check("operator delete"); __libc_free(p); }
+void operator delete[](void* p) noexcept { if (p) rt::check("operator delete[]"); __libc_free(p); }
+void operator delete(void* p, size_t) noexcept { if (p) rt::check("operator delete"); __libc_free(p); }
+void operator delete[](void* p, size_t) noexcept { if (p) rt::check("operator delete[]"); __libc_free(p); }
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+enum class Pattern : int {
+    Static = 0,
+    Sweep,
+    Random,
+    ModeSwitch,
+    Quality,
+    Freeze,
+
+    Count
+};
+
+static const char* patternName(Pattern p) {
+    switch (p) {
+    case Pattern::Static:     return "static";
+    case Pattern::Sweep:      return "sweep";
+    case Pattern::Random:     return "random";
+    case Pattern::ModeSwitch: return "modeswitch";
+    case Pattern::Quality:    return "quality";
+    case Pattern::Freeze:     return "freeze";
+    default:                  return "?";
+    }
+}
+
+static bool patternFromString(const std::string& s, Pattern& out) {
+    for (int i = 0; i < int(Pattern::Count); ++i) {
+        if (s == patternName(Pattern(i))) { out = Pattern(i); return true; }
+    }
+    return false;
+}
+
+struct RtCheckOptions {
+    std::vector<bigpi::Mode> modes;
+    std::vector<Pattern> patterns;
+    int sr = 48000;
+    int block = 64;
+    float seconds = 1.0f;
+    bool keepGoing = false;
+    bool selfTest = false;
+};
+
+static void printUsage() {
+    std::cout <<
+        "bigpi_rtcheck [options]\n"
+        "  --modes all|Name,Name        modes (default all)\n"
+        "  --patterns all|sweep,...     static,sweep,random,modeswitch,quality,freeze\n"
+        "  --sr 48000                   sample rate\n"
+        "  --block 64                   block size\n"
+        "  --seconds 1.0                audio per mode and pattern\n"
+        "  --keep-going                 report every call site instead of aborting\n"
+        "  --self-test                  trigger violations on purpose (checks the checker)\n";
+}
+
+static bool parseArgs(int argc, char** argv, RtCheckOptions& o) {
+    for (int i = 0; i < int(bigpi::Mode::Count); ++i) o.modes.push_back(bigpi::Mode(i));
+    for (int i = 0; i < int(Pattern::Count); ++i) o.patterns.push_back(Pattern(i));
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](std::string& v) -> bool {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+            v = argv[++i];
+            return true;
+        };
+
+        std::string v;
+        if (a == "--help" || a == "-h") { printUsage(); std::exit(0); }
+        else if (a == "--modes") {
+            if (!next(v)) return false;
+            if (v != "all") {
+                o.modes.clear();
+                for (const auto& name : parseCsvList(v)) {
+                    bigpi::Mode m;
+                    if (!bigpi::modeFromString(name.c_str(), m)) { std::cerr << "Unknown mode: " << name << "\n"; return false; }
+                    o.modes.push_back(m);
+                }
+            }
+        }
+        else if (a == "--patterns") {
+            if (!next(v)) return false;
+            if (v != "all") {
+                o.patterns.clear();
+                for (const auto& name : parseCsvList(v)) {
+                    Pattern p;
+                    if (!patternFromString(name, p)) { std::cerr << "Unknown pattern: " << name << "\n"; return false; }
+                    o.patterns.push_back(p);
+                }
+            }
+        }
+        else if (a == "--sr") { if (!next(v)) return false; o.sr = std::max(8000, std::atoi(v.c_str())); }
+        else if (a == "--block") { if (!next(v)) return false; o.block = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--seconds") { if (!next(v)) return false; o.seconds = std::max(0.05f, float(std::atof(v.c_str()))); }
+        else if (a == "--keep-going") { o.keepGoing = true; }
+        else if (a == "--self-test") { o.selfTest = true; }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            return false;
+        }
+    }
+    return !o.modes.empty() && !o.patterns.empty();
+}
+
+/*
+  automate()
+  ----------
+  Returns true (and edits p) when the pattern wants a setParams() call
+  before block number `blockIdx`. `every` is ~100 ms worth of blocks.
+*/
+static bool automate(Pattern pat, ReverbEngine::Params& p, bigpi::Mode base,
+    size_t blockIdx, size_t every, XorShift32& rng)
+{
+    switch (pat) {
+    case Pattern::Sweep: {
+        const float t = float(blockIdx % 512u) / 512.0f;
+        const float tri = (t < 0.5f) ? 2.0f * t : 2.0f - 2.0f * t;
+        p.mix = tri;
+        p.decay = 0.5f + 0.49f * tri;
+        p.predelayMs = 150.0f * tri;
+        p.dampingHz = 1500.0f + 15000.0f * tri;
+        p.modDepthMs = 12.0f * tri;
+        p.erSize = tri;
+        p.outDrive = tri;
+        return true;
+    }
+
+    case Pattern::Random:
+        p.mix = rng.uni();
+        p.decay = 0.5f + 0.5f * rng.uni();
+        p.predelayMs = 200.0f * rng.uni();
+        p.dampingHz = 1000.0f + 17000.0f * rng.uni();
+        p.modDepthMs = 20.0f * rng.uni();
+        p.modRateHz = 0.05f + 5.0f * rng.uni();
+        p.erLevel = rng.uni();
+        p.cloudFrontSizeMs = 120.0f * rng.uni();
+        p.stereoDepth = rng.uni();
+        return true;
+
+    case Pattern::ModeSwitch:
+        if (blockIdx % every != 0) return false;
+        p.mode = bigpi::Mode((int(base) + int(blockIdx / every)) % int(bigpi::Mode::Count));
+        return true;
+
+    case Pattern::Quality:
+        if (blockIdx % every != 0) return false;
+        p.tankLines = ((blockIdx / every) & 1u) ? 8 : 16;
+        return true;
+
+    case Pattern::Freeze:
+        if (blockIdx % every != 0) return false;
+        p.freeze = ((blockIdx / every) & 1u) ? 1.0f : 0.0f;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// Deliberate violations. volatile keeps the compiler from eliding new/delete.
+static void runSelfTest() {
+    rt::gMode = "-";
+    rt::gPattern = "self-test";
+
+    pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+    rt::Scope guard("processBlock");
+
+    int* volatile p = new int(42);
+    delete p;
+
+    pthread_mutex_lock(&m);
+    pthread_mutex_unlock(&m);
+
+    (void)write(2, "", 0);
+}
+
+static void runOne(bigpi::Mode mode, Pattern pat, const RtCheckOptions& o) {
+    rt::gMode = bigpi::modeToString(mode);
+    rt::gPattern = patternName(pat);
+
+    // Everything that may allocate happens here, outside the guard.
+    ReverbEngine eng;
+    ReverbEngine::Params p = prepareMode(eng, float(o.sr), o.block, mode, "preset");
+
+    std::vector<float> inL(static_cast<size_t>(o.block)), inR(static_cast<size_t>(o.block));
+    std::vector<float> outL(static_cast<size_t>(o.block)), outR(static_cast<size_t>(o.block));
+
+    XorShift32 rng(0xC0FFEEu + uint32_t(mode) * 131u + uint32_t(pat));
+    const size_t blocks = std::max<size_t>(1, size_t(o.seconds * float(o.sr)) / size_t(o.block));
+    const size_t every = std::max<size_t>(1, size_t(0.1f * float(o.sr)) / size_t(o.block));
+
+    for (size_t b = 0; b < blocks; ++b) {
+        // Noise with gaps, so tails, gates and envelopes all move
+        const bool on = ((b / every) % 4u) != 3u;
+        for (int i = 0; i < o.block; ++i) {
+            inL[size_t(i)] = on ? 0.5f * rng.bi() : 0.0f;
+            inR[size_t(i)] = on ? 0.5f * rng.bi() : 0.0f;
+        }
+
+        if (automate(pat, p, mode, b, every, rng)) {
+            rt::Scope guard("setParams");
+            eng.setParams(p);
+        }
+
+        // setParams() may have replaced preset fields; keep our copy in sync
+        // (outside the guard, the copy itself is allowed to do anything).
+        if (pat == Pattern::ModeSwitch && b % every == 0) p = eng.getParams();
+
+        {
+            rt::Scope guard("processBlock");
+            eng.processBlock(inL.data(), inR.data(), outL.data(), outR.data(), o.block);
+        }
+    }
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    rt::resolveAll();
+
+    std::cout << "Big Pi — bigpi_rtcheck\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n\n";
+
+    RtCheckOptions o;
+    if (!parseArgs(argc, argv, o)) {
+        printUsage();
+        return 1;
+    }
+    rt::gKeepGoing = o.keepGoing;
+
+    if (o.selfTest) {
+        runSelfTest();
+        const int found = rt::gViolations.load();
+        std::cout << "\nSelf-test: " << found << " violation(s) detected (expected 4)\n";
+        return (found == 4) ? 2 : 1;
+    }
+
+    for (bigpi::Mode mode : o.modes) {
+        std::cout << "  " << bigpi::modeToString(mode) << ":";
+        std::cout.flush();
+
+        for (Pattern pat : o.patterns) {
+            const int before = rt::gViolations.load();
+            runOne(mode, pat, o);
+            const int found = rt::gViolations.load() - before;
+
+            std::cout << " " << patternName(pat) << (found ? "(!)" : "");
+            std::cout.flush();
+        }
+        std::cout << "\n";
+    }
+
+    const int total = rt::gViolations.load();
+    if (total > 0) {
+        std::cout << "\nFAILED: " << total << " real-time violation(s) at "
+            << rt::gSiteCount << " distinct call site(s)\n";
+        return 2;
+    }
+
+    std::cout << "\nOK: no allocation, lock or blocking syscall inside processBlock()/setParams()\n";
+    return 0;
+}
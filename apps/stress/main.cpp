@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/Version.h"
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+#include "dsp/modes/Modes.h"
+
+#include "common/BenchStats.h"
+#include "common/EngineTiming.h"
+#include "common/TestSignals.h"
+
+/*
+  =============================================================================
+  apps/stress/main.cpp — bigpi_stress (worst-case block time per mode)
+  =============================================================================
+
+  Why:
+    On a pedal the average CPU does not matter, the worst block does.
+    bigpi_bench measures typical program material; this tool drives the
+    engine with the worst conditions we know of and keeps the tail of the
+    block-time distribution.
+
+  Scenarios (cycled per mode, each for --segment seconds, engine state
+  carries over between them so transitions are exercised too):
+    noise       full-scale white noise (+-1.0, uncorrelated L/R)
+    denormal    sparse impulses at/near FLT_MIN: tails decay through the
+                subnormal range where x87/SSE without FTZ gets slow
+    maxmod      modulation depth, rate and jitter at the Tank clamp limits
+    cloud       every Cloud feature on at maximum (wander, spray, smear,
+                dynamic diffusion, stereo depth, ducking, 8 input stages)
+    freeze      freeze on with noise, then silence while frozen
+    modeswitch  a random mode on every block (preset reload every block)
+    automation  randomised parameters on every block
+
+  In modeswitch/automation the setParams() call happens right before
+  processBlock() and is timed with it: on the pedal both run in the same
+  audio callback.
+
+  What it reports per mode:
+    - p50 / p99.9 / p99.99 / max block time
+    - max block time as % of the block period (the real per-mode budget,
+      RoadMap Phase 2 "block-level performance budget")
+    - max per scenario, and which scenario produced the worst block
+    - numeric health incidents (NaN/Inf or runaway tank resets), if any
+
+  Usage:
+    bigpi_stress [--modes all|Hall,Room,...] [--sr 48000] [--block 64]
+                 [--quality hq|eco|preset] [--hours 0.01] [--segment 1.0]
+                 [--seed N] [--json bigpi_stress.json]
+
+    --hours is simulated audio per mode (1.0 = one hour of audio per mode).
+
+  Tip:
+    Build with -DCMAKE_BUILD_TYPE=Release, pin the CPU governor to
+    "performance" and keep the machine otherwise idle.
+*/
+
+using namespace bigpi::bench;
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+enum class Scenario : int {
+    Noise = 0,
+    Denormal,
+    MaxMod,
+    Cloud,
+    Freeze,
+    ModeSwitch,
+    Automation,
+
+    Count
+};
+
+static constexpr int kNumScenarios = int(Scenario::Count);
+
+static const char* scenarioName(Scenario s) {
+    switch (s) {
+    case Scenario::Noise:      return "noise";
+    case Scenario::Denormal:   return "denormal";
+    case Scenario::MaxMod:     return "maxmod";
+    case Scenario::Cloud:      return "cloud";
+    case Scenario::Freeze:     return "freeze";
+    case Scenario::ModeSwitch: return "modeswitch";
+    case Scenario::Automation: return "automation";
+    default:                   return "unknown";
+    }
+}
+
+// Parameters for a scenario, starting from the mode's own defaults.
+static ReverbEngine::Params scenarioParams(Scenario s, const ReverbEngine::Params& base, float sr) {
+    ReverbEngine::Params p = base;
+
+    switch (s) {
+    case Scenario::MaxMod:
+        // Tank clamps: depth <= 2000 samples, rate <= 20 Hz, jitter <= 2.0
+        p.modDepthMs = 2000.0f * 1000.0f / sr;
+        p.modRateHz = 20.0f;
+        p.modJitterEnable = 1.0f;
+        p.modJitterAmount = 2.0f;
+        p.modJitterRateHz = 20.0f;
+        p.modJitterSmoothMs = 1.0f;
+        break;
+
+    case Scenario::Cloud:
+        p.cloudEnable = 1.0f;
+        p.cloudWanderAmount = 1.0f;
+        p.cloudWanderRateHz = 2.0f;
+        p.cloudFrontEnable = 1.0f;
+        p.cloudFrontAmount = 1.0f;
+        p.cloudFrontSizeMs = 120.0f;
+        p.cloudFrontWidth = 1.0f;
+        p.cloudSmearEnable = 1.0f;
+        p.cloudSmearAmount = 1.0f;
+        p.cloudSmearTimeMs = 60.0f;
+        p.cloudSmearWidth = 1.0f;
+        p.dynDiffEnable = 1.0f;
+        p.dynDiffTailBoost = 1.0f;
+        p.dynDiffTransientReduce = 1.0f;
+        p.dynDiffLateBoost = 1.0f;
+        p.lateDiffEnable = 1.0f;
+        p.lateDiffAmount = 1.0f;
+        p.inputDiffStages = 8;
+        p.stereoDepth = 1.0f;
+        p.duckEnable = 1.0f;
+        break;
+
+    case Scenario::Freeze:
+        p.freeze = 1.0f;
+        p.decay = 1.0f;
+        break;
+
+    default:
+        break;
+    }
+    return p;
+}
+
+// Random but bounded automation values (per block).
+static void randomiseParams(ReverbEngine::Params& p, XorShift32& rng) {
+    p.mix = rng.uni();
+    p.decay = 0.5f + 0.5f * rng.uni();
+    p.predelayMs = 200.0f * rng.uni();
+    p.dampingHz = 1000.0f + 17000.0f * rng.uni();
+    p.modDepthMs = 20.0f * rng.uni();
+    p.modRateHz = 0.05f + 5.0f * rng.uni();
+    p.erSize = rng.uni();
+    p.erLevel = rng.uni();
+    p.cloudFrontSizeMs = 120.0f * rng.uni();
+    p.cloudSmearTimeMs = 60.0f * rng.uni();
+    p.outDrive = rng.uni();
+    p.stereoDepth = rng.uni();
+}
+
+/*
+  fillInput()
+  -----------
+  Writes one block of scenario input. `pos` is the sample index inside the
+  current segment, `segLen` its length.
+*/
+static void fillInput(Scenario s, float* L, float* R, int n, size_t pos, size_t segLen, XorShift32& rng) {
+    switch (s) {
+    case Scenario::Denormal: {
+        // Impulses every ~85 ms at 48 kHz, amplitudes around the normal/subnormal
+        // boundary, silence in between so the tail decays into subnormals.
+        static const float kAmps[4] = { FLT_MIN, 4.0f * FLT_MIN, 1.0e-30f, 1.0e-20f };
+        for (int i = 0; i < n; ++i) {
+            const size_t k = pos + size_t(i);
+            const bool hit = (k & 4095u) == 0;
+            const float a = hit ? kAmps[(k >> 12) & 3u] : 0.0f;
+            L[i] = a;
+            R[i] = (k & 8192u) ? -a : a;
+        }
+        break;
+    }
+
+    case Scenario::Freeze:
+        // Noise into the frozen tank for the first quarter, then silence.
+        for (int i = 0; i < n; ++i) {
+            const bool on = (pos + size_t(i)) < segLen / 4;
+            L[i] = on ? rng.bi() : 0.0f;
+            R[i] = on ? rng.bi() : 0.0f;
+        }
+        break;
+
+    default:
+        // Full-scale white noise
+        for (int i = 0; i < n; ++i) {
+            L[i] = rng.bi();
+            R[i] = rng.bi();
+        }
+        break;
+    }
+}
+
+// ============================================================================
+// Config
+// ============================================================================
+
+struct StressOptions {
+    std::vector<bigpi::Mode> modes;
+    int sr = 48000;
+    int block = 64;
+    std::string quality = "hq";
+
+    double hours = 0.01;        // simulated audio per mode
+    double segmentSeconds = 1.0;
+
+    uint32_t seed = 0x5EEDu;
+    std::string jsonPath = "bigpi_stress.json";
+};
+
+static void printUsage() {
+    std::cout <<
+        "bigpi_stress options:\n"
+        "  --modes all|Name,Name    modes to run (default all)\n"
+        "  --sr 48000               sample rate\n"
+        "  --block 64               block size\n"
+        "  --quality hq|eco|preset  tank line count\n"
+        "  --hours H                simulated audio per mode (default 0.01)\n"
+        "  --segment S              seconds per scenario segment (default 1)\n"
+        "  --seed N                 RNG seed\n"
+        "  --json PATH              JSON report path (default bigpi_stress.json)\n";
+}
+
+static bool parseArgs(int argc, char** argv, StressOptions& o) {
+    for (int i = 0; i < int(bigpi::Mode::Count); ++i) o.modes.push_back(bigpi::Mode(i));
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](std::string& v) -> bool {
+            if (i + 1 >= argc) { std::cerr << "Missing value for " << a << "\n"; return false; }
+            v = argv[++i];
+            return true;
+        };
+
+        std::string v;
+        if (a == "--help" || a == "-h") { printUsage(); std::exit(0); }
+        else if (a == "--modes") {
+            if (!next(v)) return false;
+            if (v != "all") {
+                o.modes.clear();
+                for (const auto& name : parseCsvList(v)) {
+                    bigpi::Mode m;
+                    if (!bigpi::modeFromString(name.c_str(), m)) { std::cerr << "Unknown mode: " << name << "\n"; return false; }
+                    o.modes.push_back(m);
+                }
+            }
+        }
+        else if (a == "--sr") { if (!next(v)) return false; o.sr = std::max(8000, std::atoi(v.c_str())); }
+        else if (a == "--block") { if (!next(v)) return false; o.block = std::max(1, std::atoi(v.c_str())); }
+        else if (a == "--quality") {
+            if (!next(v)) return false;
+            if (!isValidQuality(v)) { std::cerr << "Unknown quality: " << v << "\n"; return false; }
+            o.quality = v;
+        }
+        else if (a == "--hours") { if (!next(v)) return false; o.hours = std::max(1.0e-4, std::atof(v.c_str())); }
+        else if (a == "--segment") { if (!next(v)) return false; o.segmentSeconds = std::max(0.05, std::atof(v.c_str())); }
+        else if (a == "--seed") { if (!next(v)) return false; o.seed = uint32_t(std::strtoul(v.c_str(), nullptr, 0)); }
+        else if (a == "--json") { if (!next(v)) return false; o.jsonPath = v; }
+        else {
+            std::cerr << "Unknown option: " << a << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return !o.modes.empty();
+}
+
+// ============================================================================
+// Run one mode
+// ============================================================================
+
+struct ModeResult {
+    std::string mode;
+    LatencyHistogram all;
+    std::array<uint64_t, kNumScenarios> scenarioMaxNs{};
+    Scenario worst = Scenario::Noise;
+    double simulatedSeconds = 0.0;
+
+    // Numeric health incidents (NaN/Inf, runaway) seen by the engine
+    uint64_t nonFiniteResets = 0;
+    uint64_t runawayResets = 0;
+};
+
+static void runMode(bigpi::Mode mode, const StressOptions& o, ModeResult& res) {
+    const float sr = float(o.sr);
+    const int block = o.block;
+
+    ReverbEngine eng;
+    const ReverbEngine::Params base = prepareMode(eng, sr, block, mode, o.quality);
+
+    XorShift32 rng(o.seed ^ (uint32_t(int(mode)) * 0x9E3779B9u));
+
+    std::vector<float> inL(static_cast<size_t>(block)), inR(static_cast<size_t>(block));
+    std::vector<float> outL(static_cast<size_t>(block)), outR(static_cast<size_t>(block));
+
+    const size_t segLen = size_t(o.segmentSeconds * double(o.sr));
+    const double totalSamples = o.hours * 3600.0 * double(o.sr);
+
+    res.mode = bigpi::modeToString(mode);
+
+    double done = 0.0;
+    double nextReport = 600.0 * double(o.sr); // progress every 10 simulated minutes
+    int seg = 0;
+
+    while (done < totalSamples) {
+        const Scenario sc = Scenario(seg % kNumScenarios);
+        seg++;
+
+        ReverbEngine::Params p = scenarioParams(sc, base, sr);
+        eng.setParams(p);
+
+        for (size_t pos = 0; pos < segLen; pos += size_t(block)) {
+            const int n = int(std::min<size_t>(size_t(block), segLen - pos));
+            fillInput(sc, inL.data(), inR.data(), n, pos, segLen, rng);
+
+            // Control changes that happen inside the audio callback
+            const bool perBlockParams = (sc == Scenario::ModeSwitch || sc == Scenario::Automation);
+            if (sc == Scenario::ModeSwitch) {
+                p.mode = bigpi::Mode(int(rng.next() % uint32_t(bigpi::Mode::Count)));
+            }
+            else if (sc == Scenario::Automation) {
+                randomiseParams(p, rng);
+            }
+
+            const uint64_t t0 = nowNs();
+            if (perBlockParams) eng.setParams(p);
+            eng.processBlock(inL.data(), inR.data(), outL.data(), outR.data(), n);
+            const uint64_t dt = nowNs() - t0;
+
+            res.all.record(dt);
+            uint64_t& m = res.scenarioMaxNs[size_t(sc)];
+            if (dt > m) m = dt;
+            if (dt >= res.all.max()) res.worst = sc;
+        }
+
+        // Back to the mode under test after switching around
+        if (sc == Scenario::ModeSwitch) eng.setParams(base);
+
+        done += double(segLen);
+        if (done >= nextReport) {
+            std::printf("  %-12s %6.1f min simulated, max so far %.1f us\n",
+                res.mode.c_str(), done / double(o.sr) / 60.0, double(res.all.max()) * 1e-3);
+            std::fflush(stdout);
+            nextReport += 600.0 * double(o.sr);
+        }
+    }
+
+    res.simulatedSeconds = done / double(o.sr);
+
+    const ReverbEngine::Stats st = eng.getStats();
+    res.nonFiniteResets = st.healthNonFiniteResets;
+    res.runawayResets = st.healthRunawayResets;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    std::cout << "Big Pi — bigpi_stress\n";
+    std::cout << "Build: " << REVERB_BUILD_ID << "\n";
+
+    StressOptions o;
+    if (!parseArgs(argc, argv, o)) return 1;
+
+    if (!isOptimizedBuild()) {
+        std::cout << "WARNING: this is not an optimized build (NDEBUG not set).\n"
+                     "         Configure with -DCMAKE_BUILD_TYPE=Release for real numbers.\n";
+    }
+
+    const double deadlineNs = blockDeadlineNs(float(o.sr), o.block);
+    std::printf("sr %d, block %d (%.1f us deadline), quality %s, %.3f h simulated per mode\n\n",
+        o.sr, o.block, deadlineNs * 1e-3, o.quality.c_str(), o.hours);
+
+    std::vector<ModeResult> results(o.modes.size());
+    for (size_t i = 0; i < o.modes.size(); ++i) {
+        runMode(o.modes[i], o, results[i]);
+    }
+
+    std::printf("\n%-12s %9s %9s %9s %9s %9s %8s  %s\n",
+        "mode", "blocks", "p50 us", "p99.9 us", "p99.99us", "max us", "max %", "worst scenario");
+
+    std::vector<std::string> lines;
+    for (const auto& r : results) {
+        const double p50 = double(r.all.percentile(0.50)) * 1e-3;
+        const double p999 = double(r.all.percentile(0.999)) * 1e-3;
+        const double p9999 = double(r.all.percentile(0.9999)) * 1e-3;
+        const double maxUs = double(r.all.max()) * 1e-3;
+        const double budgetPct = 100.0 * double(r.all.max()) / deadlineNs;
+
+        std::printf("%-12s %9llu %9.2f %9.2f %9.2f %9.2f %7.1f%%  %s\n",
+            r.mode.c_str(), (unsigned long long)r.all.count(), p50, p999, p9999, maxUs, budgetPct,
+            scenarioName(r.worst));
+        if (r.nonFiniteResets || r.runawayResets) {
+            std::printf("%-12s   health incidents: %llu NaN/Inf, %llu runaway\n", "",
+                (unsigned long long)r.nonFiniteResets, (unsigned long long)r.runawayResets);
+        }
+
+        JsonObject j;
+        j.str("mode", r.mode)
+            .integer("sr", o.sr)
+            .integer("block", o.block)
+            .str("quality", o.quality)
+            .num("simulated_s", r.simulatedSeconds)
+            .integer("blocks", int64_t(r.all.count()))
+            .num("p50_us", p50)
+            .num("p999_us", p999)
+            .num("p9999_us", p9999)
+            .num("max_us", maxUs)
+            .num("max_budget_pct", budgetPct)
+            .str("worst_scenario", scenarioName(r.worst))
+            .integer("health_nonfinite_resets", int64_t(r.nonFiniteResets))
+            .integer("health_runaway_resets", int64_t(r.runawayResets));
+        for (int s = 0; s < kNumScenarios; ++s) {
+            const std::string key = std::string("max_us_") + scenarioName(Scenario(s));
+            j.num(key.c_str(), double(r.scenarioMaxNs[size_t(s)]) * 1e-3);
+        }
+        lines.push_back(j.done());
+    }
+
+    // Per-scenario max table (which condition hurts which mode)
+    std::printf("\nmax us per scenario:\n%-12s", "mode");
+    for (int s = 0; s < kNumScenarios; ++s) std::printf(" %10s", scenarioName(Scenario(s)));
+    std::printf("\n");
+    for (const auto& r : results) {
+        std::printf("%-12s", r.mode.c_str());
+        for (int s = 0; s < kNumScenarios; ++s) std::printf(" %10.2f", double(r.scenarioMaxNs[size_t(s)]) * 1e-3);
+        std::printf("\n");
+    }
+
+    if (!o.jsonPath.empty()) {
+        std::ofstream f(o.jsonPath);
+        if (!f) {
+            std::cerr << "Cannot write " << o.jsonPath << "\n";
+            return 1;
+        }
+        writeJsonLines(f, lines);
+        std::cout << "\nWrote JSON: " << o.jsonPath << "\n";
+    }
+
+    return 0;
+}
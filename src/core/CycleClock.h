@@ -0,0 +1,92 @@
+#pragma once
+/*
+  =============================================================================
+  CycleClock.h — Big Pi low-overhead timestamp counter
+  =============================================================================
+
+  readCycleCounter() returns a monotonically increasing tick count that is as
+  cheap as the platform allows:
+
+    x86 / x86-64 : RDTSC (invariant TSC on every CPU we care about)
+    AArch64      : CNTVCT_EL0 (generic timer, fixed frequency, user readable)
+    elsewhere    : std::chrono::steady_clock in nanoseconds
+
+  Ticks are NOT nanoseconds on x86/ARM. Use ticksPerSecond() (measured once,
+  ~20 ms, on first call) to convert. Never call ticksPerSecond() from the
+  audio thread for the first time.
+
+  Real-time safety:
+    readCycleCounter() is a single instruction on x86/ARM: no syscalls,
+    no locks, no allocation.
+*/
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace bigpi::core {
+
+    inline uint64_t readCycleCounter() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t v;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+        return v;
+#else
+        using namespace std::chrono;
+        return uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Human-readable name of the tick source (for reports).
+    inline const char* cycleCounterName() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return "rdtsc";
+#elif defined(__aarch64__)
+        return "cntvct";
+#else
+        return "steady_clock";
+#endif
+    }
+
+    /*
+      ticksPerSecond()
+      ----------------
+      Calibrated against steady_clock once (thread-safe static init).
+      On AArch64 the frequency register is read directly.
+    */
+    inline double ticksPerSecond() {
+        static const double tps = []() -> double {
+#if defined(__aarch64__)
+            uint64_t f;
+            asm volatile("mrs %0, cntfrq_el0" : "=r"(f));
+            if (f > 0) return double(f);
+#elif !(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+            return 1.0e9;
+#endif
+            using namespace std::chrono;
+            const auto t0 = steady_clock::now();
+            const uint64_t c0 = readCycleCounter();
+            while (steady_clock::now() - t0 < milliseconds(20)) {
+            }
+            const auto t1 = steady_clock::now();
+            const uint64_t c1 = readCycleCounter();
+            const double sec = duration<double>(t1 - t0).count();
+            return (sec > 0.0) ? double(c1 - c0) / sec : 1.0e9;
+        }();
+        return tps;
+    }
+
+    inline double ticksToNs(uint64_t ticks) {
+        return double(ticks) * 1.0e9 / ticksPerSecond();
+    }
+
+} // namespace bigpi::core
@@ -0,0 +1,250 @@
+#pragma once
+/*
+  =============================================================================
+  Health.h — Big Pi block-rate numeric health monitor (NaN / Inf / runaway)
+  =============================================================================
+
+  RoadMap Phase 0 "NaN / runaway protection".
+
+  The problem:
+    A feedback network never forgets. One NaN written into a tank line
+    circulates forever (every line is mixed into every other line each
+    sample), and the feedback saturation only partially bounds a runaway
+    (e.g. decay multipliers above 1 in one band).
+
+  Why block rate:
+    Checking every sample inside the tank loop would cost more than the
+    problem is worth. Instead, once per chunk we scan:
+      - the wet buffers right before OutputStage (tail + ER), and
+      - the tank's per-line outputs of the last sample.
+    A NaN anywhere in the wet path reaches both within one loop time, so
+    nothing is missed, only noticed up to one chunk later.
+
+    The scan is a max(|x|) reduction that also flags non-finite values
+    (SSE2 / NEON when available, scalar otherwise). It touches 2 * chunk +
+    16 floats per chunk.
+
+  What it decides (HealthMonitor::check):
+    ResetWetPath  NaN/Inf seen. The wet buffers are garbage and there is no
+                  way to fade garbage, so they are zeroed and every wet-path
+                  state is cleared (OutputStage keeps its state: it never
+                  saw the bad values, so its filters ring down cleanly).
+    ResetTank     Finite but above kRunawayLevel for longer than
+                  kRunawayHoldMs. The current chunk fades out, only the
+                  recirculating part (tank, diffusion, smear) is cleared.
+
+    After either reset the wet signal fades back in over kFadeInMs, so the
+    recovery itself does not click.
+
+  Counters are single-writer relaxed atomics (same rules as core/Profiling.h)
+  and are always compiled in: they are read through ReverbEngine::getStats().
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIGPI_HEALTH_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BIGPI_HEALTH_NEON 1
+#endif
+
+namespace bigpi::core {
+
+    // ============================================================================
+    // Block scan
+    // ============================================================================
+
+    struct BlockScan {
+        float peak = 0.0f;          // max |x| over the finite values
+        bool nonFinite = false;     // any NaN or Inf seen
+    };
+
+    /*
+      scanBlock(x, n, s)
+      ------------------
+      Accumulates max |x| and a NaN/Inf flag into `s`.
+
+      Trick: |x| > FLT_MAX is true for Inf, and an "unordered or greater"
+      compare is also true for NaN, so one compare catches both.
+    */
+    inline void scanBlock(const float* x, int n, BlockScan& s) {
+        int i = 0;
+        float peak = s.peak;
+        bool bad = false;
+
+#if BIGPI_HEALTH_SSE2
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 maxFinite = _mm_set1_ps(FLT_MAX);
+        __m128 vPeak = _mm_setzero_ps();
+        __m128 vBad = _mm_setzero_ps();
+
+        for (; i + 4 <= n; i += 4) {
+            const __m128 a = _mm_and_ps(_mm_loadu_ps(x + i), absMask);
+            vBad = _mm_or_ps(vBad, _mm_cmpnle_ps(a, maxFinite));    // NaN or Inf
+            vPeak = _mm_max_ps(vPeak, a);                           // NaN lanes ignored below
+        }
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, vPeak);
+        for (float v : lanes) peak = (v > peak && v <= FLT_MAX) ? v : peak;
+        bad = (_mm_movemask_ps(vBad) != 0);
+#elif BIGPI_HEALTH_NEON
+        const float32x4_t maxFinite = vdupq_n_f32(FLT_MAX);
+        float32x4_t vPeak = vdupq_n_f32(0.0f);
+        uint32x4_t vBad = vdupq_n_u32(0);
+
+        for (; i + 4 <= n; i += 4) {
+            const float32x4_t a = vabsq_f32(vld1q_f32(x + i));
+            vBad = vorrq_u32(vBad, vmvnq_u32(vcleq_f32(a, maxFinite))); // NaN or Inf
+            vPeak = vmaxq_f32(vPeak, a);
+        }
+
+        float lanes[4];
+        vst1q_f32(lanes, vPeak);
+        for (float v : lanes) peak = (v > peak && v <= FLT_MAX) ? v : peak;
+        bad = (vgetq_lane_u32(vBad, 0) | vgetq_lane_u32(vBad, 1) | vgetq_lane_u32(vBad, 2) | vgetq_lane_u32(vBad, 3)) != 0;
+#endif
+
+        for (; i < n; ++i) {
+            const float a = std::abs(x[i]);
+            if (!(a <= FLT_MAX)) bad = true;
+            else if (a > peak) peak = a;
+        }
+
+        s.peak = peak;
+        s.nonFinite = s.nonFinite || bad;
+    }
+
+    // ============================================================================
+    // Monitor
+    // ============================================================================
+
+    struct HealthStats {
+        uint64_t nonFiniteResets = 0;   // NaN/Inf incidents (wet path reset)
+        uint64_t runawayResets = 0;     // sustained over-level incidents (tank reset)
+        float maxTankPeak = 0.0f;       // largest finite tank line output seen
+    };
+
+    class HealthMonitor {
+    public:
+        enum class Action : int {
+            None = 0,
+            ResetTank,
+            ResetWetPath
+        };
+
+        // +24 dBFS: far above anything the saturating tank produces in normal
+        // use, low enough to catch a runaway long before it reaches Inf.
+        static constexpr float kRunawayLevel = 16.0f;
+        static constexpr float kRunawayHoldMs = 50.0f;
+        static constexpr float kFadeInMs = 20.0f;
+
+        // Call from prepare() (not the audio thread).
+        void prepare(float sampleRate) {
+            runawayHoldSamples = uint32_t(kRunawayHoldMs * 0.001f * sampleRate);
+            fadeStep = 1.0f / std::max(1.0f, kFadeInMs * 0.001f * sampleRate);
+            reset();
+        }
+
+        // Clears detection state (not the counters).
+        void reset() {
+            overSamples = 0;
+            fadeGain = 1.0f;
+        }
+
+        // Audio thread, once per chunk.
+        Action check(const float* wetL, const float* wetR, int n, const float* tankY, int lines) {
+            BlockScan tank;
+            scanBlock(tankY, lines, tank);
+
+            BlockScan wet;
+            scanBlock(wetL, n, wet);
+            scanBlock(wetR, n, wet);
+
+            if (tank.nonFinite || wet.nonFinite) {
+                overSamples = 0;
+                bump(nonFinite);
+                return Action::ResetWetPath;
+            }
+
+            if (tank.peak > maxTankPeak.load(std::memory_order_relaxed)) {
+                maxTankPeak.store(tank.peak, std::memory_order_relaxed);
+            }
+
+            if (tank.peak > kRunawayLevel || wet.peak > kRunawayLevel) {
+                overSamples += uint32_t(n);
+                if (overSamples >= runawayHoldSamples) {
+                    overSamples = 0;
+                    bump(runaway);
+                    return Action::ResetTank;
+                }
+            }
+            else {
+                overSamples = 0;
+            }
+            return Action::None;
+        }
+
+        // After a reset: start the wet fade-in from silence.
+        void startFadeIn() { fadeGain = 0.0f; }
+
+        bool fading() const { return fadeGain < 1.0f; }
+
+        // Audio thread: applies the fade-in ramp to the wet buffers.
+        void applyFadeIn(float* wetL, float* wetR, int n) {
+            for (int i = 0; i < n; ++i) {
+                fadeGain = std::min(1.0f, fadeGain + fadeStep);
+                wetL[i] *= fadeGain;
+                wetR[i] *= fadeGain;
+            }
+        }
+
+        // Audio thread: 1 -> 0 over the chunk (the last good chunk before a tank reset).
+        static void applyFadeOut(float* wetL, float* wetR, int n) {
+            const float step = 1.0f / float(std::max(1, n));
+            for (int i = 0; i < n; ++i) {
+                const float g = 1.0f - step * float(i + 1);
+                wetL[i] *= g;
+                wetR[i] *= g;
+            }
+        }
+
+        // Any thread.
+        HealthStats snapshot() const {
+            HealthStats s;
+            s.nonFiniteResets = nonFinite.load(std::memory_order_relaxed);
+            s.runawayResets = runaway.load(std::memory_order_relaxed);
+            s.maxTankPeak = maxTankPeak.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        void resetCounters() {
+            nonFinite.store(0, std::memory_order_relaxed);
+            runaway.store(0, std::memory_order_relaxed);
+            maxTankPeak.store(0.0f, std::memory_order_relaxed);
+        }
+
+    private:
+        uint32_t runawayHoldSamples = 2400;
+        uint32_t overSamples = 0;
+
+        float fadeStep = 1.0f / 960.0f;
+        float fadeGain = 1.0f;
+
+        std::atomic<uint64_t> nonFinite{ 0 };
+        std::atomic<uint64_t> runaway{ 0 };
+        std::atomic<float> maxTankPeak{ 0.0f };
+
+        // Single writer: plain load + store, no read-modify-write needed.
+        static void bump(std::atomic<uint64_t>& a) {
+            a.store(a.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+} // namespace bigpi::core
@@ -0,0 +1,338 @@
+#pragma once
+/*
+  =============================================================================
+  Profiling.h — Big Pi per-stage timing instrumentation (compile-time optional)
+  =============================================================================
+
+  RoadMap Phase 0 "Profiling hooks" / Phase 2 "CPU profiling per mode".
+
+  How it works:
+    - ReverbEngine::processBlock() is split into stages (predelay, ER, spray,
+      diffusion, tank, taps, smear, late diffusion, ducking, OutputStage, mix).
+    - Each stage is timed with the TSC (core/CycleClock.h) and aggregated into
+      a fixed log2 histogram per stage. No allocation, no locks.
+    - ReverbEngine::getStats() returns a snapshot (Stats) that can be read from
+      any thread. Counters are single-writer relaxed atomics, so a snapshot is
+      per-field consistent, not a cross-field transaction.
+    - Every whole block is also checked against a deadline (xrun risk).
+
+  Compile-time switch:
+    BIGPI_PROFILE=1 (CMake: -DBIGPI_ENABLE_PROFILING=ON) compiles the timers in.
+    Without it the BIGPI_PROF_* macros expand to nothing and the engine does
+    not even carry the recorder member: zero overhead.
+
+  IMPORTANT:
+    BIGPI_PROFILE changes the layout of ReverbEngine. It must be defined the
+    same way for every translation unit (the CMake option does that).
+*/
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "core/CycleClock.h"
+#include "core/QualityGovernor.h"
+
+#ifndef BIGPI_PROFILE
+#define BIGPI_PROFILE 0
+#endif
+
+namespace bigpi::prof {
+
+    // ============================================================================
+    // Stages
+    // ============================================================================
+
+    enum class Stage : int {
+        Predelay = 0,
+        EarlyReflections,
+        Spray,
+        Granular,   // grain engine (dsp/granular/GranularEngine.h)
+        Tape,       // Magnetic mode tape front end (dsp/tape/MagneticTape.h)
+        Sidechain,  // shared level analysis (dsp/analysis/Sidechain.h)
+        Diffusion,
+        Tank,
+        Taps,
+        Spring,     // Spring mode spring model (dsp/spring/SpringModel.h)
+        Singularity, // Singularity mode long network (dsp/singularity/SingularityEngine.h)
+        Smear,
+        LateDiffusion,
+        Ducking,
+        OutputStage,
+        Mix,
+        Health,     // block-rate NaN/runaway scan (core/Health.h)
+        Block,      // whole processBlock() call
+
+        Count
+    };
+
+    inline constexpr int kNumStages = int(Stage::Count);
+
+    inline const char* stageName(Stage s) {
+        switch (s) {
+        case Stage::Predelay:         return "predelay";
+        case Stage::EarlyReflections: return "er";
+        case Stage::Spray:            return "spray";
+        case Stage::Granular:         return "granular";
+        case Stage::Tape:             return "tape";
+        case Stage::Sidechain:        return "sidechain";
+        case Stage::Diffusion:        return "diffusion";
+        case Stage::Tank:             return "tank";
+        case Stage::Taps:             return "taps";
+        case Stage::Spring:           return "spring";
+        case Stage::Singularity:      return "singularity";
+        case Stage::Smear:            return "smear";
+        case Stage::LateDiffusion:    return "late_diffusion";
+        case Stage::Ducking:          return "ducking";
+        case Stage::OutputStage:      return "output_stage";
+        case Stage::Mix:              return "mix";
+        case Stage::Health:           return "health";
+        case Stage::Block:            return "block";
+        default:                      return "unknown";
+        }
+    }
+
+    // ============================================================================
+    // Snapshot types (plain data, safe to copy around)
+    // ============================================================================
+
+    // Bucket b holds durations in [2^b, 2^(b+1)) ns. Bucket 0 also holds 0 ns.
+    inline constexpr int kHistBuckets = 32;
+
+    struct StageHistogram {
+        uint64_t count = 0;     // number of recorded chunks/blocks
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        std::array<uint64_t, kHistBuckets> buckets{};
+
+        double meanNs() const { return count ? double(totalNs) / double(count) : 0.0; }
+
+        // Upper edge of the bucket holding quantile q (coarse: factor-of-2 bins).
+        uint64_t percentileNs(double q) const {
+            if (count == 0) return 0;
+            const uint64_t rank = uint64_t(q * double(count - 1)) + 1;
+            uint64_t acc = 0;
+            for (int b = 0; b < kHistBuckets; ++b) {
+                acc += buckets[b];
+                if (acc >= rank) {
+                    const uint64_t edge = (uint64_t(2) << b) - 1;
+                    return edge < maxNs ? edge : maxNs;
+                }
+            }
+            return maxNs;
+        }
+    };
+
+    struct Stats {
+        bool enabled = false;           // false when compiled without BIGPI_PROFILE
+
+        double deadlineNs = 0.0;        // last deadline used for xrun checks
+        uint64_t blocks = 0;            // processBlock() calls
+        uint64_t samples = 0;           // samples processed
+        uint64_t riskBlocks = 0;        // block time > kRiskFraction * deadline
+        uint64_t xrunBlocks = 0;        // block time > deadline
+
+        std::array<StageHistogram, kNumStages> stages{};
+
+        // Numeric health incidents (core/Health.h).
+        // Always filled, even when the timers are compiled out.
+        uint64_t healthNonFiniteResets = 0;
+        uint64_t healthRunawayResets = 0;
+        float healthMaxTankPeak = 0.0f;
+
+        // Adaptive quality governor (core/QualityGovernor.h): level, step
+        // counters and the recent decisions. Always filled.
+        bigpi::core::GovernorStats governor{};
+
+        const StageHistogram& stage(Stage s) const { return stages[size_t(s)]; }
+    };
+
+    // Blocks above this fraction of the deadline count as "at risk".
+    inline constexpr double kRiskFraction = 0.75;
+
+    // ============================================================================
+    // Recorder (audio-thread writer, any-thread reader)
+    // ============================================================================
+
+    class Recorder {
+    public:
+        // Call from prepare() (not the audio thread): calibrates the tick rate.
+        void prepare() {
+            nsPerTick = 1.0e9 / bigpi::core::ticksPerSecond();
+            reset();
+        }
+
+        void reset() {
+            for (auto& s : stages) {
+                s.count.store(0, std::memory_order_relaxed);
+                s.totalNs.store(0, std::memory_order_relaxed);
+                s.maxNs.store(0, std::memory_order_relaxed);
+                for (auto& b : s.buckets) b.store(0, std::memory_order_relaxed);
+            }
+            blocks.store(0, std::memory_order_relaxed);
+            samples.store(0, std::memory_order_relaxed);
+            riskBlocks.store(0, std::memory_order_relaxed);
+            xrunBlocks.store(0, std::memory_order_relaxed);
+        }
+
+        // 0 = derive the deadline from each call (n / sampleRate).
+        void setDeadlineNs(double ns) { fixedDeadlineNs.store(ns, std::memory_order_relaxed); }
+
+        uint64_t now() const { return bigpi::core::readCycleCounter(); }
+
+        // Audio thread only.
+        void record(Stage s, uint64_t ticks) {
+            const uint64_t ns = uint64_t(double(ticks) * nsPerTick);
+            Counters& c = stages[size_t(s)];
+            bump(c.count, 1);
+            bump(c.totalNs, ns);
+            if (ns > c.maxNs.load(std::memory_order_relaxed)) c.maxNs.store(ns, std::memory_order_relaxed);
+            bump(c.buckets[size_t(bucketOf(ns))], 1);
+        }
+
+        // Audio thread only: whole-block bookkeeping + deadline check.
+        void recordBlock(uint64_t ticks, int n, float sampleRate) {
+            record(Stage::Block, ticks);
+
+            const double ns = double(ticks) * nsPerTick;
+            double deadline = fixedDeadlineNs.load(std::memory_order_relaxed);
+            if (deadline <= 0.0) deadline = 1.0e9 * double(n) / double(sampleRate);
+            lastDeadlineNs.store(deadline, std::memory_order_relaxed);
+
+            bump(blocks, 1);
+            bump(samples, uint64_t(n));
+            if (ns > deadline) bump(xrunBlocks, 1);
+            if (ns > kRiskFraction * deadline) bump(riskBlocks, 1);
+        }
+
+        // Any thread.
+        Stats snapshot() const {
+            Stats st;
+            st.enabled = true;
+            st.deadlineNs = lastDeadlineNs.load(std::memory_order_relaxed);
+            st.blocks = blocks.load(std::memory_order_relaxed);
+            st.samples = samples.load(std::memory_order_relaxed);
+            st.riskBlocks = riskBlocks.load(std::memory_order_relaxed);
+            st.xrunBlocks = xrunBlocks.load(std::memory_order_relaxed);
+
+            for (int i = 0; i < kNumStages; ++i) {
+                const Counters& c = stages[size_t(i)];
+                StageHistogram& h = st.stages[size_t(i)];
+                h.count = c.count.load(std::memory_order_relaxed);
+                h.totalNs = c.totalNs.load(std::memory_order_relaxed);
+                h.maxNs = c.maxNs.load(std::memory_order_relaxed);
+                for (int b = 0; b < kHistBuckets; ++b) {
+                    h.buckets[size_t(b)] = c.buckets[size_t(b)].load(std::memory_order_relaxed);
+                }
+            }
+            return st;
+        }
+
+    private:
+        struct Counters {
+            std::atomic<uint64_t> count{ 0 };
+            std::atomic<uint64_t> totalNs{ 0 };
+            std::atomic<uint64_t> maxNs{ 0 };
+            std::array<std::atomic<uint64_t>, kHistBuckets> buckets{};
+        };
+
+        std::array<Counters, kNumStages> stages{};
+
+        std::atomic<uint64_t> blocks{ 0 };
+        std::atomic<uint64_t> samples{ 0 };
+        std::atomic<uint64_t> riskBlocks{ 0 };
+        std::atomic<uint64_t> xrunBlocks{ 0 };
+
+        std::atomic<double> fixedDeadlineNs{ 0.0 };
+        std::atomic<double> lastDeadlineNs{ 0.0 };
+
+        double nsPerTick = 1.0;
+
+        // Single writer: plain load + store, no read-modify-write needed.
+        static void bump(std::atomic<uint64_t>& a, uint64_t v) {
+            a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+
+        static int bucketOf(uint64_t ns) {
+            int b = 0;
+            while (ns > 1 && b < kHistBuckets - 1) { ns >>= 1; ++b; }
+            return b;
+        }
+    };
+
+    // ============================================================================
+    // Timers
+    // ============================================================================
+
+    // Times one scope into one stage.
+    class ScopedStageTimer {
+    public:
+        ScopedStageTimer(Recorder& r, Stage s) : rec(r), stage(s), t0(r.now()) {}
+        ~ScopedStageTimer() { rec.record(stage, rec.now() - t0); }
+
+        ScopedStageTimer(const ScopedStageTimer&) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        Recorder& rec;
+        Stage stage;
+        uint64_t t0;
+    };
+
+    /*
+      LapTimer
+      --------
+      For per-sample loops that interleave several stages (diffusion -> tank ->
+      taps share state sample by sample and cannot be split into passes).
+      lap(stage) charges the time since the previous lap to `stage`; flush()
+      records one histogram entry per stage for the whole chunk.
+    */
+    class LapTimer {
+    public:
+        explicit LapTimer(Recorder& r) : rec(r) { acc.fill(0); last = r.now(); }
+
+        void lap(Stage s) {
+            const uint64_t t = rec.now();
+            acc[size_t(s)] += t - last;
+            used |= 1u << unsigned(s);
+            last = t;
+        }
+
+        // Records every stage that was lapped at least once.
+        void flush() {
+            for (int i = 0; i < kNumStages; ++i) {
+                if (used & (1u << unsigned(i))) rec.record(Stage(i), acc[size_t(i)]);
+            }
+        }
+
+        // Re-syncs the lap start (e.g. after skipping untimed work).
+        void restart() { last = rec.now(); }
+
+    private:
+        Recorder& rec;
+        std::array<uint64_t, kNumStages> acc{};
+        uint64_t last = 0;
+        uint32_t used = 0;
+    };
+
+} // namespace bigpi::prof
+
+// ============================================================================
+// Macros (compile to nothing without BIGPI_PROFILE)
+// ============================================================================
+
+#define BIGPI_PROF_CONCAT2(a, b) a##b
+#define BIGPI_PROF_CONCAT(a, b) BIGPI_PROF_CONCAT2(a, b)
+
+#if BIGPI_PROFILE
+#define BIGPI_PROF_SCOPE(rec, stage) \
+    ::bigpi::prof::ScopedStageTimer BIGPI_PROF_CONCAT(bigpiProfScope_, __LINE__)((rec), ::bigpi::prof::Stage::stage)
+#define BIGPI_PROF_LAP_BEGIN(lt, rec) ::bigpi::prof::LapTimer lt((rec))
+#define BIGPI_PROF_LAP(lt, stage) (lt).lap(::bigpi::prof::Stage::stage)
+#define BIGPI_PROF_LAP_FLUSH(lt) (lt).flush()
+#else
+#define BIGPI_PROF_SCOPE(rec, stage) ((void)0)
+#define BIGPI_PROF_LAP_BEGIN(lt, rec) ((void)0)
+#define BIGPI_PROF_LAP(lt, stage) ((void)0)
+#define BIGPI_PROF_LAP_FLUSH(lt) ((void)0)
+#endif
@@ -0,0 +1,454 @@
+#pragma once
+/*
+  =============================================================================
+  QualityGovernor.h — Big Pi adaptive quality governor (CPU pressure)
+  =============================================================================
+
+  RoadMap Phase 10 "Eco / HQ", made automatic.
+
+  The problem:
+    On a pedal a late block is an audible click, and a busy host (other
+    plugins, a thermally throttled SoC, a GUI redraw) can eat the headroom
+    the engine was budgeted with. Eco vs HQ is a static choice; this picks
+    the cost at run time instead, and only as low as the CPU forces it.
+
+  How it decides (once per processBlock() call):
+    load = block processing time / block deadline (1.0 = exactly on time)
+
+    Step down one level when
+      - the smoothed load (kLoadSmoothMs) is above stepDownLoad, or
+      - a single block overran its deadline (load > 1) while the smoothed
+        load is above stepUpLoad. An overrun out of a quiet average is the
+        OS preempting us, which cheaper DSP would not have prevented.
+    Step up one level when the smoothed load has stayed below stepUpLoad
+    for upHoldMs.
+
+    After every change the governor waits kDwellMs before the next one, so
+    the load it sees already reflects the new level. If a step up is undone
+    by a step down within the hold time, the hold time doubles (up to
+    kMaxUpHoldMs): a CPU that sits right at a level boundary settles on the
+    cheaper side instead of toggling. Each step up that survives a full hold
+    time halves it again.
+
+  Levels (cumulative, cheapest last):
+    0 Full            everything on
+    1 NoModulation    jitter and cloud wander off (the noise generators are
+                      the most expensive part of the per-line modulation)
+    2 FewerDiffusers  input diffusion stages halved (at least 2)
+    3 NoSprayOrSmear  cloud front-end spray taps and post-tank smear taps off
+    4 LinearInterp    tank delay reads switch from cubic to linear
+    5 EcoLines        tank falls back from 16 to 8 lines
+
+  How changes sound:
+    Levels 1-3 are continuous gains (modulation depth, diffusion blend,
+    spray/smear amount) and ramp over kXfadeMs. Level 4 needs no fade (both
+    interpolators read the same signal). Level 5 changes the network
+    itself: the tank tail dips to silence over kDipMs, the line count
+    switches at the bottom of the dip, and the tail comes back over kDipMs.
+    Early reflections and the dry signal are untouched by the dip.
+
+  Visibility:
+    Counters and the last kLogSize decisions are single-writer relaxed
+    atomics (same rules as core/Health.h), read through snapshot() and
+    ReverbEngine::getStats(). A decision is packed into one 64-bit word so a
+    reader never sees half of one.
+
+  Off by default. While disabled and fully ramped up the engine does not
+  even read the clock, so output is bit-exact with a build without it.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace bigpi::core {
+
+    // ============================================================================
+    // Levels and decisions
+    // ============================================================================
+
+    enum class QualityLevel : int {
+        Full = 0,
+        NoModulation,
+        FewerDiffusers,
+        NoSprayOrSmear,
+        LinearInterp,
+        EcoLines,
+
+        Count
+    };
+
+    inline constexpr int kNumQualityLevels = int(QualityLevel::Count);
+
+    inline const char* qualityLevelName(int level) {
+        switch (QualityLevel(level)) {
+        case QualityLevel::Full:           return "full";
+        case QualityLevel::NoModulation:   return "no_modulation";
+        case QualityLevel::FewerDiffusers: return "fewer_diffusers";
+        case QualityLevel::NoSprayOrSmear: return "no_spray_smear";
+        case QualityLevel::LinearInterp:   return "linear_interp";
+        case QualityLevel::EcoLines:       return "eco_lines";
+        default:                           return "?";
+        }
+    }
+
+    enum class GovernorReason : int {
+        Load = 0,       // smoothed load above stepDownLoad
+        Overrun,        // one block missed its deadline
+        Headroom,       // load below stepUpLoad for the hold time
+        Disabled        // governor switched off: straight back to Full
+    };
+
+    inline const char* governorReasonName(GovernorReason r) {
+        switch (r) {
+        case GovernorReason::Load:     return "load";
+        case GovernorReason::Overrun:  return "overrun";
+        case GovernorReason::Headroom: return "headroom";
+        case GovernorReason::Disabled: return "disabled";
+        default:                       return "?";
+        }
+    }
+
+    struct GovernorDecision {
+        uint32_t atMs = 0;          // engine time (ms of audio since reset)
+        int from = 0;               // QualityLevel before
+        int to = 0;                 // QualityLevel after
+        float load = 0.0f;          // load that triggered it (block or smoothed)
+        GovernorReason reason = GovernorReason::Load;
+    };
+
+    struct GovernorStats {
+        bool enabled = false;
+        int level = 0;                  // current QualityLevel
+        int maxLevel = 0;               // deepest level reached
+        uint64_t stepDowns = 0;
+        uint64_t stepUps = 0;
+        uint64_t overruns = 0;          // blocks with load > 1 (seen while enabled)
+        float load = 0.0f;              // smoothed load
+        float peakLoad = 0.0f;          // worst single block
+        float upHoldMs = 0.0f;          // current step-up hold (grows on oscillation)
+        std::array<uint64_t, kNumQualityLevels> blocksAtLevel{};
+
+        // Most recent decisions, oldest first; logCount entries are valid.
+        static constexpr int kLogSize = 8;
+        std::array<GovernorDecision, kLogSize> log{};
+        int logCount = 0;
+    };
+
+    // ============================================================================
+    // Governor
+    // ============================================================================
+
+    class QualityGovernor {
+    public:
+        struct Settings {
+            float stepDownLoad = 0.80f;     // smoothed load that triggers a step down
+            float stepUpLoad = 0.50f;       // smoothed load that allows a step up
+            float upHoldMs = 1500.0f;       // time below stepUpLoad before a step up
+            int maxLevel = kNumQualityLevels - 1;
+        };
+
+        static constexpr float kLoadSmoothMs = 50.0f;
+        static constexpr float kDwellMs = 100.0f;
+        static constexpr float kMaxUpHoldMs = 30000.0f;
+        static constexpr float kXfadeMs = 20.0f;
+        static constexpr float kDipMs = 10.0f;
+
+        // Call from prepare() (not the audio thread).
+        void prepare(float sampleRate) {
+            sr = sampleRate;
+            xfadeStep = 1.0f / std::max(1.0f, kXfadeMs * 0.001f * sr);
+            dipStep = 1.0f / std::max(1.0f, kDipMs * 0.001f * sr);
+            dwellSamples = uint64_t(kDwellMs * 0.001f * sr);
+            reset();
+        }
+
+        // Back to Full with every ramp settled (not the counters).
+        void reset() {
+            level = 0;
+            ramp.fill(1.0f);
+            ecoApplied = false;
+            dip = 1.0f;
+            dipPhase = DipPhase::Idle;
+            loadEma = 0.0f;
+            samples = 0;
+            sinceChange = dwellSamples;
+            belowSamples = 0;
+            lastChangeWasUp = false;
+            upHoldSamples = uint64_t(settings.upHoldMs * 0.001f * sr);
+            publishLevel();
+        }
+
+        // Any thread. Disabling ramps back to Full on the audio thread.
+        void setEnabled(bool on) { enabledFlag.store(on, std::memory_order_relaxed); }
+        bool enabled() const { return enabledFlag.load(std::memory_order_relaxed); }
+
+        // Not the audio thread (prepare() time).
+        void setSettings(const Settings& s) {
+            settings = s;
+            settings.maxLevel = std::max(0, std::min(s.maxLevel, kNumQualityLevels - 1));
+            upHoldSamples = uint64_t(settings.upHoldMs * 0.001f * sr);
+        }
+
+        // True while the engine has to apply anything at all: enabled, or
+        // still ramping back to Full after being disabled.
+        bool active() const { return enabled() || !settled(); }
+
+        // ------------------------------------------------------------------
+        // Audio thread: decisions
+        // ------------------------------------------------------------------
+
+        /*
+          update(load, n)
+          ---------------
+          Once per processBlock() call, after the block: load is the block
+          time divided by its deadline, n the samples it covered.
+          Returns true when the level changed.
+        */
+        bool update(float load, int n) {
+            const int before = level;
+            decide(load, n);
+            return level != before;
+        }
+
+        int currentLevel() const { return level; }
+
+        // ------------------------------------------------------------------
+        // Audio thread: what the engine applies (once per chunk)
+        // ------------------------------------------------------------------
+
+        // Advances the continuous ramps by one chunk and starts a line-count
+        // dip when the level asks for a different line count.
+        void advance(int n) {
+            const float d = xfadeStep * float(n);
+            for (int l = 1; l < kNumQualityLevels; ++l) {
+                const float want = (level >= l) ? 0.0f : 1.0f;
+                ramp[size_t(l)] = (want < ramp[size_t(l)])
+                    ? std::max(want, ramp[size_t(l)] - d)
+                    : std::min(want, ramp[size_t(l)] + d);
+            }
+
+            const bool wantEco = (level >= int(QualityLevel::EcoLines));
+            if (dipPhase != DipPhase::Down && wantEco != ecoApplied) dipPhase = DipPhase::Down;
+            else if (dipPhase == DipPhase::Down && wantEco == ecoApplied) dipPhase = DipPhase::Up;
+        }
+
+        // 1 = feature fully on, 0 = fully off. Levels 1..3 (continuous).
+        float gain(QualityLevel l) const { return ramp[size_t(l)]; }
+
+        bool linearInterp() const { return level >= int(QualityLevel::LinearInterp); }
+
+        // Line cap the tank should run at (switches only at the bottom of a dip).
+        int linesCap(int maxLines) const { return ecoApplied ? std::min(8, maxLines) : maxLines; }
+
+        bool dipping() const { return dipPhase != DipPhase::Idle; }
+
+        // Per-sample tail gain while dipping().
+        float nextDipGain() {
+            if (dipPhase == DipPhase::Down) {
+                dip = std::max(0.0f, dip - dipStep);
+            }
+            else if (dipPhase == DipPhase::Up) {
+                dip = std::min(1.0f, dip + dipStep);
+                if (dip >= 1.0f) dipPhase = DipPhase::Idle;
+            }
+            return dip;
+        }
+
+        // End of chunk: true when the tail is silent and the line count should
+        // switch now. The caller switches, then calls finishLinesSwitch().
+        bool linesSwitchDue() const { return dipPhase == DipPhase::Down && dip <= 0.0f; }
+
+        void finishLinesSwitch() {
+            ecoApplied = !ecoApplied;
+            dipPhase = DipPhase::Up;
+        }
+
+        // ------------------------------------------------------------------
+        // Any thread
+        // ------------------------------------------------------------------
+
+        GovernorStats snapshot() const {
+            GovernorStats s;
+            s.enabled = enabled();
+            s.level = levelNow.load(std::memory_order_relaxed);
+            s.maxLevel = maxLevelSeen.load(std::memory_order_relaxed);
+            s.stepDowns = stepDowns.load(std::memory_order_relaxed);
+            s.stepUps = stepUps.load(std::memory_order_relaxed);
+            s.overruns = overruns.load(std::memory_order_relaxed);
+            s.load = loadNow.load(std::memory_order_relaxed);
+            s.peakLoad = peakLoad.load(std::memory_order_relaxed);
+            s.upHoldMs = upHoldMsNow.load(std::memory_order_relaxed);
+            for (int l = 0; l < kNumQualityLevels; ++l) {
+                s.blocksAtLevel[size_t(l)] = blocksAtLevel[size_t(l)].load(std::memory_order_relaxed);
+            }
+
+            const uint64_t count = logCount.load(std::memory_order_acquire);
+            const uint64_t first = (count > uint64_t(GovernorStats::kLogSize)) ? count - GovernorStats::kLogSize : 0;
+            for (uint64_t i = first; i < count; ++i) {
+                s.log[size_t(s.logCount++)] = unpack(logWords[size_t(i % GovernorStats::kLogSize)].load(std::memory_order_relaxed));
+            }
+            return s;
+        }
+
+        void resetCounters() {
+            stepDowns.store(0, std::memory_order_relaxed);
+            stepUps.store(0, std::memory_order_relaxed);
+            overruns.store(0, std::memory_order_relaxed);
+            peakLoad.store(0.0f, std::memory_order_relaxed);
+            maxLevelSeen.store(levelNow.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            for (auto& b : blocksAtLevel) b.store(0, std::memory_order_relaxed);
+            logCount.store(0, std::memory_order_release);
+        }
+
+    private:
+        enum class DipPhase : int { Idle = 0, Down, Up };
+
+        float sr = 48000.0f;
+        Settings settings{};
+
+        std::atomic<bool> enabledFlag{ false };
+
+        // Audio-thread state
+        int level = 0;
+        std::array<float, kNumQualityLevels> ramp{ 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };   // [0] unused
+        float xfadeStep = 1.0f / 960.0f;
+
+        bool ecoApplied = false;
+        float dip = 1.0f;
+        float dipStep = 1.0f / 480.0f;
+        DipPhase dipPhase = DipPhase::Idle;
+
+        float loadEma = 0.0f;
+        uint64_t samples = 0;
+        uint64_t sinceChange = 0;
+        uint64_t belowSamples = 0;
+        uint64_t dwellSamples = 4800;
+        uint64_t upHoldSamples = 72000;
+        bool lastChangeWasUp = false;
+
+        // Published (any-thread readable)
+        std::atomic<int> levelNow{ 0 };
+        std::atomic<int> maxLevelSeen{ 0 };
+        std::atomic<uint64_t> stepDowns{ 0 };
+        std::atomic<uint64_t> stepUps{ 0 };
+        std::atomic<uint64_t> overruns{ 0 };
+        std::atomic<float> loadNow{ 0.0f };
+        std::atomic<float> peakLoad{ 0.0f };
+        std::atomic<float> upHoldMsNow{ 0.0f };
+        std::array<std::atomic<uint64_t>, kNumQualityLevels> blocksAtLevel{};
+
+        std::array<std::atomic<uint64_t>, GovernorStats::kLogSize> logWords{};
+        std::atomic<uint64_t> logCount{ 0 };
+
+        bool settled() const {
+            if (level != 0 || ecoApplied || dipPhase != DipPhase::Idle) return false;
+            for (int l = 1; l < kNumQualityLevels; ++l) {
+                if (ramp[size_t(l)] < 1.0f) return false;
+            }
+            return true;
+        }
+
+        void change(int to, float load, GovernorReason reason) {
+            const int from = level;
+            level = to;
+            sinceChange = 0;
+            belowSamples = 0;
+            lastChangeWasUp = (to < from) && reason == GovernorReason::Headroom;
+
+            bump((to > from) ? stepDowns : stepUps);
+            publishLevel();
+
+            GovernorDecision d;
+            d.atMs = uint32_t(std::min<uint64_t>(0xFFFFFFFFu, samples * 1000u / uint64_t(std::max(1.0f, sr))));
+            d.from = from;
+            d.to = to;
+            d.load = load;
+            d.reason = reason;
+
+            const uint64_t c = logCount.load(std::memory_order_relaxed);
+            logWords[size_t(c % GovernorStats::kLogSize)].store(pack(d), std::memory_order_relaxed);
+            logCount.store(c + 1, std::memory_order_release);
+        }
+
+        void publishLevel() {
+            levelNow.store(level, std::memory_order_relaxed);
+            if (level > maxLevelSeen.load(std::memory_order_relaxed)) maxLevelSeen.store(level, std::memory_order_relaxed);
+            upHoldMsNow.store(float(upHoldSamples) * 1000.0f / sr, std::memory_order_relaxed);
+        }
+
+        void decide(float load, int n) {
+            samples += uint64_t(n);
+            sinceChange += uint64_t(n);
+            bump(blocksAtLevel[size_t(level)]);
+
+            if (!enabled()) {
+                if (level != 0) change(0, load, GovernorReason::Disabled);
+                return;
+            }
+
+            const float a = 1.0f - std::exp(-float(n) / (kLoadSmoothMs * 0.001f * sr));
+            loadEma += a * (load - loadEma);
+            loadNow.store(loadEma, std::memory_order_relaxed);
+
+            if (load > peakLoad.load(std::memory_order_relaxed)) peakLoad.store(load, std::memory_order_relaxed);
+            if (load > 1.0f) bump(overruns);
+
+            // A step up that survived a whole hold time: relax the hold again.
+            if (lastChangeWasUp && sinceChange >= upHoldSamples) {
+                lastChangeWasUp = false;
+                setUpHold(std::max(uint64_t(settings.upHoldMs * 0.001f * sr), upHoldSamples / 2));
+            }
+
+            if (sinceChange < dwellSamples) return;
+
+            const bool overrun = (load > 1.0f && loadEma > settings.stepUpLoad);
+            if ((overrun || loadEma > settings.stepDownLoad) && level < settings.maxLevel) {
+                if (lastChangeWasUp) {
+                    setUpHold(std::min(uint64_t(kMaxUpHoldMs * 0.001f * sr), upHoldSamples * 2));
+                }
+                change(level + 1, overrun ? load : loadEma,
+                    overrun ? GovernorReason::Overrun : GovernorReason::Load);
+                return;
+            }
+
+            if (loadEma < settings.stepUpLoad && level > 0) {
+                belowSamples += uint64_t(n);
+                if (belowSamples >= upHoldSamples) change(level - 1, loadEma, GovernorReason::Headroom);
+            }
+            else {
+                belowSamples = 0;
+            }
+        }
+
+        void setUpHold(uint64_t s) {
+            upHoldSamples = s;
+            upHoldMsNow.store(float(upHoldSamples) * 1000.0f / sr, std::memory_order_relaxed);
+        }
+
+        // [atMs:32][load x1000:16][reason:4][to:4][from:4]
+        static uint64_t pack(const GovernorDecision& d) {
+            const uint64_t load = uint64_t(std::min(65535.0f, std::max(0.0f, d.load * 1000.0f)));
+            return (uint64_t(d.atMs) << 32) | (load << 16)
+                | (uint64_t(int(d.reason) & 0xF) << 8) | (uint64_t(d.to & 0xF) << 4) | uint64_t(d.from & 0xF);
+        }
+
+        static GovernorDecision unpack(uint64_t w) {
+            GovernorDecision d;
+            d.atMs = uint32_t(w >> 32);
+            d.load = float((w >> 16) & 0xFFFF) / 1000.0f;
+            d.reason = GovernorReason(int((w >> 8) & 0xF));
+            d.to = int((w >> 4) & 0xF);
+            d.from = int(w & 0xF);
+            return d;
+        }
+
+        // Single writer: plain load + store, no read-modify-write needed.
+        static void bump(std::atomic<uint64_t>& a) {
+            a.store(a.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+} // namespace bigpi::core
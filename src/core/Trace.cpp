@@ -0,0 +1,232 @@
+#include "core/Trace.h"
+
+#include <algorithm> // std::max
+#include <chrono>    // collector period
+#include <cstdio>    // std::snprintf
+#include <fstream>   // std::ofstream
+
+namespace bigpi::trace {
+
+    namespace {
+
+        // Cached ring per thread. `gen` guards against a stale pointer after
+        // init() reallocated the pool.
+        struct ThreadSlot {
+            void* ring = nullptr;
+            uint64_t gen = 0;
+        };
+
+        thread_local ThreadSlot tlsSlot{};
+
+        size_t nextPow2(size_t v) {
+            size_t p = 1;
+            while (p < v) p <<= 1;
+            return p;
+        }
+
+        // Event names are code literals, but escape anyway so a stray quote
+        // cannot break the JSON.
+        void writeJsonString(std::ostream& os, const char* s) {
+            os << '"';
+            for (; s && *s; ++s) {
+                const char c = *s;
+                if (c == '"' || c == '\\') os << '\\' << c;
+                else if (static_cast<unsigned char>(c) < 0x20) os << ' ';
+                else os << c;
+            }
+            os << '"';
+        }
+
+    } // namespace
+
+    Tracer& Tracer::instance() {
+        static Tracer t;
+        return t;
+    }
+
+    Tracer::~Tracer() {
+        stopCollector();
+    }
+
+    void Tracer::init(int maxThreads, size_t eventsPerThread) {
+        if (isRecording()) return;
+        stopCollector();
+
+        ringCount = std::max(1, maxThreads);
+        const size_t cap = nextPow2(std::max<size_t>(64, eventsPerThread));
+        mask = cap - 1;
+
+        rings.reset(new Ring[size_t(ringCount)]);
+        for (int i = 0; i < ringCount; ++i) {
+            rings[size_t(i)].events.assign(cap, Event{});
+        }
+
+        generation++;
+        unclaimedDrops.store(0, std::memory_order_relaxed);
+        collected.clear();
+
+        // Calibrate the tick rate now, not on the first export.
+        (void)bigpi::core::ticksPerSecond();
+    }
+
+    void Tracer::start() {
+        if (!rings) init();
+        recording.store(true, std::memory_order_release);
+    }
+
+    void Tracer::stop() {
+        recording.store(false, std::memory_order_release);
+    }
+
+    Tracer::Ring* Tracer::ringForThisThread() {
+        if (tlsSlot.gen == generation) return static_cast<Ring*>(tlsSlot.ring);
+
+        // First event from this thread since init(): claim a free ring.
+        // Bounded loop over a fixed pool, one CAS per ring -> wait-free.
+        Ring* found = nullptr;
+        for (int i = 0; i < ringCount; ++i) {
+            bool expected = false;
+            if (rings[size_t(i)].claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                found = &rings[size_t(i)];
+                break;
+            }
+        }
+
+        // Cache the miss as well, so a thread without a ring does not rescan
+        // the pool on every event.
+        tlsSlot.ring = found;
+        tlsSlot.gen = generation;
+        return found;
+    }
+
+    void Tracer::setThreadName(const char* name) {
+        if (!rings) return;
+        if (Ring* r = ringForThisThread()) r->threadName.store(name, std::memory_order_release);
+    }
+
+    size_t Tracer::drain(std::vector<DrainedEvent>& out) {
+        size_t count = 0;
+        for (int i = 0; i < ringCount; ++i) {
+            Ring& r = rings[size_t(i)];
+            const uint64_t h = r.head.load(std::memory_order_acquire);
+            uint64_t t = r.tail.load(std::memory_order_relaxed);
+
+            for (; t < h; ++t) {
+                DrainedEvent d;
+                d.ev = r.events[size_t(t) & mask];
+                d.slot = i;
+                out.push_back(d);
+                count++;
+            }
+            r.tail.store(t, std::memory_order_release);
+        }
+        return count;
+    }
+
+    uint64_t Tracer::droppedEvents() const {
+        uint64_t n = unclaimedDrops.load(std::memory_order_relaxed);
+        for (int i = 0; i < ringCount; ++i) n += rings[size_t(i)].dropped.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    void Tracer::startCollector(int periodMs) {
+        if (collectorRun.load(std::memory_order_relaxed) || !rings) return;
+        collectorRun.store(true, std::memory_order_release);
+
+        const auto period = std::chrono::milliseconds(std::max(1, periodMs));
+        collector = std::thread([this, period]() {
+            while (collectorRun.load(std::memory_order_acquire)) {
+                drain(collected);
+                std::this_thread::sleep_for(period);
+            }
+        });
+    }
+
+    void Tracer::stopCollector() {
+        collectorRun.store(false, std::memory_order_release);
+        if (collector.joinable()) collector.join();
+    }
+
+    /*
+      writeChromeJson()
+      -----------------
+      Chrome "JSON Object Format":
+        { "traceEvents": [ ... ], "displayTimeUnit": "ns", "otherData": {...} }
+
+      pid is always 1, tid is the ring slot + 1. Timestamps are microseconds
+      relative to the first recorded event.
+    */
+    bool Tracer::writeChromeJson(const std::string& path) {
+        stopCollector();
+        if (rings) drain(collected);
+
+        std::ofstream f(path);
+        if (!f) return false;
+
+        uint64_t t0 = 0;
+        if (!collected.empty()) {
+            t0 = collected.front().ev.ticks;
+            for (const auto& d : collected) t0 = std::min(t0, d.ev.ticks);
+        }
+        const double usPerTick = 1.0e6 / bigpi::core::ticksPerSecond();
+
+        f << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto sep = [&]() {
+            if (!first) f << ",\n";
+            first = false;
+        };
+
+        // Thread names (metadata events)
+        for (int i = 0; i < ringCount; ++i) {
+            const Ring& r = rings[size_t(i)];
+            if (!r.claimed.load(std::memory_order_acquire)) continue;
+
+            const char* name = r.threadName.load(std::memory_order_acquire);
+            char fallback[32];
+            if (!name) {
+                std::snprintf(fallback, sizeof(fallback), "thread %d", i + 1);
+                name = fallback;
+            }
+
+            sep();
+            f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (i + 1)
+              << ",\"args\":{\"name\":";
+            writeJsonString(f, name);
+            f << "}}";
+        }
+
+        char ts[32];
+        for (const auto& d : collected) {
+            std::snprintf(ts, sizeof(ts), "%.3f", double(d.ev.ticks - t0) * usPerTick);
+
+            sep();
+            f << "{\"name\":";
+            writeJsonString(f, d.ev.name);
+            f << ",\"pid\":1,\"tid\":" << (d.slot + 1) << ",\"ts\":" << ts;
+
+            switch (d.ev.type) {
+            case EventType::Begin:
+                f << ",\"ph\":\"B\"";
+                if (d.ev.arg != 0) f << ",\"args\":{\"n\":" << d.ev.arg << "}";
+                break;
+            case EventType::End:
+                f << ",\"ph\":\"E\"";
+                break;
+            case EventType::Instant:
+                f << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"value\":" << d.ev.arg << "}";
+                break;
+            case EventType::Counter:
+                f << ",\"ph\":\"C\",\"args\":{\"value\":" << d.ev.arg << "}";
+                break;
+            }
+            f << "}";
+        }
+
+        f << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"clock\":\""
+          << bigpi::core::cycleCounterName() << "\",\"dropped_events\":" << droppedEvents() << "}}\n";
+
+        return bool(f);
+    }
+
+} // namespace bigpi::trace
@@ -0,0 +1,217 @@
+#pragma once
+/*
+  =============================================================================
+  Trace.h — Big Pi realtime timeline tracer (Chrome / Perfetto trace export)
+  =============================================================================
+
+  Why:
+    Profiling.h tells us averages and histograms. To find a *sporadic* overrun
+    on a pedal we need a timeline: which block was slow, which stage blew up,
+    and what happened just before (mode change, parameter swap, ...).
+
+  How it works:
+    - init() preallocates a fixed pool of per-thread ring buffers
+      (not on the audio thread).
+    - The first event a thread emits claims one free ring with a single CAS
+      and caches it in a thread_local pointer. After that every event is a
+      plain store into that thread's own ring: single producer, no locks,
+      no allocation, wait-free. A full ring drops the event (and counts it)
+      instead of blocking. Rings stay claimed until the next init().
+    - A reader (the harness, or the collector thread started with
+      startCollector()) drains all rings and writes Chrome trace JSON.
+      Open the file in chrome://tracing or https://ui.perfetto.dev
+
+  Events:
+    begin/end : a duration (block, stage)       -> "ph":"B" / "ph":"E"
+    instant   : a point in time (mode change)   -> "ph":"i"
+    counter   : a value over time               -> "ph":"C"
+
+    Event names must be string literals (or otherwise live for the whole
+    program): only the pointer is stored.
+
+  Compile-time switch:
+    BIGPI_TRACE=1 (CMake: -DBIGPI_ENABLE_TRACE=ON) compiles the engine
+    markers in. Without it the BIGPI_TRACE_* macros expand to nothing.
+    The Tracer class itself is always built, so tools can link against it.
+
+  Runtime switch:
+    Markers only record between start() and stop(). When not recording a
+    marker costs one relaxed atomic load.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/CycleClock.h"
+
+#ifndef BIGPI_TRACE
+#define BIGPI_TRACE 0
+#endif
+
+namespace bigpi::trace {
+
+    enum class EventType : uint8_t {
+        Begin = 0,
+        End,
+        Instant,
+        Counter
+    };
+
+    struct Event {
+        uint64_t ticks = 0;         // core::readCycleCounter()
+        const char* name = nullptr; // static string
+        int64_t arg = 0;            // instant/counter value, block size, ...
+        EventType type = EventType::Instant;
+    };
+
+    // One event as drained by the reader (ring index -> thread slot).
+    struct DrainedEvent {
+        Event ev;
+        int slot = 0;
+    };
+
+    class Tracer {
+    public:
+        // Process-wide tracer used by the BIGPI_TRACE_* macros.
+        static Tracer& instance();
+
+        // ---------------------------------------------------------------------
+        // Setup (NOT real-time safe)
+        // ---------------------------------------------------------------------
+
+        // Allocates maxThreads rings of eventsPerThread events each.
+        // eventsPerThread is rounded up to a power of two.
+        // Call before start() and while no thread is emitting; calling it
+        // again while recording is ignored.
+        void init(int maxThreads = 8, size_t eventsPerThread = size_t(1) << 16);
+
+        void start();
+        void stop();
+
+        bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+        // ---------------------------------------------------------------------
+        // Markers (real-time safe: wait-free, no allocation, no locks)
+        // ---------------------------------------------------------------------
+
+        void begin(const char* name, int64_t arg = 0) { emit(EventType::Begin, name, arg); }
+        void end(const char* name) { emit(EventType::End, name, 0); }
+        void instant(const char* name, int64_t arg = 0) { emit(EventType::Instant, name, arg); }
+        void counter(const char* name, int64_t value) { emit(EventType::Counter, name, value); }
+
+        // Names the calling thread in the exported trace (claims its ring).
+        void setThreadName(const char* name);
+
+        // ---------------------------------------------------------------------
+        // Reader side (any ONE thread at a time)
+        // ---------------------------------------------------------------------
+
+        // Moves every pending event into `out` (appends). Returns the count.
+        size_t drain(std::vector<DrainedEvent>& out);
+
+        // Events lost because a ring was full or no ring was free.
+        uint64_t droppedEvents() const;
+
+        // Stops the collector (if running), drains, then writes everything
+        // collected so far as Chrome trace JSON.
+        // Returns false if the file cannot be written.
+        bool writeChromeJson(const std::string& path);
+
+        // Optional background thread that drains every periodMs so long runs
+        // do not overflow the rings. stopCollector() joins it.
+        void startCollector(int periodMs = 50);
+        void stopCollector();
+
+        ~Tracer();
+
+    private:
+        struct Ring {
+            std::vector<Event> events;          // preallocated in init()
+            std::atomic<uint64_t> head{ 0 };    // written by the owner thread
+            std::atomic<uint64_t> tail{ 0 };    // written by the reader
+            std::atomic<uint64_t> dropped{ 0 };
+            std::atomic<bool> claimed{ false };
+            std::atomic<const char*> threadName{ nullptr };
+        };
+
+        std::unique_ptr<Ring[]> rings;
+        int ringCount = 0;
+        size_t mask = 0;
+        uint64_t generation = 1;                 // bumped by init(): invalidates cached slots
+
+        std::atomic<bool> recording{ false };
+        std::atomic<uint64_t> unclaimedDrops{ 0 };
+
+        // Collected (drained) events, reader side only.
+        std::vector<DrainedEvent> collected;
+
+        std::thread collector;
+        std::atomic<bool> collectorRun{ false };
+
+        Ring* ringForThisThread();
+
+        void emit(EventType type, const char* name, int64_t arg) {
+            if (!recording.load(std::memory_order_relaxed)) return;
+
+            Ring* r = ringForThisThread();
+            if (!r) {
+                unclaimedDrops.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            const uint64_t h = r->head.load(std::memory_order_relaxed);
+            if (h - r->tail.load(std::memory_order_acquire) >= uint64_t(r->events.size())) {
+                r->dropped.store(r->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+
+            Event& e = r->events[size_t(h) & mask];
+            e.ticks = bigpi::core::readCycleCounter();
+            e.name = name;
+            e.arg = arg;
+            e.type = type;
+
+            r->head.store(h + 1, std::memory_order_release);
+        }
+    };
+
+    // RAII begin/end pair.
+    class ScopedTrace {
+    public:
+        explicit ScopedTrace(const char* n, int64_t arg = 0) : name(n) { Tracer::instance().begin(n, arg); }
+        ~ScopedTrace() { Tracer::instance().end(name); }
+
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    private:
+        const char* name;
+    };
+
+} // namespace bigpi::trace
+
+// ============================================================================
+// Macros (compile to nothing without BIGPI_TRACE)
+// ============================================================================
+
+#define BIGPI_TRACE_CONCAT2(a, b) a##b
+#define BIGPI_TRACE_CONCAT(a, b) BIGPI_TRACE_CONCAT2(a, b)
+
+#if BIGPI_TRACE
+#define BIGPI_TRACE_SCOPE(name) \
+    ::bigpi::trace::ScopedTrace BIGPI_TRACE_CONCAT(bigpiTraceScope_, __LINE__)(name)
+#define BIGPI_TRACE_SCOPE_ARG(name, arg) \
+    ::bigpi::trace::ScopedTrace BIGPI_TRACE_CONCAT(bigpiTraceScope_, __LINE__)((name), int64_t(arg))
+#define BIGPI_TRACE_INSTANT(name, arg) ::bigpi::trace::Tracer::instance().instant((name), int64_t(arg))
+#define BIGPI_TRACE_COUNTER(name, value) ::bigpi::trace::Tracer::instance().counter((name), int64_t(value))
+#else
+#define BIGPI_TRACE_SCOPE(name) ((void)0)
+#define BIGPI_TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define BIGPI_TRACE_INSTANT(name, arg) ((void)0)
+#define BIGPI_TRACE_COUNTER(name, value) ((void)0)
+#endif
@@ -0,0 +1,203 @@
+#pragma once
+/*
+  =============================================================================
+  Sidechain.h — Big Pi shared sidechain analysis (block peak / RMS / envelopes)
+  =============================================================================
+
+  Several stages of the engine react to how loud something is:
+
+    ducking             dry input level      (attack 8 ms, release 120 ms)
+    dynamic diffusion   tank injection level (fast 2/35 ms vs slow 18/220 ms)
+
+  and future envelope shaping (bloom) wants the same kind of numbers. Instead
+  of every stage owning a dsp::EnvelopeFollower and running it inside its own
+  per-sample loop, one SidechainAnalyzer per watched signal runs once per
+  chunk and publishes the results:
+
+    1. Detector: d[i] = 0.5 * (|L[i]| + |R[i]|), plus the block peak and
+       RMS of d (SSE2 / NEON when available, scalar otherwise).
+    2. Followers: up to kMaxFollowers attack/release envelopes over d,
+       written to per-sample arrays. Consumers just read envelope(k)[i].
+
+  Step 2 is a recursion (each sample needs the previous envelope), so it
+  stays scalar, but it is one tight loop with a select instead of a branch
+  in every consumer. The envelope math is exactly dsp::EnvelopeFollower's,
+  so switching a stage over to the analyzer does not change its output.
+
+  What does not belong here:
+    The tank's dynamic-damping follower and the engine's tail envelope
+    smoother watch the tank's own output of the previous sample. They sit
+    inside the feedback loop and cannot be computed ahead for a whole chunk.
+
+  REAL-TIME RULE: prepare() and setFollower() may allocate / call exp();
+  analyze() and clear() never do.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIGPI_SIDECHAIN_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BIGPI_SIDECHAIN_NEON 1
+#endif
+
+namespace bigpi::core {
+
+    class SidechainAnalyzer {
+    public:
+        static constexpr int kMaxFollowers = 4;
+
+        // Block statistics of the detector signal (last analyze() call)
+        struct Frame {
+            float peak = 0.0f;      // max d[i]
+            float rms = 0.0f;       // sqrt(mean(d[i]^2))
+            int samples = 0;
+        };
+
+        void prepare(float sampleRate, int maxBlock) {
+            sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+            capacity = std::max(1, maxBlock);
+
+            detector.assign(capacity, 0.0f);
+            for (int k = 0; k < kMaxFollowers; ++k) {
+                envBuf[k].assign(capacity, 0.0f);
+                followers[k].setSampleRate(sr);
+            }
+            clear();
+        }
+
+        // Configures follower k (prepare time). Followers 0..k become active.
+        void setFollower(int k, float attackMs, float releaseMs) {
+            if (k < 0 || k >= kMaxFollowers) return;
+            followers[k].setSampleRate(sr);
+            followers[k].setAttackReleaseMs(attackMs, releaseMs);
+            numFollowers = std::max(numFollowers, k + 1);
+        }
+
+        void clear() {
+            for (auto& f : followers) f.clear();
+            for (auto& b : envBuf) std::fill(b.begin(), b.end(), 0.0f);
+            frame = Frame{};
+        }
+
+        /*
+          analyze(l, r, n)
+          ----------------
+          Runs the detector and every active follower over n <= maxBlock
+          samples. Results stay valid until the next call.
+        */
+        void analyze(const float* l, const float* r, int n) {
+            n = std::min(n, capacity);
+
+            float sumSq = 0.0f;
+            frame.peak = detect(l, r, detector.data(), n, sumSq);
+            frame.rms = (n > 0) ? std::sqrt(sumSq / float(n)) : 0.0f;
+            frame.samples = n;
+
+            for (int k = 0; k < numFollowers; ++k) {
+                runFollower(followers[k], detector.data(), envBuf[k].data(), n);
+            }
+        }
+
+        const Frame& lastFrame() const { return frame; }
+
+        // Per-sample envelope of follower k for the last analyzed block.
+        const float* envelope(int k) const { return envBuf[k].data(); }
+
+        // Envelope of follower k after the last analyzed sample.
+        float current(int k) const { return followers[k].env; }
+
+    private:
+        float sr = 48000.0f;
+        int capacity = 0;
+        int numFollowers = 0;
+
+        std::vector<float> detector{};
+        std::array<dsp::EnvelopeFollower, kMaxFollowers> followers{};
+        std::array<std::vector<float>, kMaxFollowers> envBuf{};
+        Frame frame{};
+
+        // d[i] = 0.5 * (|l| + |r|); returns max d, accumulates sum of d^2
+        static float detect(const float* l, const float* r, float* d, int n, float& sumSq) {
+            int i = 0;
+            float peak = 0.0f;
+            float sum = 0.0f;
+
+#if BIGPI_SIDECHAIN_SSE2
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 half = _mm_set1_ps(0.5f);
+            __m128 vPeak = _mm_setzero_ps();
+            __m128 vSum = _mm_setzero_ps();
+
+            for (; i + 4 <= n; i += 4) {
+                const __m128 a = _mm_and_ps(_mm_loadu_ps(l + i), absMask);
+                const __m128 b = _mm_and_ps(_mm_loadu_ps(r + i), absMask);
+                const __m128 v = _mm_mul_ps(half, _mm_add_ps(a, b));
+                _mm_storeu_ps(d + i, v);
+                vPeak = _mm_max_ps(vPeak, v);
+                vSum = _mm_add_ps(vSum, _mm_mul_ps(v, v));
+            }
+
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, vPeak);
+            for (float v : lanes) peak = std::max(peak, v);
+            _mm_store_ps(lanes, vSum);
+            sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif BIGPI_SIDECHAIN_NEON
+            const float32x4_t half = vdupq_n_f32(0.5f);
+            float32x4_t vPeak = vdupq_n_f32(0.0f);
+            float32x4_t vSum = vdupq_n_f32(0.0f);
+
+            for (; i + 4 <= n; i += 4) {
+                const float32x4_t a = vabsq_f32(vld1q_f32(l + i));
+                const float32x4_t b = vabsq_f32(vld1q_f32(r + i));
+                const float32x4_t v = vmulq_f32(half, vaddq_f32(a, b));
+                vst1q_f32(d + i, v);
+                vPeak = vmaxq_f32(vPeak, v);
+                vSum = vmlaq_f32(vSum, v, v);
+            }
+
+            float lanes[4];
+            vst1q_f32(lanes, vPeak);
+            for (float v : lanes) peak = std::max(peak, v);
+            vst1q_f32(lanes, vSum);
+            sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+            for (; i < n; ++i) {
+                const float v = 0.5f * (std::abs(l[i]) + std::abs(r[i]));
+                d[i] = v;
+                peak = std::max(peak, v);
+                sum += v * v;
+            }
+
+            sumSq = sum;
+            return peak;
+        }
+
+        // Same math as dsp::EnvelopeFollower::process() (x is already >= 0)
+        static void runFollower(dsp::EnvelopeFollower& f, const float* x, float* out, int n) {
+            const float aAtk = f.aAtk;
+            const float aRel = f.aRel;
+            float env = f.env;
+
+            for (int i = 0; i < n; ++i) {
+                const float mag = x[i];
+                const float a = (mag > env) ? aAtk : aRel;
+                env = a * env + (1.0f - a) * mag;
+                env = dsp::killDenorm(env);
+                out[i] = env;
+            }
+
+            f.env = env;
+        }
+    };
+
+} // namespace bigpi::core
@@ -136,6 +136,12 @@ namespace dsp {
 
         void clear() { z1 = 0.0f; z2 = 0.0f; }
 
+        // Takes another biquad's coefficients, keeps this one's state.
+        void copyCoeffs(const Biquad& o) {
+            b0 = o.b0; b1 = o.b1; b2 = o.b2;
+            a1 = o.a1; a2 = o.a2;
+        }
+
         float process(float x) {
             float y = b0 * x + z1;
             z1 = b1 * x - a1 * y + z2;
@@ -185,6 +191,23 @@ namespace dsp {
             a1 = aa1 / aa0; a2 = aa2 / aa0;
         }
 
+        // Band-pass, 0 dB at the centre frequency
+        void setBandPass(float hz, float Q, float sr) {
+            Q = clampf(Q, 0.1f, 10.0f);
+            float w0, c, s; omega(hz, sr, w0, c, s);
+            float alpha = s / (2.0f * Q);
+
+            float bb0 = alpha;
+            float bb1 = 0.0f;
+            float bb2 = -alpha;
+            float aa0 = 1.0f + alpha;
+            float aa1 = -2.0f * c;
+            float aa2 = 1.0f - alpha;
+
+            b0 = bb0 / aa0; b1 = bb1 / aa0; b2 = bb2 / aa0;
+            a1 = aa1 / aa0; a2 = aa2 / aa0;
+        }
+
         void setLowShelf(float hz, float gainDb, float S, float sr) {
             S = clampf(S, 0.1f, 5.0f);
             float A = std::pow(10.0f, gainDb / 40.0f);
@@ -358,6 +381,25 @@ namespace dsp {
 
             return h00 * y1 + h10 * m1 + h01 * y2 + h11 * m2;
         }
+
+        // Two-point linear read: cheaper than readFracCubic(), slightly duller
+        // on modulated lines (used by the quality governor under CPU pressure).
+        float readFracLinear(float delaySamples) const {
+            if (buf.size() < 4) return 0.0f;
+
+            delaySamples = clampf(delaySamples, 0.0f, float(buf.size() - 4));
+
+            float rp = float(w) - delaySamples;
+            while (rp < 0.0f) rp += float(buf.size());
+            while (rp >= float(buf.size())) rp -= float(buf.size());
+
+            int i1 = int(rp);
+            float f = rp - float(i1);
+
+            int i2 = i1 + 1; if (i2 >= (int)buf.size()) i2 -= (int)buf.size();
+
+            return buf[i1] + f * (buf[i2] - buf[i1]);
+        }
     };
 
     // ============================================================================
@@ -414,6 +456,35 @@ namespace dsp {
         return y * norm;
     }
 
+    // Rational tanh approximation (max error ~1.3e-3, exact +-1 beyond |x| ~ 4)
+    inline float fastTanh(float x) {
+        x = clampf(x, -5.0f, 5.0f);
+        const float x2 = x * x;
+        const float num = x * (2027025.0f + x2 * (270270.0f + x2 * (6930.0f + 36.0f * x2)));
+        const float den = 2027025.0f + x2 * (945945.0f + x2 * (51975.0f + 630.0f * x2));
+        return clampf(num / den, -1.0f, 1.0f);
+    }
+
+    // softSat() curve with the normaliser cached at setDrive() time and
+    // fastTanh() instead of std::tanh (per-sample cost: one division).
+    struct SoftSaturator {
+        float gain = 1.0f;      // 1 + drive
+        float norm = 1.0f;      // 1 / tanh(1 + drive)
+
+        void setDrive(float drive) {
+            drive = clampf(drive, 0.0f, 10.0f);
+            gain = 1.0f + drive;
+            norm = 1.0f / std::tanh(gain);
+        }
+
+        // Gain for small signals (the slope at 0)
+        float smallSignalGain() const { return gain * norm; }
+
+        float process(float x) const {
+            return fastTanh(x * gain) * norm;
+        }
+    };
+
     // ============================================================================
     // SmoothNoise
     // ============================================================================
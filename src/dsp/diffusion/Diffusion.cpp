@@ -83,7 +83,7 @@ namespace bigpi::core {
         inputCfg = cfg;
 
         // NOTE: header helper name is clampInputStages()
-        activeInputStages = clampInputStages(inputCfg.stages);
+        activeInputStages = std::min(clampInputStages(inputCfg.stages), inputStageCap);
 
         for (int i = 0; i < kMaxInputStages; ++i) {
             float msL = inputCfg.timesMsL[i];
@@ -133,6 +133,52 @@ namespace bigpi::core {
         R = xR;
     }
 
+    void Diffusion::setInputStageCap(int cap) {
+        inputStageCap = clampInputStages(cap);
+        activeInputStages = std::min(clampInputStages(inputCfg.stages), inputStageCap);
+    }
+
+    void Diffusion::processInputBlend(float& L, float& R, int lowStages, float wFull) {
+        const int fullStages = clampInputStages(inputCfg.stages);
+        if (!inited || fullStages <= 0) return;
+
+        lowStages = std::max(0, std::min(lowStages, fullStages));
+
+        float g = dsp::clampf(tvG, 0.30f, 0.85f);
+
+        float xL = L;
+        float xR = R;
+        float lowL = L;
+        float lowR = R;
+
+        for (int i = 0; i < fullStages; ++i) {
+            if (i == lowStages) {
+                lowL = xL;
+                lowR = xR;
+            }
+
+            inL[i].g = g;
+            inR[i].g = g;
+
+            xL = inL[i].process(xL);
+            xR = inR[i].process(xR);
+        }
+        if (lowStages == fullStages) {
+            lowL = xL;
+            lowR = xR;
+        }
+
+        L = lowL + wFull * (xL - lowL);
+        R = lowR + wFull * (xR - lowR);
+    }
+
+    void Diffusion::clearInputStagesFrom(int first) {
+        for (int i = std::max(0, first); i < kMaxInputStages; ++i) {
+            inL[i].clear();
+            inR[i].clear();
+        }
+    }
+
     void Diffusion::processLate(float& L, float& R, float amount01) {
         if (!inited) return;
 
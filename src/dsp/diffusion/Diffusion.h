@@ -115,6 +115,28 @@ namespace bigpi::core {
         // Applies the input diffusion chain in-place.
         void processInput(float& L, float& R);
 
+        // ----------------------------------------------------------------------
+        // Quality governor support (core/QualityGovernor.h)
+        // ----------------------------------------------------------------------
+
+        // Upper bound on the active input stages; survives setInputConfig().
+        // kMaxInputStages = no cap.
+        void setInputStageCap(int cap);
+
+        int getConfiguredInputStages() const { return clampInputStages(inputCfg.stages); }
+
+        /*
+          processInputBlend(L, R, lowStages, wFull)
+          -----------------------------------------
+          Runs every configured stage (ignoring the cap), taps the signal after
+          lowStages and returns low + wFull * (full - low). Used to crossfade
+          between two stage counts without a click.
+        */
+        void processInputBlend(float& L, float& R, int lowStages, float wFull);
+
+        // Flushes stages [first, kMaxInputStages) before they are re-enabled.
+        void clearInputStagesFrom(int first);
+
         /*
           processLate(L, R, amount01)
           ---------------------------
@@ -140,6 +162,7 @@ namespace bigpi::core {
 
         // How many input stages are active
         int activeInputStages = 6;
+        int inputStageCap = kMaxInputStages;
 
         // Time-varying diffusion coefficient (optional modulation source)
         float tvG = 0.72f;
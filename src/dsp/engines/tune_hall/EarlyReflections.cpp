@@ -16,13 +16,6 @@ static inline float msToSamples(float ms, float sr) {
 void EarlyReflections::prepare(float sampleRate) {
     sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
 
-    // Early reflections rarely need more than ~80ms buffer.
-    // We allocate 100ms for safety.
-    int maxSamples = std::max(16, int(sr * 0.10f));
-
-    delayL.init(maxSamples);
-    delayR.init(maxSamples);
-
     // Smoothing times chosen to prevent zipper noise but remain responsive.
     levelSm.setTimeMs(80.0f, sr);
     sizeSm.setTimeMs(120.0f, sr);
@@ -33,9 +26,6 @@ void EarlyReflections::prepare(float sampleRate) {
 }
 
 void EarlyReflections::reset() {
-    delayL.clear();
-    delayR.clear();
-
     dampL.clear();
     dampR.clear();
 
@@ -50,7 +40,8 @@ void EarlyReflections::setParams(const Params& p) {
     target = p;
 }
 
-void EarlyReflections::processBlock(const float* inL, const float* inR,
+void EarlyReflections::processBlock(const dsp::DelayLine& histL, const dsp::DelayLine& histR,
+    float offsetSamp,
     float* outL, float* outR,
     int n)
 {
@@ -74,17 +65,11 @@ void EarlyReflections::processBlock(const float* inL, const float* inR,
         dampR.a = aLP;
 
         // --------------------------------------------------------------------
-        // 2) Read input and write into delay
+        // 2) Multi-tap read from the shared input history
+        //    (the history is ahead of sample i by n - 1 - i samples)
         // --------------------------------------------------------------------
-        float xL = inL[i];
-        float xR = inR[i];
+        const float base = offsetSamp + float(n - 1 - i);
 
-        delayL.push(xL);
-        delayR.push(xR);
-
-        // --------------------------------------------------------------------
-        // 3) Multi-tap read
-        // --------------------------------------------------------------------
         float erL = 0.0f;
         float erR = 0.0f;
 
@@ -94,21 +79,21 @@ void EarlyReflections::processBlock(const float* inL, const float* inR,
             // Slight decorrelation for R tap times so stereo ER doesn't collapse
             float dSampR = msToSamples(kTapTimesMs[t] * size * 1.10f, sr);
 
-            float tapL = delayL.readFracCubic(dSampL);
-            float tapR = delayR.readFracCubic(dSampR);
+            float tapL = histL.readFracCubic(base + dSampL);
+            float tapR = histR.readFracCubic(base + dSampR);
 
             erL += tapL * kTapGains[t];
             erR += tapR * kTapGains[t];
         }
 
         // --------------------------------------------------------------------
-        // 4) Damping (low-pass)
+        // 3) Damping (low-pass)
         // --------------------------------------------------------------------
         erL = dampL.process(erL);
         erR = dampR.process(erR);
 
         // --------------------------------------------------------------------
-        // 5) Stereo width (Mid/Side)
+        // 4) Stereo width (Mid/Side)
         // --------------------------------------------------------------------
         float M = 0.5f * (erL + erR);
         float S = 0.5f * (erL - erR);
@@ -119,7 +104,7 @@ void EarlyReflections::processBlock(const float* inL, const float* inR,
         erR = M - S;
 
         // --------------------------------------------------------------------
-        // 6) Apply level
+        // 5) Apply level
         // --------------------------------------------------------------------
         erL *= level;
         erR *= level;
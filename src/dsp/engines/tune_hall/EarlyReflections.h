@@ -21,7 +21,7 @@ public:
 
     EarlyReflections() = default;
 
-    // Allocate buffers and initialize smoothers.
+    // Initialize smoothers (ER owns no delay memory, see processBlock).
     void prepare(float sampleRate);
 
     // Flush delay/filter state.
@@ -30,20 +30,30 @@ public:
     // Update target parameters (smoothing happens in process).
     void setParams(const Params& p);
 
-    // Process block of stereo input -> stereo ER output.
-    void processBlock(const float* inL, const float* inR,
+    /*
+      Process one block -> stereo ER output.
+
+      The ER taps read the engine's input history (the predelay buffer)
+      directly instead of copying the predelayed signal into delay lines
+      of their own. histL/histR must already hold all n input samples of
+      this block (sample n-1 is the newest). Every tap is read at
+          offsetSamp + tapDelay + (n - 1 - i)
+      for output sample i, so offsetSamp = predelay - 1 gives taps that
+      sit tapDelay after the predelayed signal.
+    */
+    void processBlock(const dsp::DelayLine& histL, const dsp::DelayLine& histR,
+        float offsetSamp,
         float* outL, float* outR,
         int n);
 
+    // Longest tap (ms) at the largest size: the input history must cover it.
+    static constexpr float kMaxTapMs = 41.0f * 2.0f * 1.10f;
+
 private:
     float sr = 48000.0f;
 
     Params target{};
 
-    // Delay lines for left/right ER
-    dsp::DelayLine delayL{};
-    dsp::DelayLine delayR{};
-
     // Damping filters (one-pole low-pass)
     dsp::OnePoleLP dampL{};
     dsp::OnePoleLP dampR{};
@@ -48,25 +48,44 @@ void OutputStage::setParams(const Params& p) {
 }
 
 void OutputStage::updateFilters() {
+    applyCoeffs(makeCoeffs(target, sr));
+}
+
+OutputStage::Coeffs OutputStage::makeCoeffs(const Params& p, float sampleRate) {
+    const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+    Coeffs k;
+    k.params = p;
+
     // Clamp params to safe ranges.
-    float hpHz = std::max(5.0f, std::min(target.hpHz, 0.49f * sr));
+    float hpHz = std::max(5.0f, std::min(p.hpHz, 0.49f * sr));
 
-    float lowHz = std::max(5.0f, std::min(target.lowShelfHz, 0.49f * sr));
-    float highHz = std::max(5.0f, std::min(target.highShelfHz, 0.49f * sr));
+    float lowHz = std::max(5.0f, std::min(p.lowShelfHz, 0.49f * sr));
+    float highHz = std::max(5.0f, std::min(p.highShelfHz, 0.49f * sr));
 
-    float lowDb = std::max(-24.0f, std::min(target.lowGainDb, 24.0f));
-    float highDb = std::max(-24.0f, std::min(target.highGainDb, 24.0f));
+    float lowDb = std::max(-24.0f, std::min(p.lowGainDb, 24.0f));
+    float highDb = std::max(-24.0f, std::min(p.highGainDb, 24.0f));
 
     // High-pass
-    hpL.setHighPass(hpHz, 0.707f, sr);
-    hpR.setHighPass(hpHz, 0.707f, sr);
+    k.hp.setHighPass(hpHz, 0.707f, sr);
+
+    // Shelves (L and R share the design)
+    k.lowShelf.setLowShelf(lowHz, lowDb, 0.9f, sr);
+    k.highShelf.setHighShelf(highHz, highDb, 0.9f, sr);
+    return k;
+}
+
+void OutputStage::applyCoeffs(const Coeffs& k) {
+    target = k.params;
+
+    hpL.copyCoeffs(k.hp);
+    hpR.copyCoeffs(k.hp);
 
-    // Shelves
-    lowL.setLowShelf(lowHz, lowDb, 0.9f, sr);
-    lowR.setLowShelf(lowHz, lowDb, 0.9f, sr);
+    lowL.copyCoeffs(k.lowShelf);
+    lowR.copyCoeffs(k.lowShelf);
 
-    highL.setHighShelf(highHz, highDb, 0.9f, sr);
-    highR.setHighShelf(highHz, highDb, 0.9f, sr);
+    highL.copyCoeffs(k.highShelf);
+    highR.copyCoeffs(k.highShelf);
 }
 
 void OutputStage::processBlock(float* wetL, float* wetR, int n) {
@@ -22,12 +22,29 @@ public:
         float level = 1.0f;   // output level scaling
     };
 
+    /*
+      Coeffs
+      ------
+      Params plus the filter coefficients they design at one sample rate.
+      makeCoeffs() is pure (any thread); applyCoeffs() only copies, so a
+      program change on the audio thread does no filter design.
+    */
+    struct Coeffs {
+        Params params{};
+        dsp::Biquad hp{};
+        dsp::Biquad lowShelf{};
+        dsp::Biquad highShelf{};
+    };
+
     OutputStage() = default;
 
     void prepare(float sampleRate);
     void reset();
     void setParams(const Params& p);
 
+    static Coeffs makeCoeffs(const Params& p, float sampleRate);
+    void applyCoeffs(const Coeffs& k);
+
     // In-place processing of wet buffers
     void processBlock(float* wetL, float* wetR, int n);
 
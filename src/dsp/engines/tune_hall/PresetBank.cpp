@@ -0,0 +1,558 @@
+#include "dsp/engines/tune_hall/PresetBank.h"
+
+#include "core/Version.h"
+
+#include <cstdio>    // std::snprintf
+#include <cstring>   // std::memcpy, std::memcmp, std::memchr
+#include <fstream>   // std::ifstream, std::ofstream
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BIGPI_BANK_MMAP 1
+#else
+#define BIGPI_BANK_MMAP 0
+#endif
+
+/*
+  =============================================================================
+  PresetBank.cpp — Big Pi binary preset bank (implementation)
+  =============================================================================
+*/
+
+static const char kMagic[8] = { 'B', 'I', 'G', 'P', 'I', 'B', 'N', 'K' };
+
+static inline size_t alignUp(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+// FNV-1a (64-bit): checksum of the payload
+static uint64_t fnv1a64(const unsigned char* p, size_t n, uint64_t h = 0xCBF29CE484222325ull) {
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+// Length of a fixed-size, maybe unterminated char field
+static size_t fieldLen(const char* s, size_t cap) {
+    const void* z = std::memchr(s, 0, cap);
+    return z ? size_t(static_cast<const char*>(z) - s) : cap;
+}
+
+static uint32_t mixLayout(uint32_t h, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        h ^= (v >> (8 * i)) & 0xFFu;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+PresetBank::~PresetBank() {
+    close();
+}
+
+// =============================================================================
+// Layout schema
+// =============================================================================
+//
+// Every struct stored in a Program, member by member, in declaration order.
+// layoutHash() mixes in each member's name, offset and size, so reordering,
+// renaming, resizing or swapping members changes the hash (struct sizes
+// alone would not). Nested structs appear once as a member of their parent
+// and once with a table of their own.
+//
+// BIGPI_LAYOUT_COVERS fails the build when a table no longer tiles its
+// struct exactly, i.e. a member was added, removed or moved without
+// updating the table here (and bumping PresetBank::kVersion).
+
+struct LayoutField {
+    const char* name;
+    size_t offset;
+    size_t size;
+    size_t align;
+};
+
+#define BIGPI_LAYOUT_FIELD(T, m) \
+    LayoutField{ #m, offsetof(T, m), sizeof(T::m), alignof(decltype(T::m)) }
+#define BIGPI_LAYOUT_FIELD_ALIGNED(T, m, a) \
+    LayoutField{ #m, offsetof(T, m), sizeof(T::m), size_t(a) }
+
+// True when the fields, in order, fill a struct of this size and alignment
+// with nothing but alignment padding between them.
+template <size_t N>
+static constexpr bool layoutCovers(const LayoutField (&f)[N], size_t size, size_t align) {
+    size_t end = 0;
+    for (size_t i = 0; i < N; ++i) {
+        if (f[i].offset != (end + f[i].align - 1) / f[i].align * f[i].align) return false;
+        end = f[i].offset + f[i].size;
+    }
+    return (end + align - 1) / align * align == size;
+}
+
+#define BIGPI_LAYOUT_COVERS(T, table) \
+    static_assert(layoutCovers(table, sizeof(T), alignof(T)), \
+        #T " changed: update " #table " in PresetBank.cpp and bump PresetBank::kVersion")
+
+#define F(m) BIGPI_LAYOUT_FIELD(dsp::Biquad, m)
+static constexpr LayoutField kBiquadFields[] = {
+    F(b0), F(b1), F(b2), F(a1), F(a2), F(z1), F(z2),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(dsp::Biquad, kBiquadFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(dsp::SoftSaturator, m)
+static constexpr LayoutField kSoftSaturatorFields[] = {
+    F(gain), F(norm),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(dsp::SoftSaturator, kSoftSaturatorFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::ModeFeatures, m)
+static constexpr LayoutField kModeFeaturesFields[] = {
+    F(usePitchBlock), F(useGranularBlock), F(useMagneticBlock), F(useSingularity),
+    F(useSpringModel), F(useBlossomEnv),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::ModeFeatures, kModeFeaturesFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::TankConfig, m)
+static constexpr LayoutField kModeTankFields[] = {
+    F(delayLines), F(delayScale), F(useHouseholder), F(inputDiffStages), F(inputDiffG),
+    F(lateDiffMinG), F(lateDiffMaxG), F(modDepthMs), F(modRateHz), F(decayLowMul), F(decayMidMul),
+    F(decayHighMul), F(tapPattern), F(tapPatternLate), F(modDepthMul), F(modRateMul),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::TankConfig, kModeTankFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::ModeConfig, m)
+static constexpr LayoutField kModeConfigFields[] = {
+    F(mode), F(tank), F(features), F(defaultMix), F(defaultDecay), F(defaultDamping),
+    F(defaultPreDelay), F(defaultERLevel), F(defaultERSize),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::ModeConfig, kModeConfigFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::Tank::Config, m)
+static constexpr LayoutField kTankConfigFields[] = {
+    F(lines), F(matrix), F(delaySamp), F(fbHpHz), F(dampHz), F(xoverLoHz), F(xoverHiHz),
+    F(decayLowMul), F(decayMidMul), F(decayHighMul), F(drive), F(satMix), F(modDepthSamples),
+    F(modRateHz), F(modDepthMul), F(modRateMul), F(jitterEnable), F(jitterAmount), F(jitterRateHz),
+    F(jitterSmoothMs), F(cloudEnable), F(cloudSpinHz), F(cloudWanderAmount), F(cloudWanderRateHz),
+    F(cloudWanderSmoothMs), F(dynEnable), F(dynAmount), F(dynMinHz), F(dynMaxHz), F(dynSensitivity),
+    F(dynAtkMs), F(dynRelMs), F(shimmerAmount), F(shimmerFifthMix),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::Tank::Config, kTankConfigFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::Tank::Coeffs, m)
+static constexpr LayoutField kTankCoeffsFields[] = {
+    F(cfg), F(hpA), F(lpA), F(xLoA), F(xHiA), F(jitterRateHz), F(jitterPeriod), F(jitterA),
+    F(cloudRateHz), F(cloudPeriod), F(cloudA), F(envAtk), F(envRel), F(decay01), F(fbGainLow),
+    F(fbGainMid), F(fbGainHigh),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::Tank::Coeffs, kTankCoeffsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::Diffusion::InputConfig, m)
+static constexpr LayoutField kDiffInputFields[] = {
+    F(stages), F(g), F(timesMsL), F(timesMsR),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::Diffusion::InputConfig, kDiffInputFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::Diffusion::LateConfig, m)
+static constexpr LayoutField kDiffLateFields[] = {
+    F(minG), F(maxG), F(timesMsL), F(timesMsR),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::Diffusion::LateConfig, kDiffLateFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(EarlyReflections::Params, m)
+static constexpr LayoutField kErParamsFields[] = {
+    F(level), F(size), F(dampHz), F(width),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(EarlyReflections::Params, kErParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(OutputStage::Params, m)
+static constexpr LayoutField kOutParamsFields[] = {
+    F(hpHz), F(lowShelfHz), F(lowGainDb), F(highShelfHz), F(highGainDb), F(width), F(drive),
+    F(level),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(OutputStage::Params, kOutParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(OutputStage::Coeffs, m)
+static constexpr LayoutField kOutCoeffsFields[] = {
+    F(params), F(hp), F(lowShelf), F(highShelf),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(OutputStage::Coeffs, kOutCoeffsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::GranularEngine::Params, m)
+static constexpr LayoutField kGranularParamsFields[] = {
+    F(behavior), F(densityHz), F(lengthMs), F(pitchRange), F(reverse), F(scan),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::GranularEngine::Params, kGranularParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::SpringModel::Params, m)
+static constexpr LayoutField kSpringParamsFields[] = {
+    F(lengthMs), F(dispersion), F(drip), F(dampHz), F(toneHz), F(emphasis),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::SpringModel::Params, kSpringParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::SpringModel::Coeffs, m)
+static constexpr LayoutField kSpringCoeffsFields[] = {
+    F(params), F(stretch), F(loopDelay),
+    BIGPI_LAYOUT_FIELD_ALIGNED(bigpi::core::SpringModel::Coeffs, apCoef, 16), F(feedback), F(lpA),
+    F(hpA), F(band),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::SpringModel::Coeffs, kSpringCoeffsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::MagneticTape::Params, m)
+static constexpr LayoutField kTapeParamsFields[] = {
+    F(heads), F(timeMs), F(feedback), F(wow), F(flutter), F(drive), F(age),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::MagneticTape::Params, kTapeParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::MagneticTape::Coeffs, m)
+static constexpr LayoutField kTapeCoeffsFields[] = {
+    F(params), F(numHeads), F(ratio), F(gainL), F(gainR), F(wowCos), F(wowSin), F(flutterCos),
+    F(flutterSin), F(timeSamp), F(wowSamp), F(flutterSamp), F(wowRotCos), F(wowRotSin),
+    F(flutterRotCos), F(flutterRotSin), F(feedback), F(sat), F(playGain), F(lpA), F(hpA),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::MagneticTape::Coeffs, kTapeCoeffsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::SingularityEngine::Params, m)
+static constexpr LayoutField kSingularityParamsFields[] = {
+    F(sizeSec), F(decaySec), F(dampHz), F(gravity),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::SingularityEngine::Params, kSingularityParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(bigpi::core::SingularityEngine::Coeffs, m)
+static constexpr LayoutField kSingularityCoeffsFields[] = {
+    F(params), F(decim), F(decRate), F(delay), F(warpAmp), F(warpInc), F(gain), F(gainFrozen),
+    F(lpA), F(aa),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(bigpi::core::SingularityEngine::Coeffs, kSingularityCoeffsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(ReverbEngine::Params, m)
+static constexpr LayoutField kEngineParamsFields[] = {
+    F(mode), F(mix), F(predelayMs), F(decay), F(dampingHz), F(feedbackHpHz), F(modDepthMs),
+    F(modRateHz), F(modJitterEnable), F(modJitterAmount), F(modJitterRateHz), F(modJitterSmoothMs),
+    F(fbXoverLoHz), F(fbXoverHiHz), F(decayLowMul), F(decayMidMul), F(decayHighMul),
+    F(inputDiffStages), F(inputDiffG), F(lateDiffEnable), F(lateDiffAmount), F(lateDiffMinG),
+    F(lateDiffMaxG), F(erLevel), F(erSize), F(erDampHz), F(erWidth), F(stereoDepth), F(cloudEnable),
+    F(cloudSpinHz), F(cloudWanderAmount), F(cloudWanderRateHz), F(cloudWanderSmoothMs),
+    F(cloudFrontEnable), F(cloudFrontAmount), F(cloudFrontSizeMs), F(cloudFrontWidth),
+    F(cloudDelaySetEnable), F(cloudSmearEnable), F(cloudSmearAmount), F(cloudSmearTimeMs),
+    F(cloudSmearWidth), F(dynDiffEnable), F(dynDiffTailBoost), F(dynDiffTransientReduce),
+    F(dynDiffLateBoost), F(shimmerEnable), F(shimmerAmount), F(shimmerFifthMix), F(granularEnable),
+    F(granularAmount), F(granularBehavior), F(granularDensityHz), F(granularLengthMs),
+    F(granularPitchRange), F(granularReverse), F(granularScan), F(springEnable), F(springMix),
+    F(springLengthMs), F(springDispersion), F(springDrip), F(springDampHz), F(springToneHz),
+    F(springEmphasis), F(tapeEnable), F(tapeMix), F(tapeHeads), F(tapeTimeMs), F(tapeFeedback),
+    F(tapeWow), F(tapeFlutter), F(tapeDrive), F(tapeAge), F(singularityEnable), F(singularityMix),
+    F(singularitySizeSec), F(singularityDecaySec), F(singularityDampHz), F(singularityGravity),
+    F(outHpHz), F(outLowShelfHz), F(outLowGainDb), F(outHighShelfHz), F(outHighGainDb), F(outWidth),
+    F(outDrive), F(outLevel), F(freeze), F(duckEnable), F(duckThresholdDb), F(duckDepthDb),
+    F(loudCompEnable), F(loudCompStrength), F(loudCompMaxDb), F(tankLines),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(ReverbEngine::Params, kEngineParamsFields);
+
+#define F(m) BIGPI_LAYOUT_FIELD(ReverbEngine::Program, m)
+static constexpr LayoutField kProgramFields[] = {
+    F(params), F(sampleRate), F(modeCfg), F(tank), F(diffInput), F(diffLate), F(er), F(out),
+    F(granular), F(spring), F(tape), F(singularity),
+};
+#undef F
+BIGPI_LAYOUT_COVERS(ReverbEngine::Program, kProgramFields);
+
+static uint32_t mixName(uint32_t h, const char* s) {
+    for (; *s; ++s) {
+        h ^= uint32_t(uint8_t(*s));
+        h *= 0x01000193u;
+    }
+    return mixLayout(h, 0u);
+}
+
+template <size_t N>
+static uint32_t mixSchema(uint32_t h, const char* type, size_t size, const LayoutField (&f)[N]) {
+    h = mixName(h, type);
+    h = mixLayout(h, uint32_t(size));
+    for (const LayoutField& field : f) {
+        h = mixName(h, field.name);
+        h = mixLayout(h, uint32_t(field.offset));
+        h = mixLayout(h, uint32_t(field.size));
+    }
+    return h;
+}
+
+#define BIGPI_LAYOUT_MIX(h, T, table) mixSchema(h, #T, sizeof(T), table)
+
+uint32_t PresetBank::layoutHash() {
+    using Tank = bigpi::core::Tank;
+    using Diffusion = bigpi::core::Diffusion;
+
+    uint32_t h = 0x811C9DC5u;
+    h = BIGPI_LAYOUT_MIX(h, ReverbEngine::Program, kProgramFields);
+    h = BIGPI_LAYOUT_MIX(h, ReverbEngine::Params, kEngineParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::ModeConfig, kModeConfigFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::TankConfig, kModeTankFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::ModeFeatures, kModeFeaturesFields);
+    h = BIGPI_LAYOUT_MIX(h, Tank::Config, kTankConfigFields);
+    h = BIGPI_LAYOUT_MIX(h, Tank::Coeffs, kTankCoeffsFields);
+    h = BIGPI_LAYOUT_MIX(h, Diffusion::InputConfig, kDiffInputFields);
+    h = BIGPI_LAYOUT_MIX(h, Diffusion::LateConfig, kDiffLateFields);
+    h = BIGPI_LAYOUT_MIX(h, EarlyReflections::Params, kErParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, OutputStage::Params, kOutParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, OutputStage::Coeffs, kOutCoeffsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::GranularEngine::Params, kGranularParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::SpringModel::Params, kSpringParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::SpringModel::Coeffs, kSpringCoeffsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::MagneticTape::Params, kTapeParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::MagneticTape::Coeffs, kTapeCoeffsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::SingularityEngine::Params, kSingularityParamsFields);
+    h = BIGPI_LAYOUT_MIX(h, bigpi::core::SingularityEngine::Coeffs, kSingularityCoeffsFields);
+    h = BIGPI_LAYOUT_MIX(h, dsp::Biquad, kBiquadFields);
+    h = BIGPI_LAYOUT_MIX(h, dsp::SoftSaturator, kSoftSaturatorFields);
+
+    h = mixLayout(h, uint32_t(Tank::kMaxLines));
+    h = mixLayout(h, uint32_t(Diffusion::kMaxInputStages));
+    h = mixLayout(h, uint32_t(Diffusion::kLateStages));
+    h = mixLayout(h, uint32_t(bigpi::Mode::Count));
+    return h;
+}
+
+// =============================================================================
+// Writing
+// =============================================================================
+
+bool PresetBank::write(const std::string& path,
+    const std::vector<Entry>& entries,
+    const std::vector<float>& rates,
+    std::string& error)
+{
+    if (entries.empty()) { error = "no presets"; return false; }
+    if (rates.empty() || int(rates.size()) > kMaxRates) {
+        error = "need 1.." + std::to_string(kMaxRates) + " sample rates";
+        return false;
+    }
+    for (size_t i = 0; i < rates.size(); ++i) {
+        if (!(rates[i] > 1.0f)) { error = "bad sample rate"; return false; }
+        for (size_t j = 0; j < i; ++j) {
+            if (rates[j] == rates[i]) { error = "duplicate sample rate"; return false; }
+        }
+    }
+    for (const Entry& e : entries) {
+        if (e.name.empty() || e.name.size() >= size_t(kNameLen)) {
+            error = "preset name must be 1.." + std::to_string(kNameLen - 1) + " characters: '" + e.name + "'";
+            return false;
+        }
+    }
+
+    const size_t stride = alignUp(sizeof(Program), kAlign);
+    const size_t namesOffset = kHeaderBytes;
+    const size_t programsOffset = alignUp(namesOffset + entries.size() * kNameLen, kAlign);
+    const size_t fileSize = programsOffset + entries.size() * rates.size() * stride;
+
+    std::vector<unsigned char> buf(fileSize, 0);
+
+    for (size_t p = 0; p < entries.size(); ++p) {
+        std::memcpy(&buf[namesOffset + p * kNameLen], entries[p].name.data(), entries[p].name.size());
+
+        for (size_t r = 0; r < rates.size(); ++r) {
+            const Program g = ReverbEngine::makeProgram(entries[p].params, rates[r]);
+            std::memcpy(&buf[programsOffset + (p * rates.size() + r) * stride], &g, sizeof(Program));
+        }
+    }
+
+    FileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.endianTag = kEndianTag;
+    h.layoutHash = layoutHash();
+    h.programSize = uint32_t(sizeof(Program));
+    h.programStride = uint32_t(stride);
+    h.numPrograms = uint32_t(entries.size());
+    h.numRates = uint32_t(rates.size());
+    for (size_t r = 0; r < rates.size(); ++r) h.rates[r] = rates[r];
+    std::snprintf(h.buildId, sizeof(h.buildId), "%s", REVERB_BUILD_ID);
+    h.namesOffset = namesOffset;
+    h.programsOffset = programsOffset;
+    h.fileSize = fileSize;
+    h.payloadHash = fnv1a64(buf.data() + namesOffset, fileSize - namesOffset);
+    std::memcpy(buf.data(), &h, sizeof(h));
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) { error = "cannot write " + path; return false; }
+    f.write(reinterpret_cast<const char*>(buf.data()), std::streamsize(buf.size()));
+    if (!f) { error = "write failed: " + path; return false; }
+    return true;
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+bool PresetBank::open(const std::string& path, std::string& error) {
+    close();
+
+#if BIGPI_BANK_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { error = "cannot open " + path; return false; }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        error = "cannot stat " + path;
+        return false;
+    }
+
+    void* m = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) { error = "cannot map " + path; return false; }
+
+    base = static_cast<const unsigned char*>(m);
+    length = size_t(st.st_size);
+    mapLength = length;
+#else
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) { error = "cannot open " + path; return false; }
+
+    const std::streamoff size = f.tellg();
+    if (size <= 0) { error = "empty file " + path; return false; }
+    f.seekg(0);
+
+    storage.assign((size_t(size) + 7) / 8, 0);
+    f.read(reinterpret_cast<char*>(storage.data()), size);
+    if (!f) { storage.clear(); error = "read failed: " + path; return false; }
+
+    base = reinterpret_cast<const unsigned char*>(storage.data());
+    length = size_t(size);
+#endif
+
+    if (!validate(error)) {
+        error = path + ": " + error;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PresetBank::close() {
+#if BIGPI_BANK_MMAP
+    if (mapLength != 0) ::munmap(const_cast<unsigned char*>(base), mapLength);
+#endif
+    base = nullptr;
+    length = 0;
+    mapLength = 0;
+    storage.clear();
+    storage.shrink_to_fit();
+}
+
+bool PresetBank::validate(std::string& error) const {
+    if (length < kHeaderBytes) { error = "too short for a bank header"; return false; }
+
+    const FileHeader& h = *header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) { error = "not a Big Pi preset bank"; return false; }
+    if (h.endianTag != kEndianTag) { error = "written on a machine with another byte order"; return false; }
+    if (h.version != kVersion) {
+        error = "bank version " + std::to_string(h.version) + ", this build reads " + std::to_string(kVersion);
+        return false;
+    }
+    const std::string writer(h.buildId, fieldLen(h.buildId, sizeof(h.buildId)));
+    if (h.layoutHash != layoutHash() || h.programSize != sizeof(Program)) {
+        error = "program layout differs from this build (bank built by '" + writer + "'), rebuild the bank";
+        return false;
+    }
+
+    if (h.numPrograms == 0 || h.numRates == 0 || h.numRates > uint32_t(kMaxRates)) {
+        error = "bad program / rate count";
+        return false;
+    }
+    if (h.programStride < h.programSize || h.programStride % kAlign != 0) {
+        error = "bad program stride";
+        return false;
+    }
+
+    const uint64_t namesEnd = h.namesOffset + uint64_t(h.numPrograms) * kNameLen;
+    const uint64_t programsEnd = h.programsOffset
+        + uint64_t(h.numPrograms) * h.numRates * h.programStride;
+
+    if (h.fileSize != length
+        || h.namesOffset < kHeaderBytes || namesEnd > h.programsOffset
+        || h.programsOffset % kAlign != 0 || programsEnd > h.fileSize) {
+        error = "truncated or inconsistent offsets";
+        return false;
+    }
+
+    if (fnv1a64(base + h.namesOffset, size_t(h.fileSize - h.namesOffset)) != h.payloadHash) {
+        error = "checksum mismatch (corrupt file)";
+        return false;
+    }
+
+    for (uint32_t p = 0; p < h.numPrograms; ++p) {
+        const char* n = reinterpret_cast<const char*>(base + h.namesOffset + size_t(p) * kNameLen);
+        if (fieldLen(n, kNameLen) >= size_t(kNameLen)) { error = "unterminated preset name"; return false; }
+    }
+
+    for (uint32_t p = 0; p < h.numPrograms; ++p) {
+        for (uint32_t r = 0; r < h.numRates; ++r) {
+            Program g;
+            std::memcpy(&g, base + h.programsOffset + (size_t(p) * h.numRates + r) * h.programStride, sizeof(Program));
+            if (g.sampleRate != h.rates[r] || int(g.params.mode) < 0 || int(g.params.mode) >= int(bigpi::Mode::Count)) {
+                error = "program " + std::to_string(p) + " does not match its rate slot";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Accessors
+// =============================================================================
+
+float PresetBank::rate(int i) const {
+    if (i < 0 || i >= rateCount()) return 0.0f;
+    return header()->rates[i];
+}
+
+const char* PresetBank::name(int program) const {
+    if (program < 0 || program >= programCount()) return "";
+    return reinterpret_cast<const char*>(base + header()->namesOffset + size_t(program) * kNameLen);
+}
+
+int PresetBank::findByName(const std::string& n) const {
+    for (int p = 0; p < programCount(); ++p) {
+        if (n == name(p)) return p;
+    }
+    return -1;
+}
+
+const PresetBank::Program* PresetBank::find(int program, float sampleRate) const {
+    if (program < 0 || program >= programCount()) return nullptr;
+
+    const FileHeader& h = *header();
+    for (uint32_t r = 0; r < h.numRates; ++r) {
+        if (h.rates[r] == sampleRate) {
+            return reinterpret_cast<const Program*>(
+                base + h.programsOffset + (size_t(program) * h.numRates + r) * h.programStride);
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,140 @@
+#pragma once
+/*
+  =============================================================================
+  PresetBank.h — Big Pi binary preset bank (precomputed programs)
+  =============================================================================
+
+  Why:
+    A program change through setParams() redesigns every filter, re-derives
+    the tank delay set and recomputes the feedback gains (exp/log per line).
+    On a pedal that work belongs at build time, not on the audio thread.
+
+    A bank file holds, for every preset and every supported sample rate, a
+    complete ReverbEngine::Program (params + all derived coefficients). The
+    file is memory-mapped; a program change is
+        engine.setProgram(bank.find(index, sampleRate));
+    i.e. a pointer swap, picked up by the next processBlock().
+
+  File layout (all offsets from the start of the file, native endianness):
+
+    [0]              FileHeader (kHeaderBytes, zero padded)
+    [namesOffset]    numPrograms x char[kNameLen], NUL terminated
+    [programsOffset] numPrograms x numRates programs, program-major:
+                     (program * numRates + rate) * programStride
+                     each one a raw ReverbEngine::Program
+
+  Versioning:
+    Programs are stored as raw structs, so a bank is only valid for builds
+    with the same struct layout. open() refuses files with another magic,
+    version, endianness, layout hash or a payload that fails its checksum.
+    buildId is informational (REVERB_BUILD_ID of the writer). Rebuild the
+    bank with `bigpi_test bank build` whenever open() refuses it.
+
+    The layout hash covers every member of every stored struct (name,
+    offset, size: the schema tables in PresetBank.cpp) plus the engine's
+    fixed limits, so a reordered, renamed or swapped member changes it.
+    The tables are checked at compile time: a struct change that is not
+    mirrored there fails the build. Bump kVersion with every such change.
+
+  Threads:
+    open()/close()/write() allocate and do file I/O: never on the audio
+    thread. The accessors are const and may be called from anywhere; the
+    Program pointers stay valid until close() (or destruction).
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "dsp/engines/tune_hall/ReverbEngine.h"
+
+class PresetBank {
+public:
+    using Program = ReverbEngine::Program;
+
+    // Stored as raw bytes: must survive a memcpy (and a mmap).
+    static_assert(std::is_trivially_copyable<Program>::value,
+        "ReverbEngine::Program must be trivially copyable to live in a bank file");
+
+    // Bump on ANY change to a struct stored in Program (see Versioning).
+    // 2: granular, spring, tape and singularity members; per-member layout hash.
+    static constexpr uint32_t kVersion = 2;
+    static constexpr int kMaxRates = 8;
+    static constexpr int kNameLen = 32;             // including the NUL
+    static constexpr size_t kHeaderBytes = 256;
+    static constexpr size_t kAlign = 64;            // program stride / section alignment
+
+    struct FileHeader {
+        char     magic[8];          // "BIGPIBNK"
+        uint32_t version;           // kVersion
+        uint32_t endianTag;         // kEndianTag as written by the builder
+        uint32_t layoutHash;        // layoutHash() of the builder
+        uint32_t programSize;       // sizeof(Program)
+        uint32_t programStride;     // programSize rounded up to kAlign
+        uint32_t numPrograms;
+        uint32_t numRates;
+        uint32_t reserved;
+        float    rates[kMaxRates];
+        char     buildId[32];
+        uint64_t namesOffset;
+        uint64_t programsOffset;
+        uint64_t fileSize;
+        uint64_t payloadHash;       // FNV-1a 64 over [namesOffset, fileSize)
+    };
+    static_assert(sizeof(FileHeader) <= kHeaderBytes, "FileHeader must fit kHeaderBytes");
+
+    // One preset to write. params must already be resolved (mode preset
+    // applied, see ReverbEngine::withModePreset()).
+    struct Entry {
+        std::string name;
+        ReverbEngine::Params params{};
+    };
+
+    PresetBank() = default;
+    ~PresetBank();
+
+    PresetBank(const PresetBank&) = delete;
+    PresetBank& operator=(const PresetBank&) = delete;
+
+    // Builds every entry at every rate and writes the file. false + error on failure.
+    static bool write(const std::string& path,
+        const std::vector<Entry>& entries,
+        const std::vector<float>& rates,
+        std::string& error);
+
+    // Maps (POSIX) or reads the file and validates it. false + error on failure.
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    bool isMapped() const { return mapLength != 0; }
+
+    int programCount() const { return isOpen() ? int(header()->numPrograms) : 0; }
+    int rateCount() const { return isOpen() ? int(header()->numRates) : 0; }
+    float rate(int i) const;
+    const char* buildId() const { return isOpen() ? header()->buildId : ""; }
+
+    const char* name(int program) const;
+    int findByName(const std::string& name) const;      // -1 if absent
+
+    // O(1). nullptr for a bad index or a rate the bank was not built for.
+    const Program* find(int program, float sampleRate) const;
+
+    // Layout fingerprint of this build (see Versioning above).
+    static uint32_t layoutHash();
+
+private:
+    static constexpr uint32_t kEndianTag = 0x01020304u;
+
+    const unsigned char* base = nullptr;
+    size_t length = 0;
+
+    size_t mapLength = 0;                   // != 0 when base is an mmap
+    std::vector<uint64_t> storage{};        // read() fallback (8-byte aligned)
+
+    const FileHeader* header() const { return reinterpret_cast<const FileHeader*>(base); }
+
+    bool validate(std::string& error) const;
+};
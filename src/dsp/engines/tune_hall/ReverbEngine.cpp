@@ -1,5 +1,8 @@
 ﻿#include "dsp/engines/tune_hall/ReverbEngine.h"
 
+#include "core/CycleClock.h"
+#include "core/Trace.h"
+
 #include <algorithm> // std::min, std::max
 #include <array>     // std::array
 #include <cmath>     // std::abs
@@ -30,7 +33,7 @@ void ReverbEngine::rebuildStereoVectors(int lines) {
     std::array<int, bigpi::core::Tank::kMaxLines> idx{};
     for (int i = 0; i < lines; ++i) idx[i] = i;
 
-    uint32_t x = 0xC10UD00Du ^ (uint32_t(int(target.mode)) * 0x9E3779B9u);
+    uint32_t x = 0xC100D00Du ^ (uint32_t(int(target.mode)) * 0x9E3779B9u);
     auto rnd = [&]() -> uint32_t {
         x ^= x << 13;
         x ^= x >> 17;
@@ -61,12 +64,25 @@ void ReverbEngine::prepare(float sampleRate, int blockSize) {
     wetR.assign(block, 0.0f);
     erL.assign(block, 0.0f);
     erR.assign(block, 0.0f);
+    grainL.assign(block, 0.0f);
+    grainR.assign(block, 0.0f);
+    springL.assign(block, 0.0f);
+    springR.assign(block, 0.0f);
+    tapeOutL.assign(block, 0.0f);
+    tapeOutR.assign(block, 0.0f);
+    singL.assign(block, 0.0f);
+    singR.assign(block, 0.0f);
+    tailEnvBuf.assign(block, 0.0f);
 
     er.prepare(sr);
     outStage.prepare(sr);
 
-    // Predelay buffer also doubles as the source for Cloud front-end multitap spray.
-    const int preMax = std::max(16, int(sr * 0.20f)); // 200 ms
+    // Shared input history: predelay, every ER tap and every Cloud front-end
+    // spray tap read this one buffer at different offsets. It must reach the
+    // longest predelay plus the longest ER / spray tap behind it, plus one
+    // chunk (ER and spray read it after the whole chunk has been written).
+    const float historyMs = 200.0f + std::max(EarlyReflections::kMaxTapMs, 120.0f + 0.45f);
+    const int preMax = std::max(16, int(msToSamples(historyMs, sr)) + block + 4);
     preL.init(preMax);
     preR.init(preMax);
 
@@ -75,29 +91,53 @@ void ReverbEngine::prepare(float sampleRate, int blockSize) {
     smearL.init(smearMax);
     smearR.init(smearMax);
 
+    // Granular / MicroCosmos grain engine (2 s capture buffer)
+    granular.prepare(sr, block, 0x6A41A7u);
+    granularRunning = false;
+
+    // Spring mode dispersive springs
+    spring.prepare(sr);
+    springRunning = false;
+
+    // Magnetic mode tape front end
+    tape.prepare(sr);
+    tapeRunning = false;
+
+    // Singularity mode long network (compressed, decimated history)
+    singularity.prepare(sr);
+    singularityRunning = false;
+
     diffusion.init(sr, 0xB16B00B5u);
 
     lfos.init(16, sr);
 
-    duckEnv.setSampleRate(sr);
-    duckEnv.setAttackReleaseMs(8.0f, 120.0f);
-    duckEnv.clear();
+    inputSide.prepare(sr, block);
+    inputSide.setFollower(kDuckEnv, 8.0f, 120.0f);
 
     // Step 6: dynamic diffusion helpers
-    diffFast.setSampleRate(sr);
-    diffSlow.setSampleRate(sr);
     // fast/slow pair for transient detection
-    diffFast.setAttackReleaseMs(2.0f, 35.0f);
-    diffSlow.setAttackReleaseMs(18.0f, 220.0f);
-    diffFast.clear();
-    diffSlow.clear();
+    injectSide.prepare(sr, block);
+    injectSide.setFollower(kDiffFastEnv, 2.0f, 35.0f);
+    injectSide.setFollower(kDiffSlowEnv, 18.0f, 220.0f);
     tailEnvSm = 0.0f;
 
     const int maxTankDelay = std::max(64, int(sr * 2.5f));
     tank.init(sr, maxTankDelay, 0xC0FFEEu);
 
+    // Governor starts at full quality (resolveTankLines() reads its line cap)
+    governor.prepare(sr);
+    governorDiffCapped = false;
+    diffusion.setInputStageCap(bigpi::core::Diffusion::kMaxInputStages);
+    tank.setCostOverrides(1.0f, false);
+
     // Apply preset defaults into target + tank config
-    applyModePreset(target.mode);
+    loadProgram(makeProgram(withModePreset(target), sr));
+
+#if BIGPI_PROFILE
+    prof.prepare();
+#endif
+
+    health.prepare(sr);
 
     prepared = true;
     reset();
@@ -113,139 +153,41 @@ void ReverbEngine::reset() {
     smearR.clear();
 
     er.reset();
+    granular.clear();
+    tape.clear();
     diffusion.clear();
     tank.clear();
+    spring.clear();
+    singularity.clear();
     outStage.reset();
 
-    duckEnv.clear();
+    inputSide.clear();
 
-    diffFast.clear();
-    diffSlow.clear();
+    injectSide.clear();
     tailEnvSm = 0.0f;
+
+    health.reset();
 }
 
 void ReverbEngine::setParams(const Params& p) {
     const bool modeChanged = (p.mode != target.mode);
-    target = p;
+
+    BIGPI_TRACE_INSTANT("params", int(p.mode));
 
     if (modeChanged) {
-        applyModePreset(target.mode);
+        BIGPI_TRACE_INSTANT("mode_change", int(p.mode));
     }
 
-    // Early reflections
-    EarlyReflections::Params erp;
-    erp.level = target.erLevel;
-    erp.size = target.erSize;
-    erp.dampHz = target.erDampHz;
-    erp.width = target.erWidth;
-    er.setParams(erp);
-
-    // Output stage
-    OutputStage::Params op;
-    op.hpHz = target.outHpHz;
-    op.lowShelfHz = target.outLowShelfHz;
-    op.lowGainDb = target.outLowGainDb;
-    op.highShelfHz = target.outHighShelfHz;
-    op.highGainDb = target.outHighGainDb;
-    op.width = target.outWidth;
-    op.drive = target.outDrive;
-    op.level = target.outLevel;
-    outStage.setParams(op);
-
-    // Diffusion
-    bigpi::core::Diffusion::InputConfig inCfg = {};
-    inCfg.stages = target.inputDiffStages;
-    inCfg.g = target.inputDiffG;
-    diffusion.setInputConfig(inCfg);
-
-    bigpi::core::Diffusion::LateConfig lateCfg = {};
-    lateCfg.minG = target.lateDiffMinG;
-    lateCfg.maxG = target.lateDiffMaxG;
-    diffusion.setLateConfig(lateCfg);
-
-    // Tank
-    bigpi::core::Tank::Config tc = tank.getConfig();
-
-    tc.fbHpHz = target.feedbackHpHz;
-    tc.dampHz = target.dampingHz;
-
-    tc.xoverLoHz = target.fbXoverLoHz;
-    tc.xoverHiHz = target.fbXoverHiHz;
-
-    tc.decayLowMul = target.decayLowMul;
-    tc.decayMidMul = target.decayMidMul;
-    tc.decayHighMul = target.decayHighMul;
-
-    tc.modDepthSamples = msToSamples(target.modDepthMs, sr);
-    tc.modRateHz = target.modRateHz;
-
-    tc.jitterEnable = target.modJitterEnable;
-    tc.jitterAmount = target.modJitterAmount;
-    tc.jitterRateHz = target.modJitterRateHz;
-    tc.jitterSmoothMs = target.modJitterSmoothMs;
-
-    // Cloudify modulation controls
-    tc.cloudEnable = target.cloudEnable;
-    tc.cloudSpinHz = target.cloudSpinHz;
-    tc.cloudWanderAmount = target.cloudWanderAmount;
-    tc.cloudWanderRateHz = target.cloudWanderRateHz;
-    tc.cloudWanderSmoothMs = target.cloudWanderSmoothMs;
-
-    tank.setConfig(tc);
+    loadProgram(makeProgram(modeChanged ? withModePreset(p) : p, sr));
 }
 
-void ReverbEngine::applyModePreset(bigpi::Mode m) {
-    modeCfg = bigpi::getModePreset(m);
+ReverbEngine::Params ReverbEngine::withModePreset(const Params& p) {
+    const bigpi::ModeConfig modeCfg = bigpi::getModePreset(p.mode);
+    const bigpi::Mode m = p.mode;
 
-    bigpi::core::Tank::Config tc = tank.getConfig();
-    tc.lines = modeCfg.tank.delayLines;
-
-    // ensure vectors match tank line count
-    rebuildStereoVectors(tc.lines);
-
-    tc.matrix = modeCfg.tank.useHouseholder
-        ? bigpi::core::MatrixType::Householder
-        : bigpi::core::MatrixType::Hadamard;
-
-    // Base delay sets (ms)
-    static const float baseMs16_Default[16] = {
-      29.7f, 37.1f, 41.1f, 43.7f,
-      53.9f, 59.5f, 61.7f, 71.3f,
-      79.9f, 89.7f, 97.3f, 101.9f,
-      107.9f, 115.1f, 123.7f, 131.9f
-    };
-
-    static const float baseMs16_Hall[16] = {
-      31.7f, 37.9f, 41.3f, 43.1f,
-      53.3f, 59.9f, 61.1f, 71.7f,
-      79.3f, 89.1f, 97.9f, 103.3f,
-      109.7f, 117.1f, 125.9f, 137.3f
-    };
-
-    // Step 4: Cloud delay-line set
-    static const float baseMs16_Cloud[16] = {
-      27.9f, 33.6f, 39.2f, 44.9f,
-      51.7f, 57.4f, 63.8f, 70.9f,
-      78.1f, 86.6f, 95.8f, 104.7f,
-      114.3f, 124.9f, 136.8f, 149.7f
-    };
-
-    const float* baseSet = baseMs16_Default;
-    if (m == bigpi::Mode::Hall) baseSet = baseMs16_Hall;
-
-    if (m == bigpi::Mode::Sky && target.cloudDelaySetEnable > 0.0001f) {
-        baseSet = baseMs16_Cloud;
-    }
-
-    for (int i = 0; i < 16; ++i) {
-        const float ms = baseSet[i] * modeCfg.tank.delayScale;
-        tc.delaySamp[i] = msToSamples(ms, sr);
-    }
-
-    tc.modDepthMul = modeCfg.tank.modDepthMul;
-    tc.modRateMul = modeCfg.tank.modRateMul;
+    Params target = p;
 
-    // Preset-driven parameters (stored in target)
+    // Preset-driven parameters
     target.inputDiffStages = modeCfg.tank.inputDiffStages;
     target.inputDiffG = modeCfg.tank.inputDiffG;
 
@@ -319,16 +261,108 @@ void ReverbEngine::applyModePreset(bigpi::Mode m) {
         target.dynDiffLateBoost = 0.20f;
     }
 
-    // Push configs now
-    tank.setConfig(tc);
+    // Shimmer pitch block (ModeFeatures::usePitchBlock)
+    if (modeCfg.features.usePitchBlock) {
+        target.shimmerEnable = 1.0f;
+        target.shimmerAmount = 0.30f;
+        target.shimmerFifthMix = 0.30f;
+    }
+    else {
+        target.shimmerEnable = 0.0f;
+    }
+
+    // Grain engine (ModeFeatures::useGranularBlock)
+    if (modeCfg.features.useGranularBlock && m == bigpi::Mode::MicroCosmic) {
+        // MicroCosmos: slow, long, pitched-down grains (Tunnel)
+        target.granularEnable = 1.0f;
+        target.granularAmount = 0.85f;
+        target.granularBehavior = 1.0f;
+        target.granularDensityHz = 8.0f;
+        target.granularLengthMs = 180.0f;
+        target.granularPitchRange = 0.15f;
+        target.granularReverse = 0.10f;
+        target.granularScan = 0.80f;
+    }
+    else if (modeCfg.features.useGranularBlock) {
+        target.granularEnable = 1.0f;
+        target.granularAmount = 0.70f;
+        target.granularBehavior = 0.0f;
+        target.granularDensityHz = 14.0f;
+        target.granularLengthMs = 90.0f;
+        target.granularPitchRange = 0.30f;
+        target.granularReverse = 0.30f;
+        target.granularScan = 0.50f;
+    }
+    else {
+        target.granularEnable = 0.0f;
+    }
+
+    // Spring model (ModeFeatures::useSpringModel)
+    if (modeCfg.features.useSpringModel) {
+        target.springEnable = 1.0f;
+        target.springMix = 0.65f;
+        target.springLengthMs = 38.0f;
+        target.springDispersion = 0.60f;
+        target.springDrip = 0.55f;
+        target.springDampHz = 4500.0f;
+        target.springToneHz = 2200.0f;
+        target.springEmphasis = 0.50f;
+    }
+    else {
+        target.springEnable = 0.0f;
+    }
+
+    // Tape front end (ModeFeatures::useMagneticBlock)
+    if (modeCfg.features.useMagneticBlock) {
+        target.tapeEnable = 1.0f;
+        target.tapeMix = 0.50f;
+        target.tapeHeads = 2.0f;
+        target.tapeTimeMs = 120.0f;
+        target.tapeFeedback = 0.35f;
+        target.tapeWow = 0.35f;
+        target.tapeFlutter = 0.25f;
+        target.tapeDrive = 1.20f;
+        target.tapeAge = 0.30f;
+    }
+    else {
+        target.tapeEnable = 0.0f;
+    }
+
+    // Long warped network (ModeFeatures::useSingularity)
+    if (modeCfg.features.useSingularity) {
+        target.singularityEnable = 1.0f;
+        target.singularityMix = 0.50f;
+        target.singularitySizeSec = 1.6f;
+        target.singularityDecaySec = 14.0f;
+        target.singularityDampHz = 3200.0f;
+        target.singularityGravity = 0.50f;
+    }
+    else {
+        target.singularityEnable = 0.0f;
+    }
+
+    return target;
+}
 
-    EarlyReflections::Params erp;
-    erp.level = target.erLevel;
-    erp.size = target.erSize;
-    erp.dampHz = target.erDampHz;
-    erp.width = target.erWidth;
-    er.setParams(erp);
+ReverbEngine::Program ReverbEngine::makeProgram(const Params& resolved, float sampleRate) {
+    const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+    const Params& target = resolved;
+    const bigpi::Mode m = target.mode;
 
+    Program g;
+    g.params = target;
+    g.sampleRate = sr;
+    g.modeCfg = bigpi::getModePreset(m);
+
+    const bigpi::ModeConfig& modeCfg = g.modeCfg;
+
+    // Early reflections (smoothed per sample inside ER, so params only)
+    g.er.level = target.erLevel;
+    g.er.size = target.erSize;
+    g.er.dampHz = target.erDampHz;
+    g.er.width = target.erWidth;
+
+    // Output stage
     OutputStage::Params op;
     op.hpHz = target.outHpHz;
     op.lowShelfHz = target.outLowShelfHz;
@@ -338,48 +372,159 @@ void ReverbEngine::applyModePreset(bigpi::Mode m) {
     op.width = target.outWidth;
     op.drive = target.outDrive;
     op.level = target.outLevel;
-    outStage.setParams(op);
+    g.out = OutputStage::makeCoeffs(op, sr);
 
-    bigpi::core::Diffusion::InputConfig inCfg = {};
-    inCfg.stages = target.inputDiffStages;
-    inCfg.g = target.inputDiffG;
-    diffusion.setInputConfig(inCfg);
+    // Diffusion
+    g.diffInput.stages = target.inputDiffStages;
+    g.diffInput.g = target.inputDiffG;
 
-    bigpi::core::Diffusion::LateConfig lateCfg = {};
-    lateCfg.minG = target.lateDiffMinG;
-    lateCfg.maxG = target.lateDiffMaxG;
-    diffusion.setLateConfig(lateCfg);
+    g.diffLate.minG = target.lateDiffMinG;
+    g.diffLate.maxG = target.lateDiffMaxG;
 
-    // Ensure tank config includes non-preset-owned fields too
-    bigpi::core::Tank::Config tc2 = tank.getConfig();
-    tc2.xoverLoHz = target.fbXoverLoHz;
-    tc2.xoverHiHz = target.fbXoverHiHz;
+    // Tank
+    bigpi::core::Tank::Config tc{};
 
-    tc2.decayLowMul = target.decayLowMul;
-    tc2.decayMidMul = target.decayMidMul;
-    tc2.decayHighMul = target.decayHighMul;
+    // Eco/HQ override; anything else falls back to the mode preset.
+    // (The quality governor's line cap is applied in loadProgram().)
+    tc.lines = (target.tankLines == 8 || target.tankLines == 16)
+        ? target.tankLines
+        : modeCfg.tank.delayLines;
 
-    tc2.modDepthSamples = msToSamples(target.modDepthMs, sr);
-    tc2.modRateHz = target.modRateHz;
+    tc.matrix = modeCfg.tank.useHouseholder
+        ? bigpi::core::MatrixType::Householder
+        : bigpi::core::MatrixType::Hadamard;
 
-    tc2.jitterEnable = target.modJitterEnable;
-    tc2.jitterAmount = target.modJitterAmount;
-    tc2.jitterRateHz = target.modJitterRateHz;
-    tc2.jitterSmoothMs = target.modJitterSmoothMs;
+    // Base delay set (precomputed per mode and common sample rate)
+    tc.delaySamp = bigpi::getTankDelaySamples(m, target.cloudDelaySetEnable > 0.0001f, sr);
 
-    tc2.cloudEnable = target.cloudEnable;
-    tc2.cloudSpinHz = target.cloudSpinHz;
-    tc2.cloudWanderAmount = target.cloudWanderAmount;
-    tc2.cloudWanderRateHz = target.cloudWanderRateHz;
-    tc2.cloudWanderSmoothMs = target.cloudWanderSmoothMs;
+    tc.modDepthMul = modeCfg.tank.modDepthMul;
+    tc.modRateMul = modeCfg.tank.modRateMul;
 
-    tc2.fbHpHz = target.feedbackHpHz;
-    tc2.dampHz = target.dampingHz;
+    tc.fbHpHz = target.feedbackHpHz;
+    tc.dampHz = target.dampingHz;
 
-    tank.setConfig(tc2);
+    tc.xoverLoHz = target.fbXoverLoHz;
+    tc.xoverHiHz = target.fbXoverHiHz;
+
+    tc.decayLowMul = target.decayLowMul;
+    tc.decayMidMul = target.decayMidMul;
+    tc.decayHighMul = target.decayHighMul;
+
+    tc.modDepthSamples = msToSamples(target.modDepthMs, sr);
+    tc.modRateHz = target.modRateHz;
+
+    tc.jitterEnable = target.modJitterEnable;
+    tc.jitterAmount = target.modJitterAmount;
+    tc.jitterRateHz = target.modJitterRateHz;
+    tc.jitterSmoothMs = target.modJitterSmoothMs;
+
+    // Cloudify modulation controls
+    tc.cloudEnable = target.cloudEnable;
+    tc.cloudSpinHz = target.cloudSpinHz;
+    tc.cloudWanderAmount = target.cloudWanderAmount;
+    tc.cloudWanderRateHz = target.cloudWanderRateHz;
+    tc.cloudWanderSmoothMs = target.cloudWanderSmoothMs;
+
+    // Shimmer pitch block (Shimmer mode)
+    tc.shimmerAmount = (target.shimmerEnable > 0.0001f) ? target.shimmerAmount : 0.0f;
+    tc.shimmerFifthMix = target.shimmerFifthMix;
+
+    // Grain engine
+    {
+        using Granular = bigpi::core::GranularEngine;
+        const int b = int(dsp::clampf(target.granularBehavior, 0.0f, float(int(Granular::Behavior::Count) - 1)) + 0.5f);
+        g.granular.behavior = Granular::Behavior(b);
+        g.granular.densityHz = target.granularDensityHz;
+        g.granular.lengthMs = target.granularLengthMs;
+        g.granular.pitchRange = target.granularPitchRange;
+        g.granular.reverse = target.granularReverse;
+        g.granular.scan = target.granularScan;
+    }
+
+    // Spring model
+    {
+        bigpi::core::SpringModel::Params sp;
+        sp.lengthMs = target.springLengthMs;
+        sp.dispersion = target.springDispersion;
+        sp.drip = target.springDrip;
+        sp.dampHz = target.springDampHz;
+        sp.toneHz = target.springToneHz;
+        sp.emphasis = target.springEmphasis;
+        g.spring = bigpi::core::SpringModel::makeCoeffs(sp, sr);
+    }
+
+    // Tape front end
+    {
+        using Tape = bigpi::core::MagneticTape;
+        Tape::Params tp;
+        const int heads = int(dsp::clampf(target.tapeHeads, 0.0f, float(int(Tape::HeadPattern::Count) - 1)) + 0.5f);
+        tp.heads = Tape::HeadPattern(heads);
+        tp.timeMs = target.tapeTimeMs;
+        tp.feedback = target.tapeFeedback;
+        tp.wow = target.tapeWow;
+        tp.flutter = target.tapeFlutter;
+        tp.drive = target.tapeDrive;
+        tp.age = target.tapeAge;
+        g.tape = Tape::makeCoeffs(tp, sr);
+    }
+
+    // Singularity long network
+    {
+        bigpi::core::SingularityEngine::Params sp;
+        sp.sizeSec = target.singularitySizeSec;
+        sp.decaySec = target.singularityDecaySec;
+        sp.dampHz = target.singularityDampHz;
+        sp.gravity = target.singularityGravity;
+        g.singularity = bigpi::core::SingularityEngine::makeCoeffs(sp, sr);
+    }
+
+    // Feedback gains for the decay the first block will ask for
+    g.tank = bigpi::core::Tank::makeCoeffs(tc, sr,
+        computeEffectiveDecay(target.decay, target.freeze));
+
+    return g;
 }
 
-float ReverbEngine::computeEffectiveDecay(float decay, float freeze01) const {
+void ReverbEngine::setProgram(const Program* program) {
+    pendingProgram.store(program, std::memory_order_release);
+}
+
+/*
+  loadProgram(g)
+  --------------
+  Copies a Program into the modules. No allocation and no coefficient
+  design, so it is safe at the top of processBlock(). The governor's
+  current caps (input stages, line count) stay in force.
+*/
+void ReverbEngine::loadProgram(const Program& g) {
+    target = g.params;
+    modeCfg = g.modeCfg;
+
+    er.setParams(g.er);
+    granular.setParams(g.granular);
+    spring.applyCoeffs(g.spring);
+    tape.applyCoeffs(g.tape);
+    singularity.applyCoeffs(g.singularity);
+    outStage.applyCoeffs(g.out);
+
+    diffusion.setInputConfig(g.diffInput);
+    diffusion.setLateConfig(g.diffLate);
+
+    tankCoeffs = g.tank;
+    tank.applyCoeffs(tankCoeffs, governor.linesCap(bigpi::core::Tank::kMaxLines));
+
+    // ensure vectors match tank line count
+    rebuildStereoVectors(tank.getConfig().lines);
+}
+
+int ReverbEngine::resolveTankLines() const {
+    // Eco/HQ override; anything else falls back to the mode preset.
+    // The quality governor may cap it further (EcoLines level).
+    if (target.tankLines == 8 || target.tankLines == 16) return governor.linesCap(target.tankLines);
+    return governor.linesCap(modeCfg.tank.delayLines);
+}
+
+float ReverbEngine::computeEffectiveDecay(float decay, float freeze01) {
     freeze01 = dsp::clampf(freeze01, 0.0f, 1.0f);
     decay = dsp::clampf(decay, 0.0f, 0.9995f);
     const float frozen = 0.9993f;
@@ -395,6 +540,158 @@ float ReverbEngine::computeLoudnessCompDb(float decay01) const {
     return -maxDb * strength * decay01;
 }
 
+ReverbEngine::Stats ReverbEngine::getStats() const {
+#if BIGPI_PROFILE
+    Stats st = prof.snapshot();
+#else
+    Stats st{};
+#endif
+
+    const bigpi::core::HealthStats h = health.snapshot();
+    st.healthNonFiniteResets = h.nonFiniteResets;
+    st.healthRunawayResets = h.runawayResets;
+    st.healthMaxTankPeak = h.maxTankPeak;
+
+    st.governor = governor.snapshot();
+    return st;
+}
+
+void ReverbEngine::resetStats() {
+#if BIGPI_PROFILE
+    prof.reset();
+#endif
+    health.resetCounters();
+    governor.resetCounters();
+}
+
+/*
+  recoverFromHealthIncident()
+  ---------------------------
+  Audio thread. Runs between the ducking stage and OutputStage, so wetL/R
+  hold this chunk's wet signal (tail + ER) and nothing bad has reached
+  OutputStage or the outputs yet.
+
+  ResetWetPath (NaN/Inf): the chunk is unusable, so it is replaced by
+  silence and every wet-path state is cleared, including predelay and ER in
+  case the bad value came in with the input. OutputStage is kept: it never
+  saw the bad samples and rings down from its last good state.
+
+  ResetTank (runaway): the chunk is still finite, so it fades out and only
+  the recirculating path (tank, diffusion, smear) is cleared.
+
+  Both then fade the wet signal back in (see HealthMonitor::applyFadeIn).
+*/
+void ReverbEngine::recoverFromHealthIncident(bigpi::core::HealthMonitor::Action action, int chunk) {
+    using Action = bigpi::core::HealthMonitor::Action;
+
+    if (action == Action::ResetWetPath) {
+        BIGPI_TRACE_INSTANT("health_nonfinite", chunk);
+
+        std::fill(wetL.begin(), wetL.begin() + chunk, 0.0f);
+        std::fill(wetR.begin(), wetR.begin() + chunk, 0.0f);
+
+        preL.clear();
+        preR.clear();
+        er.reset();
+        granular.clear();
+        tape.clear();
+        inputSide.clear();
+    }
+    else {
+        BIGPI_TRACE_INSTANT("health_runaway", chunk);
+
+        bigpi::core::HealthMonitor::applyFadeOut(wetL.data(), wetR.data(), chunk);
+    }
+
+    tank.clear();
+    diffusion.clear();
+    spring.clear();
+    singularity.clear();
+    smearL.clear();
+    smearR.clear();
+
+    injectSide.clear();
+    tailEnvSm = 0.0f;
+
+    health.startFadeIn();
+}
+
+void ReverbEngine::setStatsDeadlineUs(float us) {
+    governorDeadlineNs.store(double(std::max(0.0f, us)) * 1000.0, std::memory_order_relaxed);
+#if BIGPI_PROFILE
+    prof.setDeadlineNs(double(std::max(0.0f, us)) * 1000.0);
+#endif
+}
+
+void ReverbEngine::setQualityGovernor(bool enabled) {
+    // Calibrate the tick rate here, never on the audio thread.
+    if (enabled) (void)bigpi::core::ticksPerSecond();
+    governor.setEnabled(enabled);
+}
+
+void ReverbEngine::setQualityGovernorSettings(const bigpi::core::QualityGovernor::Settings& s) {
+    governor.setSettings(s);
+}
+
+/*
+  applyGovernorChunk()
+  --------------------
+  Audio thread, start of every chunk while the governor is active. Advances
+  its ramps and pushes the cheap overrides (tank modulation scale and
+  interpolation, input diffusion stage cap). Returns the spray/smear gain
+  (1 = as configured, 0 = off).
+
+  Input diffusion: while the FewerDiffusers ramp is between 0 and 1 the
+  chain runs in full and is blended with its reduced-stage tap (see
+  Diffusion::processInputBlend); at 0 the stage cap makes the cut real.
+  Stages coming back are flushed first so they do not replay old input.
+*/
+float ReverbEngine::applyGovernorChunk(int chunk) {
+    using Level = bigpi::core::QualityLevel;
+
+    governor.advance(chunk);
+
+    tank.setCostOverrides(governor.gain(Level::NoModulation), governor.linearInterp());
+
+    const int fullStages = diffusion.getConfiguredInputStages();
+    const int lowStages = std::min(fullStages, std::max(2, fullStages / 2));
+    const float wDiff = governor.gain(Level::FewerDiffusers);
+
+    if (wDiff <= 0.0f) {
+        diffusion.setInputStageCap(lowStages);
+        governorDiffCapped = true;
+    }
+    else if (governorDiffCapped) {
+        diffusion.clearInputStagesFrom(lowStages);
+        diffusion.setInputStageCap(bigpi::core::Diffusion::kMaxInputStages);
+        governorDiffCapped = false;
+    }
+
+    return governor.gain(Level::NoSprayOrSmear);
+}
+
+/*
+  switchGovernorLines()
+  ---------------------
+  Audio thread, end of a chunk, when the tank tail has dipped to silence
+  (QualityGovernor::linesSwitchDue). Lines that come back are cleared first.
+  The program's Tank::Coeffs already cover all kMaxLines lines (decay
+  gains included), so this only copies: no coefficient design here.
+*/
+void ReverbEngine::switchGovernorLines() {
+    governor.finishLinesSwitch();
+
+    const int before = tank.getConfig().lines;
+    const int lines = resolveTankLines();
+    if (lines == before) return;
+
+    BIGPI_TRACE_INSTANT("governor_lines", lines);
+
+    if (lines > before) tank.clearLinesFrom(before);
+    tank.applyCoeffs(tankCoeffs, governor.linesCap(bigpi::core::Tank::kMaxLines));
+    rebuildStereoVectors(tank.getConfig().lines);
+}
+
 void ReverbEngine::processBlock(const float* inL, const float* inR,
     float* outL, float* outR,
     int n)
@@ -402,6 +699,23 @@ void ReverbEngine::processBlock(const float* inL, const float* inR,
     if (!prepared) return;
     if (n <= 0) return;
 
+#if BIGPI_PROFILE
+    const uint64_t blockT0 = prof.now();
+#endif
+    BIGPI_TRACE_SCOPE_ARG("processBlock", n);
+
+    // Quality governor: only touches the clock (and the DSP) while active.
+    const bool govOn = governor.active();
+    const uint64_t govT0 = govOn ? bigpi::core::readCycleCounter() : 0;
+
+    // Program change (setProgram): a pointer swap, then plain copies.
+    if (const Program* g = pendingProgram.exchange(nullptr, std::memory_order_acquire)) {
+        if (g->sampleRate == sr) {
+            BIGPI_TRACE_INSTANT("program", int(g->params.mode));
+            loadProgram(*g);
+        }
+    }
+
     // Step 3: Cloud front-end multitap pattern (fixed, RT-safe)
     static constexpr int kCloudTaps = 8;
     static constexpr float kTapPos[kCloudTaps] = {
@@ -420,22 +734,65 @@ void ReverbEngine::processBlock(const float* inL, const float* inR,
     static constexpr float kSmearGain[kSmearTaps] = { 0.88f, 0.70f, 0.56f, 0.45f, 0.36f, 0.30f };
     static constexpr float kSmearSign[kSmearTaps] = { +1.0f, -1.0f, +1.0f, -1.0f, +1.0f, -1.0f };
 
+    /*
+      Stage layout per chunk
+      ----------------------
+      Each stage runs as its own pass over the chunk so it can be timed
+      (core/Profiling.h) and later optimised in isolation:
+
+        predelay -> ER -> spray/injection -> sidechain ->
+        [diffusion -> tank -> taps] -> smear -> late diffusion ->
+        loudness/ducking -> OutputStage -> mix
+
+      The sidechain stage computes the level envelopes used by dynamic
+      diffusion and ducking for the whole chunk up front.
+
+      Diffusion, tank and taps stay interleaved per sample: the dynamic
+      diffusion g follows the tank envelope of the previous sample.
+
+      Buffer use inside a chunk:
+        wetL/R : predelayed -> injection -> tank tail -> wet out
+        erL/R  : early reflections
+        tailEnvBuf : smoothed tank envelope per sample (for late diffusion)
+    */
     int pos = 0;
     while (pos < n) {
         const int chunk = std::min(block, n - pos);
 
+        const float costGain = govOn ? applyGovernorChunk(chunk) : 1.0f;
+        const bool diffBlend = govOn && !governorDiffCapped
+            && governor.gain(bigpi::core::QualityLevel::FewerDiffusers) < 1.0f;
+        const bool tailDip = govOn && governor.dipping();
+
         const float preSamp = msToSamples(dsp::clampf(target.predelayMs, 0.0f, 200.0f), sr);
 
-        // Predelay stage (also fills the buffer used by cloud multitaps)
-        for (int i = 0; i < chunk; ++i) {
-            preL.push(inL[pos + i]);
-            preR.push(inR[pos + i]);
-            wetL[i] = preL.readFracCubic(preSamp);
-            wetR[i] = preR.readFracCubic(preSamp);
+        // Read position of the predelayed signal (a delay of 1 is the sample
+        // just pushed; 0 would wrap around to the oldest one)
+        const float preRead = std::max(1.0f, preSamp);
+
+        // ---------------------------------------------------------------------
+        // Predelay stage: writes the chunk into the shared input history
+        // (ER and cloud multitaps read it below)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Predelay);
+            BIGPI_TRACE_SCOPE("predelay");
+            for (int i = 0; i < chunk; ++i) {
+                preL.push(inL[pos + i]);
+                preR.push(inR[pos + i]);
+                wetL[i] = preL.readFracCubic(preRead);
+                wetR[i] = preR.readFracCubic(preRead);
+            }
         }
 
-        // Early reflections
-        er.processBlock(wetL.data(), wetR.data(), erL.data(), erR.data(), chunk);
+        // ---------------------------------------------------------------------
+        // Early reflections (taps behind the predelay in the same history)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, EarlyReflections);
+            BIGPI_TRACE_SCOPE("er");
+            er.processBlock(preL, preR, preRead - 1.0f, erL.data(), erR.data(), chunk);
+        }
 
         std::array<float, bigpi::core::Tank::kMaxLines> yVec{};
 
@@ -455,14 +812,14 @@ void ReverbEngine::processBlock(const float* inL, const float* inR,
         const float gS = dsp::clampf(target.stereoDepth, 0.0f, 1.0f);
 
         const float cfEnable = (target.cloudFrontEnable > 0.0001f) ? 1.0f : 0.0f;
-        const float cfAmt = dsp::clampf(target.cloudFrontAmount, 0.0f, 1.0f) * cfEnable;
+        const float cfAmt = dsp::clampf(target.cloudFrontAmount, 0.0f, 1.0f) * cfEnable * costGain;
         const float cfSizeSamp = msToSamples(dsp::clampf(target.cloudFrontSizeMs, 0.0f, 120.0f), sr);
         const float cfWidth = dsp::clampf(target.cloudFrontWidth, 0.0f, 1.0f);
         const float widthSkewSamp = cfWidth * msToSamples(0.45f, sr); // up to ~0.45 ms
 
         // Step 5 controls (cache per chunk)
         const float smearOn = (target.cloudSmearEnable > 0.0001f) ? 1.0f : 0.0f;
-        const float smearAmt = dsp::clampf(target.cloudSmearAmount, 0.0f, 1.0f) * smearOn;
+        const float smearAmt = dsp::clampf(target.cloudSmearAmount, 0.0f, 1.0f) * smearOn * costGain;
         const float smearTimeSamp = msToSamples(dsp::clampf(target.cloudSmearTimeMs, 0.0f, 60.0f), sr);
         const float smearWidth = dsp::clampf(target.cloudSmearWidth, 0.0f, 1.0f);
         const float smearSkewSamp = smearWidth * msToSamples(0.60f, sr); // up to ~0.6 ms
@@ -477,182 +834,450 @@ void ReverbEngine::processBlock(const float* inL, const float* inR,
         // (Equivalent to ~30–60 ms “feel” without adding another filter object.)
         const float tailSmA = 0.995f;
 
-        for (int i = 0; i < chunk; ++i) {
-            const float pL = wetL[i];
-            const float pR = wetR[i];
+        // ---------------------------------------------------------------------
+        // Step 3: Cloud front-end multitap spray from predelay buffer
+        //         + injection build (wetL/R becomes the tank injection)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Spray);
+            BIGPI_TRACE_SCOPE("spray");
 
-            const float eL = erL[i];
-            const float eR = erR[i];
+            if (cfAmt > 0.0f && cfSizeSamp > 0.0f) {
+                for (int i = 0; i < chunk; ++i) {
+                    float sprayL = 0.0f;
+                    float sprayR = 0.0f;
 
-            // -----------------------------------------------------------------
-            // Step 3: Cloud front-end multitap spray from predelay buffer
-            // -----------------------------------------------------------------
-            float sprayL = 0.0f;
-            float sprayR = 0.0f;
+                    // The history already holds the whole chunk: sample i
+                    // is chunk - 1 - i samples behind its write position.
+                    const float age = float(chunk - 1 - i);
 
-            if (cfAmt > 0.0f && cfSizeSamp > 0.0f) {
-                for (int t = 0; t < kCloudTaps; ++t) {
-                    const float dt = kTapPos[t] * cfSizeSamp;
-                    const float sign = kTapSign[t];
-                    const float skew = sign * widthSkewSamp;
+                    for (int t = 0; t < kCloudTaps; ++t) {
+                        const float dt = kTapPos[t] * cfSizeSamp;
+                        const float sign = kTapSign[t];
+                        const float skew = sign * widthSkewSamp;
+
+                        const float dL = std::max(1.0f, preSamp + dt + skew) + age;
+                        const float dR = std::max(1.0f, preSamp + dt - skew) + age;
 
-                    const float dL = std::max(1.0f, preSamp + dt + skew);
-                    const float dR = std::max(1.0f, preSamp + dt - skew);
+                        const float tapL = preL.readFracCubic(dL);
+                        const float tapR = preR.readFracCubic(dR);
 
-                    const float tapL = preL.readFracCubic(dL);
-                    const float tapR = preR.readFracCubic(dR);
+                        sprayL += kTapGain[t] * tapL;
+                        sprayR += kTapGain[t] * tapR;
+                    }
 
-                    sprayL += kTapGain[t] * tapL;
-                    sprayR += kTapGain[t] * tapR;
+                    // conservative normalization
+                    sprayL *= 0.22f;
+                    sprayR *= 0.22f;
+
+                    wetL[i] = wetL[i] + erL[i] * 0.65f + cfAmt * sprayL;
+                    wetR[i] = wetR[i] + erR[i] * 0.65f + cfAmt * sprayR;
                 }
+            }
+            else {
+                for (int i = 0; i < chunk; ++i) {
+                    wetL[i] = wetL[i] + erL[i] * 0.65f;
+                    wetR[i] = wetR[i] + erR[i] * 0.65f;
+                }
+            }
+        }
 
-                // conservative normalization
-                sprayL *= 0.22f;
-                sprayR *= 0.22f;
+        // ---------------------------------------------------------------------
+        // Granular / MicroCosmos: while enabled the dry input is captured;
+        // the grains replace part of the injection and get diffused /
+        // smeared by the tank. Switching it on starts from an empty buffer
+        // and silent voices. While frozen the capture stops and the grains
+        // keep scanning it.
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Granular);
+            BIGPI_TRACE_SCOPE("granular");
+
+            const float grainOn = (target.granularEnable > 0.0001f) ? 1.0f : 0.0f;
+            const float grainAmt = dsp::clampf(target.granularAmount, 0.0f, 1.0f) * grainOn;
+
+            if (grainOn > 0.0f) {
+                if (!granularRunning) {
+                    granular.clear();
+                    granularRunning = true;
+                }
+
+                granular.capture(inL + pos, inR + pos, chunk, target.freeze > 0.5f);
+            }
+            else {
+                granularRunning = false;
             }
 
-            // Build injection
-            float injL = pL + eL * 0.65f + cfAmt * sprayL;
-            float injR = pR + eR * 0.65f + cfAmt * sprayR;
+            if (grainAmt > 0.0f) {
+                granular.render(grainL.data(), grainR.data(), chunk);
 
-            // -----------------------------------------------------------------
-            // Step 6: Dynamic diffusion refinement (input diffusion g per-sample)
-            // - transient detector from input (fast - slow env)
-            // - tail energy from tank (previous samples), smoothed
-            // -----------------------------------------------------------------
-            float inputMono = 0.5f * (std::abs(injL) + std::abs(injR));
-            float f = diffFast.process(inputMono);
-            float s = diffSlow.process(inputMono);
+                for (int i = 0; i < chunk; ++i) {
+                    wetL[i] = (1.0f - grainAmt) * wetL[i] + grainAmt * grainL[i];
+                    wetR[i] = (1.0f - grainAmt) * wetR[i] + grainAmt * grainR[i];
+                }
+            }
+        }
 
-            // transient proxy: normalized fast-slow difference
-            // (scale chosen to be musical and stable across typical pedal levels)
-            float transient01 = dsp::clampf((f - s) * 6.0f, 0.0f, 1.0f);
+        // ---------------------------------------------------------------------
+        // Magnetic: multi-head tape delay; its heads replace part of the
+        // injection, so the echoes are diffused and smeared by the tank
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Tape);
+            BIGPI_TRACE_SCOPE("tape");
+
+            const float tapeOn = (target.tapeEnable > 0.0001f) ? 1.0f : 0.0f;
+            const float tapeMix = dsp::clampf(target.tapeMix, 0.0f, 1.0f) * tapeOn;
+
+            if (tapeMix > 0.0f) {
+                if (!tapeRunning) {
+                    tape.clear();
+                    tapeRunning = true;
+                }
 
-            float tailRaw = dsp::clampf(tank.getEnv01(), 0.0f, 1.0f);
-            tailEnvSm = tailSmA * tailEnvSm + (1.0f - tailSmA) * tailRaw;
-            tailEnvSm = dsp::killDenorm(tailEnvSm);
+                tape.processBlock(wetL.data(), wetR.data(), tapeOutL.data(), tapeOutR.data(), chunk);
 
-            // Compute dynamic g around the knob value
-            float gBase = dsp::clampf(target.inputDiffG, 0.30f, 0.85f);
+                for (int i = 0; i < chunk; ++i) {
+                    wetL[i] = (1.0f - tapeMix) * wetL[i] + tapeMix * tapeOutL[i];
+                    wetR[i] = (1.0f - tapeMix) * wetR[i] + tapeMix * tapeOutR[i];
+                }
+            }
+            else {
+                tapeRunning = false;
+            }
+        }
 
-            // Tail boost increases diffusion as the tank gets denser
-            float gTail = gBase * (1.0f + tailBoost * (0.35f + 0.65f * tailEnvSm));
+        // ---------------------------------------------------------------------
+        // Sidechain analysis: level of the dry input (ducking) and of the
+        // injection (dynamic diffusion), once per chunk
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Sidechain);
+            BIGPI_TRACE_SCOPE("sidechain");
+            inputSide.analyze(inL + pos, inR + pos, chunk);
+            injectSide.analyze(wetL.data(), wetR.data(), chunk);
+        }
 
-            // Transient reduce pulls diffusion down on pick attacks
-            float gTrans = gTail * (1.0f - transReduce * 0.55f * transient01);
+        const float* diffFastEnv = injectSide.envelope(kDiffFastEnv);
+        const float* diffSlowEnv = injectSide.envelope(kDiffSlowEnv);
+        const float* duckEnv = inputSide.envelope(kDuckEnv);
 
-            float gDyn = dsp::clampf(gTrans, 0.30f, 0.85f);
+        // Spring mode: the springs take the same injection as the tank
+        const float springOn = (target.springEnable > 0.0001f) ? 1.0f : 0.0f;
+        const float springMix = dsp::clampf(target.springMix, 0.0f, 1.0f) * springOn;
 
-            // Apply per-sample time-varying diffusion g
-            diffusion.setTimeVaryingG(gDyn);
+        if (springMix > 0.0f) {
+            std::copy_n(wetL.begin(), chunk, springL.begin());
+            std::copy_n(wetR.begin(), chunk, springR.begin());
+        }
 
-            diffusion.processInput(injL, injR);
+        // Singularity mode: the long network takes the injection as well
+        const float singOn = (target.singularityEnable > 0.0001f) ? 1.0f : 0.0f;
+        const float singMix = dsp::clampf(target.singularityMix, 0.0f, 1.0f) * singOn;
 
-            // Step 1: MS decorrelated vector injection into tank
-            const float M = 0.5f * (injL + injR);
-            const float S = 0.5f * (injL - injR);
+        if (singMix > 0.0f) {
+            std::copy_n(wetL.begin(), chunk, singL.begin());
+            std::copy_n(wetR.begin(), chunk, singR.begin());
+        }
 
-            for (int li = 0; li < tcNow.lines; ++li) {
-                injVec[li] = (M * vM[li]) + (S * gS) * vS[li];
-            }
+        // ---------------------------------------------------------------------
+        // Diffusion -> Tank -> Taps (interleaved per sample)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_TRACE_SCOPE("diffusion_tank_taps");
+            BIGPI_PROF_LAP_BEGIN(lap, prof);
 
-            tank.processSampleVec(injVec, effDecay, lfos, yVec);
+            for (int i = 0; i < chunk; ++i) {
+                float injL = wetL[i];
+                float injR = wetR[i];
 
-            float tailL = 0.0f, tailR = 0.0f;
-            bigpi::core::renderTapPattern(yVec, tcNow.lines, modeCfg.tank.tapPattern, tailL, tailR);
+                // -----------------------------------------------------------------
+                // Step 6: Dynamic diffusion refinement (input diffusion g per-sample)
+                // - transient detector from input (fast - slow env)
+                // - tail energy from tank (previous samples), smoothed
+                // -----------------------------------------------------------------
+                const float f = diffFastEnv[i];
+                const float s = diffSlowEnv[i];
 
-            // -----------------------------------------------------------------
-            // Step 5: Optional post-tank micro-smear
-            // -----------------------------------------------------------------
-            if (smearAmt > 0.0f && smearTimeSamp > 0.0f) {
-                smearL.push(tailL);
-                smearR.push(tailR);
+                // transient proxy: normalized fast-slow difference
+                // (scale chosen to be musical and stable across typical pedal levels)
+                float transient01 = dsp::clampf((f - s) * 6.0f, 0.0f, 1.0f);
+
+                float tailRaw = dsp::clampf(tank.getEnv01(), 0.0f, 1.0f);
+                tailEnvSm = tailSmA * tailEnvSm + (1.0f - tailSmA) * tailRaw;
+                tailEnvSm = dsp::killDenorm(tailEnvSm);
+
+                // Compute dynamic g around the knob value
+                float gBase = dsp::clampf(target.inputDiffG, 0.30f, 0.85f);
+
+                // Tail boost increases diffusion as the tank gets denser
+                float gTail = gBase * (1.0f + tailBoost * (0.35f + 0.65f * tailEnvSm));
+
+                // Transient reduce pulls diffusion down on pick attacks
+                float gTrans = gTail * (1.0f - transReduce * 0.55f * transient01);
+
+                float gDyn = dsp::clampf(gTrans, 0.30f, 0.85f);
+
+                // Apply per-sample time-varying diffusion g
+                diffusion.setTimeVaryingG(gDyn);
+
+                if (diffBlend) {
+                    const int fullStages = diffusion.getConfiguredInputStages();
+                    diffusion.processInputBlend(injL, injR, std::min(fullStages, std::max(2, fullStages / 2)),
+                        governor.gain(bigpi::core::QualityLevel::FewerDiffusers));
+                }
+                else {
+                    diffusion.processInput(injL, injR);
+                }
+
+                BIGPI_PROF_LAP(lap, Diffusion);
+
+                // Step 1: MS decorrelated vector injection into tank
+                const float M = 0.5f * (injL + injR);
+                const float S = 0.5f * (injL - injR);
+
+                for (int li = 0; li < tcNow.lines; ++li) {
+                    injVec[li] = (M * vM[li]) + (S * gS) * vS[li];
+                }
 
-                float sL = 0.0f;
-                float sR = 0.0f;
+                tank.processSampleVec(injVec, effDecay, lfos, yVec);
 
-                for (int t = 0; t < kSmearTaps; ++t) {
-                    const float dt = kSmearPos[t] * smearTimeSamp;
-                    const float sign = kSmearSign[t];
-                    const float skew = sign * smearSkewSamp;
+                BIGPI_PROF_LAP(lap, Tank);
 
-                    const float dL = std::max(1.0f, dt + skew);
-                    const float dR = std::max(1.0f, dt - skew);
+                float tailL = 0.0f, tailR = 0.0f;
+                bigpi::core::renderTapPattern(yVec, tcNow.lines, modeCfg.tank.tapPattern, tailL, tailR);
 
-                    sL += kSmearGain[t] * smearL.readFracCubic(dL);
-                    sR += kSmearGain[t] * smearR.readFracCubic(dR);
+                if (tailDip) {
+                    const float g = governor.nextDipGain();
+                    tailL *= g;
+                    tailR *= g;
                 }
 
-                // normalization
-                sL *= 0.20f;
-                sR *= 0.20f;
+                wetL[i] = tailL;
+                wetR[i] = tailR;
+                tailEnvBuf[i] = tailEnvSm;
 
-                tailL = (1.0f - smearAmt) * tailL + smearAmt * (tailL + sL);
-                tailR = (1.0f - smearAmt) * tailR + smearAmt * (tailR + sR);
+                BIGPI_PROF_LAP(lap, Taps);
+            }
+
+            BIGPI_PROF_LAP_FLUSH(lap);
+        }
+
+        // ---------------------------------------------------------------------
+        // Spring model, blended with the tank tail (RoadMap Phase 3)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Spring);
+            BIGPI_TRACE_SCOPE("spring");
+
+            if (springMix > 0.0f) {
+                if (!springRunning) {
+                    spring.clear();
+                    springRunning = true;
+                }
+
+                spring.processBlock(springL.data(), springR.data(), springL.data(), springR.data(), chunk);
+
+                for (int i = 0; i < chunk; ++i) {
+                    wetL[i] = (1.0f - springMix) * wetL[i] + springMix * springL[i];
+                    wetR[i] = (1.0f - springMix) * wetR[i] + springMix * springR[i];
+                }
             }
             else {
-                smearL.push(tailL);
-                smearR.push(tailR);
+                springRunning = false;
             }
+        }
 
-            // -----------------------------------------------------------------
-            // Step 6: Dynamic late diffusion refinement
-            // - boost late diffusion as tail builds (optional)
-            // -----------------------------------------------------------------
-            float lateAmt = dsp::clampf(target.lateDiffAmount, 0.0f, 1.0f);
-            if (lateBoost > 0.0f) {
-                // Boost more when tail is “filled”; keep bounded
-                float boost = 1.0f + lateBoost * (0.25f + 0.75f * tailEnvSm);
-                lateAmt = dsp::clampf(lateAmt * boost, 0.0f, 1.0f);
+        // ---------------------------------------------------------------------
+        // Singularity long network, blended with the tank tail (RoadMap Phase 8)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Singularity);
+            BIGPI_TRACE_SCOPE("singularity");
+
+            if (singMix > 0.0f) {
+                if (!singularityRunning) {
+                    singularity.clear();
+                    singularityRunning = true;
+                }
+
+                singularity.processBlock(singL.data(), singR.data(), singL.data(), singR.data(), chunk,
+                    target.freeze > 0.5f);
+
+                for (int i = 0; i < chunk; ++i) {
+                    wetL[i] = (1.0f - singMix) * wetL[i] + singMix * singL[i];
+                    wetR[i] = (1.0f - singMix) * wetR[i] + singMix * singR[i];
+                }
             }
+            else {
+                singularityRunning = false;
+            }
+        }
 
-            if (target.lateDiffEnable > 0.0001f) {
-                diffusion.processLate(tailL, tailR, lateAmt);
+        // ---------------------------------------------------------------------
+        // Step 5: Optional post-tank micro-smear
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Smear);
+            BIGPI_TRACE_SCOPE("smear");
+
+            if (smearAmt > 0.0f && smearTimeSamp > 0.0f) {
+                for (int i = 0; i < chunk; ++i) {
+                    const float tailL = wetL[i];
+                    const float tailR = wetR[i];
+
+                    smearL.push(tailL);
+                    smearR.push(tailR);
+
+                    float sL = 0.0f;
+                    float sR = 0.0f;
+
+                    for (int t = 0; t < kSmearTaps; ++t) {
+                        const float dt = kSmearPos[t] * smearTimeSamp;
+                        const float sign = kSmearSign[t];
+                        const float skew = sign * smearSkewSamp;
+
+                        const float dL = std::max(1.0f, dt + skew);
+                        const float dR = std::max(1.0f, dt - skew);
+
+                        sL += kSmearGain[t] * smearL.readFracCubic(dL);
+                        sR += kSmearGain[t] * smearR.readFracCubic(dR);
+                    }
+
+                    // normalization
+                    sL *= 0.20f;
+                    sR *= 0.20f;
+
+                    wetL[i] = (1.0f - smearAmt) * tailL + smearAmt * (tailL + sL);
+                    wetR[i] = (1.0f - smearAmt) * tailR + smearAmt * (tailR + sR);
+                }
             }
+            else {
+                for (int i = 0; i < chunk; ++i) {
+                    smearL.push(wetL[i]);
+                    smearR.push(wetR[i]);
+                }
+            }
+        }
 
-            float wetOutL = tailL + eL;
-            float wetOutR = tailR + eR;
+        // ---------------------------------------------------------------------
+        // Step 6: Dynamic late diffusion refinement
+        // - boost late diffusion as tail builds (optional)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, LateDiffusion);
+            BIGPI_TRACE_SCOPE("late_diffusion");
 
-            // Loudness comp
-            float loudDb = 0.0f;
-            if (target.loudCompEnable > 0.0001f) loudDb = computeLoudnessCompDb(target.decay);
-            const float loudGain = dsp::dbToLin(loudDb);
+            if (target.lateDiffEnable > 0.0001f) {
+                const float lateBase = dsp::clampf(target.lateDiffAmount, 0.0f, 1.0f);
 
-            wetOutL *= loudGain;
-            wetOutR *= loudGain;
+                for (int i = 0; i < chunk; ++i) {
+                    float lateAmt = lateBase;
+                    if (lateBoost > 0.0f) {
+                        // Boost more when tail is “filled”; keep bounded
+                        float boost = 1.0f + lateBoost * (0.25f + 0.75f * tailEnvBuf[i]);
+                        lateAmt = dsp::clampf(lateAmt * boost, 0.0f, 1.0f);
+                    }
 
-            // Ducking
-            float duckGain = 1.0f;
-            if (target.duckEnable > 0.0001f) {
-                const float inMono = 0.5f * (std::abs(inL[pos + i]) + std::abs(inR[pos + i]));
-                const float env = duckEnv.process(inMono);
+                    diffusion.processLate(wetL[i], wetR[i], lateAmt);
+                }
+            }
+        }
 
-                if (env > duckThreshLin) {
-                    const float denom = std::max(1e-6f, (1.0f - duckThreshLin));
-                    const float over = dsp::clampf((env - duckThreshLin) / denom, 0.0f, 1.0f);
-                    duckGain = (1.0f - over) + over * duckDepthLin;
+        // ---------------------------------------------------------------------
+        // ER sum + loudness comp + ducking
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Ducking);
+            BIGPI_TRACE_SCOPE("ducking");
+
+            const bool duckOn = (target.duckEnable > 0.0001f);
+
+            for (int i = 0; i < chunk; ++i) {
+                float wetOutL = wetL[i] + erL[i];
+                float wetOutR = wetR[i] + erR[i];
+
+                // Loudness comp
+                wetOutL *= loudGain;
+                wetOutR *= loudGain;
+
+                // Ducking
+                float duckGain = 1.0f;
+                if (duckOn) {
+                    const float env = duckEnv[i];
+
+                    if (env > duckThreshLin) {
+                        const float denom = std::max(1e-6f, (1.0f - duckThreshLin));
+                        const float over = dsp::clampf((env - duckThreshLin) / denom, 0.0f, 1.0f);
+                        duckGain = (1.0f - over) + over * duckDepthLin;
+                    }
                 }
+
+                wetL[i] = wetOutL * duckGain;
+                wetR[i] = wetOutR * duckGain;
             }
+        }
+
+        // ---------------------------------------------------------------------
+        // Numeric health: block-rate NaN/Inf/runaway scan (core/Health.h)
+        // ---------------------------------------------------------------------
+        {
+            BIGPI_PROF_SCOPE(prof, Health);
+            BIGPI_TRACE_SCOPE("health");
+
+            const bool wasFading = health.fading();
+
+            const auto action = health.check(wetL.data(), wetR.data(), chunk,
+                tank.getLastOutputs().data(), tcNow.lines);
+
+            if (action != bigpi::core::HealthMonitor::Action::None) {
+                recoverFromHealthIncident(action, chunk);
+            }
+            else if (wasFading) {
+                health.applyFadeIn(wetL.data(), wetR.data(), chunk);
+            }
+        }
 
-            wetL[i] = wetOutL * duckGain;
-            wetR[i] = wetOutR * duckGain;
+        {
+            BIGPI_PROF_SCOPE(prof, OutputStage);
+            BIGPI_TRACE_SCOPE("output_stage");
+            outStage.processBlock(wetL.data(), wetR.data(), chunk);
         }
 
-        outStage.processBlock(wetL.data(), wetR.data(), chunk);
+        {
+            BIGPI_PROF_SCOPE(prof, Mix);
+            BIGPI_TRACE_SCOPE("mix");
 
-        const float mix = dsp::clampf(target.mix, 0.0f, 1.0f);
+            const float mix = dsp::clampf(target.mix, 0.0f, 1.0f);
 
-        for (int i = 0; i < chunk; ++i) {
-            const float dryL = inL[pos + i];
-            const float dryR = inR[pos + i];
+            for (int i = 0; i < chunk; ++i) {
+                const float dryL = inL[pos + i];
+                const float dryR = inR[pos + i];
 
-            const float wL = wetL[i];
-            const float wR = wetR[i];
+                const float wL = wetL[i];
+                const float wR = wetR[i];
 
-            outL[pos + i] = (1.0f - mix) * dryL + mix * wL;
-            outR[pos + i] = (1.0f - mix) * dryR + mix * wR;
+                outL[pos + i] = (1.0f - mix) * dryL + mix * wL;
+                outR[pos + i] = (1.0f - mix) * dryR + mix * wR;
+            }
         }
 
+        if (tailDip && governor.linesSwitchDue()) switchGovernorLines();
+
         pos += chunk;
     }
-}
\ No newline at end of file
+
+#if BIGPI_PROFILE
+    prof.recordBlock(prof.now() - blockT0, n, sr);
+#endif
+
+    if (govOn) {
+        const double fixedNs = governorDeadlineNs.load(std::memory_order_relaxed);
+        const double deadlineNs = (fixedNs > 0.0) ? fixedNs : double(n) * 1.0e9 / double(sr);
+        const double ns = bigpi::core::ticksToNs(bigpi::core::readCycleCounter() - govT0);
+
+        if (governor.update(float(ns / deadlineNs), n)) {
+            BIGPI_TRACE_INSTANT("governor_level", governor.currentLevel());
+        }
+    }
+}
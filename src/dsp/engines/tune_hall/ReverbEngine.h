@@ -7,9 +7,14 @@
 
 #include <vector>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <algorithm> // std::min/std::max used in implementation
 
+#include "core/Health.h"
+#include "core/Profiling.h"
+#include "core/QualityGovernor.h"
+#include "dsp/analysis/Sidechain.h"
 #include "dsp/common/Dsp.h"
 #include "dsp/engines/tune_hall/EarlyReflections.h"
 #include "dsp/engines/tune_hall/OutputStage.h"
@@ -18,6 +23,10 @@
 #include "dsp/modes/ModePresets.h"
 
 #include "dsp/diffusion/Diffusion.h"
+#include "dsp/granular/GranularEngine.h"
+#include "dsp/spring/SpringModel.h"
+#include "dsp/singularity/SingularityEngine.h"
+#include "dsp/tape/MagneticTape.h"
 #include "dsp/tail/Tank.h"
 #include "dsp/tail/TapPatterns.h"
 
@@ -116,6 +125,95 @@ public:
         float dynDiffTransientReduce = 0.35f;
         float dynDiffLateBoost = 0.35f;
 
+        // ---------------------------------------------------------------------
+        // Shimmer: pitch shifter inside the tank feedback (Shimmer mode)
+        //
+        // shimmerAmount:
+        //   share of the shimmer lines' feedback that is pitch-shifted (0..1)
+        //
+        // shimmerFifthMix:
+        //   0 = octave up (+12) only, 1 = fifth up (+7) only
+        // ---------------------------------------------------------------------
+        float shimmerEnable = 0.0f;
+        float shimmerAmount = 0.30f;
+        float shimmerFifthMix = 0.30f;
+
+        // ---------------------------------------------------------------------
+        // Granular / MicroCosmos: grains from a 2 s capture of the dry input,
+        // blended into the tank injection (dsp/granular/GranularEngine.h)
+        //
+        // granularAmount:
+        //   0 = injection unchanged, 1 = grains only
+        //
+        // granularBehavior:
+        //   0 = Mosaic, 1 = Tunnel, 2 = Sequence
+        // ---------------------------------------------------------------------
+        float granularEnable = 0.0f;
+        float granularAmount = 0.70f;
+        float granularBehavior = 0.0f;
+        float granularDensityHz = 14.0f;
+        float granularLengthMs = 90.0f;
+        float granularPitchRange = 0.30f;
+        float granularReverse = 0.30f;
+        float granularScan = 0.50f;
+
+        // ---------------------------------------------------------------------
+        // Spring: dispersive spring model fed by the tank injection, blended
+        // with the tank tail (dsp/spring/SpringModel.h)
+        //
+        // springMix:
+        //   0 = tank tail only, 1 = springs only
+        //
+        // springDrip:
+        //   spring loop feedback (how long the chirps keep repeating)
+        // ---------------------------------------------------------------------
+        float springEnable = 0.0f;
+        float springMix = 0.65f;
+        float springLengthMs = 38.0f;
+        float springDispersion = 0.60f;
+        float springDrip = 0.55f;
+        float springDampHz = 4500.0f;
+        float springToneHz = 2200.0f;
+        float springEmphasis = 0.50f;
+
+        // ---------------------------------------------------------------------
+        // Magnetic: multi-head tape delay in front of the tank
+        // (dsp/tape/MagneticTape.h)
+        //
+        // tapeMix:
+        //   0 = injection unchanged, 1 = tape heads only
+        //
+        // tapeHeads:
+        //   head spacing preset: 0 = Single, 1 = Pair, 2 = Triple, 3 = Quad
+        // ---------------------------------------------------------------------
+        float tapeEnable = 0.0f;
+        float tapeMix = 0.50f;
+        float tapeHeads = 2.0f;
+        float tapeTimeMs = 120.0f;
+        float tapeFeedback = 0.35f;
+        float tapeWow = 0.35f;
+        float tapeFlutter = 0.25f;
+        float tapeDrive = 1.20f;
+        float tapeAge = 0.30f;
+
+        // ---------------------------------------------------------------------
+        // Singularity: warped multi-second feedback network fed by the tank
+        // injection, blended with the tank tail
+        // (dsp/singularity/SingularityEngine.h)
+        //
+        // singularityMix:
+        //   0 = tank tail only, 1 = long network only
+        //
+        // singularityGravity:
+        //   time bending depth (read heads drift in speed / pitch)
+        // ---------------------------------------------------------------------
+        float singularityEnable = 0.0f;
+        float singularityMix = 0.50f;
+        float singularitySizeSec = 1.6f;
+        float singularityDecaySec = 14.0f;
+        float singularityDampHz = 3200.0f;
+        float singularityGravity = 0.50f;
+
         float outHpHz = 20.0f;
         float outLowShelfHz = 200.0f;
         float outLowGainDb = 0.0f;
@@ -136,6 +234,16 @@ public:
         float loudCompEnable = 1.0f;
         float loudCompStrength = 0.50f;
         float loudCompMaxDb = 9.0f;
+
+        // ---------------------------------------------------------------------
+        // Eco / HQ quality switch (RoadMap Phase 10)
+        //
+        // tankLines:
+        //   0  = use the mode preset line count
+        //   8  = Eco (8-line tank)
+        //   16 = HQ  (16-line tank)
+        // ---------------------------------------------------------------------
+        int tankLines = 0;
     };
 
     ReverbEngine() = default;
@@ -144,10 +252,91 @@ public:
     void reset();
     void setParams(const Params& p);
 
+    // Current target params (after any mode preset defaults were applied).
+    const Params& getParams() const { return target; }
+
     void processBlock(const float* inL, const float* inR,
         float* outL, float* outR,
         int n);
 
+    // -------------------------------------------------------------------------
+    // Per-stage timing stats (RoadMap Phase 2: CPU profiling per mode)
+    //
+    // Only populated when built with BIGPI_PROFILE=1
+    // (CMake: -DBIGPI_ENABLE_PROFILING=ON). Otherwise Stats::enabled is false
+    // and these calls cost nothing.
+    //
+    // Exception: the health* fields (NaN/runaway incidents, core/Health.h)
+    // and governor (core/QualityGovernor.h) are always filled.
+    //
+    // getStats() may be called from any thread.
+    // setStatsDeadlineUs(0) derives the deadline from each call (n / sr).
+    // The same deadline drives the quality governor.
+    // -------------------------------------------------------------------------
+    using Stats = bigpi::prof::Stats;
+
+    Stats getStats() const;
+    void resetStats();
+    void setStatsDeadlineUs(float us);
+
+    // -------------------------------------------------------------------------
+    // Adaptive quality governor (core/QualityGovernor.h)
+    //
+    // Off by default. When on, every processBlock() call is timed against the
+    // deadline and the engine steps its cost down under CPU pressure (jitter,
+    // input diffusion, spray/smear, interpolation, line count) and back up
+    // once headroom returns. Every decision shows up in Stats::governor.
+    //
+    // setQualityGovernor() may be called from any thread (not the first time
+    // from the audio thread: enabling calibrates the clock once).
+    // setQualityGovernorSettings() only outside processBlock().
+    // -------------------------------------------------------------------------
+    void setQualityGovernor(bool enabled);
+    void setQualityGovernorSettings(const bigpi::core::QualityGovernor::Settings& s);
+
+    // -------------------------------------------------------------------------
+    // Programs (precomputed parameter snapshots, see PresetBank.h)
+    //
+    // A Program is everything setParams() derives from a Params at one sample
+    // rate: the resolved params (mode preset already applied) plus the Tank,
+    // Diffusion, early-reflection and OutputStage coefficients. makeProgram()
+    // is pure: any thread, or offline into a preset bank file.
+    //
+    // setProgram() is the lock-free program change: any thread publishes a
+    // pointer, the next processBlock() picks it up and only copies (no filter
+    // design, no exp/log on the audio thread). The Program must stay alive
+    // until then; a bank keeps its programs for its whole lifetime.
+    // A Program made for another sample rate is ignored.
+    //
+    // loadProgram() applies one right away, like setParams() minus the
+    // derivation: call it from the thread that calls processBlock() (or
+    // before processing starts).
+    // -------------------------------------------------------------------------
+    struct Program {
+        Params params{};
+        float sampleRate = 48000.0f;
+
+        bigpi::ModeConfig modeCfg{};
+
+        bigpi::core::Tank::Coeffs tank{};
+        bigpi::core::Diffusion::InputConfig diffInput{};
+        bigpi::core::Diffusion::LateConfig diffLate{};
+        EarlyReflections::Params er{};
+        OutputStage::Coeffs out{};
+        bigpi::core::GranularEngine::Params granular{};
+        bigpi::core::SpringModel::Coeffs spring{};
+        bigpi::core::MagneticTape::Coeffs tape{};
+        bigpi::core::SingularityEngine::Coeffs singularity{};
+    };
+
+    // p with the defaults of p.mode's preset applied (what a mode change does).
+    static Params withModePreset(const Params& p);
+
+    static Program makeProgram(const Params& resolved, float sampleRate);
+
+    void setProgram(const Program* program);
+    void loadProgram(const Program& g);
+
 private:
     float sr = 48000.0f;
     int   block = 64;
@@ -169,8 +358,18 @@ private:
     EarlyReflections er{};
     bigpi::core::Diffusion diffusion{};
     bigpi::core::Tank tank{};
+    bigpi::core::Tank::Coeffs tankCoeffs{};     // last loadProgram(); the governor's line switch reapplies it
     OutputStage outStage{};
-
+    bigpi::core::GranularEngine granular{};
+    bool granularRunning = false;   // cleared when the grains start again
+    bigpi::core::SpringModel spring{};
+    bool springRunning = false;     // cleared when the springs start again
+    bigpi::core::MagneticTape tape{};
+    bool tapeRunning = false;       // cleared when the tape starts again
+    bigpi::core::SingularityEngine singularity{};
+    bool singularityRunning = false; // cleared when the network starts again
+
+    // Shared input history: predelay, ER taps and cloud spray taps
     dsp::DelayLine preL{}, preR{};
 
     // Step 5: post-tank micro-smear buffers (small, RT-safe)
@@ -178,11 +377,16 @@ private:
 
     dsp::MultiLFO lfos{};
 
-    dsp::EnvelopeFollower duckEnv{};
+    // Shared sidechain analysis (dsp/analysis/Sidechain.h), once per chunk:
+    //   inputSide  : dry input -> ducking
+    //   injectSide : tank injection -> Step 6 dynamic diffusion (fast/slow)
+    bigpi::core::SidechainAnalyzer inputSide{};
+    bigpi::core::SidechainAnalyzer injectSide{};
+    static constexpr int kDuckEnv = 0;
+    static constexpr int kDiffFastEnv = 0;
+    static constexpr int kDiffSlowEnv = 1;
 
-    // Step 6: dynamic diffusion helpers (RT-safe, no allocations)
-    dsp::EnvelopeFollower diffFast{};
-    dsp::EnvelopeFollower diffSlow{};
+    // Step 6: smoothed tank envelope (inside the feedback loop, per sample)
     float tailEnvSm = 0.0f;
 
     // REAL-TIME RULE:
@@ -191,8 +395,35 @@ private:
     std::vector<float> wetR{};
     std::vector<float> erL{};
     std::vector<float> erR{};
-
-    void applyModePreset(bigpi::Mode m);
-    float computeEffectiveDecay(float decay, float freeze01) const;
+    std::vector<float> grainL{};
+    std::vector<float> grainR{};
+    std::vector<float> springL{};
+    std::vector<float> springR{};
+    std::vector<float> tapeOutL{};
+    std::vector<float> tapeOutR{};
+    std::vector<float> singL{};
+    std::vector<float> singR{};
+    std::vector<float> tailEnvBuf{};
+
+    // NaN / runaway protection (RoadMap Phase 0), checked once per chunk
+    bigpi::core::HealthMonitor health{};
+    void recoverFromHealthIncident(bigpi::core::HealthMonitor::Action action, int chunk);
+
+    // Adaptive quality governor, applied once per chunk
+    bigpi::core::QualityGovernor governor{};
+    std::atomic<double> governorDeadlineNs{ 0.0 };   // 0 = n / sr
+    bool governorDiffCapped = false;                  // input stages at the reduced count
+    float applyGovernorChunk(int chunk);
+    void switchGovernorLines();
+
+#if BIGPI_PROFILE
+    bigpi::prof::Recorder prof{};
+#endif
+
+    // Program change handoff: written by setProgram(), taken by processBlock()
+    std::atomic<const Program*> pendingProgram{ nullptr };
+
+    int resolveTankLines() const;
+    static float computeEffectiveDecay(float decay, float freeze01);
     float computeLoudnessCompDb(float decay01) const;
 };
\ No newline at end of file
@@ -0,0 +1,370 @@
+#include "dsp/granular/GranularEngine.h"
+
+/*
+  =============================================================================
+  GranularEngine.cpp — Big Pi granular engine (implementation)
+  =============================================================================
+*/
+
+#include <algorithm> // std::min, std::max, std::fill
+#include <cmath>     // std::cos, std::exp2, std::sqrt, std::abs
+
+#include "dsp/common/Dsp.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIGPI_GRANULAR_SSE2 1
+#endif
+
+namespace bigpi::core {
+
+    // Sequence behaviour: pitch pattern (semitones) stepped once per grain
+    static constexpr int kSequenceSteps = 4;
+    static constexpr float kSequenceSemis[kSequenceSteps] = { 0.0f, 12.0f, 0.0f, 7.0f };
+
+    void GranularEngine::prepare(float sampleRate, int maxBlockSize, uint32_t seed) {
+        sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+        maxBlock = std::max(1, maxBlockSize);
+
+        size = std::max(64, int(kCaptureSeconds * sr));
+
+        // +2 guard samples: buf[size], buf[size + 1] mirror buf[0], buf[1]
+        bufL.assign(size_t(size) + 2, 0.0f);
+        bufR.assign(size_t(size) + 2, 0.0f);
+
+        accL.assign(size_t(maxBlock) * kGroupWidth, 0.0f);
+        accR.assign(size_t(maxBlock) * kGroupWidth, 0.0f);
+
+        for (int i = 0; i <= kWindowSize; ++i) {
+            const float t = float(i) / float(kWindowSize);
+            window[i] = 0.5f * (1.0f - std::cos(2.0f * dsp::kPi * t));
+        }
+        window[kWindowSize] = 0.0f;
+        window[kWindowSize + 1] = 0.0f;
+
+        rng = (seed == 0) ? 1u : seed;
+
+        clear();
+    }
+
+    void GranularEngine::clear() {
+        std::fill(bufL.begin(), bufL.end(), 0.0f);
+        std::fill(bufR.begin(), bufR.end(), 0.0f);
+        writePos = 0;
+        writePosAtBlock = 0;
+        captured = 0;
+
+        for (int v = 0; v < kMaxVoices; ++v) {
+            vPos[v] = 0.0f;
+            vSpeed[v] = 0.0f;
+            vAge[v] = 0.0f;
+            vInvLen[v] = 0.0f;
+            vGainL[v] = 0.0f;
+            vGainR[v] = 0.0f;
+            vActive[v] = false;
+        }
+
+        samplesToNext = 0.0f;
+        sequenceStep = 0;
+    }
+
+    void GranularEngine::setParams(const Params& p) {
+        params = p;
+
+        const int b = std::max(0, std::min(int(p.behavior), int(Behavior::Count) - 1));
+        params.behavior = Behavior(b);
+
+        params.densityHz = dsp::clampf(p.densityHz, 0.1f, 80.0f);
+        params.lengthMs = dsp::clampf(p.lengthMs, 10.0f, 500.0f);
+        params.pitchRange = dsp::clampf(p.pitchRange, 0.0f, 12.0f);
+        params.reverse = dsp::clampf(p.reverse, 0.0f, 1.0f);
+        params.scan = dsp::clampf(p.scan, 0.0f, 1.0f);
+    }
+
+    int GranularEngine::activeVoices() const {
+        int n = 0;
+        for (bool a : vActive) n += a ? 1 : 0;
+        return n;
+    }
+
+    // ============================================================================
+    // Capture
+    // ============================================================================
+
+    void GranularEngine::capture(const float* inL, const float* inR, int n, bool frozen) {
+        writePosAtBlock = writePos;
+        captured = frozen ? 0 : n;
+        if (frozen) return;
+
+        for (int i = 0; i < n; ++i) {
+            bufL[writePos] = inL[i];
+            bufR[writePos] = inR[i];
+
+            if (writePos < 2) {
+                bufL[size_t(size + writePos)] = inL[i];
+                bufR[size_t(size + writePos)] = inR[i];
+            }
+
+            if (++writePos >= size) writePos = 0;
+        }
+    }
+
+    // ============================================================================
+    // Scheduler
+    // ============================================================================
+
+    float GranularEngine::nextRandom01() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return float(rng >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float GranularEngine::nextRandomBi() {
+        return 2.0f * nextRandom01() - 1.0f;
+    }
+
+    int GranularEngine::pickVoice() const {
+        for (int v = 0; v < kMaxVoices; ++v) {
+            if (!vActive[v]) return v;
+        }
+
+        // Steal the voice closest to the end of its window (quietest cut)
+        int best = 0;
+        float bestPhase = -1.0f;
+        for (int v = 0; v < kMaxVoices; ++v) {
+            const float ph = vAge[v] * vInvLen[v];
+            if (ph > bestPhase) { bestPhase = ph; best = v; }
+        }
+        return best;
+    }
+
+    /*
+      spawn(offset)
+      -------------
+      Starts a grain `offset` samples into the current block.
+
+      Start distance D (samples behind the write head at the grain's start):
+        pitch up   : the head gains (speed - 1) per sample on the writer,
+                     so D >= (speed - 1) * len keeps it behind the writer
+        pitch down / reverse : the head falls back (1 - speed) per sample,
+                     so D <= size - (1 - speed) * len keeps it from being
+                     overwritten
+      The scan parameter chooses how much of that allowed range is used.
+    */
+    void GranularEngine::spawn(int offset) {
+        const Behavior b = params.behavior;
+
+        float len = params.lengthMs * 0.001f * sr * (b == Behavior::Tunnel ? 3.0f : 1.0f);
+
+        float semis = 0.0f;
+        float pan = 0.0f;
+        switch (b) {
+        case Behavior::Tunnel:
+            semis = (nextRandom01() < 0.5f ? -12.0f : -7.0f) + 0.25f * params.pitchRange * nextRandomBi();
+            pan = 0.3f * nextRandomBi();
+            break;
+        case Behavior::Sequence:
+            semis = kSequenceSemis[sequenceStep % kSequenceSteps];
+            pan = (sequenceStep & 1) ? 0.5f : -0.5f;
+            break;
+        case Behavior::Mosaic:
+        default:
+            semis = params.pitchRange * nextRandomBi();
+            pan = 0.6f * nextRandomBi();
+            break;
+        }
+
+        float speed = std::exp2(semis / 12.0f);
+        if (params.reverse > 0.0f && nextRandom01() < params.reverse) speed = -speed;
+
+        // The grain must fit the buffer at this speed
+        const float room = float(size) - 8.0f;
+        const float span = std::abs(1.0f - speed);
+        if (span * len > room) len = room / span;
+        len = std::max(len, 16.0f);
+
+        const float dMin = std::max(0.0f, speed - 1.0f) * len + 2.0f;
+        const float dMax = std::max(dMin, float(size) - 4.0f - std::max(0.0f, 1.0f - speed) * len);
+        const float reach = dMin + params.scan * (dMax - dMin);
+
+        float dist = dMin;
+        if (b == Behavior::Sequence) {
+            dist = dMin + (reach - dMin) * float(sequenceStep % kSequenceSteps) / float(kSequenceSteps);
+            ++sequenceStep;
+        }
+        else {
+            dist = dMin + nextRandom01() * (reach - dMin);
+        }
+
+        // "Now" for the grain: the write head as it was at sample `offset`
+        const int now = writePosAtBlock + std::min(offset + 1, captured);
+
+        // Position at the start of the block: age 0 falls on sample `offset`
+        float pos = float(now) - dist - speed * float(offset);
+        pos = std::fmod(pos, float(size));
+        if (pos < 0.0f) pos += float(size);
+
+        const int v = pickVoice();
+        vPos[v] = pos;
+        vSpeed[v] = speed;
+        vAge[v] = -float(offset);
+        vInvLen[v] = 1.0f / len;
+        vGainL[v] = std::sqrt(1.0f - pan);
+        vGainR[v] = std::sqrt(1.0f + pan);
+        vActive[v] = true;
+    }
+
+    // ============================================================================
+    // Rendering
+    // ============================================================================
+
+    void GranularEngine::renderGroup(int g, int n) {
+        const int base = g * kGroupWidth;
+        float* aL = accL.data();
+        float* aR = accR.data();
+        const float* wt = window.data();
+        const float* bL = bufL.data();
+        const float* bR = bufR.data();
+
+#if BIGPI_GRANULAR_SSE2
+        __m128 pos = _mm_load_ps(vPos + base);
+        __m128 age = _mm_load_ps(vAge + base);
+        const __m128 spd = _mm_load_ps(vSpeed + base);
+        const __m128 inv = _mm_load_ps(vInvLen + base);
+        const __m128 gl = _mm_load_ps(vGainL + base);
+        const __m128 gr = _mm_load_ps(vGainR + base);
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 wsz = _mm_set1_ps(float(kWindowSize));
+        const __m128 sizeF = _mm_set1_ps(float(size));
+
+        alignas(16) int wi[kGroupWidth];
+        alignas(16) int bi[kGroupWidth];
+
+        for (int i = 0; i < n; ++i) {
+            // Window (table + linear interpolation); phase < 0 or >= 1 reads 0
+            const __m128 ph = _mm_min_ps(_mm_max_ps(_mm_mul_ps(age, inv), zero), one);
+            const __m128 x = _mm_mul_ps(ph, wsz);
+            const __m128i xi = _mm_cvttps_epi32(x);
+            const __m128 wf = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+
+            // Buffer read position (pos is kept in [0, size))
+            const __m128i pi = _mm_cvttps_epi32(pos);
+            const __m128 pf = _mm_sub_ps(pos, _mm_cvtepi32_ps(pi));
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(wi), xi);
+            _mm_store_si128(reinterpret_cast<__m128i*>(bi), pi);
+
+            const __m128 w0 = _mm_setr_ps(wt[wi[0]], wt[wi[1]], wt[wi[2]], wt[wi[3]]);
+            const __m128 w1 = _mm_setr_ps(wt[wi[0] + 1], wt[wi[1] + 1], wt[wi[2] + 1], wt[wi[3] + 1]);
+            const __m128 w = _mm_add_ps(w0, _mm_mul_ps(wf, _mm_sub_ps(w1, w0)));
+
+            const __m128 l0 = _mm_setr_ps(bL[bi[0]], bL[bi[1]], bL[bi[2]], bL[bi[3]]);
+            const __m128 l1 = _mm_setr_ps(bL[bi[0] + 1], bL[bi[1] + 1], bL[bi[2] + 1], bL[bi[3] + 1]);
+            const __m128 r0 = _mm_setr_ps(bR[bi[0]], bR[bi[1]], bR[bi[2]], bR[bi[3]]);
+            const __m128 r1 = _mm_setr_ps(bR[bi[0] + 1], bR[bi[1] + 1], bR[bi[2] + 1], bR[bi[3] + 1]);
+
+            const __m128 sL = _mm_add_ps(l0, _mm_mul_ps(pf, _mm_sub_ps(l1, l0)));
+            const __m128 sR = _mm_add_ps(r0, _mm_mul_ps(pf, _mm_sub_ps(r1, r0)));
+
+            float* accLi = aL + size_t(i) * kGroupWidth;
+            float* accRi = aR + size_t(i) * kGroupWidth;
+            _mm_storeu_ps(accLi, _mm_add_ps(_mm_loadu_ps(accLi), _mm_mul_ps(_mm_mul_ps(w, gl), sL)));
+            _mm_storeu_ps(accRi, _mm_add_ps(_mm_loadu_ps(accRi), _mm_mul_ps(_mm_mul_ps(w, gr), sR)));
+
+            age = _mm_add_ps(age, one);
+            pos = _mm_add_ps(pos, spd);
+            pos = _mm_sub_ps(pos, _mm_and_ps(_mm_cmpge_ps(pos, sizeF), sizeF));
+            pos = _mm_add_ps(pos, _mm_and_ps(_mm_cmplt_ps(pos, zero), sizeF));
+        }
+
+        _mm_store_ps(vPos + base, pos);
+        _mm_store_ps(vAge + base, age);
+#else
+        for (int l = 0; l < kGroupWidth; ++l) {
+            const int v = base + l;
+            float pos = vPos[v];
+            float age = vAge[v];
+            const float spd = vSpeed[v];
+            const float inv = vInvLen[v];
+            const float gl = vGainL[v];
+            const float gr = vGainR[v];
+            const float fSize = float(size);
+
+            for (int i = 0; i < n; ++i) {
+                const float ph = std::min(std::max(age * inv, 0.0f), 1.0f);
+                const float x = ph * float(kWindowSize);
+                const int xi = int(x);
+                const float w = wt[xi] + (x - float(xi)) * (wt[xi + 1] - wt[xi]);
+
+                const int pi = int(pos);
+                const float pf = pos - float(pi);
+                const float sL = bL[pi] + pf * (bL[pi + 1] - bL[pi]);
+                const float sR = bR[pi] + pf * (bR[pi + 1] - bR[pi]);
+
+                aL[size_t(i) * kGroupWidth + l] += w * gl * sL;
+                aR[size_t(i) * kGroupWidth + l] += w * gr * sR;
+
+                age += 1.0f;
+                pos += spd;
+                if (pos >= fSize) pos -= fSize;
+                if (pos < 0.0f) pos += fSize;
+            }
+
+            vPos[v] = pos;
+            vAge[v] = age;
+        }
+#endif
+    }
+
+    void GranularEngine::render(float* outL, float* outR, int n) {
+        n = std::min(n, maxBlock);
+
+        // Scheduler: grains due inside this block, sample-accurate
+        const float interval = sr / params.densityHz;
+        samplesToNext = std::min(samplesToNext, 1.5f * interval);   // follow density increases
+
+        while (samplesToNext < float(n)) {
+            spawn(std::max(0, int(samplesToNext)));
+
+            float next = interval;
+            if (params.behavior == Behavior::Mosaic) next *= 0.5f + nextRandom01();
+            samplesToNext += next;
+        }
+        samplesToNext -= float(n);
+
+        std::fill(accL.begin(), accL.begin() + size_t(n) * kGroupWidth, 0.0f);
+        std::fill(accR.begin(), accR.begin() + size_t(n) * kGroupWidth, 0.0f);
+
+        for (int g = 0; g < kGroups; ++g) {
+            const int base = g * kGroupWidth;
+            if (vActive[base] || vActive[base + 1] || vActive[base + 2] || vActive[base + 3]) {
+                renderGroup(g, n);
+            }
+        }
+
+        // Overlapping grains add up: scale by 1/sqrt(expected overlap)
+        const float lenSec = params.lengthMs * 0.001f * (params.behavior == Behavior::Tunnel ? 3.0f : 1.0f);
+        const float norm = 1.0f / std::sqrt(std::max(1.0f, params.densityHz * lenSec));
+
+        for (int i = 0; i < n; ++i) {
+            const float* l = &accL[size_t(i) * kGroupWidth];
+            const float* r = &accR[size_t(i) * kGroupWidth];
+            outL[i] = norm * ((l[0] + l[1]) + (l[2] + l[3]));
+            outR[i] = norm * ((r[0] + r[1]) + (r[2] + r[3]));
+        }
+
+        // Retire finished grains
+        for (int v = 0; v < kMaxVoices; ++v) {
+            if (vActive[v] && vAge[v] * vInvLen[v] >= 1.0f) {
+                vActive[v] = false;
+                vGainL[v] = 0.0f;
+                vGainR[v] = 0.0f;
+                vSpeed[v] = 0.0f;
+            }
+        }
+    }
+
+} // namespace bigpi::core
@@ -0,0 +1,128 @@
+#pragma once
+/*
+  =============================================================================
+  GranularEngine.h — Big Pi granular engine (Granular / MicroCosmos modes)
+  =============================================================================
+
+  RoadMap Phase 7 (Granular) and Phase 9 (MicroCosmos):
+
+      Input -> capture buffer (2 s stereo) -> ~32 grains -> Diffusion -> Tank
+
+  The engine does not sit inside the tank: ReverbEngine blends its output
+  into the tank injection, so the grains get diffused and smeared by the
+  existing network.
+
+  Grain model:
+    A grain plays a piece of the capture buffer through a Hann window:
+      speed > 1 -> pitch up, speed < 1 -> pitch down, speed < 0 -> reverse
+    Behaviours (Behavior):
+      Mosaic   : random start positions, slight pitch variation, jittered timing
+      Tunnel   : slow (octave / fifth below), long grains, drone
+      Sequence : grid-timed grains stepping through the buffer (rhythmic)
+
+  Performance layout:
+    - Voice state is structure-of-arrays (pos[], speed[], age[], ...) in a
+      fixed pool of kMaxVoices. No allocation after prepare().
+    - The window is a lookup table (no cos per sample).
+    - render() works block-wise: for each group of 4 voices the state stays
+      in registers for the whole block and the 4 voices are computed
+      together (SSE2; scalar fallback elsewhere). Per-sample results are
+      accumulated lane-wise and reduced once per sample at the end.
+    - Grains start sample-accurately inside a block: a new grain starts at
+      a negative age, and the window is 0 until its age reaches 0.
+    - Scheduler: free voice first, otherwise the voice closest to the end
+      of its window is stolen (least audible cut).
+
+  Threads / real time:
+    prepare() allocates. capture(), render(), clear() and setParams() are
+    audio-thread safe.
+*/
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace bigpi::core {
+
+    class GranularEngine {
+    public:
+        static constexpr int kMaxVoices = 32;
+        static constexpr int kGroupWidth = 4;                       // voices per SIMD group
+        static constexpr int kGroups = kMaxVoices / kGroupWidth;
+        static constexpr int kWindowSize = 512;                     // Hann table (+2 guard points)
+        static constexpr float kCaptureSeconds = 2.0f;
+
+        enum class Behavior : int {
+            Mosaic = 0,
+            Tunnel,
+            Sequence,
+
+            Count
+        };
+
+        struct Params {
+            Behavior behavior = Behavior::Mosaic;
+            float densityHz = 12.0f;        // new grains per second
+            float lengthMs = 90.0f;         // grain length (Tunnel plays them 3x longer)
+            float pitchRange = 0.3f;        // random pitch spread, +- semitones
+            float reverse = 0.25f;          // probability of a reversed grain (0..1)
+            float scan = 0.5f;              // how far back grains may start (0..1 of the buffer)
+        };
+
+        GranularEngine() = default;
+
+        void prepare(float sampleRate, int maxBlock, uint32_t seed);
+        void clear();
+
+        // Block rate. Cheap: only copies and clamps.
+        void setParams(const Params& p);
+
+        // Writes n input samples into the capture buffer (skipped while frozen).
+        void capture(const float* inL, const float* inR, int n, bool frozen);
+
+        // Schedules and renders n samples of grains (n <= maxBlock), after capture().
+        void render(float* outL, float* outR, int n);
+
+        int activeVoices() const;
+
+    private:
+        float sr = 48000.0f;
+        int maxBlock = 0;
+        Params params{};
+
+        // Capture ring: kCaptureSeconds * sr samples + 2 guard samples
+        // (buf[size], buf[size + 1] mirror buf[0], buf[1], so linear reads never wrap).
+        std::vector<float> bufL{}, bufR{};
+        int size = 0;
+        int writePos = 0;
+        int writePosAtBlock = 0;            // writePos before the current block's capture
+        int captured = 0;                   // samples written by the last capture() (0 when frozen)
+
+        // Voice pool (structure of arrays, groups of kGroupWidth)
+        alignas(16) float vPos[kMaxVoices] = {};        // read position (buffer index)
+        alignas(16) float vSpeed[kMaxVoices] = {};      // buffer samples per output sample
+        alignas(16) float vAge[kMaxVoices] = {};        // samples since start (< 0: not yet)
+        alignas(16) float vInvLen[kMaxVoices] = {};     // 1 / length (window phase per sample)
+        alignas(16) float vGainL[kMaxVoices] = {};
+        alignas(16) float vGainR[kMaxVoices] = {};
+        std::array<bool, kMaxVoices> vActive{};
+
+        // Hann window 0.5 * (1 - cos(2 pi t)), t = 0..1, plus guard points
+        std::array<float, kWindowSize + 2> window{};
+
+        // Lane-wise accumulators (kGroupWidth floats per sample)
+        std::vector<float> accL{}, accR{};
+
+        // Scheduler
+        float samplesToNext = 0.0f;
+        int sequenceStep = 0;
+        uint32_t rng = 0x1234567u;
+
+        float nextRandom01();
+        float nextRandomBi();
+        int pickVoice() const;
+        void spawn(int offset);
+        void renderGroup(int g, int n);
+    };
+
+} // namespace bigpi::core
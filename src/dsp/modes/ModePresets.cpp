@@ -10,8 +10,15 @@
 
 namespace bigpi {
 
+    /*
+      Everything in this file is constexpr: the recipes below are evaluated
+      once, at compile time, into kModePresets (one ModeConfig per mode) and
+      kTankDelayTable (tank delay lengths in samples per mode and per common
+      sample rate). At runtime a mode change is a table lookup and a copy.
+    */
+
     // Helper to fill default modulation maps with a pleasing spread.
-    static void fillModMap_Default(std::array<float, 16>& depthMul,
+    static constexpr void fillModMap_Default(std::array<float, 16>& depthMul,
         std::array<float, 16>& rateMul)
     {
         for (int i = 0; i < 16; ++i) {
@@ -21,7 +28,7 @@ namespace bigpi {
         }
     }
 
-    static void fillModMap_Plate(std::array<float, 16>& depthMul,
+    static constexpr void fillModMap_Plate(std::array<float, 16>& depthMul,
         std::array<float, 16>& rateMul)
     {
         for (int i = 0; i < 16; ++i) {
@@ -31,7 +38,7 @@ namespace bigpi {
         }
     }
 
-    static void fillModMap_Sky(std::array<float, 16>& depthMul,
+    static constexpr void fillModMap_Sky(std::array<float, 16>& depthMul,
         std::array<float, 16>& rateMul)
     {
         for (int i = 0; i < 16; ++i) {
@@ -41,7 +48,7 @@ namespace bigpi {
         }
     }
 
-    static void fillModMap_Vintage(std::array<float, 16>& depthMul,
+    static constexpr void fillModMap_Vintage(std::array<float, 16>& depthMul,
         std::array<float, 16>& rateMul)
     {
         for (int i = 0; i < 16; ++i) {
@@ -51,7 +58,7 @@ namespace bigpi {
         }
     }
 
-    static bool modMapAllZero(const std::array<float, 16>& a,
+    static constexpr bool modMapAllZero(const std::array<float, 16>& a,
         const std::array<float, 16>& b)
     {
         for (int i = 0; i < 16; ++i) {
@@ -61,13 +68,13 @@ namespace bigpi {
         return true;
     }
 
-    static int clampDelayLines(int n) {
+    static constexpr int clampDelayLines(int n) {
         // Big Pi supports 8 or 16. If something else slips in, default to 16.
         if (n == 8) return 8;
         return 16;
     }
 
-    ModeConfig getModePreset(Mode m) {
+    static constexpr ModeConfig makeModePreset(Mode m) {
         ModeConfig cfg{};
         cfg.mode = m;
 
@@ -423,7 +430,9 @@ namespace bigpi {
 
         // Ensure late diffusion range is ordered
         if (cfg.tank.lateDiffMinG > cfg.tank.lateDiffMaxG) {
-            std::swap(cfg.tank.lateDiffMinG, cfg.tank.lateDiffMaxG);
+            const float g = cfg.tank.lateDiffMinG;   // (std::swap is not constexpr in C++17)
+            cfg.tank.lateDiffMinG = cfg.tank.lateDiffMaxG;
+            cfg.tank.lateDiffMaxG = g;
         }
 
         // Ensure modulation maps are not accidentally left all-zero
@@ -434,6 +443,109 @@ namespace bigpi {
         return cfg;
     }
 
+    // ============================================================================
+    // Base delay sets (ms, 16 lines), scaled by TankConfig::delayScale
+    // ============================================================================
+
+    static constexpr std::array<float, 16> kBaseMs16_Default = {
+      29.7f, 37.1f, 41.1f, 43.7f,
+      53.9f, 59.5f, 61.7f, 71.3f,
+      79.9f, 89.7f, 97.3f, 101.9f,
+      107.9f, 115.1f, 123.7f, 131.9f
+    };
+
+    static constexpr std::array<float, 16> kBaseMs16_Hall = {
+      31.7f, 37.9f, 41.3f, 43.1f,
+      53.3f, 59.9f, 61.1f, 71.7f,
+      79.3f, 89.1f, 97.9f, 103.3f,
+      109.7f, 117.1f, 125.9f, 137.3f
+    };
+
+    // Kappa+Cloud Mod (Step 4): Cloud delay-line set (Sky only)
+    static constexpr std::array<float, 16> kBaseMs16_Cloud = {
+      27.9f, 33.6f, 39.2f, 44.9f,
+      51.7f, 57.4f, 63.8f, 70.9f,
+      78.1f, 86.6f, 95.8f, 104.7f,
+      114.3f, 124.9f, 136.8f, 149.7f
+    };
+
+    static constexpr const std::array<float, 16>& baseDelaySet(Mode m, bool cloudSet) {
+        if (m == Mode::Hall) return kBaseMs16_Hall;
+        if (m == Mode::Sky && cloudSet) return kBaseMs16_Cloud;
+        return kBaseMs16_Default;
+    }
+
+    // Same arithmetic as the engine's msToSamples(): ms * 0.001 * sr
+    static constexpr std::array<float, 16> makeTankDelaySamples(const ModeConfig& cfg, bool cloudSet, float sr) {
+        const std::array<float, 16>& base = baseDelaySet(cfg.mode, cloudSet);
+
+        std::array<float, 16> d{};
+        for (int i = 0; i < 16; ++i) {
+            const float ms = base[i] * cfg.tank.delayScale;
+            d[i] = ms * 0.001f * sr;
+        }
+        return d;
+    }
+
+    // ============================================================================
+    // Compile-time tables
+    // ============================================================================
+
+    static constexpr int kNumModes = int(Mode::Count);
+
+    // One entry per mode, plus Mode::Count (the plain global defaults).
+    static constexpr std::array<ModeConfig, kNumModes + 1> buildModePresets() {
+        std::array<ModeConfig, kNumModes + 1> t{};
+        for (int i = 0; i <= kNumModes; ++i) t[i] = makeModePreset(Mode(i));
+        return t;
+    }
+
+    static constexpr std::array<ModeConfig, kNumModes + 1> kModePresets = buildModePresets();
+
+    // Sample rates with a precomputed delay table; others are computed on the fly.
+    static constexpr int kNumTableRates = 5;
+    static constexpr float kTableRates[kNumTableRates] = { 44100.0f, 48000.0f, 88200.0f, 96000.0f, 192000.0f };
+
+    // [rate][mode][cloudSet]
+    struct TankDelayTable {
+        std::array<float, 16> samples[kNumTableRates][kNumModes][2];
+    };
+
+    static constexpr TankDelayTable buildTankDelayTable() {
+        TankDelayTable t{};
+        for (int r = 0; r < kNumTableRates; ++r) {
+            for (int m = 0; m < kNumModes; ++m) {
+                t.samples[r][m][0] = makeTankDelaySamples(kModePresets[m], false, kTableRates[r]);
+                t.samples[r][m][1] = makeTankDelaySamples(kModePresets[m], true, kTableRates[r]);
+            }
+        }
+        return t;
+    }
+
+    static constexpr TankDelayTable kTankDelayTable = buildTankDelayTable();
+
+    static_assert(kModePresets[int(Mode::Sky)].tank.delayLines == 16, "Sky must keep the full 16-line tank");
+    static_assert(kTankDelayTable.samples[1][int(Mode::Hall)][0][0] == 31.7f * 1.15f * 0.001f * 48000.0f,
+        "delay table must match the runtime formula");
+
+    // ============================================================================
+    // Lookups
+    // ============================================================================
+
+    ModeConfig getModePreset(Mode m) {
+        if (int(m) >= 0 && int(m) <= kNumModes) return kModePresets[size_t(m)];
+        return makeModePreset(m);
+    }
+
+    std::array<float, 16> getTankDelaySamples(Mode m, bool cloudSet, float sampleRate) {
+        if (int(m) >= 0 && int(m) < kNumModes) {
+            for (int r = 0; r < kNumTableRates; ++r) {
+                if (sampleRate == kTableRates[r]) return kTankDelayTable.samples[r][int(m)][cloudSet ? 1 : 0];
+            }
+        }
+        return makeTankDelaySamples(getModePreset(m), cloudSet, sampleRate);
+    }
+
 } // namespace bigpi
 
 
@@ -24,7 +24,10 @@
 
   Implementation note:
   --------------------
-  ModePresets.cpp returns a ModeConfig object for a given Mode.
+  ModePresets.cpp returns a ModeConfig object for a given Mode. The recipes
+  are constexpr and evaluated at compile time into tables, together with
+  the tank delay lengths (in samples) for 44.1 / 48 / 88.2 / 96 / 192 kHz,
+  so selecting a mode costs a lookup and a copy.
 */
 
 #include <array>
@@ -124,5 +127,17 @@ namespace bigpi {
     */
     ModeConfig getModePreset(Mode m);
 
+    /*
+      getTankDelaySamples(mode, cloudSet, sampleRate)
+
+      Tank delay-line lengths in samples: the mode's base delay set
+      (Hall has its own, Sky uses the Cloud set when cloudSet is true,
+      everything else the default set) scaled by TankConfig::delayScale.
+
+      A copy of a precomputed table row for 44100 / 48000 / 88200 / 96000 /
+      192000 Hz; other rates are computed with the same arithmetic.
+    */
+    std::array<float, 16> getTankDelaySamples(Mode m, bool cloudSet, float sampleRate);
+
 } // namespace bigpi
 
@@ -108,6 +108,23 @@ namespace bigpi {
         }
     }
 
+    // Reverse of modeToString (exact, case-sensitive match).
+    // Returns false and leaves `out` untouched for unknown names.
+    inline bool modeFromString(const char* name, Mode& out) {
+        if (!name) return false;
+
+        for (int i = 0; i < int(Mode::Count); ++i) {
+            const char* a = modeToString(Mode(i));
+            const char* b = name;
+            while (*a && *a == *b) { ++a; ++b; }
+            if (*a == '\0' && *b == '\0') {
+                out = Mode(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
     // ============================================================================
     // Mode Category Helpers
     // ============================================================================
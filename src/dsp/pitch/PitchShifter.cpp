@@ -0,0 +1,107 @@
+#include "dsp/pitch/PitchShifter.h"
+
+/*
+  =============================================================================
+  PitchShifter.cpp — Big Pi in-loop shimmer pitch shifter (implementation)
+  =============================================================================
+*/
+
+#include <algorithm> // std::max, std::min
+#include <cmath>     // std::sin, std::pow, std::lround
+
+namespace bigpi::core {
+
+    void PitchShifter::prepare(float sampleRate) {
+        sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        // 44.1/48 kHz -> 2, 88.2/96 kHz -> 4, 192 kHz -> 8
+        decim = std::max(1, int(std::lround(sr / kTargetRateHz)));
+        const float rate = sr / float(decim);
+
+        windowSamp = kWindowMs * 0.001f * rate;
+        buf.init(int(windowSamp) + 8);
+
+        // sin^2 over one window: w(p) + w(p + 0.5) == 1
+        for (int i = 0; i <= kWindowSize; ++i) {
+            const float s = std::sin(dsp::kPi * float(i) / float(kWindowSize));
+            window[i] = s * s;
+        }
+
+        voices[0].ratio = 2.0f;                             // +12
+        voices[1].ratio = std::pow(2.0f, 7.0f / 12.0f);     // +7
+
+        // Pitching up: the read head gains (ratio - 1) samples on the write
+        // head per sample, i.e. its delay shrinks by that much.
+        for (Voice& v : voices) {
+            v.step = (v.ratio - 1.0f) / windowSamp;
+        }
+
+        clear();
+    }
+
+    void PitchShifter::clear() {
+        buf.clear();
+
+        for (int i = 0; i < kVoices; ++i) {
+            // Spread the voices so their crossfades do not line up
+            voices[i].phase = 0.25f * float(i);
+        }
+
+        acc = 0.0f;
+        accCount = 0;
+        yPrev = 0.0f;
+        yNew = 0.0f;
+    }
+
+    void PitchShifter::setVoiceGains(float octaveGain, float fifthGain) {
+        voices[0].gain = octaveGain;
+        voices[1].gain = fifthGain;
+    }
+
+    float PitchShifter::windowAt(float p) const {
+        const float x = p * float(kWindowSize);
+        const int i = std::min(int(x), kWindowSize - 1);
+        const float f = x - float(i);
+        return window[i] + f * (window[i + 1] - window[i]);
+    }
+
+    float PitchShifter::processDecimated(float x) {
+        buf.push(x);
+
+        float y = 0.0f;
+
+        for (Voice& v : voices) {
+            // Delay shrinks from windowSamp to 0 over one window, then wraps
+            v.phase -= v.step;
+            if (v.phase < 0.0f) v.phase += 1.0f;
+
+            float pB = v.phase + 0.5f;
+            if (pB >= 1.0f) pB -= 1.0f;
+
+            // +1: delay 1 is the newest sample (see dsp::DelayLine)
+            const float a = windowAt(v.phase) * buf.readFracLinear(1.0f + v.phase * windowSamp);
+            const float b = windowAt(pB) * buf.readFracLinear(1.0f + pB * windowSamp);
+
+            y += v.gain * (a + b);
+        }
+
+        return dsp::killDenorm(y);
+    }
+
+    float PitchShifter::process(float x) {
+        acc += x;
+        ++accCount;
+
+        if (accCount >= decim) {
+            yPrev = yNew;
+            yNew = processDecimated(acc / float(decim));
+            acc = 0.0f;
+            accCount = 0;
+        }
+
+        // Linear interpolation from the previous to the newest decimated output
+        const float t = float(accCount + 1) / float(decim);
+        return yPrev + t * (yNew - yPrev);
+    }
+
+} // namespace bigpi::core
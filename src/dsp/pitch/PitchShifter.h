@@ -0,0 +1,93 @@
+#pragma once
+/*
+  =============================================================================
+  PitchShifter.h — Big Pi in-loop shimmer pitch shifter (+12 / +7)
+  =============================================================================
+
+  What it is for:
+    Shimmer mode (ModeFeatures::usePitchBlock). The Tank feeds part of its
+    own feedback through this block, so every trip around the loop climbs
+    another octave / fifth and the tail "blooms" upwards.
+
+  How it works (classic dual read head, a.k.a. rotating-tape shifter):
+    - The input is written into a short delay buffer.
+    - A read head sweeps through the buffer at a different speed than the
+      write head: reading faster than writing raises the pitch by `ratio`.
+    - When the head reaches the write position it jumps back one window
+      length. To hide the jump, a second head runs half a window behind
+      and the two are crossfaded with a sin^2 window (the two windows
+      always add up to 1, so the level stays constant).
+    - Two voices (octave and fifth) share the buffer; each has its own
+      pair of heads.
+
+  Why it is cheap:
+    - It runs at a decimated rate (about 24 kHz). Its input is the tank
+      feedback, which has already been through the feedback low-pass, so
+      there is little to lose above 12 kHz. Decimation is a boxcar
+      average, upsampling a linear interpolation.
+    - Reads are linear, the window is a precomputed table.
+    Per full-rate sample that is ~2 linear reads and a few multiplies,
+    less than two tank lines (each a cubic read, LFO, noise and five
+    filters).
+
+  Real-time safety:
+    - prepare() allocates; process() and clear() never do.
+*/
+
+#include <array>
+#include <cstdint>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::core {
+
+    class PitchShifter {
+    public:
+        static constexpr int kVoices = 2;               // octave, fifth
+        static constexpr int kWindowSize = 256;         // sin^2 table (+1 guard point)
+        static constexpr float kWindowMs = 50.0f;       // head sweep length
+        static constexpr float kTargetRateHz = 24000.0f;
+
+        PitchShifter() = default;
+
+        void prepare(float sampleRate);
+
+        // Flush the buffer and restart the heads.
+        void clear();
+
+        // Voice gains: octave (+12 semitones) and fifth (+7 semitones).
+        void setVoiceGains(float octaveGain, float fifthGain);
+
+        // One full-rate sample in, one out (about one decimated period of latency).
+        float process(float x);
+
+        int decimation() const { return decim; }
+
+    private:
+        float sr = 48000.0f;
+        int decim = 2;
+
+        dsp::DelayLine buf{};
+        float windowSamp = 1200.0f;     // at the decimated rate
+
+        std::array<float, kWindowSize + 1> window{};
+
+        struct Voice {
+            float ratio = 2.0f;
+            float gain = 0.0f;
+            float step = 0.0f;          // phase increment per decimated sample
+            float phase = 0.0f;         // head A; head B is phase + 0.5
+        };
+        std::array<Voice, kVoices> voices{};
+
+        // Decimation / upsampling state
+        float acc = 0.0f;
+        int accCount = 0;
+        float yPrev = 0.0f;
+        float yNew = 0.0f;
+
+        float windowAt(float p) const;
+        float processDecimated(float x);
+    };
+
+} // namespace bigpi::core
@@ -0,0 +1,251 @@
+#include "dsp/singularity/SingularityEngine.h"
+
+/*
+  =============================================================================
+  SingularityEngine.cpp — Big Pi warped long-delay engine (implementation)
+  =============================================================================
+*/
+
+#include <algorithm> // std::max, std::min, std::fill
+#include <cmath>     // std::abs, std::copysign, std::exp, std::floor, std::lround, std::lrint, std::pow, std::sin
+
+namespace bigpi::core {
+
+    namespace {
+
+        // Line lengths relative to sizeSec (no common factors -> no stacked echoes)
+        constexpr float kLineRatio[SingularityEngine::kLines] = { 1.00f, 1.37f, 1.79f, 2.31f };
+
+        // Gravity orbit rates (Hz), one per line
+        constexpr float kWarpHz[SingularityEngine::kLines] = { 0.047f, 0.061f, 0.073f, 0.089f };
+
+        constexpr float kFreezeDecaySec = 600.0f;
+        constexpr float kMaxLevel = 8.0f;           // stored values are clamped here
+        constexpr float kTwoPi = 2.0f * dsp::kPi;
+
+    } // namespace
+
+    // ============================================================================
+    // Block-compressed line
+    // ============================================================================
+
+    void SingularityEngine::Line::write(float x, int ringMask) {
+        // Keep the history finite and bounded (NaN -> 0)
+        const float a = std::abs(x);
+        if (!(a <= kMaxLevel)) x = (a > kMaxLevel) ? std::copysign(kMaxLevel, x) : 0.0f;
+
+        stage[size_t(fill)] = x;
+        w = (w + 1) & ringMask;
+
+        if (++fill < kBlockLen) return;
+
+        // Block full: one scale for the block, 16-bit mantissas
+        float peak = 0.0f;
+        for (float v : stage) peak = std::max(peak, std::abs(v));
+
+        const int start = (w - kBlockLen) & ringMask;   // block aligned (ring is a multiple of kBlockLen)
+        const float inv = (peak > 0.0f) ? 32767.0f / peak : 0.0f;
+
+        for (int j = 0; j < kBlockLen; ++j) {
+            q[size_t(start + j)] = int16_t(std::lrint(stage[size_t(j)] * inv));
+        }
+        scale[size_t(start / kBlockLen)] = peak * (1.0f / 32767.0f);
+
+        fill = 0;
+    }
+
+    float SingularityEngine::Line::read(int index, int ringMask) const {
+        index &= ringMask;
+        return float(q[size_t(index)]) * scale[size_t(index / kBlockLen)];
+    }
+
+    // ============================================================================
+    // Setup
+    // ============================================================================
+
+    void SingularityEngine::prepare(float sampleRate) {
+        sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        k = makeCoeffs(k.params, sr);
+
+        // Longest line plus its warp swing, at the decimated rate
+        const int need = int(kMaxSeconds * k.decRate) + 2 * kBlockLen;
+        int len = kBlockLen;
+        while (len < need) len <<= 1;
+        mask = len - 1;
+
+        for (Line& l : lines) {
+            l.q.assign(size_t(len), 0);
+            l.scale.assign(size_t(len / kBlockLen), 0.0f);
+        }
+
+        applyCoeffs(k);
+        clear();
+    }
+
+    void SingularityEngine::clear() {
+        for (Line& l : lines) {
+            std::fill(l.q.begin(), l.q.end(), int16_t(0));
+            std::fill(l.scale.begin(), l.scale.end(), 0.0f);
+            l.stage.fill(0.0f);
+            l.fill = 0;
+            l.w = 0;
+        }
+
+        warpPhase.fill(0.0f);
+        warpCur.fill(0.0f);
+        warpStep.fill(0.0f);
+        controlCount = 0;
+
+        damp.fill(0.0f);
+
+        aaInL.clear(); aaInR.clear();
+        aaOutL.clear(); aaOutR.clear();
+        accL = 0.0f; accR = 0.0f;
+        accCount = 0;
+        prevL = 0.0f; prevR = 0.0f;
+        newL = 0.0f; newR = 0.0f;
+    }
+
+    size_t SingularityEngine::historyBytes() const {
+        size_t bytes = 0;
+        for (const Line& l : lines) {
+            bytes += l.q.size() * sizeof(int16_t) + l.scale.size() * sizeof(float);
+        }
+        return bytes;
+    }
+
+    SingularityEngine::Coeffs SingularityEngine::makeCoeffs(const Params& p, float sampleRate) {
+        const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        Coeffs c;
+        c.params = p;
+
+        // 44.1/48 kHz -> 4, 88.2 kHz -> 7, 96 kHz -> 8, 192 kHz -> 16
+        c.decim = std::max(1, int(std::lround(sr / kTargetRateHz)));
+        c.decRate = sr / float(c.decim);
+
+        c.params.sizeSec = dsp::clampf(p.sizeSec, 0.2f, 3.0f);
+        c.params.decaySec = dsp::clampf(p.decaySec, 1.0f, 60.0f);
+        c.params.dampHz = dsp::clampf(p.dampHz, 500.0f, 0.45f * c.decRate);
+        c.params.gravity = dsp::clampf(p.gravity, 0.0f, 1.0f);
+
+        const Params& q = c.params;
+
+        for (int l = 0; l < kLines; ++l) {
+            const float sec = q.sizeSec * kLineRatio[l];
+            c.delay[size_t(l)] = sec * c.decRate;
+
+            // Offset A sin(2 pi f t) changes the read speed by up to A 2 pi f
+            const float amp = q.gravity * kMaxBend / (kTwoPi * kWarpHz[l]) * c.decRate;
+            c.warpAmp[size_t(l)] = std::min(amp, 0.25f * c.delay[size_t(l)]);
+            c.warpInc[size_t(l)] = kTwoPi * kWarpHz[l] * float(kControlTicks) / c.decRate;
+
+            c.gain[size_t(l)] = std::pow(10.0f, -3.0f * sec / q.decaySec);
+            c.gainFrozen[size_t(l)] = std::pow(10.0f, -3.0f * sec / kFreezeDecaySec);
+        }
+
+        c.lpA = std::exp(-kTwoPi * q.dampHz / c.decRate);
+        c.aa.setLowPass(0.4f * c.decRate, 0.707f, sr);
+
+        return c;
+    }
+
+    void SingularityEngine::applyCoeffs(const Coeffs& c) {
+        // The rings are sized for one decimation factor (prepare())
+        const int decim = k.decim;
+        k = c;
+        k.decim = decim;
+        k.decRate = sr / float(decim);
+
+        aaInL.copyCoeffs(c.aa); aaInR.copyCoeffs(c.aa);
+        aaOutL.copyCoeffs(c.aa); aaOutR.copyCoeffs(c.aa);
+    }
+
+    // ============================================================================
+    // Processing
+    // ============================================================================
+
+    void SingularityEngine::updateWarp() {
+        for (int l = 0; l < kLines; ++l) {
+            float ph = warpPhase[size_t(l)] + k.warpInc[size_t(l)];
+            if (ph >= kTwoPi) ph -= kTwoPi;
+            warpPhase[size_t(l)] = ph;
+
+            const float target = k.warpAmp[size_t(l)] * std::sin(ph);
+            warpStep[size_t(l)] = (target - warpCur[size_t(l)]) * (1.0f / float(kControlTicks));
+        }
+    }
+
+    void SingularityEngine::tick(float xL, float xR, bool frozen) {
+        if (controlCount == 0) updateWarp();
+        if (++controlCount >= kControlTicks) controlCount = 0;
+
+        std::array<float, kLines> y{};
+
+        for (int l = 0; l < kLines; ++l) {
+            Line& line = lines[size_t(l)];
+
+            warpCur[size_t(l)] += warpStep[size_t(l)];
+
+            // Delay = nominal + warp; the integer part is split off so the
+            // fraction stays precise on multi-second lines
+            const float nominal = k.delay[size_t(l)];
+            const int baseInt = int(nominal);
+            const float d = (nominal - float(baseInt)) + warpCur[size_t(l)];
+            const float dFloor = std::floor(d);
+            const float fr = d - dFloor;
+
+            // Delay 1 is the newest sample (index w - 1)
+            const int i1 = line.w - baseInt - int(dFloor);
+            const float a = line.read(i1, mask);
+            const float b = line.read(i1 - 1, mask);
+            const float v = a + fr * (b - a);
+
+            damp[size_t(l)] = dsp::killDenorm(k.lpA * damp[size_t(l)] + (1.0f - k.lpA) * v);
+            y[size_t(l)] = damp[size_t(l)];
+        }
+
+        // Householder 4x4: f = y - (2/N) sum(y)
+        const float s = 0.5f * ((y[0] + y[1]) + (y[2] + y[3]));
+
+        const float inL = frozen ? 0.0f : 0.5f * xL;
+        const float inR = frozen ? 0.0f : 0.5f * xR;
+        const float in[kLines] = { inL, inR, inL, inR };
+        const std::array<float, kLines>& g = frozen ? k.gainFrozen : k.gain;
+
+        for (int l = 0; l < kLines; ++l) {
+            lines[size_t(l)].write(in[l] + g[size_t(l)] * (y[size_t(l)] - s), mask);
+        }
+
+        newL = 0.5f * (y[0] + y[2]);
+        newR = 0.5f * (y[1] + y[3]);
+    }
+
+    void SingularityEngine::processBlock(const float* inL, const float* inR, float* outL, float* outR, int n, bool frozen) {
+        if (lines[0].q.empty()) return;
+
+        const int decim = k.decim;
+        const float invDecim = 1.0f / float(decim);
+
+        for (int i = 0; i < n; ++i) {
+            accL += aaInL.process(inL[i]);
+            accR += aaInR.process(inR[i]);
+
+            if (++accCount >= decim) {
+                prevL = newL;
+                prevR = newR;
+                tick(accL * invDecim, accR * invDecim, frozen);
+                accL = 0.0f;
+                accR = 0.0f;
+                accCount = 0;
+            }
+
+            // Linear interpolation from the previous to the newest decimated output
+            const float t = float(accCount + 1) * invDecim;
+            outL[i] = aaOutL.process(prevL + t * (newL - prevL));
+            outR[i] = aaOutR.process(prevR + t * (newR - prevR));
+        }
+    }
+
+} // namespace bigpi::core
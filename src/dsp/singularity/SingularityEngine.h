@@ -0,0 +1,133 @@
+#pragma once
+/*
+  =============================================================================
+  SingularityEngine.h — Big Pi warped long-delay engine (Singularity mode)
+  =============================================================================
+
+  RoadMap Phase 8: long delay scaling, gravity control, time bending.
+
+  What it adds:
+    A second, much larger feedback network next to the tank: four lines of
+    up to kMaxSeconds each, mixed by a 4x4 Householder matrix. "Gravity"
+    slowly bends the read heads back and forth (time bending): the tail
+    drifts in pitch and stretches, like light around a black hole.
+
+  Why it is cheap in memory:
+    Multi-second lines at full rate in float (dsp::DelayLine) cost
+    4 lines x 8 s x 192 kHz x 4 bytes = 24.6 MB. Here:
+      - The network runs decimated at ~12 kHz (sr / decim). Its feedback
+        band is damped to a few kHz anyway, so nothing audible is lost.
+      - History is stored block-compressed: blocks of kBlockLen samples
+        share one float scale (block peak / 32767) and keep 16-bit
+        mantissas (~90 dB below each block's own peak).
+    Result: about 2.1 bytes per stored sample at ~12 kHz, ~1.1 MB in total
+    at any sample rate.
+
+  Processing:
+    - Full rate: anti-alias low-pass, boxcar decimation (as PitchShifter),
+      linear upsampling and the same low-pass against images.
+    - Decimated rate: line reads (linear), loop damping, Householder mix,
+      write-back.
+    - Control rate (every kControlTicks decimated samples): the gravity
+      warp computes each line's next read delay; per sample the delay
+      only ramps linearly towards it.
+
+  Coefficients follow the OutputStage pattern: makeCoeffs() is pure and
+  may run on any thread; applyCoeffs() only copies.
+
+  REAL-TIME RULE: prepare() allocates; everything else is audio-thread safe.
+*/
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::core {
+
+    class SingularityEngine {
+    public:
+        static constexpr int kLines = 4;
+        static constexpr int kBlockLen = 32;            // samples per compressed block
+        static constexpr int kControlTicks = 16;        // decimated samples per warp update
+        static constexpr float kTargetRateHz = 12000.0f;
+        static constexpr float kMaxSeconds = 8.0f;      // longest line incl. warp
+        static constexpr float kMaxBend = 0.03f;        // read speed deviation at gravity 1 (~50 cents)
+
+        struct Params {
+            float sizeSec = 1.6f;       // shortest line; the others are longer (x1.37, x1.79, x2.31)
+            float decaySec = 14.0f;     // RT60 of the network
+            float dampHz = 3200.0f;     // loop low-pass
+            float gravity = 0.5f;       // time bending depth (0..1)
+        };
+
+        struct Coeffs {
+            Params params{};
+
+            int decim = 4;
+            float decRate = 12000.0f;
+
+            std::array<float, kLines> delay{};          // nominal, decimated samples
+            std::array<float, kLines> warpAmp{};        // read delay swing, decimated samples
+            std::array<float, kLines> warpInc{};        // warp phase step per control tick
+            std::array<float, kLines> gain{};           // feedback for decaySec
+            std::array<float, kLines> gainFrozen{};     // feedback while frozen
+
+            float lpA = 0.0f;                           // loop damping (decimated rate)
+            dsp::Biquad aa{};                           // anti-alias / anti-image (full rate)
+        };
+
+        void prepare(float sampleRate);
+        void clear();
+
+        static Coeffs makeCoeffs(const Params& p, float sampleRate);
+        void applyCoeffs(const Coeffs& c);
+
+        // Stereo in, stereo out (network output only). While frozen the
+        // input is ignored and the network holds its content.
+        void processBlock(const float* inL, const float* inR, float* outL, float* outR, int n, bool frozen);
+
+        // Bytes held by the compressed history (for stats / tests).
+        size_t historyBytes() const;
+
+    private:
+        // Block-compressed ring: 16-bit mantissas, one float scale per block.
+        // The newest, still open block lives in `stage` until it is full.
+        struct Line {
+            std::vector<int16_t> q{};
+            std::vector<float> scale{};
+            std::array<float, kBlockLen> stage{};
+            int fill = 0;
+            int w = 0;          // absolute write index (masked)
+
+            void write(float x, int mask);
+            float read(int index, int mask) const;
+        };
+
+        float sr = 48000.0f;
+        Coeffs k{};
+
+        std::array<Line, kLines> lines{};
+        int mask = 0;
+
+        // Gravity warp: delay offset ramp per line
+        std::array<float, kLines> warpPhase{};
+        std::array<float, kLines> warpCur{};
+        std::array<float, kLines> warpStep{};
+        int controlCount = 0;
+
+        std::array<float, kLines> damp{};
+
+        // Decimation / upsampling (PitchShifter pattern)
+        dsp::Biquad aaInL{}, aaInR{}, aaOutL{}, aaOutR{};
+        float accL = 0.0f, accR = 0.0f;
+        int accCount = 0;
+        float prevL = 0.0f, prevR = 0.0f;
+        float newL = 0.0f, newR = 0.0f;
+
+        void updateWarp();
+        void tick(float xL, float xR, bool frozen);
+    };
+
+} // namespace bigpi::core
@@ -0,0 +1,229 @@
+#include "dsp/spring/SpringModel.h"
+
+/*
+  =============================================================================
+  SpringModel.cpp — Big Pi dispersive spring model (implementation)
+  =============================================================================
+*/
+
+#include <algorithm> // std::max, std::min, std::fill
+#include <cmath>     // std::exp, std::lround
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BIGPI_SPRING_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BIGPI_SPRING_NEON 1
+#endif
+
+namespace bigpi::core {
+
+    namespace {
+
+        // Per-spring spread: lengths and dispersion differ a little so the
+        // four springs do not chirp in unison.
+        constexpr float kLaneLength[SpringModel::kLanes] = { 1.00f, 0.89f, 1.12f, 0.95f };
+        constexpr float kLaneDispersion[SpringModel::kLanes] = { 1.00f, 0.96f, 1.03f, 0.98f };
+
+        constexpr float kLoopHpHz = 90.0f;          // transducer low cut
+        constexpr float kBandQ = 1.0f;
+        constexpr float kEmphasisGain = 1.5f;       // emphasis 1 -> about +8 dB at toneHz
+        constexpr float kDenormThreshold = 1e-20f;  // same as dsp::killDenorm()
+
+        // --------------------------------------------------------------------
+        // Four-lane vector helpers (one lane per spring)
+        // --------------------------------------------------------------------
+#if BIGPI_SPRING_SSE2
+        using Vec = __m128;
+        inline Vec vLoad(const float* p) { return _mm_load_ps(p); }
+        inline void vStore(float* p, Vec v) { _mm_store_ps(p, v); }
+        inline void vStoreU(float* p, Vec v) { _mm_storeu_ps(p, v); }
+        inline Vec vSet1(float x) { return _mm_set1_ps(x); }
+        inline Vec vSet(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+        inline Vec vAdd(Vec a, Vec b) { return _mm_add_ps(a, b); }
+        inline Vec vSub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+        inline Vec vMul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+        inline Vec vKillDenorm(Vec v) {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            return _mm_and_ps(v, _mm_cmpge_ps(_mm_and_ps(v, absMask), _mm_set1_ps(kDenormThreshold)));
+        }
+#elif BIGPI_SPRING_NEON
+        using Vec = float32x4_t;
+        inline Vec vLoad(const float* p) { return vld1q_f32(p); }
+        inline void vStore(float* p, Vec v) { vst1q_f32(p, v); }
+        inline void vStoreU(float* p, Vec v) { vst1q_f32(p, v); }
+        inline Vec vSet1(float x) { return vdupq_n_f32(x); }
+        inline Vec vSet(float a, float b, float c, float d) {
+            const float t[4] = { a, b, c, d };
+            return vld1q_f32(t);
+        }
+        inline Vec vAdd(Vec a, Vec b) { return vaddq_f32(a, b); }
+        inline Vec vSub(Vec a, Vec b) { return vsubq_f32(a, b); }
+        inline Vec vMul(Vec a, Vec b) { return vmulq_f32(a, b); }
+        inline Vec vKillDenorm(Vec v) {
+            const uint32x4_t keep = vcgeq_f32(vabsq_f32(v), vdupq_n_f32(kDenormThreshold));
+            return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), keep));
+        }
+#else
+        struct Vec { float v[4]; };
+        inline Vec vLoad(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+        inline void vStore(float* p, Vec a) { for (int l = 0; l < 4; ++l) p[l] = a.v[l]; }
+        inline void vStoreU(float* p, Vec a) { vStore(p, a); }
+        inline Vec vSet1(float x) { return { { x, x, x, x } }; }
+        inline Vec vSet(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+        inline Vec vAdd(Vec a, Vec b) { for (int l = 0; l < 4; ++l) a.v[l] += b.v[l]; return a; }
+        inline Vec vSub(Vec a, Vec b) { for (int l = 0; l < 4; ++l) a.v[l] -= b.v[l]; return a; }
+        inline Vec vMul(Vec a, Vec b) { for (int l = 0; l < 4; ++l) a.v[l] *= b.v[l]; return a; }
+        inline Vec vKillDenorm(Vec a) { for (int l = 0; l < 4; ++l) a.v[l] = dsp::killDenorm(a.v[l]); return a; }
+#endif
+
+        int loopSamples(float ms, float sr) {
+            return std::max(1, int(std::lround(ms * 0.001f * sr)));
+        }
+
+    } // namespace
+
+    void SpringModel::prepare(float sampleRate) {
+        sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        // Power-of-two ring for the longest spring at kMaxLengthMs
+        const int need = loopSamples(kMaxLengthMs * kLaneLength[2], sr) + 4;
+        int len = 1;
+        while (len < need) len <<= 1;
+
+        loop.assign(size_t(len) * kLanes, 0.0f);
+        loopMask = len - 1;
+
+        applyCoeffs(makeCoeffs(k.params, sr));
+        clear();
+    }
+
+    void SpringModel::clear() {
+        for (auto& stage : apState)
+            for (auto& s : stage)
+                for (float& v : s) v = 0.0f;
+        slot = 0;
+
+        for (int l = 0; l < kLanes; ++l) {
+            lpState[l] = 0.0f;
+            hpState[l] = 0.0f;
+        }
+
+        std::fill(loop.begin(), loop.end(), 0.0f);
+        loopPos = 0;
+
+        bandL.clear();
+        bandR.clear();
+    }
+
+    SpringModel::Coeffs SpringModel::makeCoeffs(const Params& p, float sampleRate) {
+        const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        Coeffs c;
+        c.params = p;
+        c.params.lengthMs = dsp::clampf(p.lengthMs, 15.0f, kMaxLengthMs);
+        c.params.dispersion = dsp::clampf(p.dispersion, 0.0f, 1.0f);
+        c.params.drip = dsp::clampf(p.drip, 0.0f, 1.0f);
+        c.params.dampHz = dsp::clampf(p.dampHz, 1000.0f, 12000.0f);
+        c.params.toneHz = dsp::clampf(p.toneHz, 300.0f, 6000.0f);
+        c.params.emphasis = dsp::clampf(p.emphasis, 0.0f, 1.0f);
+
+        const Params& q = c.params;
+
+        // z^-M stretch keeps the chirp in the same audible band at any rate
+        c.stretch = std::max(1, std::min(kMaxStretch, int(std::lround(sr / 48000.0f))));
+
+        for (int l = 0; l < kLanes; ++l) {
+            c.loopDelay[size_t(l)] = loopSamples(q.lengthMs * kLaneLength[l], sr);
+            c.apCoef[size_t(l)] = dsp::clampf((0.30f + 0.45f * q.dispersion) * kLaneDispersion[l], 0.0f, 0.85f);
+        }
+
+        // Allpasses have unity gain and the loop filters are <= 1, so 0.85 is safe
+        c.feedback = 0.25f + 0.60f * q.drip;
+
+        c.lpA = std::exp(-2.0f * dsp::kPi * q.dampHz / sr);
+        c.hpA = std::exp(-2.0f * dsp::kPi * kLoopHpHz / sr);
+
+        c.band.setBandPass(q.toneHz, kBandQ, sr);
+
+        return c;
+    }
+
+    void SpringModel::applyCoeffs(const Coeffs& c) {
+        // A different stretch reinterprets the stage states: start clean
+        if (c.stretch != k.stretch) {
+            for (auto& stage : apState)
+                for (auto& s : stage)
+                    for (float& v : s) v = 0.0f;
+            slot = 0;
+        }
+
+        k = c;
+        bandL.copyCoeffs(c.band);
+        bandR.copyCoeffs(c.band);
+    }
+
+    void SpringModel::processBlock(const float* inL, const float* inR, float* outL, float* outR, int n) {
+        if (loop.empty()) return;
+
+        const Vec a = vLoad(k.apCoef.data());
+        const Vec fb = vSet1(k.feedback);
+        const Vec lpA = vSet1(k.lpA);
+        const Vec lpB = vSet1(1.0f - k.lpA);
+        const Vec hpA = vSet1(k.hpA);
+        const Vec hpB = vSet1(1.0f - k.hpA);
+
+        Vec lp = vLoad(lpState);
+        Vec hp = vLoad(hpState);
+
+        const int stretch = k.stretch;
+        const int d0 = k.loopDelay[0], d1 = k.loopDelay[1], d2 = k.loopDelay[2], d3 = k.loopDelay[3];
+        const float emph = kEmphasisGain * k.params.emphasis;
+
+        float* ring = loop.data();
+        alignas(16) float o[kLanes];
+
+        for (int i = 0; i < n; ++i) {
+            // Loop delay read (one index per spring)
+            const Vec back = vSet(
+                ring[((loopPos - d0) & loopMask) * kLanes + 0],
+                ring[((loopPos - d1) & loopMask) * kLanes + 1],
+                ring[((loopPos - d2) & loopMask) * kLanes + 2],
+                ring[((loopPos - d3) & loopMask) * kLanes + 3]);
+
+            Vec x = vAdd(vSet(inL[i], inL[i], inR[i], inR[i]), vMul(fb, back));
+
+            // Dispersion: y = a*x + v[n-M], v[n] = x - a*y, all springs at once.
+            // The states are flushed like every recursive filter state: once
+            // the input stops they decay through the subnormal range.
+            for (int s = 0; s < kStages; ++s) {
+                float* st = apState[s][slot];
+                const Vec y = vAdd(vMul(a, x), vLoad(st));
+                vStore(st, vKillDenorm(vSub(x, vMul(a, y))));
+                x = y;
+            }
+
+            // Loop band limits
+            lp = vKillDenorm(vAdd(vMul(lpA, lp), vMul(lpB, x)));
+            hp = vKillDenorm(vAdd(vMul(hpA, hp), vMul(hpB, lp)));
+            const Vec y = vSub(lp, hp);
+
+            vStoreU(ring + size_t(loopPos) * kLanes, y);
+            loopPos = (loopPos + 1) & loopMask;
+            if (++slot >= stretch) slot = 0;
+
+            // Two springs per side, then the mid-range hump
+            vStore(o, y);
+            const float sL = 0.5f * (o[0] + o[1]);
+            const float sR = 0.5f * (o[2] + o[3]);
+
+            outL[i] = sL + emph * bandL.process(sL);
+            outR[i] = sR + emph * bandR.process(sR);
+        }
+
+        vStore(lpState, lp);
+        vStore(hpState, hp);
+    }
+
+} // namespace bigpi::core
@@ -0,0 +1,108 @@
+#pragma once
+/*
+  =============================================================================
+  SpringModel.h — Big Pi dispersive spring model (Spring mode)
+  =============================================================================
+
+  RoadMap Phase 3: series allpass chain, bandpass emphasis, subtle
+  dispersion, drip control, optional tank tail blend.
+
+  What a spring does:
+    A spring tank is a dispersive delay: high frequencies travel down the
+    spring more slowly than low ones, so every echo arrives as a rising
+    "chirp" instead of a click. The echo bounces back and forth between
+    the transducers, chirping again each trip (the "drip").
+
+  Model (per spring):
+
+      in --(+)--> [allpass cascade] --> [loop LP / HP] --+--> out
+           ^                                              |
+           +--- feedback ("drip") <--- [loop delay] <-----+
+
+    - Dispersion: kStages first-order allpasses
+          H(z) = (a + z^-M) / (1 + a z^-M)
+      Each stage delays high frequencies more than low ones; 80 of them
+      spread a click over several milliseconds. M ("stretch") is
+      round(sr / 48 kHz), so 96 / 192 kHz give the same chirp in the
+      audible band as 48 kHz.
+    - Loop LP (spring bandwidth, ~4.5 kHz) and HP (transducer low cut).
+    - Bandpass emphasis on the output: the mid-range hump of a real tank.
+
+  Performance layout:
+    A long allpass cascade is one long dependency chain, too slow as 80
+    scalar dsp::Allpass calls per spring. Here kLanes = 4 springs (two per
+    side, different lengths) run side by side in one SIMD register:
+    every stage is one multiply-add pair for all four springs, and the
+    stage states are stored lane-interleaved (apState[stage][slot][lane])
+    so each stage is one aligned load / store. SSE2 and NEON, scalar
+    fallback elsewhere.
+
+  Coefficients follow the OutputStage pattern: makeCoeffs() is pure and
+  may run on any thread; applyCoeffs() only copies.
+
+  REAL-TIME RULE: prepare() allocates; everything else is audio-thread safe.
+*/
+
+#include <array>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::core {
+
+    class SpringModel {
+    public:
+        static constexpr int kLanes = 4;                // springs: 0, 1 -> left, 2, 3 -> right
+        static constexpr int kStages = 80;              // allpass stages per spring
+        static constexpr int kMaxStretch = 4;           // 192 kHz
+        static constexpr float kMaxLengthMs = 80.0f;
+
+        struct Params {
+            float lengthMs = 38.0f;     // round trip of the springs (echo spacing)
+            float dispersion = 0.60f;   // chirp spread (0..1)
+            float drip = 0.55f;         // loop feedback: how long the chirps repeat (0..1)
+            float dampHz = 4500.0f;     // spring bandwidth (loop low-pass)
+            float toneHz = 2200.0f;     // emphasis band centre
+            float emphasis = 0.50f;     // 0 = flat, 1 = strong mid hump
+        };
+
+        struct Coeffs {
+            Params params{};
+            int stretch = 1;
+            std::array<int, kLanes> loopDelay{};
+            alignas(16) std::array<float, kLanes> apCoef{};
+            float feedback = 0.0f;
+            float lpA = 0.0f;
+            float hpA = 0.0f;
+            dsp::Biquad band{};
+        };
+
+        void prepare(float sampleRate);
+        void clear();
+
+        static Coeffs makeCoeffs(const Params& p, float sampleRate);
+        void applyCoeffs(const Coeffs& c);
+
+        // Stereo in, stereo out (the wet spring signal only).
+        void processBlock(const float* inL, const float* inR, float* outL, float* outR, int n);
+
+    private:
+        float sr = 48000.0f;
+        Coeffs k{};
+
+        // Allpass states: [stage][stretch slot][lane]
+        alignas(16) float apState[kStages][kMaxStretch][kLanes] = {};
+        int slot = 0;
+
+        alignas(16) float lpState[kLanes] = {};
+        alignas(16) float hpState[kLanes] = {};
+
+        // Loop delay, lane-interleaved: loop[pos * kLanes + lane]
+        std::vector<float> loop{};
+        int loopMask = 0;
+        int loopPos = 0;
+
+        dsp::Biquad bandL{}, bandR{};
+    };
+
+} // namespace bigpi::core
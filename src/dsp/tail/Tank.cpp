@@ -57,6 +57,7 @@ namespace bigpi::core {
         envFollower.clear();
         env01 = 0.0f;
 
+        shimmer.prepare(sr);
 
         // Kappa+Cloud Mod (Level 2): deterministic phase offsets for "spin"
         // We generate a shuffled set of offsets in [0, 2π).
@@ -105,11 +106,34 @@ namespace bigpi::core {
         envFollower.clear();
         env01 = 0.0f;
 
+        shimmer.clear();
+
         dynDampHzCurrent = cfg.dampHz;
         cloudPhase = 0.0f;
     }
 
+    void Tank::clearLinesFrom(int first) {
+        for (int i = std::max(0, first); i < kMaxLines; ++i) {
+            d[i].clear();
+
+            hp[i].clear();
+            lp[i].clear();
+            xLo[i].clear();
+            xHi[i].clear();
+
+            lastY[i] = 0.0f;
+        }
+    }
+
     void Tank::setConfig(const Config& c) {
+        applyCoeffs(makeCoeffs(c, sr));
+    }
+
+    Tank::Coeffs Tank::makeCoeffs(const Config& c, float sampleRate, float decay01) {
+        const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        Coeffs k;
+        Config& cfg = k.cfg;
         cfg = c;
 
         cfg.lines = std::max(1, std::min(cfg.lines, kMaxLines));
@@ -149,26 +173,117 @@ namespace bigpi::core {
         cfg.dynAtkMs = dsp::clampf(cfg.dynAtkMs, 0.1f, 2000.0f);
         cfg.dynRelMs = dsp::clampf(cfg.dynRelMs, 0.1f, 5000.0f);
 
+        cfg.shimmerAmount = dsp::clampf(cfg.shimmerAmount, 0.0f, 1.0f);
+        cfg.shimmerFifthMix = dsp::clampf(cfg.shimmerFifthMix, 0.0f, 1.0f);
+
+        // Filter coefficients: the same cutoff on every line, so compute once
+        // (through the real filter setters, so the numbers are identical).
+        dsp::OnePoleHP hpT;
+        dsp::OnePoleLP lpT, xLoT, xHiT;
+        hpT.setCutoff(cfg.fbHpHz, sr);
+        lpT.setCutoff(cfg.dampHz, sr);
+        xLoT.setCutoff(cfg.xoverLoHz, sr);
+        xHiT.setCutoff(cfg.xoverHiHz, sr);
+        k.hpA = hpT.a;
+        k.lpA = lpT.a;
+        k.xLoA = xLoT.a;
+        k.xHiA = xHiT.a;
+
+        dsp::SmoothNoise jitT, cloudT;
+        jitT.setSampleRate(sr);
+        jitT.setRateHz(cfg.jitterRateHz);
+        jitT.setSmoothMs(cfg.jitterSmoothMs);
+        k.jitterRateHz = jitT.rateHz;
+        k.jitterPeriod = jitT.samplesToNext;
+        k.jitterA = jitT.a;
+
+        cloudT.setSampleRate(sr);
+        cloudT.setRateHz(cfg.cloudWanderRateHz);
+        cloudT.setSmoothMs(cfg.cloudWanderSmoothMs);
+        k.cloudRateHz = cloudT.rateHz;
+        k.cloudPeriod = cloudT.samplesToNext;
+        k.cloudA = cloudT.a;
+
+        dsp::EnvelopeFollower envT;
+        envT.setSampleRate(sr);
+        envT.setAttackReleaseMs(cfg.dynAtkMs, cfg.dynRelMs);
+        k.envAtk = envT.aAtk;
+        k.envRel = envT.aRel;
+
+        if (decay01 >= 0.0f) {
+            k.decay01 = decay01;
+            computeDecayGains(cfg, sr, decay01, kMaxLines, k.fbGainLow, k.fbGainMid, k.fbGainHigh);
+        }
+        return k;
+    }
+
+    void Tank::applyCoeffs(const Coeffs& k, int linesCap) {
+        const bool shimmerWasOn = cfg.shimmerAmount > 0.0f;
+
+        cfg = k.cfg;
+        cfg.lines = std::max(1, std::min(cfg.lines, linesCap));
+
         // Update filters once per config change (cheap, safe)
         for (int i = 0; i < cfg.lines; ++i) {
-            hp[i].setCutoff(cfg.fbHpHz, sr);
-            lp[i].setCutoff(cfg.dampHz, sr);
+            hp[i].a = k.hpA;
+            lp[i].a = k.lpA;
 
-            xLo[i].setCutoff(cfg.xoverLoHz, sr);
-            xHi[i].setCutoff(cfg.xoverHiHz, sr);
+            xLo[i].a = k.xLoA;
+            xHi[i].a = k.xHiA;
 
-            jitter[i].setRateHz(cfg.jitterRateHz);
-            jitter[i].setSmoothMs(cfg.jitterSmoothMs);
+            jitter[i].rateHz = k.jitterRateHz;
+            jitter[i].samplesToNext = k.jitterPeriod;
+            jitter[i].a = k.jitterA;
 
-            cloudNoise[i].setRateHz(cfg.cloudWanderRateHz);
-            cloudNoise[i].setSmoothMs(cfg.cloudWanderSmoothMs);
+            cloudNoise[i].rateHz = k.cloudRateHz;
+            cloudNoise[i].samplesToNext = k.cloudPeriod;
+            cloudNoise[i].a = k.cloudA;
         }
 
-        envFollower.setAttackReleaseMs(cfg.dynAtkMs, cfg.dynRelMs);
+        envFollower.aAtk = k.envAtk;
+        envFollower.aRel = k.envRel;
+
+        // The pitch buffer is not fed while shimmer is off: do not replay stale audio
+        if (cfg.shimmerAmount > 0.0f && !shimmerWasOn) shimmer.clear();
+        shimmer.setVoiceGains(1.0f - cfg.shimmerFifthMix, cfg.shimmerFifthMix);
 
         dynDampHzCurrent = cfg.dampHz;
 
-        lastDecay01 = -1.0f;
+        if (k.decay01 >= 0.0f) {
+            fbGainLow = k.fbGainLow;
+            fbGainMid = k.fbGainMid;
+            fbGainHigh = k.fbGainHigh;
+            lastDecay01 = k.decay01;
+        }
+        else {
+            lastDecay01 = -1.0f;
+        }
+    }
+
+    /*
+      applyShimmer(fb, N)
+      -------------------
+      The shimmer lines (0, 4, 8, 12 below N) share one pitch shifter: their
+      mean feedback goes in, and each of them then feeds back
+          (1 - amount) * own feedback + amount * shifted
+      A convex mix of two signals that have both already passed the decay
+      gains, so the loop gain stays below 1 and decay still applies to the
+      shifted part on every trip.
+    */
+    void Tank::applyShimmer(std::array<float, kMaxLines>& fb, int N) {
+        float sum = 0.0f;
+        int count = 0;
+        for (int i = 0; i < N; i += kShimmerLineStride) {
+            sum += fb[i];
+            ++count;
+        }
+
+        const float shifted = shimmer.process(sum / float(count));
+        const float a = cfg.shimmerAmount;
+
+        for (int i = 0; i < N; i += kShimmerLineStride) {
+            fb[i] = (1.0f - a) * fb[i] + a * shifted;
+        }
     }
 
     float Tank::computeDynamicDampingHz(float staticDampHz, float env01Now) {
@@ -186,24 +301,32 @@ namespace bigpi::core {
         if (decay01 == lastDecay01) return;
         lastDecay01 = decay01;
 
+        computeDecayGains(cfg, sr, decay01, cfg.lines, fbGainLow, fbGainMid, fbGainHigh);
+    }
+
+    void Tank::computeDecayGains(const Config& c, float sampleRate, float decay01, int lines,
+        std::array<float, kMaxLines>& low,
+        std::array<float, kMaxLines>& mid,
+        std::array<float, kMaxLines>& high)
+    {
         const float rt60Base = decay01ToRt60Sec(decay01);
 
-        const float rt60Low = rt60Base * std::max(0.10f, cfg.decayLowMul);
-        const float rt60Mid = rt60Base * std::max(0.10f, cfg.decayMidMul);
-        const float rt60High = rt60Base * std::max(0.10f, cfg.decayHighMul);
+        const float rt60Low = rt60Base * std::max(0.10f, c.decayLowMul);
+        const float rt60Mid = rt60Base * std::max(0.10f, c.decayMidMul);
+        const float rt60High = rt60Base * std::max(0.10f, c.decayHighMul);
 
-        const int N = std::max(1, std::min(cfg.lines, kMaxLines));
+        const int N = std::max(1, std::min(lines, kMaxLines));
 
         for (int i = 0; i < N; ++i) {
-            const float delaySec = std::max(1.0f, cfg.delaySamp[i]) / sr;
+            const float delaySec = std::max(1.0f, c.delaySamp[i]) / sampleRate;
 
-            fbGainLow[i] = rt60ToFeedbackGain(delaySec, rt60Low);
-            fbGainMid[i] = rt60ToFeedbackGain(delaySec, rt60Mid);
-            fbGainHigh[i] = rt60ToFeedbackGain(delaySec, rt60High);
+            low[i] = rt60ToFeedbackGain(delaySec, rt60Low);
+            mid[i] = rt60ToFeedbackGain(delaySec, rt60Mid);
+            high[i] = rt60ToFeedbackGain(delaySec, rt60High);
 
-            fbGainLow[i] = dsp::clampf(fbGainLow[i], 0.0f, 0.9997f);
-            fbGainMid[i] = dsp::clampf(fbGainMid[i], 0.0f, 0.9997f);
-            fbGainHigh[i] = dsp::clampf(fbGainHigh[i], 0.0f, 0.9997f);
+            low[i] = dsp::clampf(low[i], 0.0f, 0.9997f);
+            mid[i] = dsp::clampf(mid[i], 0.0f, 0.9997f);
+            high[i] = dsp::clampf(high[i], 0.0f, 0.9997f);
         }
     }
 
@@ -247,24 +370,24 @@ namespace bigpi::core {
             }
 
             float jit = 0.0f;
-            if (cfg.jitterEnable > 0.0001f) {
+            if (cfg.jitterEnable > 0.0001f && costModScale > 0.0f) {
                 jit = jitter[i].process();
             }
 
             float wander = 0.0f;
-            if (cfg.cloudEnable > 0.0001f) {
+            if (cfg.cloudEnable > 0.0001f && costModScale > 0.0f) {
                 wander = cfg.cloudWanderAmount * cloudNoise[i].process();
             }
 
             float mod = cfg.modDepthSamples
-                * (lfo * depthMul + cfg.jitterEnable * cfg.jitterAmount * jit + wander * depthMul);
+                * (lfo * depthMul + cfg.jitterEnable * cfg.jitterAmount * costModScale * jit + wander * costModScale * depthMul);
 
             float delay = cfg.delaySamp[i] + mod;
 
             // Avoid reading at ~0 delay (read head ≈ write head).
             delay = std::max(1.0f, delay);
 
-            float yi = d[i].readFracCubic(delay);
+            float yi = costLinearReads ? d[i].readFracLinear(delay) : d[i].readFracCubic(delay);
 
             y[i] = yi;
             yOut[i] = yi;
@@ -293,6 +416,8 @@ namespace bigpi::core {
 
         updateDecayGains(baseDecay);
 
+        std::array<float, kMaxLines> fbLine{};
+
         const float injPerLine = inj / float(N);
         for (int i = 0; i < N; ++i) {
             float fb = y[i];
@@ -313,8 +438,13 @@ namespace bigpi::core {
 
             float sat = dsp::softSat(fbColored, cfg.drive);
             float fbFinal = (1.0f - cfg.satMix) * fbColored + cfg.satMix * sat;
+            fbLine[i] = fbFinal;
+        }
+
+        if (cfg.shimmerAmount > 0.0f) applyShimmer(fbLine, N);
 
-            d[i].push(injPerLine + fbFinal);
+        for (int i = 0; i < N; ++i) {
+            d[i].push(injPerLine + fbLine[i]);
         }
     }
 
@@ -363,24 +493,24 @@ namespace bigpi::core {
             }
 
             float jit = 0.0f;
-            if (cfg.jitterEnable > 0.0001f) {
+            if (cfg.jitterEnable > 0.0001f && costModScale > 0.0f) {
                 jit = jitter[i].process();
             }
 
             float wander = 0.0f;
-            if (cfg.cloudEnable > 0.0001f) {
+            if (cfg.cloudEnable > 0.0001f && costModScale > 0.0f) {
                 wander = cfg.cloudWanderAmount * cloudNoise[i].process();
             }
 
             float mod = cfg.modDepthSamples
-                * (lfo * depthMul + cfg.jitterEnable * cfg.jitterAmount * jit + wander * depthMul);
+                * (lfo * depthMul + cfg.jitterEnable * cfg.jitterAmount * costModScale * jit + wander * costModScale * depthMul);
 
             float delay = cfg.delaySamp[i] + mod;
 
             // Avoid reading at ~0 delay (read head ≈ write head).
             delay = std::max(1.0f, delay);
 
-            float yi = d[i].readFracCubic(delay);
+            float yi = costLinearReads ? d[i].readFracLinear(delay) : d[i].readFracCubic(delay);
 
             y[i] = yi;
             yOut[i] = yi;
@@ -409,6 +539,8 @@ namespace bigpi::core {
 
         updateDecayGains(baseDecay);
 
+        std::array<float, kMaxLines> fbLine{};
+
         for (int i = 0; i < N; ++i) {
             float fb = y[i];
 
@@ -428,8 +560,13 @@ namespace bigpi::core {
 
             float sat = dsp::softSat(fbColored, cfg.drive);
             float fbFinal = (1.0f - cfg.satMix) * fbColored + cfg.satMix * sat;
+            fbLine[i] = fbFinal;
+        }
 
-            d[i].push(injVec[i] + fbFinal);
+        if (cfg.shimmerAmount > 0.0f) applyShimmer(fbLine, N);
+
+        for (int i = 0; i < N; ++i) {
+            d[i].push(injVec[i] + fbLine[i]);
         }
     }
 
@@ -29,6 +29,8 @@
        - measures internal tank energy (tail “age” proxy)
   8) Optional saturation inside feedback:
        - adds density and “glue”
+  9) Optional shimmer (dsp/pitch/PitchShifter.h):
+       - every 4th line feeds back partly pitch-shifted (+12 / +7)
 
   Real-time safety:
     - No allocations during processSample()
@@ -39,6 +41,7 @@
 #include <cstdint>
 
 #include "dsp/common/Dsp.h"
+#include "dsp/pitch/PitchShifter.h"
 #include "dsp/tail/Matrices.h"
 
 namespace bigpi::core {
@@ -116,6 +119,12 @@ namespace bigpi::core {
             float dynSensitivity = 3.0f;
             float dynAtkMs = 12.0f;
             float dynRelMs = 280.0f;
+
+            // Shimmer (Shimmer mode): in the shimmer lines (every 4th line)
+            // this share of the feedback is replaced by a pitch-shifted copy.
+            // 0 = off (the pitch block is not run at all).
+            float shimmerAmount = 0.0f;
+            float shimmerFifthMix = 0.30f;  // 0 = octave only, 1 = fifth only
         };
 
         // ----------------------------------------------------------------------
@@ -132,9 +141,73 @@ namespace bigpi::core {
         // Apply configuration (safe to call at block rate)
         void setConfig(const Config& c);
 
+        /*
+          Coeffs
+          ------
+          Everything setConfig() derives from a Config, precomputed for one
+          sample rate: clamped config, filter and modulator coefficients and
+          (optionally) the feedback gains for one decay value.
+
+          makeCoeffs() runs anywhere (no Tank instance, no audio thread);
+          applyCoeffs() only copies, so it is what a program change uses on
+          the audio thread (see ReverbEngine::Program). Trivially copyable:
+          it is stored as-is in preset bank files.
+        */
+        struct Coeffs {
+            Config cfg{};                   // clamped
+
+            float hpA = 0.0f;               // same cutoff on every line
+            float lpA = 0.0f;
+            float xLoA = 0.0f;
+            float xHiA = 0.0f;
+
+            float jitterRateHz = 0.35f;
+            int   jitterPeriod = 1;
+            float jitterA = 0.0f;
+
+            float cloudRateHz = 0.08f;
+            int   cloudPeriod = 1;
+            float cloudA = 0.0f;
+
+            float envAtk = 0.0f;
+            float envRel = 0.0f;
+
+            // Feedback gains for decay01 (all kMaxLines lines); decay01 < 0
+            // = not precomputed, the first processed sample computes them.
+            float decay01 = -1.0f;
+            std::array<float, kMaxLines> fbGainLow{};
+            std::array<float, kMaxLines> fbGainMid{};
+            std::array<float, kMaxLines> fbGainHigh{};
+        };
+
+        static Coeffs makeCoeffs(const Config& c, float sampleRate, float decay01 = -1.0f);
+
+        // linesCap: the quality governor's line cap (applied on top of cfg.lines).
+        void applyCoeffs(const Coeffs& k, int linesCap = kMaxLines);
+
         // Access current config
         const Config& getConfig() const { return cfg; }
 
+        /*
+          setCostOverrides(modScale, linearInterp)
+          ----------------------------------------
+          Run-time cost reduction for the quality governor
+          (core/QualityGovernor.h). Unlike setConfig() this touches no filter
+          state, so it is safe to call every chunk.
+
+            modScale     : scales jitter and cloud wander depth (0 also skips
+                           their noise generators); 1 = as configured
+            linearInterp : linear instead of cubic delay reads
+        */
+        void setCostOverrides(float modScale, bool linearInterp) {
+            costModScale = dsp::clampf(modScale, 0.0f, 1.0f);
+            costLinearReads = linearInterp;
+        }
+
+        // Clears lines [first, kMaxLines) only: used before re-enabling lines
+        // that were switched off, so they do not replay stale audio.
+        void clearLinesFrom(int first);
+
         // ----------------------------------------------------------------------
         // Processing
         // ----------------------------------------------------------------------
@@ -158,6 +231,11 @@ namespace bigpi::core {
         // Envelope output (0..1-ish), used as a tail energy proxy.
         float getEnv01() const { return env01; }
 
+        // Per-line outputs of the last processed sample (first cfg.lines valid).
+        // Cheap block-rate health probe: a NaN or runaway anywhere in the
+        // network shows up here within one loop time.
+        const std::array<float, kMaxLines>& getLastOutputs() const { return lastY; }
+
     private:
         float sr = 48000.0f;
         bool inited = false;
@@ -190,6 +268,15 @@ namespace bigpi::core {
         // Smoothed dynamic damping cutoff
         float dynDampHzCurrent = 9000.0f;
 
+        // Shimmer pitch block (only runs when cfg.shimmerAmount > 0)
+        static constexpr int kShimmerLineStride = 4;
+        PitchShifter shimmer{};
+        void applyShimmer(std::array<float, kMaxLines>& fb, int N);
+
+        // Quality governor overrides (see setCostOverrides)
+        float costModScale = 1.0f;
+        bool costLinearReads = false;
+
         // ----------------------------------------------------------------------
         // Kappa upgrade: RT60-based decay gains (stable, line-length aware)
         // ----------------------------------------------------------------------
@@ -201,7 +288,12 @@ namespace bigpi::core {
 
         void updateDecayGains(float decay01);
 
-        // Last outputs (debug/inspection; not required for sound)
+        static void computeDecayGains(const Config& c, float sampleRate, float decay01, int lines,
+            std::array<float, kMaxLines>& low,
+            std::array<float, kMaxLines>& mid,
+            std::array<float, kMaxLines>& high);
+
+        // Last outputs (health probe / inspection; not required for sound)
         std::array<float, kMaxLines> lastY{};
 
         // Seed for deterministic variation
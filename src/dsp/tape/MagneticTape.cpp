@@ -0,0 +1,264 @@
+#include "dsp/tape/MagneticTape.h"
+
+/*
+  =============================================================================
+  MagneticTape.cpp — Big Pi multi-head tape delay (implementation)
+  =============================================================================
+*/
+
+#include <algorithm> // std::max, std::min, std::fill
+#include <cmath>     // std::cos, std::sin, std::exp, std::pow, std::sqrt
+
+namespace bigpi::core {
+
+    namespace {
+
+        struct HeadLayout {
+            int count;
+            float ratio[MagneticTape::kMaxHeads];
+            float gain[MagneticTape::kMaxHeads];
+            float pan[MagneticTape::kMaxHeads];     // -1 = left, +1 = right
+        };
+
+        constexpr HeadLayout kHeadLayouts[int(MagneticTape::HeadPattern::Count)] = {
+            { 1, { 1.0f, 0.0f, 0.0f, 0.0f }, { 1.00f, 0.0f,  0.0f,  0.0f  }, {  0.0f, 0.0f,  0.0f,   0.0f  } },
+            { 2, { 1.0f, 2.0f, 0.0f, 0.0f }, { 0.80f, 0.60f, 0.0f,  0.0f  }, { -0.4f, 0.4f,  0.0f,   0.0f  } },
+            { 3, { 1.0f, 2.0f, 3.0f, 0.0f }, { 0.70f, 0.55f, 0.45f, 0.0f  }, { -0.5f, 0.5f,  0.0f,   0.0f  } },
+            { 4, { 1.0f, 1.5f, 2.4f, 3.3f }, { 0.60f, 0.50f, 0.45f, 0.40f }, { -0.6f, 0.6f, -0.25f,  0.25f } },
+        };
+
+        constexpr float kWowHz = 0.55f;
+        constexpr float kFlutterHz = 6.2f;
+        constexpr float kDriftHz = 0.35f;           // random wander added to the wow
+        constexpr float kWowHeadPhase = 0.9f;       // radians between neighbouring heads
+        constexpr float kFlutterHeadPhase = 2.1f;
+        constexpr float kTimeGlideMs = 250.0f;
+
+    } // namespace
+
+    void MagneticTape::prepare(float sampleRate) {
+        sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        // Farthest head at the longest time, plus the deepest modulation
+        // (centre offset + swing, see gatherHeads())
+        const float maxMs = kMaxTimeMs * 3.3f + 3.0f * kMaxWowMs + 2.0f * kMaxFlutterMs;
+        const int need = int(maxMs * 0.001f * sr) + 8;
+        int len = 1;
+        while (len < need) len <<= 1;
+
+        tapeL.assign(size_t(len), 0.0f);
+        tapeR.assign(size_t(len), 0.0f);
+        mask = len - 1;
+
+        drift.setSampleRate(sr);
+        drift.setRateHz(kDriftHz);
+        drift.setSmoothMs(600.0f);
+        drift.seed(0x7A9E0001u);
+
+        timeSm.setTimeMs(kTimeGlideMs, sr);
+
+        applyCoeffs(makeCoeffs(k.params, sr));
+        clear();
+    }
+
+    void MagneticTape::clear() {
+        std::fill(tapeL.begin(), tapeL.end(), 0.0f);
+        std::fill(tapeR.begin(), tapeR.end(), 0.0f);
+        writePos = 0;
+
+        wowRe = 1.0f; wowIm = 0.0f;
+        flutterRe = 1.0f; flutterIm = 0.0f;
+        drift.clear();
+        timeSm.setInstant(k.timeSamp);
+
+        lpL.clear(); lpR.clear();
+        hpL.clear(); hpR.clear();
+    }
+
+    MagneticTape::Coeffs MagneticTape::makeCoeffs(const Params& p, float sampleRate) {
+        const float sr = (sampleRate <= 1.0f) ? 48000.0f : sampleRate;
+
+        Coeffs c;
+        c.params = p;
+
+        const int pattern = std::max(0, std::min(int(p.heads), int(HeadPattern::Count) - 1));
+        c.params.heads = HeadPattern(pattern);
+        c.params.timeMs = dsp::clampf(p.timeMs, kMinTimeMs, kMaxTimeMs);
+        c.params.feedback = dsp::clampf(p.feedback, 0.0f, 0.9f);
+        c.params.wow = dsp::clampf(p.wow, 0.0f, 1.0f);
+        c.params.flutter = dsp::clampf(p.flutter, 0.0f, 1.0f);
+        c.params.drive = dsp::clampf(p.drive, 0.0f, 6.0f);
+        c.params.age = dsp::clampf(p.age, 0.0f, 1.0f);
+
+        const Params& q = c.params;
+        const HeadLayout& layout = kHeadLayouts[pattern];
+
+        // Heads share the output level: sum of gains normalised to ~1
+        float gainSum = 0.0f;
+        for (int h = 0; h < layout.count; ++h) gainSum += layout.gain[h];
+        const float gainNorm = 1.0f / std::max(1.0f, gainSum);
+
+        c.numHeads = layout.count;
+        for (int h = 0; h < kMaxHeads; ++h) {
+            const bool on = (h < layout.count);
+            const float g = on ? layout.gain[h] * gainNorm : 0.0f;
+
+            c.ratio[size_t(h)] = on ? layout.ratio[h] : 1.0f;
+            c.gainL[size_t(h)] = g * std::sqrt(1.0f - layout.pan[h]);
+            c.gainR[size_t(h)] = g * std::sqrt(1.0f + layout.pan[h]);
+
+            // cos(phi + theta) = cos(phi) cos(theta) - sin(phi) sin(theta)
+            c.wowCos[size_t(h)] = std::cos(kWowHeadPhase * float(h));
+            c.wowSin[size_t(h)] = -std::sin(kWowHeadPhase * float(h));
+            c.flutterCos[size_t(h)] = std::cos(kFlutterHeadPhase * float(h));
+            c.flutterSin[size_t(h)] = -std::sin(kFlutterHeadPhase * float(h));
+        }
+
+        c.timeSamp = q.timeMs * 0.001f * sr;
+        c.wowSamp = q.wow * kMaxWowMs * 0.001f * sr;
+        c.flutterSamp = q.flutter * kMaxFlutterMs * 0.001f * sr;
+
+        const float wW = 2.0f * dsp::kPi * kWowHz / sr;
+        const float wF = 2.0f * dsp::kPi * kFlutterHz / sr;
+        c.wowRotCos = std::cos(wW);
+        c.wowRotSin = std::sin(wW);
+        c.flutterRotCos = std::cos(wF);
+        c.flutterRotSin = std::sin(wF);
+
+        // The tape is recorded hot (drive); playback gain brings small
+        // signals back to unity, so the loop gain is just `feedback`
+        c.sat.setDrive(q.drive);
+        c.playGain = 1.0f / c.sat.smallSignalGain();
+        c.feedback = q.feedback;
+
+        // Age: 14 kHz -> 2.5 kHz top end, 40 -> 150 Hz low cut
+        const float lpHz = 14000.0f * std::pow(2500.0f / 14000.0f, q.age);
+        const float hpHz = 40.0f + 110.0f * q.age;
+        c.lpA = std::exp(-2.0f * dsp::kPi * std::min(lpHz, 0.45f * sr) / sr);
+        c.hpA = std::exp(-2.0f * dsp::kPi * hpHz / sr);
+
+        return c;
+    }
+
+    void MagneticTape::applyCoeffs(const Coeffs& c) {
+        k = c;
+        lpL.a = c.lpA; lpR.a = c.lpA;
+        hpL.a = c.hpA; hpR.a = c.hpA;
+    }
+
+    // ============================================================================
+    // Shared modulation (once per sub-block)
+    // ============================================================================
+
+    void MagneticTape::renderModulation(int m) {
+        const float wc = k.wowRotCos, ws = k.wowRotSin;
+        const float fc = k.flutterRotCos, fs = k.flutterRotSin;
+
+        for (int i = 0; i < m; ++i) {
+            // Rotate the shared oscillators (no sin/cos per sample)
+            const float wRe = wowRe * wc - wowIm * ws;
+            const float wIm = wowRe * ws + wowIm * wc;
+            wowRe = wRe; wowIm = wIm;
+
+            const float fRe = flutterRe * fc - flutterIm * fs;
+            const float fIm = flutterRe * fs + flutterIm * fc;
+            flutterRe = fRe; flutterIm = fIm;
+
+            // Drift shifts the wow centre for every head alike
+            const float d = 0.5f * drift.process();
+
+            modWowRe[size_t(i)] = wowRe;
+            modWowIm[size_t(i)] = wowIm;
+            modDrift[size_t(i)] = d;
+            modFlutterRe[size_t(i)] = flutterRe;
+            modFlutterIm[size_t(i)] = flutterIm;
+            modTime[size_t(i)] = timeSm.process(k.timeSamp);
+        }
+
+        // Keep the oscillators on the unit circle (rounding drift)
+        const float wMag = 1.0f / std::sqrt(wowRe * wowRe + wowIm * wowIm);
+        wowRe *= wMag; wowIm *= wMag;
+        const float fMag = 1.0f / std::sqrt(flutterRe * flutterRe + flutterIm * flutterIm);
+        flutterRe *= fMag; flutterIm *= fMag;
+    }
+
+    // ============================================================================
+    // Play heads (all heads, whole sub-block)
+    // ============================================================================
+
+    void MagneticTape::gatherHeads(int m) {
+        std::fill(headL.begin(), headL.begin() + m, 0.0f);
+        std::fill(headR.begin(), headR.begin() + m, 0.0f);
+
+        const float* tL = tapeL.data();
+        const float* tR = tapeR.data();
+
+        // wow (with drift) swings within +-1.5, flutter within +-1: the centre
+        // offset keeps every head at least 2 samples behind its nominal distance
+        const float wowDepth = k.wowSamp;
+        const float flutterDepth = k.flutterSamp;
+        const float wowCentre = 1.5f * wowDepth + flutterDepth + 2.0f;
+
+        for (int h = 0; h < k.numHeads; ++h) {
+            const float ratio = k.ratio[size_t(h)];
+            const float gl = k.gainL[size_t(h)];
+            const float gr = k.gainR[size_t(h)];
+            const float wcH = k.wowCos[size_t(h)], wsH = k.wowSin[size_t(h)];
+            const float fcH = k.flutterCos[size_t(h)], fsH = k.flutterSin[size_t(h)];
+
+            for (int i = 0; i < m; ++i) {
+                const float wow = modWowRe[size_t(i)] * wcH + modWowIm[size_t(i)] * wsH + modDrift[size_t(i)];
+                const float flutter = modFlutterRe[size_t(i)] * fcH + modFlutterIm[size_t(i)] * fsH;
+
+                // Delay = long head distance + short modulation. The integer
+                // part is split off first so the fraction keeps its precision
+                // (a float near 2^17 only resolves 1/64 sample).
+                const float base = ratio * modTime[size_t(i)];
+                const int baseInt = int(base);
+                const float d = (base - float(baseInt)) + wowCentre + wowDepth * wow + flutterDepth * flutter;
+                const int dInt = int(d);
+                const float fr = d - float(dInt);
+
+                // Sample i is written at writePos + i
+                const int i1 = (writePos + i - baseInt - dInt) & mask;
+                const int i0 = (i1 - 1) & mask;
+
+                headL[size_t(i)] += gl * (tL[i1] + fr * (tL[i0] - tL[i1]));
+                headR[size_t(i)] += gr * (tR[i1] + fr * (tR[i0] - tR[i1]));
+            }
+        }
+    }
+
+    void MagneticTape::processBlock(const float* inL, const float* inR, float* outL, float* outR, int n) {
+        if (tapeL.empty()) return;
+
+        int done = 0;
+        while (done < n) {
+            const int m = std::min(kSubBlock, n - done);
+
+            renderModulation(m);
+            gatherHeads(m);
+
+            const float fb = k.feedback;
+            const float playGain = k.playGain;
+
+            for (int i = 0; i < m; ++i) {
+                // Playback EQ: worn tape loses top and bottom
+                const float pL = hpL.process(lpL.process(playGain * headL[size_t(i)]));
+                const float pR = hpR.process(lpR.process(playGain * headR[size_t(i)]));
+
+                outL[done + i] = pL;
+                outR[done + i] = pR;
+
+                // Record head: input plus repeats, saturated onto the tape
+                const int w = (writePos + i) & mask;
+                tapeL[size_t(w)] = k.sat.process(inL[done + i] + fb * pL);
+                tapeR[size_t(w)] = k.sat.process(inR[done + i] + fb * pR);
+            }
+
+            writePos = (writePos + m) & mask;
+            done += m;
+        }
+    }
+
+} // namespace bigpi::core
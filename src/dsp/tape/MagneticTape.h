@@ -0,0 +1,148 @@
+#pragma once
+/*
+  =============================================================================
+  MagneticTape.h — Big Pi multi-head tape delay (Magnetic mode front end)
+  =============================================================================
+
+  RoadMap Phase 6: multi-head tape delay with head spacing presets,
+  wow/flutter, tape saturation and age control, in front of the tank:
+
+      injection -> [record head] -> tape loop -> [play heads 1..N] -> Tank
+                        ^                               |
+                        +-------- feedback -------------+
+
+  One tape, many heads:
+    All heads read the same stereo ring buffer (the tape). A head is only
+    a delay (its distance from the record head) and a gain / pan. Adding a
+    head costs one interpolated read per sample, not another buffer.
+
+  One wow/flutter source:
+    A real transport has one capstan and one reel, so every head sees the
+    same speed wobble, just at a different point of its cycle. The model
+    runs one wow oscillator (plus a slow random drift) and one flutter
+    oscillator per sample. Each head takes them with a fixed phase offset
+    (a rotation of the shared oscillator: two multiplies per head).
+
+  Block processing:
+    processBlock() works in sub-blocks of up to kSubBlock samples:
+      1. the shared modulation for the sub-block is computed once,
+      2. each head is gathered over the whole sub-block (all heads),
+      3. playback EQ (age), feedback and the record saturation run per
+         sample and write the sub-block to the tape.
+    Step 2 only reads tape written before the sub-block, which holds
+    because the shortest head distance (kMinTimeMs minus the deepest
+    wow/flutter) is longer than kSubBlock at any sample rate.
+
+  Saturation:
+    The record head uses dsp::SoftSaturator (the softSat() curve with a
+    cached normaliser and a rational tanh). Playback divides by its
+    small-signal gain, so drive adds compression and colour but never
+    raises the level or pushes the feedback loop past unity.
+
+  REAL-TIME RULE: prepare() allocates; everything else is audio-thread safe.
+*/
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "dsp/common/Dsp.h"
+
+namespace bigpi::core {
+
+    class MagneticTape {
+    public:
+        static constexpr int kMaxHeads = 4;
+        static constexpr int kSubBlock = 256;
+        static constexpr float kMinTimeMs = 40.0f;      // head 1 distance range
+        static constexpr float kMaxTimeMs = 350.0f;
+        static constexpr float kMaxWowMs = 2.5f;        // delay deviation at wow = 1
+        static constexpr float kMaxFlutterMs = 0.25f;   // delay deviation at flutter = 1
+
+        // Head spacing presets (distances relative to timeMs)
+        enum class HeadPattern : int {
+            Single = 0,     // 1
+            Pair,           // 1, 2
+            Triple,         // 1, 2, 3 (classic three-head echo)
+            Quad,           // 1, 1.5, 2.4, 3.3 (uneven, denser)
+
+            Count
+        };
+
+        struct Params {
+            HeadPattern heads = HeadPattern::Triple;
+            float timeMs = 120.0f;      // record head -> head 1
+            float feedback = 0.35f;     // repeats (0..0.9)
+            float wow = 0.35f;          // slow pitch drift (0..1)
+            float flutter = 0.25f;      // fast pitch wobble (0..1)
+            float drive = 1.2f;         // record saturation (0..6)
+            float age = 0.30f;          // 0 = new tape, 1 = worn (darker, thinner)
+        };
+
+        struct Coeffs {
+            Params params{};
+
+            int numHeads = 1;
+            std::array<float, kMaxHeads> ratio{};       // head distance / timeMs
+            std::array<float, kMaxHeads> gainL{};
+            std::array<float, kMaxHeads> gainR{};
+            std::array<float, kMaxHeads> wowCos{};      // per-head phase offsets
+            std::array<float, kMaxHeads> wowSin{};
+            std::array<float, kMaxHeads> flutterCos{};
+            std::array<float, kMaxHeads> flutterSin{};
+
+            float timeSamp = 0.0f;
+            float wowSamp = 0.0f;
+            float flutterSamp = 0.0f;
+
+            // Shared oscillators: rotation per sample
+            float wowRotCos = 1.0f, wowRotSin = 0.0f;
+            float flutterRotCos = 1.0f, flutterRotSin = 0.0f;
+
+            float feedback = 0.0f;
+            dsp::SoftSaturator sat{};                   // record head
+            float playGain = 1.0f;                      // 1 / sat small-signal gain
+            float lpA = 0.0f;                           // playback EQ (age)
+            float hpA = 0.0f;
+        };
+
+        void prepare(float sampleRate);
+        void clear();
+
+        static Coeffs makeCoeffs(const Params& p, float sampleRate);
+        void applyCoeffs(const Coeffs& c);
+
+        // Stereo in, stereo out (play heads only, no dry signal).
+        void processBlock(const float* inL, const float* inR, float* outL, float* outR, int n);
+
+    private:
+        float sr = 48000.0f;
+        Coeffs k{};
+
+        // The tape (power-of-two ring)
+        std::vector<float> tapeL{}, tapeR{};
+        int mask = 0;
+        int writePos = 0;
+
+        // Shared modulation source
+        float wowRe = 1.0f, wowIm = 0.0f;
+        float flutterRe = 1.0f, flutterIm = 0.0f;
+        dsp::SmoothNoise drift{};
+        dsp::SmoothValue timeSm{};      // head 1 distance glides like a motor speed change
+
+        // Sub-block scratch
+        std::array<float, kSubBlock> modWowRe{}, modWowIm{};
+        std::array<float, kSubBlock> modFlutterRe{}, modFlutterIm{};
+        std::array<float, kSubBlock> modDrift{};
+        std::array<float, kSubBlock> modTime{};
+        std::array<float, kSubBlock> headL{}, headR{};
+
+        // Playback EQ
+        dsp::OnePoleLP lpL{}, lpR{};
+        dsp::OnePoleHP hpL{}, hpR{};
+
+        void renderModulation(int m);
+        void gatherHeads(int m);
+    };
+
+} // namespace bigpi::core